@@ -0,0 +1,305 @@
+//--------------------------------------------------------------------------------------
+//	AssetLoader.cpp
+//
+//	The asset loader class loads a batch of model files in parallel. Files are parsed on
+//	a pool of worker threads, then the vertex and index buffers are created on the
+//	render thread
+//--------------------------------------------------------------------------------------
+
+#include <thread>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+
+#include "Defines.h"     // General definitions shared by all source files
+#include "AssetLoader.h" // Declaration of this class
+#include "GeometryCache.h" // Geometry shared between models and batches of loads
+
+#include "CMeshCache.h"  // Class to load meshes via a binary cache (taken from a full graphics engine)
+#include "MeshOptimise.h" // Vertex cache measurement
+#include "MeshQuantise.h" // Compact vertex layout errors
+
+// Size of the FIFO vertex cache simulated for the report, a conservative size for current hardware
+const unsigned int ReportCacheSize = 16;
+
+// Time passed in seconds since the given time. The standard clock is used rather than CTimer so the loader doesn't depend on Windows
+static float SecondsSince( chrono::steady_clock::time_point start )
+{
+	return chrono::duration<float>( chrono::steady_clock::now() - start ).count();
+}
+
+
+// A unique file / tangents combination to load. The mesh data is loaded on a worker thread and kept until the buffers
+// for all models using it have been created. Assets only used by models whose geometry is already cached are not loaded
+struct CAssetLoader::SAsset
+{
+	string          fileName;
+	bool            tangents;
+	bool            needed;
+	gen::CMeshCache mesh;
+	bool            loaded;
+	float           loadTime;
+};
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - may specify number of worker threads, by default uses one thread per processor core
+CAssetLoader::CAssetLoader( unsigned int numThreads /*= 0*/ )
+{
+	m_NumThreads = numThreads;
+	m_TotalTime = 0.0f;
+}
+
+// Destructor
+CAssetLoader::~CAssetLoader()
+{
+	Clear();
+}
+
+
+/////////////////////////////
+// Loading
+
+// Add a model to be loaded from the given file with the given example technique, optional tangents and optional compact vertex
+// layout (see CModel::Load). Nothing is loaded until LoadAll is called. Several models may use the same file, it will only be loaded once
+void CAssetLoader::Add( CModel* model, const string& fileName, TRenderTechnique technique, bool tangents /*= false*/,
+                        bool compact /*= false*/ )
+{
+	// Find an existing asset with the same file and options, or add a new one. The vertex layout is chosen when each model's buffers
+	// are created, so models with and without the compact layout can share an asset
+	unsigned int asset = 0;
+	while (asset < m_Assets.size() && (m_Assets[asset]->fileName != fileName || m_Assets[asset]->tangents != tangents))
+	{
+		++asset;
+	}
+	if (asset == m_Assets.size())
+	{
+		SAsset* newAsset = new SAsset;
+		newAsset->fileName = fileName;
+		newAsset->tangents = tangents;
+		newAsset->needed = false;
+		newAsset->loaded = false;
+		newAsset->loadTime = 0.0f;
+		m_Assets.push_back( newAsset );
+	}
+
+	SModelRequest request = { model, technique, compact, asset, false };
+	m_Requests.push_back( request );
+}
+
+
+// Load all the models added, then clear the list of requests. Models share geometry through the global geometry cache, files
+// are only loaded if some model needs geometry not yet in the cache. Files are loaded and parsed on worker threads, when they are
+// all finished the vertex and index buffers for each new geometry are created on the calling thread (must be the render thread)
+// Returns true if every model was loaded successfully
+bool CAssetLoader::LoadAll()
+{
+	chrono::steady_clock::time_point totalStart = chrono::steady_clock::now();
+	m_Timings.clear();
+
+	// Models whose geometry is already in the cache (e.g. from an earlier batch) use it straight away, only the remaining assets
+	// need loading
+	for (unsigned int request = 0; request < m_Requests.size(); ++request)
+	{
+		SModelRequest& modelRequest = m_Requests[request];
+		SAsset* asset = m_Assets[modelRequest.asset];
+		CModelGeometry* geometry = g_GeometryCache.Find( asset->fileName, asset->tangents, modelRequest.compact, modelRequest.technique );
+		if (geometry)
+		{
+			modelRequest.model->SetGeometry( geometry );
+			geometry->Release(); // The model holds its own reference
+			modelRequest.done = true;
+		}
+		else
+		{
+			asset->needed = true;
+		}
+	}
+
+	// Start worker threads - no more than there are assets to load. The calling thread also works on the queue, so start
+	// one less thread than requested
+	unsigned int numThreads = m_NumThreads;
+	if (numThreads == 0)
+	{
+		numThreads = thread::hardware_concurrency();
+	}
+	if (numThreads > m_Assets.size())
+	{
+		numThreads = static_cast<unsigned int>(m_Assets.size());
+	}
+	atomic<unsigned int> nextAsset( 0 );
+	vector<thread> workers;
+	for (unsigned int i = 1; i < numThreads; ++i)
+	{
+		workers.push_back( thread( &CAssetLoader::LoadAssets, this, &nextAsset ) );
+	}
+	LoadAssets( &nextAsset );
+	for (unsigned int i = 0; i < workers.size(); ++i)
+	{
+		workers[i].join();
+	}
+
+	// Prepare timings for each asset
+	m_Timings.resize( m_Assets.size() );
+	for (unsigned int asset = 0; asset < m_Assets.size(); ++asset)
+	{
+		m_Timings[asset].fileName = m_Assets[asset]->fileName;
+		m_Timings[asset].tangents = m_Assets[asset]->tangents;
+		m_Timings[asset].numModels = 0;
+		m_Timings[asset].numUploads = 0;
+		m_Timings[asset].loadTime = m_Assets[asset]->loadTime;
+		m_Timings[asset].createTime = 0.0f;
+		m_Timings[asset].loaded = m_Assets[asset]->loaded || !m_Assets[asset]->needed;
+		m_Timings[asset].compact = false;
+		m_Timings[asset].positionError = 0.0f;
+		m_Timings[asset].normalError = 0.0f;
+		m_Timings[asset].tangentError = 0.0f;
+		m_Timings[asset].textureCoordError = 0.0f;
+
+		// Measure the vertex cache efficiency across all sub-meshes, a CPU check of the face order used for rendering
+		unsigned int numFaces = 0, numVertices = 0, numTransforms = 0;
+		if (m_Assets[asset]->loaded)
+		{
+			const gen::CMeshCache& mesh = m_Assets[asset]->mesh;
+			for (unsigned int subMeshNum = 0; subMeshNum < mesh.GetNumSubMeshes(); ++subMeshNum)
+			{
+				gen::SSubMesh subMesh;
+				gen::SVertexCacheStats stats;
+				mesh.GetSubMesh( subMeshNum, &subMesh );
+				gen::MeasureVertexCache( subMesh, ReportCacheSize, &stats );
+				numFaces += stats.numFaces;
+				numVertices += stats.numVertices;
+				numTransforms += stats.numTransforms;
+			}
+		}
+		m_Timings[asset].acmr = numFaces ? static_cast<float>(numTransforms) / numFaces : 0.0f;
+		m_Timings[asset].atvr = numVertices ? static_cast<float>(numTransforms) / numVertices : 0.0f;
+	}
+
+	// Create the vertex and index buffers for each new geometry on this thread. Render devices are only used from the render thread, a
+	// DirectX 10 device could be used from any thread, but keeping all device access on one thread avoids the cost of making it thread-safe
+	// The first model needing each geometry creates it in the geometry cache, later models with the same asset and layout find it there
+	bool success = true;
+	for (unsigned int request = 0; request < m_Requests.size(); ++request)
+	{
+		SModelRequest& modelRequest = m_Requests[request];
+		SAsset* asset = m_Assets[modelRequest.asset];
+		SAssetTiming& timing = m_Timings[modelRequest.asset];
+		++timing.numModels;
+		if (modelRequest.done)
+		{
+			continue;
+		}
+
+		chrono::steady_clock::time_point createStart = chrono::steady_clock::now();
+		gen::SQuantiseError quantiseError = { 0.0f, 0.0f, 0.0f, 0.0f };
+		CModelGeometry* geometry = g_GeometryCache.Find( asset->fileName, asset->tangents, modelRequest.compact, modelRequest.technique );
+		bool created = false;
+		if (!geometry && asset->loaded)
+		{
+			geometry = g_GeometryCache.Create( asset->fileName, asset->tangents, modelRequest.compact, asset->mesh, modelRequest.technique,
+			                                   &quantiseError );
+			created = (geometry != NULL);
+		}
+		if (geometry)
+		{
+			modelRequest.model->SetGeometry( geometry );
+			geometry->Release();
+		}
+		else
+		{
+			success = false;
+		}
+		timing.createTime += SecondsSince( createStart );
+
+		// Keep the largest quantisation errors of any geometry created from the asset
+		if (created)
+		{
+			++timing.numUploads;
+		}
+		if (created && modelRequest.compact)
+		{
+			timing.compact = true;
+			timing.positionError = gen::Max( timing.positionError, quantiseError.position );
+			timing.normalError = gen::Max( timing.normalError, quantiseError.normal );
+			timing.tangentError = gen::Max( timing.tangentError, quantiseError.tangent );
+			timing.textureCoordError = gen::Max( timing.textureCoordError, quantiseError.textureCoord );
+		}
+	}
+
+	Clear();
+	m_TotalTime = SecondsSince( totalStart );
+	return success;
+}
+
+
+/////////////////////////////
+// Timing
+
+// Get a text report of the timings, vertex cache efficiency and any quantisation error from the last call to LoadAll, one line per asset
+string CAssetLoader::GetTimingReport()
+{
+	stringstream report;
+	report << fixed << setprecision( 2 );
+	float loadTime = 0.0f;
+	for (unsigned int asset = 0; asset < m_Timings.size(); ++asset)
+	{
+		const SAssetTiming& timing = m_Timings[asset];
+		report << timing.fileName << (timing.tangents ? " (tangents)" : "") << ": " << timing.numModels << " model(s), "
+		       << timing.numUploads << " upload(s), load "
+		       << timing.loadTime * 1000.0f << "ms, create " << timing.createTime * 1000.0f << "ms, ACMR " << timing.acmr
+		       << ", ATVR " << timing.atvr;
+		if (timing.compact)
+		{
+			report << setprecision( 4 ) << ", compact error: position " << timing.positionError << ", normal " << timing.normalError
+			       << "deg, tangent " << timing.tangentError << "deg, UV " << timing.textureCoordError << setprecision( 2 );
+		}
+		report << (timing.loaded ? "" : " - FAILED") << "\n";
+		loadTime += timing.loadTime;
+	}
+	report << "Total " << m_TotalTime * 1000.0f << "ms (" << loadTime * 1000.0f << "ms of loading across all threads)\n";
+	return report.str();
+}
+
+
+/////////////////////////////
+// Private functions
+
+// Worker thread function - repeatedly takes the next asset from the queue and loads it until the queue is empty
+void CAssetLoader::LoadAssets( atomic<unsigned int>* nextAsset )
+{
+	unsigned int asset;
+	while ((asset = (*nextAsset)++) < m_Assets.size())
+	{
+		// Each asset is only accessed by the thread that took it from the queue
+		SAsset* loadAsset = m_Assets[asset];
+		if (!loadAsset->needed)
+		{
+			continue;
+		}
+		chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+		try
+		{
+			loadAsset->loaded = (loadAsset->mesh.Load( loadAsset->fileName, loadAsset->tangents ) == gen::kSuccess);
+		}
+		catch (...)
+		{
+			// Exceptions must not leave a worker thread - treat as a failed load
+			loadAsset->loaded = false;
+		}
+		loadAsset->loadTime = SecondsSince( loadStart );
+	}
+}
+
+// Delete all requests and loaded data
+void CAssetLoader::Clear()
+{
+	for (unsigned int asset = 0; asset < m_Assets.size(); ++asset)
+	{
+		delete m_Assets[asset];
+	}
+	m_Assets.clear();
+	m_Requests.clear();
+}
@@ -0,0 +1,141 @@
+//--------------------------------------------------------------------------------------
+//	AssetLoader.h
+//
+//	The asset loader class loads a batch of model files in parallel. Files are parsed on
+//	a pool of worker threads, then the vertex and index buffers are created on the
+//	render thread
+//--------------------------------------------------------------------------------------
+
+#ifndef ASSET_LOADER_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define ASSET_LOADER_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <atomic>
+using namespace std;
+
+#include "Model.h"
+
+
+class CAssetLoader
+{
+/////////////////////////////
+// Public types
+public:
+
+	// Timing for a single asset (a unique file / tangents combination), filled in by LoadAll
+	struct SAssetTiming
+	{
+		string       fileName;
+		bool         tangents;
+		unsigned int numModels; // Number of models sharing this asset
+		unsigned int numUploads; // Number of geometries created from the asset, models using geometry already in the geometry cache
+		                         // share it rather than creating more (one per vertex layout at most)
+		float        loadTime;  // Time to load / parse the file on a worker thread (seconds)
+		float        createTime; // Time to create vertex and index buffers for all models using the asset (seconds)
+		float        acmr;       // Vertex cache efficiency of the asset's geometry - transforms per face and per vertex
+		float        atvr;       // (see gen::MeasureVertexCache)
+		bool         compact;    // At least one model using the asset has a compact vertex layout, largest errors introduced are:
+		float        positionError;     // - distance in model units
+		float        normalError;       // - angle in degrees
+		float        tangentError;      // - angle in degrees
+		float        textureCoordError; // - change in texture coordinate (see gen::QuantiseVertices)
+		bool         loaded;
+	};
+
+
+/////////////////////////////
+// Private types and member variables
+private:
+
+	// A model to be loaded, and the index of the asset it uses. Requests for geometry already in the geometry cache are done before
+	// loading starts
+	struct SModelRequest
+	{
+		CModel*                model;
+		TRenderTechnique       technique;
+		bool                   compact;
+		unsigned int           asset;
+		bool                   done;
+	};
+
+	// A unique file / tangents combination to load - identical requests share the same asset so each file is only loaded once
+	struct SAsset;
+
+	vector<SModelRequest> m_Requests;
+	vector<SAsset*>       m_Assets;
+
+	// Number of worker threads to use, 0 to use one per processor core
+	unsigned int m_NumThreads;
+
+	// Timings from the last call to LoadAll
+	vector<SAssetTiming> m_Timings;
+	float                m_TotalTime;
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - may specify number of worker threads, by default uses one thread per processor core
+	CAssetLoader( unsigned int numThreads = 0 );
+
+	// Destructor
+	~CAssetLoader();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CAssetLoader( const CAssetLoader& );
+	CAssetLoader& operator=( const CAssetLoader& );
+
+public:
+
+	/////////////////////////////
+	// Loading
+
+	// Add a model to be loaded from the given file with the given example technique, optional tangents and optional compact vertex
+	// layout (see CModel::Load). Nothing is loaded until LoadAll is called. Several models may use the same file, it will only be loaded once
+	void Add( CModel* model, const string& fileName, TRenderTechnique technique, bool tangents = false, bool compact = false );
+
+	// Load all the models added, then clear the list of requests. Models share geometry through the global geometry cache, files
+	// are only loaded if some model needs geometry not yet in the cache. Files are loaded and parsed on worker threads, when they are
+	// all finished the vertex and index buffers for each new geometry are created on the calling thread (must be the render thread)
+	// Returns true if every model was loaded successfully
+	bool LoadAll();
+
+
+	/////////////////////////////
+	// Timing
+
+	// Get the timings for each asset loaded by the last call to LoadAll
+	const vector<SAssetTiming>& GetTimings()
+	{
+		return m_Timings;
+	}
+
+	// Get the total time taken by the last call to LoadAll (seconds)
+	float GetTotalTime()
+	{
+		return m_TotalTime;
+	}
+
+	// Get a text report of the timings, vertex cache efficiency and any quantisation error from the last call to LoadAll, one line per asset
+	string GetTimingReport();
+
+
+/////////////////////////////
+// Private member functions
+private:
+
+	// Worker thread function - repeatedly takes the next asset from the queue and loads it until the queue is empty
+	void LoadAssets( atomic<unsigned int>* nextAsset );
+
+	// Delete all requests and loaded data
+	void Clear();
+};
+
+
+#endif // End of header guard - see top of file
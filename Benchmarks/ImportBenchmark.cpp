@@ -0,0 +1,154 @@
+//--------------------------------------------------------------------------------------
+//	ImportBenchmark.cpp
+//
+//	Times the X-file importer on the bundled models and on a generated high-valence fan,
+//	the case where matching vertex and normal face lists creates the most vertex copies
+//
+//	Usage: ImportBenchmark [repeats] [X-files...]
+//	Default is 20 repeats of Troll.x and Hills.x from the current directory. The best time
+//	of the repeats is reported
+//--------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "CImportXFile.h"
+using namespace gen;
+
+// Number of triangles in the generated fan. Every triangle has its own flat normal, so the
+// centre vertex is used with this many different normals
+const unsigned int FanFaces = 16000;
+
+
+// Create a text X-file holding a fan of triangles around a single centre vertex, with one
+// normal per face and a single material
+static string CreateFanXFile( unsigned int numFaces )
+{
+	stringstream xFile;
+	xFile << "xof 0303txt 0032\nMesh {\n" << numFaces + 1 << ";\n0.0;1.0;0.0;,\n";
+	for (unsigned int vertex = 0; vertex < numFaces; ++vertex)
+	{
+		float angle = vertex * 2.0f * kfPi / numFaces;
+		xFile << Cos( angle ) << ";0.0;" << Sin( angle ) << (vertex + 1 < numFaces ? ";,\n" : ";;\n");
+	}
+	xFile << numFaces << ";\n";
+	for (unsigned int face = 0; face < numFaces; ++face)
+	{
+		xFile << "3;0;" << face + 1 << ";" << (face + 1) % numFaces + 1 << (face + 1 < numFaces ? ";,\n" : ";;\n");
+	}
+	xFile << "MeshNormals {\n" << numFaces << ";\n";
+	for (unsigned int normal = 0; normal < numFaces; ++normal)
+	{
+		float angle = (normal + 0.5f) * 2.0f * kfPi / numFaces;
+		xFile << Cos( angle ) << ";0.7;" << Sin( angle ) << (normal + 1 < numFaces ? ";,\n" : ";;\n");
+	}
+	xFile << numFaces << ";\n";
+	for (unsigned int face = 0; face < numFaces; ++face)
+	{
+		xFile << "3;" << face << ";" << face << ";" << face << (face + 1 < numFaces ? ";,\n" : ";;\n");
+	}
+	xFile << "}\nMeshMaterialList {\n1;\n" << numFaces << ";\n";
+	for (unsigned int face = 0; face < numFaces; ++face)
+	{
+		xFile << (face + 1 < numFaces ? "0,\n" : "0;\n");
+	}
+	xFile << "Material {\n1.0;1.0;1.0;1.0;;\n0.0;\n0.0;0.0;0.0;;\n0.0;0.0;0.0;;\n}\n}\n}\n";
+	return xFile.str();
+}
+
+
+// Import the given file (or X-file data if non-NULL) the given number of times. Returns the
+// best time in milliseconds and the total vertices over all sub-meshes, or a negative time if
+// the import fails
+static double TimeImport( const string& fileName, const string* xData, unsigned int repeats, unsigned int* numVertices )
+{
+	double bestTime = -1.0;
+	for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+	{
+		CImportXFile importer;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		EImportError error = xData ? importer.ImportFile( reinterpret_cast<const TUInt8*>(xData->data()),
+		                                                  static_cast<TUInt32>(xData->size()) ) :
+		                             importer.ImportFile( fileName );
+		double time = chrono::duration<double, milli>( chrono::steady_clock::now() - start ).count();
+		if (error != kSuccess)
+		{
+			return -1.0;
+		}
+		if (bestTime < 0.0 || time < bestTime)
+		{
+			bestTime = time;
+		}
+
+		// Count the vertices after the first import (outside the timing)
+		if (repeat == 0)
+		{
+			*numVertices = 0;
+			for (TUInt32 subMesh = 0; subMesh < importer.GetNumSubMeshes(); ++subMesh)
+			{
+				SSubMesh meshData;
+				if (importer.GetSubMesh( subMesh, &meshData ) != kSuccess)
+				{
+					return -1.0;
+				}
+				*numVertices += meshData.numVertices;
+				delete[] meshData.vertices;
+				delete[] meshData.faces;
+			}
+		}
+	}
+	return bestTime;
+}
+
+
+int main( int argc, char* argv[] )
+{
+	unsigned int repeats = (argc > 1) ? atoi( argv[1] ) : 20;
+	if (repeats == 0)
+	{
+		printf( "Usage: ImportBenchmark [repeats] [X-files...]\n" );
+		return 1;
+	}
+	vector<string> fileNames;
+	for (int arg = 2; arg < argc; ++arg)
+	{
+		fileNames.push_back( argv[arg] );
+	}
+	if (fileNames.empty())
+	{
+		fileNames.push_back( "Troll.x" );
+		fileNames.push_back( "Hills.x" );
+	}
+
+	int result = 0;
+	for (unsigned int file = 0; file < fileNames.size(); ++file)
+	{
+		unsigned int numVertices = 0;
+		double time = TimeImport( fileNames[file], NULL, repeats, &numVertices );
+		if (time < 0.0)
+		{
+			printf( "%-24s import failed\n", fileNames[file].c_str() );
+			result = 1;
+			continue;
+		}
+		printf( "%-24s %8.3f ms, %u vertices\n", fileNames[file].c_str(), time, numVertices );
+	}
+
+	string fan = CreateFanXFile( FanFaces );
+	unsigned int numVertices = 0;
+	double time = TimeImport( "", &fan, repeats, &numVertices );
+	if (time < 0.0)
+	{
+		printf( "%u-face fan import failed\n", FanFaces );
+		return 1;
+	}
+	stringstream fanName;
+	fanName << FanFaces << "-face fan";
+	printf( "%-24s %8.3f ms, %u vertices\n", fanName.str().c_str(), time, numVertices );
+	return result;
+}
@@ -0,0 +1,222 @@
+//--------------------------------------------------------------------------------------
+//	SubmissionBenchmark.cpp
+//
+//	Benchmark of the CPU cost of submitting objects to the render device, comparing
+//	separate shader variable writes with constant buffers. Objects are submitted to the
+//	recording render device, so the times are the cost of working out what to submit
+//	without any graphics driver
+//
+//	Usage: SubmissionBenchmark [objects] [frames]
+//	Default is 1000 objects a frame over 50 frames
+//--------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+#include "RecordingRenderDevice.h" // Device used for the benchmark
+#include "ShaderConstants.h"       // Constant buffers being measured
+
+// Viewport dimensions (defined by the window setup code in the application)
+int g_ViewportWidth = 1280, g_ViewportHeight = 960;
+
+// Number of materials shared by the objects
+const unsigned int BenchmarkMaterials = 8;
+
+
+// Timing of one way of submitting the shader data of each object drawn
+struct SSubmissionBenchmark
+{
+	string method;
+	float  timePerObject;     // Average CPU time to submit one object, including its share of the per-frame data (nanoseconds)
+	float  commandsPerObject; // Average render device calls per object, including the draw
+	float  uploadsPerObject;  // Average shader variable writes or constant buffer uploads per object
+	float  appliesPerObject;  // Average passes the DirectX device must apply again before a draw to send changed shader variables
+};
+
+// Scene data submitted each frame, the same for both methods
+struct SBenchmarkScene
+{
+	SPerFrameConstants              frame;
+	vector<SPerMaterialConstants>   materials;
+	vector<SPerObjectConstants>     objects;
+	vector<unsigned int>            objectMaterials; // In material order
+};
+
+// Build a scene of the given number of objects spread over a grid, each group of neighbouring objects sharing a material
+static void CreateBenchmarkScene( unsigned int numObjects, SBenchmarkScene* scene )
+{
+	scene->frame.viewMatrix.MakeAffineEuler( gen::CVector3( 0.0f, 20.0f, -50.0f ), gen::CVector3( 0.3f, 0.0f, 0.0f ), gen::kZXY,
+	                                         gen::CVector3::kOne );
+	scene->frame.projMatrix = gen::CMatrix4x4::kIdentity;
+	scene->frame.cameraPos = gen::CVector3( 0.0f, 20.0f, -50.0f );
+	scene->frame.specularPower = 256.0f;
+	scene->frame.light1Pos = gen::CVector3( 30.0f, 10.0f, 0.0f );
+	scene->frame.parallaxDepth = 0.08f;
+	scene->frame.light1Colour = gen::CVector3( 10.0f, 0.0f, 7.0f );
+	scene->frame.colourMulti = 0.0f;
+	scene->frame.light2Pos = gen::CVector3( -20.0f, 30.0f, 50.0f );
+	scene->frame.light2Colour = gen::CVector3( 40.0f, 32.0f, 8.0f );
+	scene->frame.ambientColour = gen::CVector3( 0.2f, 0.2f, 0.2f );
+
+	scene->materials.resize( BenchmarkMaterials );
+	for (unsigned int material = 0; material < BenchmarkMaterials; ++material)
+	{
+		scene->materials[material].modelColour = gen::CVector3( material * 0.1f, 0.5f, 1.0f - material * 0.1f );
+	}
+
+	scene->objects.resize( numObjects );
+	scene->objectMaterials.resize( numObjects );
+	unsigned int gridSize = static_cast<unsigned int>(sqrt( static_cast<float>(numObjects) )) + 1;
+	for (unsigned int object = 0; object < numObjects; ++object)
+	{
+		gen::CVector3 position( (object % gridSize) * 5.0f, 0.0f, (object / gridSize) * 5.0f );
+		gen::CVector3 rotation( 0.0f, object * 0.1f, 0.0f );
+		scene->objects[object].worldMatrix.MakeAffineEuler( position, rotation, gen::kZXY, gen::CVector3::kOne );
+		scene->objectMaterials[object] = object * BenchmarkMaterials / numObjects;
+	}
+}
+
+
+// Submit a frame setting each value as a separate shader variable, as was done before constant buffers. The pass is applied once after
+// the per-frame values, then every object sets its colour and world matrix
+static void SubmitWithVariables( IRenderDevice* device, const SBenchmarkScene& scene, TRenderTechnique technique,
+                                 const TRenderVariable* vars )
+{
+	const SPerFrameConstants& frame = scene.frame;
+	device->SetMatrix( vars[0], frame.viewMatrix );
+	device->SetMatrix( vars[1], frame.projMatrix );
+	device->SetFloats( vars[2], &frame.cameraPos.x, 3 );
+	device->SetFloat( vars[3], frame.specularPower );
+	device->SetFloats( vars[4], &frame.light1Pos.x, 3 );
+	device->SetFloat( vars[5], frame.parallaxDepth );
+	device->SetFloats( vars[6], &frame.light1Colour.x, 3 );
+	device->SetFloat( vars[7], frame.colourMulti );
+	device->SetFloats( vars[8], &frame.light2Pos.x, 3 );
+	device->SetFloats( vars[9], &frame.light2Colour.x, 3 );
+	device->SetFloats( vars[10], &frame.ambientColour.x, 3 );
+	device->ApplyPass( technique, 0 );
+	for (unsigned int object = 0; object < scene.objects.size(); ++object)
+	{
+		device->SetFloats( vars[11], &scene.materials[scene.objectMaterials[object]].modelColour.x, 3 );
+		device->SetMatrix( vars[12], scene.objects[object].worldMatrix );
+		device->DrawIndexed( 36, 0, 0 );
+	}
+}
+
+// Submit a frame with the constant buffers - one update per tier, each skipped if the contents are unchanged. The pass is applied once
+static void SubmitWithConstants( IRenderDevice* device, const SBenchmarkScene& scene, TRenderTechnique technique,
+                                 CConstantBuffer* constants )
+{
+	constants[0].SetAndUpload( &scene.frame );
+	device->ApplyPass( technique, 0 );
+	for (unsigned int object = 0; object < scene.objects.size(); ++object)
+	{
+		constants[1].SetAndUpload( &scene.materials[scene.objectMaterials[object]] );
+		constants[2].SetAndUpload( &scene.objects[object] );
+		device->DrawIndexed( 36, 0, 0 );
+	}
+}
+
+
+// Time the submission of the given number of objects a frame over the given number of frames, setting each shader variable separately
+// (as before constant buffers) and with the per-frame, per-material and per-object constant buffers. Objects share a few materials
+// and are drawn in material order, as the render queue does. The per-frame constants change every frame (the camera moves), the
+// material and object constants don't. The constant buffers use the global render device, which must be the given recording device
+static void BenchmarkSubmission( CRecordingRenderDevice& device, unsigned int numObjects, unsigned int numFrames,
+                                 vector<SSubmissionBenchmark>* results )
+{
+	SBenchmarkScene scene;
+	CreateBenchmarkScene( numObjects, &scene );
+
+	TRenderTechnique technique = device.GetTechnique( "VertexLitTex" );
+	const char* variableNames[13] = { "ViewMatrix", "ProjMatrix", "CameraPos", "SpecularPower", "Light1Pos", "ParallaxDepth",
+	                                  "Light1Colour", "colourMulti", "Light2Pos", "Light2Colour", "AmbientColour", "ModelColour",
+	                                  "WorldMatrix" };
+	TRenderVariable vars[13];
+	for (unsigned int var = 0; var < 13; ++var)
+	{
+		vars[var] = device.GetVariable( variableNames[var] );
+	}
+	CConstantBuffer constants[3];
+	constants[0].Create( "PerFrame", sizeof(SPerFrameConstants) );
+	constants[1].Create( "PerMaterial", sizeof(SPerMaterialConstants) );
+	constants[2].Create( "PerObject", sizeof(SPerObjectConstants) );
+
+	// Each method is run for all the frames in turn, commands are counted then cleared after each frame (outside the timing) so the
+	// list doesn't grow
+	for (unsigned int method = 0; method < 2; ++method)
+	{
+		double time = 0.0;
+		unsigned int numCommands = 0, numUploads = 0, numReapplies = 0;
+		for (unsigned int frame = 0; frame < numFrames; ++frame)
+		{
+			scene.frame.cameraPos.x = frame * 0.01f;
+			device.ClearCommands();
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			if (method == 0)
+			{
+				SubmitWithVariables( &device, scene, technique, vars );
+			}
+			else
+			{
+				SubmitWithConstants( &device, scene, technique, constants );
+			}
+			time += chrono::duration<double, nano>( chrono::steady_clock::now() - start ).count();
+			numCommands += device.GetNumCommands();
+			numUploads += device.GetCommandCount( kCommandSetMatrix ) + device.GetCommandCount( kCommandSetFloats ) +
+			              device.GetCommandCount( kCommandSetFloat ) + device.GetCommandCount( kCommandUpdateBuffer );
+
+			// The effect framework only sends variables to the GPU when a pass is applied, so the DirectX device applies the pass again
+			// before a draw that follows a variable write. The recording device doesn't, so this cost isn't in the times
+			numReapplies += device.GetNumReapplies();
+		}
+
+		float numSubmitted = static_cast<float>(numObjects) * numFrames;
+		SSubmissionBenchmark result;
+		result.method = (method == 0) ? "Shader variables" : "Constant buffers";
+		result.timePerObject = static_cast<float>(time / numSubmitted);
+		result.commandsPerObject = numCommands / numSubmitted;
+		result.uploadsPerObject = numUploads / numSubmitted;
+		result.appliesPerObject = numReapplies / numSubmitted;
+		results->push_back( result );
+	}
+
+	for (unsigned int buffer = 0; buffer < 3; ++buffer)
+	{
+		constants[buffer].ReleaseResources();
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	unsigned int numObjects = (argc > 1) ? atoi( argv[1] ) : 1000;
+	unsigned int numFrames = (argc > 2) ? atoi( argv[2] ) : 50;
+	if (numObjects == 0 || numFrames == 0)
+	{
+		printf( "Usage: SubmissionBenchmark [objects] [frames]\n" );
+		return 1;
+	}
+
+	// The constant buffers use the global render device
+	CRecordingRenderDevice device;
+	g_pRenderDevice = &device;
+	vector<SSubmissionBenchmark> results;
+	BenchmarkSubmission( device, numObjects, numFrames, &results );
+	g_pRenderDevice = NULL;
+
+	printf( "%u objects, %u frames\n", numObjects, numFrames );
+	for (unsigned int result = 0; result < results.size(); ++result)
+	{
+		printf( "%-18s %8.2f ns per object, %.2f device calls, %.2f uploads, %.2f pass re-applies\n", results[result].method.c_str(),
+		        results[result].timePerObject, results[result].commandsPerObject, results[result].uploadsPerObject,
+		        results[result].appliesPerObject );
+	}
+	return 0;
+}
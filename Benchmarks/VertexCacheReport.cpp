@@ -0,0 +1,105 @@
+//--------------------------------------------------------------------------------------
+//	VertexCacheReport.cpp
+//
+//	Reports the post-transform vertex cache efficiency (ACMR and ATVR, see MeshOptimise.h)
+//	of models imported with and without the vertex cache optimisation stage, for FIFO
+//	caches of 16 and 32 entries
+//
+//	Usage: VertexCacheReport [X-files...]
+//	Default is Teapot.x, Troll.x and Sphere.x from the current directory
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "CImportXFile.h"
+#include "MeshOptimise.h"
+using namespace gen;
+
+// FIFO cache sizes simulated, the range of typical hardware
+const TUInt32 CacheSizes[2] = { 16, 32 };
+
+
+// Import the given file, optionally with the vertex cache optimisation stage, and measure the
+// vertex cache efficiency of all its sub-meshes together for each cache size. Returns false if
+// the import fails
+static bool MeasureFile( const string& fileName, bool optimise, SVertexCacheStats* stats )
+{
+	CImportXFile importer;
+	if (importer.ImportFile( fileName ) != kSuccess)
+	{
+		return false;
+	}
+	if (optimise)
+	{
+		importer.OptimiseMeshes();
+	}
+
+	for (TUInt32 cache = 0; cache < 2; ++cache)
+	{
+		stats[cache].numFaces = stats[cache].numVertices = stats[cache].numTransforms = 0;
+	}
+	for (TUInt32 subMesh = 0; subMesh < importer.GetNumSubMeshes(); ++subMesh)
+	{
+		SSubMesh meshData;
+		if (importer.GetSubMesh( subMesh, &meshData ) != kSuccess)
+		{
+			return false;
+		}
+		for (TUInt32 cache = 0; cache < 2; ++cache)
+		{
+			SVertexCacheStats subMeshStats;
+			MeasureVertexCache( meshData, CacheSizes[cache], &subMeshStats );
+			stats[cache].numFaces += subMeshStats.numFaces;
+			stats[cache].numVertices += subMeshStats.numVertices;
+			stats[cache].numTransforms += subMeshStats.numTransforms;
+		}
+		delete[] meshData.vertices;
+		delete[] meshData.faces;
+	}
+	for (TUInt32 cache = 0; cache < 2; ++cache)
+	{
+		stats[cache].acmr = stats[cache].numFaces ?
+		                    static_cast<TFloat32>(stats[cache].numTransforms) / stats[cache].numFaces : 0.0f;
+		stats[cache].atvr = stats[cache].numVertices ?
+		                    static_cast<TFloat32>(stats[cache].numTransforms) / stats[cache].numVertices : 0.0f;
+	}
+	return true;
+}
+
+
+int main( int argc, char* argv[] )
+{
+	vector<string> fileNames;
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		fileNames.push_back( argv[arg] );
+	}
+	if (fileNames.empty())
+	{
+		fileNames.push_back( "Teapot.x" );
+		fileNames.push_back( "Troll.x" );
+		fileNames.push_back( "Sphere.x" );
+	}
+
+	int result = 0;
+	printf( "%-16s %9s  %-22s %-22s\n", "", "", "FIFO 16 ACMR / ATVR", "FIFO 32 ACMR / ATVR" );
+	for (unsigned int file = 0; file < fileNames.size(); ++file)
+	{
+		SVertexCacheStats original[2], optimised[2];
+		if (!MeasureFile( fileNames[file], false, original ) || !MeasureFile( fileNames[file], true, optimised ))
+		{
+			printf( "%-16s import failed\n", fileNames[file].c_str() );
+			result = 1;
+			continue;
+		}
+		printf( "%-16s %6u faces\n", fileNames[file].c_str(), original[0].numFaces );
+		printf( "%-16s %9s  %6.3f / %-13.3f %6.3f / %-13.3f\n", "", "original", original[0].acmr, original[0].atvr,
+		        original[1].acmr, original[1].atvr );
+		printf( "%-16s %9s  %6.3f / %-13.3f %6.3f / %-13.3f\n", "", "optimised", optimised[0].acmr, optimised[0].atvr,
+		        optimised[1].acmr, optimised[1].atvr );
+	}
+	return result;
+}
@@ -11,15 +11,15 @@
 // Constructors / Destructors
 
 // Constructor - initialise all camera settings - look at the constructor declaration in the header file to see that there are defaults provided for everything
-CCamera::CCamera( D3DXVECTOR3 position, D3DXVECTOR3 rotation, float fov, float nearClip, float farClip )
+CCamera::CCamera( const gen::CVector3& position, const gen::CVector3& rotation, float fov, float nearClip, float farClip )
 {
 	m_Position = position;
 	m_Rotation = rotation;
-	UpdateMatrices();
-
 	SetFOV( fov );
 	SetNearClip( nearClip );
 	SetFarClip( farClip );
+
+	UpdateMatrices(); // Projection matrix needs the settings above
 }
 
 
@@ -30,21 +30,24 @@ CCamera::CCamera( D3DXVECTOR3 position, D3DXVECTOR3 rotation, float fov, float n
 // the view matrix that the rendering pipeline actually uses. Also create the projection matrix, a second matrix that only cameras have
 void CCamera::UpdateMatrices()
 {
-	// Make matrices for position and rotations, then multiply together to get a "camera world matrix"
-	D3DXMATRIX matrixXRot, matrixYRot, matrixZRot, matrixTranslation;
-	D3DXMatrixRotationX( &matrixXRot, m_Rotation.x );
-	D3DXMatrixRotationY( &matrixYRot, m_Rotation.y );
-	D3DXMatrixRotationZ( &matrixZRot, m_Rotation.z );
-	D3DXMatrixTranslation( &matrixTranslation, m_Position.x, m_Position.y, m_Position.z);
-	m_WorldMatrix = matrixZRot * matrixXRot * matrixYRot * matrixTranslation;
+	// Make a "camera world matrix" from position and rotations: Z rotation * X rotation * Y rotation * translation. The combined matrix is
+	// written directly from the sines and cosines of the angles rather than multiplying together a matrix for each (rotation order kZXY)
+	m_WorldMatrix.MakeAffineEuler( m_Position, m_Rotation, gen::kZXY );
 
-	// The rendering pipeline actually needs the inverse of the camera world matrix - called the view matrix. Creating an inverse is easy with DirectX:
-	D3DXMatrixInverse( &m_ViewMatrix, NULL, &m_WorldMatrix );
+	// The rendering pipeline actually needs the inverse of the camera world matrix - called the view matrix. The camera world matrix only
+	// contains rotation and translation, so the inverse is simple: transpose the rotation part and rotate the negated position by it
+	m_ViewMatrix = gen::InverseRotTrans( m_WorldMatrix );
 
 	// Initialize the projection matrix. This determines viewing properties of the camera such as field of view (FOV) and near clip distance
 	// One other factor in the projection matrix is the aspect ratio of screen (width/height) - used to adjust FOV between horizontal and vertical
+	// This is a left-handed perspective projection, the same matrix as D3DXMatrixPerspectiveFovLH, most elements are zero
 	float aspect = (float)g_ViewportWidth / g_ViewportHeight; 
-	D3DXMatrixPerspectiveFovLH( &m_ProjMatrix, m_FOV, 1.33f, m_NearClip, m_FarClip );
+	float yScale = 1.0f / gen::Tan( m_FOV * 0.5f );
+	float depthScale = m_FarClip / (m_FarClip - m_NearClip);
+	m_ProjMatrix = gen::CMatrix4x4( yScale / 1.33f, 0.0f,   0.0f,                      0.0f,
+	                                0.0f,           yScale, 0.0f,                      0.0f,
+	                                0.0f,           0.0f,   depthScale,                1.0f,
+	                                0.0f,           0.0f,   -m_NearClip * depthScale,  0.0f );
 
 	// Combine the view and projection matrix into a single matrix - which can (optionally) be used in the vertex shaders to save one matrix multiply per vertex
 	m_ViewProjMatrix = m_ViewMatrix * m_ProjMatrix;
@@ -75,28 +78,28 @@ void CCamera::Control( float frameTime, EKeyCode turnUp, EKeyCode turnDown, EKey
 	// Local X movement - move in the direction of the X axis, get axis from camera's "world" matrix
 	if (KeyHeld( moveRight ))
 	{
-		m_Position.x += m_WorldMatrix._11 * MoveSpeed * frameTime;
-		m_Position.y += m_WorldMatrix._12 * MoveSpeed * frameTime;
-		m_Position.z += m_WorldMatrix._13 * MoveSpeed * frameTime;
+		m_Position.x += m_WorldMatrix.e00 * MoveSpeed * frameTime;
+		m_Position.y += m_WorldMatrix.e01 * MoveSpeed * frameTime;
+		m_Position.z += m_WorldMatrix.e02 * MoveSpeed * frameTime;
 	}
 	if (KeyHeld( moveLeft ))
 	{
-		m_Position.x -= m_WorldMatrix._11 * MoveSpeed * frameTime;
-		m_Position.y -= m_WorldMatrix._12 * MoveSpeed * frameTime;
-		m_Position.z -= m_WorldMatrix._13 * MoveSpeed * frameTime;
+		m_Position.x -= m_WorldMatrix.e00 * MoveSpeed * frameTime;
+		m_Position.y -= m_WorldMatrix.e01 * MoveSpeed * frameTime;
+		m_Position.z -= m_WorldMatrix.e02 * MoveSpeed * frameTime;
 	}
 
 	// Local Z movement - move in the direction of the Z axis, get axis from view matrix
 	if (KeyHeld( moveForward ))
 	{
-		m_Position.x += m_WorldMatrix._31 * MoveSpeed * frameTime;
-		m_Position.y += m_WorldMatrix._32 * MoveSpeed * frameTime;
-		m_Position.z += m_WorldMatrix._33 * MoveSpeed * frameTime;
+		m_Position.x += m_WorldMatrix.e20 * MoveSpeed * frameTime;
+		m_Position.y += m_WorldMatrix.e21 * MoveSpeed * frameTime;
+		m_Position.z += m_WorldMatrix.e22 * MoveSpeed * frameTime;
 	}
 	if (KeyHeld( moveBackward ))
 	{
-		m_Position.x -= m_WorldMatrix._31 * MoveSpeed * frameTime;
-		m_Position.y -= m_WorldMatrix._32 * MoveSpeed * frameTime;
-		m_Position.z -= m_WorldMatrix._33 * MoveSpeed * frameTime;
+		m_Position.x -= m_WorldMatrix.e20 * MoveSpeed * frameTime;
+		m_Position.y -= m_WorldMatrix.e21 * MoveSpeed * frameTime;
+		m_Position.z -= m_WorldMatrix.e22 * MoveSpeed * frameTime;
 	}
 }
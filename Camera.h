@@ -8,6 +8,8 @@
 #define CAMERA_H_INCLUDED
 
 #include "Input.h"
+#include "CVector3.h"   // Maths classes from the import library, portable unlike the D3DX types
+#include "CMatrix4x4.h"
 
 //-----------------------------------------------------------------------------
 // DirectX Camera Class Defintition
@@ -20,19 +22,19 @@ class CCamera
 private:
 
 	// Postition and rotations for the camera (rarely scale cameras)
-	D3DXVECTOR3 m_Position;
-	D3DXVECTOR3 m_Rotation;
+	gen::CVector3 m_Position;
+	gen::CVector3 m_Rotation;
 
 	// Camera settings: field of view, near and far clip plane distances. Note that the FOV angle is measured in radians (radians = degrees * PI/180)
 	float m_FOV;
 	float m_NearClip;
 	float m_FarClip;
 
-	// Current view, projection and combined view-projection matrices (DirectX matrix type)
-	D3DXMATRIX m_WorldMatrix;    // Easiest to treat the camera like a model and give it a "world" matrix...
-	D3DXMATRIX m_ViewMatrix;     // ... the view matrix used in the pipeline is the inverse of its world matrix
-	D3DXMATRIX m_ProjMatrix;     // Projection matrix to set field of view and near/far clip distances
-	D3DXMATRIX m_ViewProjMatrix; // Combine (multiply) the view and projection matrices together - saves a matrix multiply in the shader (optional optimisation)
+	// Current view, projection and combined view-projection matrices (same memory layout as the DirectX matrix type)
+	gen::CMatrix4x4 m_WorldMatrix;    // Easiest to treat the camera like a model and give it a "world" matrix...
+	gen::CMatrix4x4 m_ViewMatrix;     // ... the view matrix used in the pipeline is the inverse of its world matrix
+	gen::CMatrix4x4 m_ProjMatrix;     // Projection matrix to set field of view and near/far clip distances
+	gen::CMatrix4x4 m_ViewProjMatrix; // Combine (multiply) the view and projection matrices together - saves a matrix multiply in the shader (optional optimisation)
 
 
 /////////////////////////////
@@ -43,31 +45,32 @@ public:
 	// Constructors / Destructors
 
 	// Constructor - initialise all settings, sensible defaults provided for everything.
-	CCamera( D3DXVECTOR3 position = D3DXVECTOR3(0,0,0), D3DXVECTOR3 rotation = D3DXVECTOR3(0,0,0), float fov = D3DX_PI/4, float nearClip = 0.1f, float farClip = 10000.0f );
+	CCamera( const gen::CVector3& position = gen::CVector3::kOrigin, const gen::CVector3& rotation = gen::CVector3::kZero, float fov = gen::kfPi/4,
+	         float nearClip = 0.1f, float farClip = 10000.0f );
 
 
 	/////////////////////////////
 	// Data access
 
 	// Getters
-	D3DXVECTOR3 GetPosition()
+	const gen::CVector3& GetPosition()
 	{
 		return m_Position;
 	}
-	D3DXVECTOR3 GetRotation()
+	const gen::CVector3& GetRotation()
 	{
 		return m_Rotation;
 	}
 
-	D3DXMATRIX GetViewMatrix()
+	const gen::CMatrix4x4& GetViewMatrix()
 	{
 		return m_ViewMatrix;
 	}
-	D3DXMATRIX GetProjectionMatrix()
+	const gen::CMatrix4x4& GetProjectionMatrix()
 	{
 		return m_ProjMatrix;
 	}
-	D3DXMATRIX GetViewProjectionMatrix()
+	const gen::CMatrix4x4& GetViewProjectionMatrix()
 	{
 		return m_ViewProjMatrix;
 	}
@@ -87,11 +90,11 @@ public:
 
 
 	// Setters
-	void SetPosition( D3DXVECTOR3 position )
+	void SetPosition( const gen::CVector3& position )
 	{
 		m_Position = position;
 	}
-	void SetRotation( D3DXVECTOR3 rotation )
+	void SetRotation( const gen::CVector3& rotation )
 	{
 		m_Rotation = rotation;
 	}
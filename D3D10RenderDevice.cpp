@@ -0,0 +1,372 @@
+//--------------------------------------------------------------------------------------
+//	D3D10RenderDevice.cpp
+//
+//	Render device implemented with DirectX 10, renders to the window's swap chain
+//--------------------------------------------------------------------------------------
+
+#include "Defines.h"           // General definitions shared by all source files
+#include "D3D10RenderDevice.h" // Declaration of this class
+#include <d3dx10.h>
+#include <atlbase.h>
+#include <cstring>
+
+// DirectX formats matching each vertex format
+const DXGI_FORMAT VertexFormats[kNumVertexFormats] =
+{
+	DXGI_FORMAT_R32G32_FLOAT,       // kFormatFloat2
+	DXGI_FORMAT_R32G32B32_FLOAT,    // kFormatFloat3
+	DXGI_FORMAT_R32G32B32A32_FLOAT, // kFormatFloat4
+	DXGI_FORMAT_R16G16_FLOAT,       // kFormatHalf2
+	DXGI_FORMAT_R16G16B16A16_FLOAT, // kFormatHalf4
+	DXGI_FORMAT_R8G8B8A8_SNORM,     // kFormatByte4SNorm
+	DXGI_FORMAT_R8G8B8A8_UNORM,     // kFormatByte4UNorm
+};
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - uses the given DirectX device, rendering to the given swap chain, render target and depth buffer
+CD3D10RenderDevice::CD3D10RenderDevice( ID3D10Device* device, IDXGISwapChain* swapChain, ID3D10RenderTargetView* renderTargetView,
+                                        ID3D10DepthStencilView* depthStencilView )
+{
+	m_Device = device;
+	m_SwapChain = swapChain;
+	m_RenderTargetView = renderTargetView;
+	m_DepthStencilView = depthStencilView;
+	m_Effect = NULL;
+	m_CurrentPass = NULL;
+	m_VariablesChanged = false;
+
+	// All geometry is drawn as triangle lists
+	m_Device->IASetPrimitiveTopology( D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+}
+
+// Destructor - releases all objects created through this device
+CD3D10RenderDevice::~CD3D10RenderDevice()
+{
+	for (unsigned int buffer = 0; buffer < m_Buffers.size(); ++buffer)
+	{
+		SAFE_RELEASE( m_Buffers[buffer] );
+	}
+	for (unsigned int layout = 0; layout < m_Layouts.size(); ++layout)
+	{
+		SAFE_RELEASE( m_Layouts[layout] );
+	}
+	for (unsigned int texture = 0; texture < m_Textures.size(); ++texture)
+	{
+		SAFE_RELEASE( m_Textures[texture] );
+	}
+	SAFE_RELEASE( m_Effect );
+}
+
+
+/////////////////////////////
+// Buffers and layouts
+
+TRenderBuffer CD3D10RenderDevice::CreateVertexBuffer( const void* data, unsigned int size )
+{
+	return CreateBuffer( D3D10_BIND_VERTEX_BUFFER, data, size );
+}
+
+TRenderBuffer CD3D10RenderDevice::CreateIndexBuffer( const void* data, unsigned int size )
+{
+	return CreateBuffer( D3D10_BIND_INDEX_BUFFER, data, size );
+}
+
+void CD3D10RenderDevice::ReleaseBuffer( TRenderBuffer buffer )
+{
+	if (buffer)
+	{
+		SAFE_RELEASE( m_Buffers[buffer - 1] );
+	}
+}
+
+
+// Dynamic buffers are written by the CPU and read by the GPU, DirectX places them where both have fast access
+TRenderBuffer CD3D10RenderDevice::CreateDynamicVertexBuffer( unsigned int size )
+{
+	return CreateBuffer( D3D10_BIND_VERTEX_BUFFER, NULL, size );
+}
+
+// The buffer is mapped with "discard", so DirectX gives a fresh block of memory to write while the GPU may still be reading the old
+// contents. Writing the buffer never waits for the GPU
+bool CD3D10RenderDevice::UpdateBuffer( TRenderBuffer buffer, const void* data, unsigned int size )
+{
+	void* bufferData;
+	if (FAILED( m_Buffers[buffer - 1]->Map( D3D10_MAP_WRITE_DISCARD, 0, &bufferData ) ))
+	{
+		return false;
+	}
+	memcpy( bufferData, data, size );
+	m_Buffers[buffer - 1]->Unmap();
+	return true;
+}
+
+
+// The effect is told to use the new buffer for the cbuffer in place of its own, and no longer sends the cbuffer's variables itself.
+// The buffer stays bound while passes are applied, so updating it never needs a pass to be applied again (unlike setting variables)
+TRenderBuffer CD3D10RenderDevice::CreateConstantBuffer( const string& name, unsigned int size )
+{
+	if (!m_Effect || size % 16 != 0)
+	{
+		return 0;
+	}
+	ID3D10EffectConstantBuffer* constants = m_Effect->GetConstantBufferByName( name.c_str() );
+	if (!constants->IsValid())
+	{
+		return 0;
+	}
+
+	// The buffer must hold at least every variable in the cbuffer
+	D3D10_EFFECT_TYPE_DESC typeDesc;
+	constants->GetType()->GetDesc( &typeDesc );
+	if (size < typeDesc.UnpackedSize)
+	{
+		return 0;
+	}
+
+	TRenderBuffer buffer = CreateBuffer( D3D10_BIND_CONSTANT_BUFFER, NULL, size );
+	if (buffer && FAILED( constants->SetConstantBuffer( m_Buffers[buffer - 1] ) ))
+	{
+		ReleaseBuffer( buffer );
+		return 0;
+	}
+	return buffer;
+}
+
+
+// Create a vertex layout from a list of elements, it can be used with techniques with the same vertex shader input as the example
+TRenderLayout CD3D10RenderDevice::CreateLayout( const SVertexElement* elements, unsigned int numElements, TRenderTechnique exampleTechnique )
+{
+	// Convert the element list to DirectX's description
+	static const unsigned int MaxElements = D3D10_IA_VERTEX_INPUT_STRUCTURE_ELEMENT_COUNT;
+	if (numElements > MaxElements)
+	{
+		return 0;
+	}
+	D3D10_INPUT_ELEMENT_DESC elementDescs[MaxElements];
+	for (unsigned int elt = 0; elt < numElements; ++elt)
+	{
+		elementDescs[elt].SemanticName = elements[elt].semantic;
+		elementDescs[elt].SemanticIndex = elements[elt].semanticIndex;
+		elementDescs[elt].Format = VertexFormats[elements[elt].format];
+		elementDescs[elt].AlignedByteOffset = elements[elt].offset;
+		elementDescs[elt].InputSlot = elements[elt].slot;
+		elementDescs[elt].InputSlotClass = elements[elt].perInstance ? D3D10_INPUT_PER_INSTANCE_DATA : D3D10_INPUT_PER_VERTEX_DATA;
+		elementDescs[elt].InstanceDataStepRate = elements[elt].perInstance ? 1 : 0;
+	}
+
+	// DirectX checks the layout against the vertex shader input of the example technique
+	D3D10_PASS_DESC passDesc;
+	m_Techniques[exampleTechnique - 1]->GetPassByIndex( 0 )->GetDesc( &passDesc );
+	ID3D10InputLayout* layout;
+	if (FAILED( m_Device->CreateInputLayout( elementDescs, numElements, passDesc.pIAInputSignature, passDesc.IAInputSignatureSize, &layout ) ))
+	{
+		return 0;
+	}
+	m_Layouts.push_back( layout );
+	return static_cast<TRenderLayout>(m_Layouts.size());
+}
+
+void CD3D10RenderDevice::ReleaseLayout( TRenderLayout layout )
+{
+	if (layout)
+	{
+		SAFE_RELEASE( m_Layouts[layout - 1] );
+	}
+}
+
+
+/////////////////////////////
+// Effects and textures
+
+// Load and compile an effect file. The effect code is compiled *at runtime* into low-level GPU language. Displays a message box with
+// the compiler errors if the effect file fails to compile
+bool CD3D10RenderDevice::LoadEffect( const string& fileName )
+{
+	ID3D10Blob* pErrors; // This strangely typed variable collects any errors when compiling the effect file
+	DWORD dwShaderFlags = D3D10_SHADER_ENABLE_STRICTNESS; // These "flags" are used to set the compiler options
+
+	SAFE_RELEASE( m_Effect );
+	m_Techniques.clear();
+	m_Variables.clear();
+	m_CurrentPass = NULL;
+	HRESULT hr = D3DX10CreateEffectFromFile( CA2CT(fileName.c_str()), NULL, NULL, "fx_4_0", dwShaderFlags, 0, m_Device, NULL, NULL,
+	                                         &m_Effect, &pErrors, NULL );
+	if (FAILED(hr))
+	{
+		if (pErrors != 0)  MessageBox(NULL, CA2CT(reinterpret_cast<char*>(pErrors->GetBufferPointer())), L"Error", MB_OK); // Compiler error: display error message
+		else               MessageBox(NULL, L"Error loading FX file. Ensure your FX file is in the same folder as this executable.", L"Error", MB_OK);  // No error message - probably file not found
+		return false;
+	}
+	return true;
+}
+
+
+// Get a technique or variable from the effect file by name
+TRenderTechnique CD3D10RenderDevice::GetTechnique( const string& name )
+{
+	m_Techniques.push_back( m_Effect->GetTechniqueByName( name.c_str() ) );
+	return static_cast<TRenderTechnique>(m_Techniques.size());
+}
+
+TRenderVariable CD3D10RenderDevice::GetVariable( const string& name )
+{
+	ID3D10EffectVariable* effectVariable = m_Effect->GetVariableByName( name.c_str() );
+	SVariable variable = { effectVariable->AsMatrix(), effectVariable->AsVector(), effectVariable->AsScalar(),
+	                       effectVariable->AsShaderResource() };
+	m_Variables.push_back( variable );
+	return static_cast<TRenderVariable>(m_Variables.size());
+}
+
+// Number of passes in a technique
+unsigned int CD3D10RenderDevice::GetNumPasses( TRenderTechnique technique )
+{
+	D3D10_TECHNIQUE_DESC techDesc;
+	m_Techniques[technique - 1]->GetDesc( &techDesc );
+	return techDesc.Passes;
+}
+
+
+// Load a texture from a file. Returns 0 on failure
+TRenderTexture CD3D10RenderDevice::LoadTexture( const string& fileName )
+{
+	ID3D10ShaderResourceView* texture;
+	if (FAILED( D3DX10CreateShaderResourceViewFromFile( m_Device, CA2CT(fileName.c_str()), NULL, NULL, &texture, NULL ) ))
+	{
+		return 0;
+	}
+	m_Textures.push_back( texture );
+	return static_cast<TRenderTexture>(m_Textures.size());
+}
+
+void CD3D10RenderDevice::ReleaseTexture( TRenderTexture texture )
+{
+	if (texture)
+	{
+		SAFE_RELEASE( m_Textures[texture - 1] );
+	}
+}
+
+
+/////////////////////////////
+// Shader variables
+
+void CD3D10RenderDevice::SetMatrix( TRenderVariable variable, const gen::CMatrix4x4& matrix )
+{
+	// The import library matrix has the same memory layout as a D3DXMATRIX
+	m_Variables[variable - 1].matrix->SetMatrix( const_cast<float*>(&matrix.e00) );
+	m_VariablesChanged = true;
+}
+
+void CD3D10RenderDevice::SetFloats( TRenderVariable variable, const float* values, unsigned int numValues )
+{
+	m_Variables[variable - 1].vector->SetRawValue( const_cast<float*>(values), 0, numValues * sizeof(float) );
+	m_VariablesChanged = true;
+}
+
+void CD3D10RenderDevice::SetFloat( TRenderVariable variable, float value )
+{
+	m_Variables[variable - 1].scalar->SetFloat( value );
+	m_VariablesChanged = true;
+}
+
+void CD3D10RenderDevice::SetTexture( TRenderVariable variable, TRenderTexture texture )
+{
+	m_Variables[variable - 1].resource->SetResource( texture ? m_Textures[texture - 1] : NULL );
+	m_VariablesChanged = true;
+}
+
+
+/////////////////////////////
+// Drawing
+
+void CD3D10RenderDevice::SetVertexBuffer( unsigned int slot, TRenderBuffer buffer, unsigned int vertexSize )
+{
+	ID3D10Buffer* vertexBuffer = buffer ? m_Buffers[buffer - 1] : NULL;
+	UINT offset = 0;
+	m_Device->IASetVertexBuffers( slot, 1, &vertexBuffer, &vertexSize, &offset );
+}
+
+void CD3D10RenderDevice::SetLayout( TRenderLayout layout )
+{
+	m_Device->IASetInputLayout( layout ? m_Layouts[layout - 1] : NULL );
+}
+
+void CD3D10RenderDevice::SetIndexBuffer( TRenderBuffer buffer, bool largeIndices, unsigned int offset )
+{
+	m_Device->IASetIndexBuffer( buffer ? m_Buffers[buffer - 1] : NULL, largeIndices ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT, offset );
+}
+
+void CD3D10RenderDevice::ApplyPass( TRenderTechnique technique, unsigned int pass )
+{
+	m_CurrentPass = m_Techniques[technique - 1]->GetPassByIndex( pass );
+	m_CurrentPass->Apply( 0 );
+	m_VariablesChanged = false;
+}
+
+void CD3D10RenderDevice::DrawIndexed( unsigned int numIndices, unsigned int startIndex, int baseVertex )
+{
+	if (m_VariablesChanged && m_CurrentPass)
+	{
+		m_CurrentPass->Apply( 0 );
+		m_VariablesChanged = false;
+	}
+	m_Device->DrawIndexed( numIndices, startIndex, baseVertex );
+}
+
+void CD3D10RenderDevice::DrawIndexedInstanced( unsigned int numIndices, unsigned int numInstances, unsigned int startIndex, int baseVertex,
+                                               unsigned int startInstance )
+{
+	if (m_VariablesChanged && m_CurrentPass)
+	{
+		m_CurrentPass->Apply( 0 );
+		m_VariablesChanged = false;
+	}
+	m_Device->DrawIndexedInstanced( numIndices, numInstances, startIndex, baseVertex, startInstance );
+}
+
+void CD3D10RenderDevice::Clear( const float colour[4] )
+{
+	m_Device->ClearRenderTargetView( m_RenderTargetView, colour );
+	m_Device->ClearDepthStencilView( m_DepthStencilView, D3D10_CLEAR_DEPTH, 1.0f, 0 ); // Clear the depth buffer too
+}
+
+void CD3D10RenderDevice::Present()
+{
+	m_SwapChain->Present( 0, 0 );
+}
+
+
+/////////////////////////////
+// Private member functions
+
+// Create a buffer with the given bind flags (vertex or index buffer) holding a copy of the given data. If there is no data, the buffer is
+// dynamic - the CPU can replace its contents with UpdateBuffer
+TRenderBuffer CD3D10RenderDevice::CreateBuffer( unsigned int bindFlags, const void* data, unsigned int size )
+{
+	D3D10_BUFFER_DESC bufferDesc;
+	bufferDesc.BindFlags = bindFlags;
+	bufferDesc.ByteWidth = size; // Buffer size
+	bufferDesc.MiscFlags = 0;
+	if (data)
+	{
+		bufferDesc.Usage = D3D10_USAGE_DEFAULT; // Not a dynamic buffer
+		bufferDesc.CPUAccessFlags = 0;          // Indicates that CPU won't access this buffer at all after creation
+	}
+	else
+	{
+		bufferDesc.Usage = D3D10_USAGE_DYNAMIC;
+		bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_WRITE;
+	}
+	D3D10_SUBRESOURCE_DATA initData; // Initial data
+	initData.pSysMem = data;
+	ID3D10Buffer* buffer;
+	if (FAILED( m_Device->CreateBuffer( &bufferDesc, data ? &initData : NULL, &buffer ) ))
+	{
+		return 0;
+	}
+	m_Buffers.push_back( buffer );
+	return static_cast<TRenderBuffer>(m_Buffers.size());
+}
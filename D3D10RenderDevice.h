@@ -0,0 +1,137 @@
+//--------------------------------------------------------------------------------------
+//	D3D10RenderDevice.h
+//
+//	Render device implemented with DirectX 10, renders to the window's swap chain
+//--------------------------------------------------------------------------------------
+
+#ifndef D3D10_RENDER_DEVICE_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define D3D10_RENDER_DEVICE_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include <d3d10.h>
+#include "RenderDevice.h" // Interface implemented by this class
+
+
+// Handles are indexes into lists of the DirectX objects (plus one, as 0 is never a valid handle). Released objects leave a NULL in their
+// list, the few objects created here are never released and recreated often enough for the gaps to matter
+class CD3D10RenderDevice : public IRenderDevice
+{
+/////////////////////////////
+// Private types and member variables
+private:
+
+	// DirectX objects from the device setup (see Device.cpp), not owned by this class
+	ID3D10Device*            m_Device;
+	IDXGISwapChain*          m_SwapChain;
+	ID3D10RenderTargetView*  m_RenderTargetView;
+	ID3D10DepthStencilView*  m_DepthStencilView;
+
+	// Objects created through this class, released when it is destroyed
+	ID3D10Effect*                     m_Effect;
+	vector<ID3D10Buffer*>             m_Buffers;
+	vector<ID3D10InputLayout*>        m_Layouts;
+	vector<ID3D10ShaderResourceView*> m_Textures;
+
+	// Techniques and variables from the effect, which owns them. Each variable is kept as the interface for each kind of value, only
+	// the one matching the variable's type in the effect file is valid
+	struct SVariable
+	{
+		ID3D10EffectMatrixVariable*         matrix;
+		ID3D10EffectVectorVariable*         vector;
+		ID3D10EffectScalarVariable*         scalar;
+		ID3D10EffectShaderResourceVariable* resource;
+	};
+	vector<ID3D10EffectTechnique*> m_Techniques;
+	vector<SVariable>              m_Variables;
+
+	// The effect framework only sends variables to the GPU when a pass is applied, so the current pass is applied again before a draw
+	// if any variables have changed since it was last applied. The shaders and states it selects are unchanged, DirectX skips them
+	ID3D10EffectPass* m_CurrentPass;
+	bool              m_VariablesChanged;
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - uses the given DirectX device, rendering to the given swap chain, render target and depth buffer
+	CD3D10RenderDevice( ID3D10Device* device, IDXGISwapChain* swapChain, ID3D10RenderTargetView* renderTargetView,
+	                    ID3D10DepthStencilView* depthStencilView );
+
+	// Destructor - releases all objects created through this device
+	~CD3D10RenderDevice();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CD3D10RenderDevice( const CD3D10RenderDevice& );
+	CD3D10RenderDevice& operator=( const CD3D10RenderDevice& );
+
+public:
+
+	/////////////////////////////
+	// Buffers and layouts
+
+	TRenderBuffer CreateVertexBuffer( const void* data, unsigned int size );
+	TRenderBuffer CreateIndexBuffer( const void* data, unsigned int size );
+	void ReleaseBuffer( TRenderBuffer buffer );
+	TRenderBuffer CreateDynamicVertexBuffer( unsigned int size );
+	bool UpdateBuffer( TRenderBuffer buffer, const void* data, unsigned int size );
+	TRenderBuffer CreateConstantBuffer( const string& name, unsigned int size );
+
+	TRenderLayout CreateLayout( const SVertexElement* elements, unsigned int numElements, TRenderTechnique exampleTechnique );
+	void ReleaseLayout( TRenderLayout layout );
+
+
+	/////////////////////////////
+	// Effects and textures
+
+	// Displays a message box with the compiler errors if the effect file fails to compile
+	bool LoadEffect( const string& fileName );
+
+	TRenderTechnique GetTechnique( const string& name );
+	TRenderVariable GetVariable( const string& name );
+	unsigned int GetNumPasses( TRenderTechnique technique );
+
+	TRenderTexture LoadTexture( const string& fileName );
+	void ReleaseTexture( TRenderTexture texture );
+
+
+	/////////////////////////////
+	// Shader variables
+
+	void SetMatrix( TRenderVariable variable, const gen::CMatrix4x4& matrix );
+	void SetFloats( TRenderVariable variable, const float* values, unsigned int numValues );
+	void SetFloat( TRenderVariable variable, float value );
+	void SetTexture( TRenderVariable variable, TRenderTexture texture );
+
+
+	/////////////////////////////
+	// Drawing
+
+	void SetVertexBuffer( unsigned int slot, TRenderBuffer buffer, unsigned int vertexSize );
+	void SetLayout( TRenderLayout layout );
+	void SetIndexBuffer( TRenderBuffer buffer, bool largeIndices, unsigned int offset );
+	void ApplyPass( TRenderTechnique technique, unsigned int pass );
+	void DrawIndexed( unsigned int numIndices, unsigned int startIndex, int baseVertex );
+	void DrawIndexedInstanced( unsigned int numIndices, unsigned int numInstances, unsigned int startIndex, int baseVertex,
+	                           unsigned int startInstance );
+	void Clear( const float colour[4] );
+	void Present();
+
+
+/////////////////////////////
+// Private member functions
+private:
+
+	// Create a buffer with the given bind flags (vertex, index or constant buffer) holding a copy of the given data, or a dynamic buffer if
+	// no data
+	TRenderBuffer CreateBuffer( unsigned int bindFlags, const void* data, unsigned int size );
+};
+
+
+#endif // End of header guard - see top of file
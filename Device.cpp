@@ -1,12 +1,14 @@
 #include "Device.h"
 #include "Defines.h"
+#include "D3D10RenderDevice.h"
 
 
 //--------------------------------------------------------------------------------------
 // Global Scene Variables
 //--------------------------------------------------------------------------------------
 
-// The main D3D interface, this pointer is used to access most D3D functions (and is shared across all cpp files through Defines.h)
+// The main D3D interface, this pointer is used to access most D3D functions. Only the device setup uses it directly, all rendering goes
+// through the render device (see RenderDevice.h)
 ID3D10Device* g_pd3dDevice;
 
 
@@ -103,11 +105,19 @@ bool InitDevice(HWND hWnd)
 	vp.TopLeftY = 0;
 	g_pd3dDevice->RSSetViewports(1, &vp);
 
+
+	// All rendering goes through the render device interface, which for this window is implemented with the DirectX objects above
+	g_pRenderDevice = new CD3D10RenderDevice(g_pd3dDevice, SwapChain, RenderTargetView, DepthStencilView);
+
 	return true;
 }
 
 void ReleaseDevice()
 {
+	// Release the objects created through the render device first, they belong to the D3D device
+	delete g_pRenderDevice;
+	g_pRenderDevice = NULL;
+
 	if (g_pd3dDevice)  g_pd3dDevice->ClearState(); // Resets Direct3D internal state to normal
 
 	if (DepthStencilView)  DepthStencilView->Release();
@@ -4,7 +4,8 @@
 // Global Scene Variables
 //--------------------------------------------------------------------------------------
 
-// The main D3D interface, this pointer is used to access most D3D functions (and is shared across all cpp files through Defines.h)
+// The main D3D interface, this pointer is used to access most D3D functions. Only the device setup uses it directly, all rendering goes
+// through the render device (see RenderDevice.h)
 extern ID3D10Device* g_pd3dDevice;
 
 
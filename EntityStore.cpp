@@ -0,0 +1,126 @@
+//--------------------------------------------------------------------------------------
+//	EntityStore.cpp
+//
+//	The entity store holds every model in the scene together with how to draw it, and
+//	gives out handles to refer to them
+//--------------------------------------------------------------------------------------
+
+#include "EntityStore.h" // Declaration of this class
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - creates an empty store
+CEntityStore::CEntityStore()
+{
+	m_FreeSlot = 0;
+}
+
+// Destructor - destroys all entities
+CEntityStore::~CEntityStore()
+{
+	Clear();
+}
+
+
+/////////////////////////////
+// Entities
+
+// Create an entity for the given model and return its handle. The store takes ownership of the model and deletes it when the entity
+// is destroyed. The name is only used by FindEntity
+SEntityHandle CEntityStore::Create( CModel* model, const string& name, const SMaterial& material /*= SMaterial()*/,
+                                    const SAnimation& animation /*= SAnimation()*/ )
+{
+	// Reuse a free slot if there is one, otherwise add a new slot. Generations start at 1 so default handles are never valid
+	if (m_FreeSlot == m_Slots.size())
+	{
+		SSlot slot = { 0, 1 };
+		m_Slots.push_back( slot );
+		m_FreeSlot = static_cast<unsigned int>(m_Slots.size());
+		m_EntitySlots.push_back( m_FreeSlot - 1 );
+	}
+	else
+	{
+		m_EntitySlots.push_back( m_FreeSlot );
+		m_FreeSlot = m_Slots[m_FreeSlot].entity;
+	}
+
+	// Add the entity's components to the end of the dense arrays
+	SEntityHandle entity;
+	entity.slot = m_EntitySlots.back();
+	entity.generation = m_Slots[entity.slot].generation;
+	m_Slots[entity.slot].entity = static_cast<unsigned int>(m_Models.size());
+	m_Models.push_back( model );
+	m_Materials.push_back( material );
+	m_Animations.push_back( animation );
+	m_Names.push_back( name );
+	return entity;
+}
+
+// Destroy the entity with the given handle, deleting its model. Does nothing if the handle is not valid
+void CEntityStore::Destroy( SEntityHandle entity )
+{
+	if (!IsValid( entity ))
+	{
+		return;
+	}
+
+	// Move the last entity in the dense arrays into the destroyed entity's place and update the slot referring to it
+	unsigned int index = m_Slots[entity.slot].entity;
+	unsigned int last = GetNumEntities() - 1;
+	delete m_Models[index];
+	m_Models[index] = m_Models[last];
+	m_Materials[index] = m_Materials[last];
+	m_Animations[index] = m_Animations[last];
+	m_Names[index] = m_Names[last];
+	m_EntitySlots[index] = m_EntitySlots[last];
+	m_Slots[m_EntitySlots[index]].entity = index;
+	m_Models.pop_back();
+	m_Materials.pop_back();
+	m_Animations.pop_back();
+	m_Names.pop_back();
+	m_EntitySlots.pop_back();
+
+	// Free the slot, the new generation makes existing handles to it invalid
+	++m_Slots[entity.slot].generation;
+	m_Slots[entity.slot].entity = m_FreeSlot;
+	m_FreeSlot = entity.slot;
+}
+
+// Destroy all entities
+void CEntityStore::Clear()
+{
+	for (unsigned int index = 0; index < m_Models.size(); ++index)
+	{
+		delete m_Models[index];
+	}
+	m_Models.clear();
+	m_Materials.clear();
+	m_Animations.clear();
+	m_Names.clear();
+	m_EntitySlots.clear();
+
+	// Slots are kept so that handles to the destroyed entities stay invalid, they all become free
+	for (unsigned int slot = 0; slot < m_Slots.size(); ++slot)
+	{
+		++m_Slots[slot].generation;
+		m_Slots[slot].entity = slot + 1;
+	}
+	m_FreeSlot = 0;
+}
+
+// Return the handle of the entity with the given name, or an invalid handle if there is none
+SEntityHandle CEntityStore::FindEntity( const string& name )
+{
+	SEntityHandle entity;
+	for (unsigned int index = 0; index < m_Names.size(); ++index)
+	{
+		if (m_Names[index] == name)
+		{
+			entity.slot = m_EntitySlots[index];
+			entity.generation = m_Slots[entity.slot].generation;
+			break;
+		}
+	}
+	return entity;
+}
@@ -0,0 +1,166 @@
+//--------------------------------------------------------------------------------------
+//	EntityStore.h
+//
+//	The entity store holds every model in the scene together with how to draw it, and
+//	gives out handles to refer to them
+//--------------------------------------------------------------------------------------
+
+#ifndef ENTITY_STORE_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define ENTITY_STORE_H_INCLUDED
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Model.h"
+
+
+// Handle to an entity in the store. A handle is the index of a slot in the store and the generation of that slot when the entity
+// was created. The slot is reused when the entity is destroyed, but with a new generation, so old handles are detected rather than
+// referring to the wrong entity. Default constructed handles refer to nothing
+struct SEntityHandle
+{
+	unsigned int slot;
+	unsigned int generation;
+
+	SEntityHandle() : slot( 0 ), generation( 0 ) {}
+};
+
+
+// How to draw an entity: the technique, its textures and a plain colour for techniques that use one
+struct SMaterial
+{
+	TRenderTechnique technique;
+	TRenderTexture   diffuseMap; // 0 if not used by the technique
+	TRenderTexture   normalMap;  // --"--
+	gen::CVector3    colour;     // Model colour used by plain colour techniques
+
+	SMaterial( TRenderTechnique technique = 0, TRenderTexture diffuseMap = 0, TRenderTexture normalMap = 0,
+	           const gen::CVector3& colour = gen::CVector3::kZero )
+		: technique( technique ), diffuseMap( diffuseMap ), normalMap( normalMap ), colour( colour ) {}
+};
+
+
+// How an entity animates itself each frame without any scene code, e.g. props that spin in place. Each entity's animation only changes
+// its own model, so entities can be animated in parallel. Entities that don't animate have zero speeds and cost little
+struct SAnimation
+{
+	gen::CVector3 spin; // Rotation speed around each axis (radians per second)
+
+	SAnimation( const gen::CVector3& spin = gen::CVector3::kZero ) : spin( spin ) {}
+};
+
+
+// The entities are stored densely: the data for each kind of component is kept in its own array with no gaps, so per-frame work
+// loops over exactly the live entities. The model (CModel holds an entity's transform and mesh), material and animation arrays are in
+// the same order. Destroying an entity moves the last entity into its place, so the order only stays the same as creation order while
+// nothing is destroyed. Handles go through a table of slots to find the current position of an entity in the arrays, lookups are a
+// couple of array reads. Names are only for finding entities when setting up the scene, per-frame code should keep handles
+class CEntityStore
+{
+/////////////////////////////
+// Private types and member variables
+private:
+
+	// A slot that handles refer to, giving the position of its entity in the dense arrays. Free slots form a linked list
+	struct SSlot
+	{
+		unsigned int entity;     // Position of entity in dense arrays, or next free slot if this slot is free
+		unsigned int generation; // Increased each time the slot's entity is destroyed
+	};
+	vector<SSlot>        m_Slots;
+	unsigned int         m_FreeSlot; // First free slot, m_Slots.size() if none
+
+	// Dense component arrays, one entry per live entity
+	vector<CModel*>      m_Models;    // Owned by the store
+	vector<SMaterial>    m_Materials;
+	vector<SAnimation>   m_Animations;
+	vector<string>       m_Names;
+	vector<unsigned int> m_EntitySlots; // Slot referring to each entity, used when entities are moved
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - creates an empty store
+	CEntityStore();
+
+	// Destructor - destroys all entities
+	~CEntityStore();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CEntityStore( const CEntityStore& );
+	CEntityStore& operator=( const CEntityStore& );
+
+public:
+
+	/////////////////////////////
+	// Entities
+
+	// Create an entity for the given model and return its handle. The store takes ownership of the model and deletes it when the
+	// entity is destroyed. The name is only used by FindEntity
+	SEntityHandle Create( CModel* model, const string& name, const SMaterial& material = SMaterial(),
+	                      const SAnimation& animation = SAnimation() );
+
+	// Destroy the entity with the given handle, deleting its model. Does nothing if the handle is not valid
+	void Destroy( SEntityHandle entity );
+
+	// Destroy all entities
+	void Clear();
+
+	// Does the handle refer to a live entity
+	bool IsValid( SEntityHandle entity )
+	{
+		return entity.slot < m_Slots.size() && m_Slots[entity.slot].generation == entity.generation;
+	}
+
+	// Return the handle of the entity with the given name, or an invalid handle if there is none. Searches all entities - use when
+	// setting up the scene and keep the handle, not every frame
+	SEntityHandle FindEntity( const string& name );
+
+
+	/////////////////////////////
+	// Component access by handle - return NULL if the handle is not valid
+
+	CModel* GetModel( SEntityHandle entity )
+	{
+		return IsValid( entity ) ? m_Models[m_Slots[entity.slot].entity] : NULL;
+	}
+	SMaterial* GetMaterial( SEntityHandle entity )
+	{
+		return IsValid( entity ) ? &m_Materials[m_Slots[entity.slot].entity] : NULL;
+	}
+	SAnimation* GetAnimation( SEntityHandle entity )
+	{
+		return IsValid( entity ) ? &m_Animations[m_Slots[entity.slot].entity] : NULL;
+	}
+
+
+	/////////////////////////////
+	// Component access by position in the dense arrays - for loops over all entities
+
+	unsigned int GetNumEntities()
+	{
+		return static_cast<unsigned int>(m_Models.size());
+	}
+	CModel* GetModelAt( unsigned int index )
+	{
+		return m_Models[index];
+	}
+	SMaterial& GetMaterialAt( unsigned int index )
+	{
+		return m_Materials[index];
+	}
+	SAnimation& GetAnimationAt( unsigned int index )
+	{
+		return m_Animations[index];
+	}
+};
+
+
+#endif // End of header guard - see top of file
@@ -0,0 +1,137 @@
+//--------------------------------------------------------------------------------------
+//	GeometryCache.cpp
+//
+//	The geometry cache shares model geometry between all models loaded from the same file
+//	with the same options, so the vertex and index buffers of each are only created once
+//--------------------------------------------------------------------------------------
+
+#include "Defines.h"       // General definitions shared by all source files
+#include "GeometryCache.h" // Declaration of this class
+
+#include "CMeshCache.h" // Class to load meshes via a binary cache (taken from a full graphics engine)
+
+// Cache used by models loading from files
+CGeometryCache g_GeometryCache;
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - creates an empty cache
+CGeometryCache::CGeometryCache()
+{
+}
+
+// Destructor - any geometry still in use is left to its users, but is no longer cached
+CGeometryCache::~CGeometryCache()
+{
+	// Geometry released after this must not try to remove itself from the destroyed cache
+	for (TGeometryMap::iterator it = m_Geometry.begin(); it != m_Geometry.end(); ++it)
+	{
+		it->second->m_Cache = NULL;
+	}
+}
+
+
+/////////////////////////////
+// Geometry access
+
+// Find the geometry loaded from the given file with the given options. If found, a reference is added for the caller and the
+// geometry's vertex layout is created from the example technique if it doesn't have one yet. Returns NULL if not in the cache
+CModelGeometry* CGeometryCache::Find( const string& fileName, bool tangents, bool compact, TRenderTechnique exampleTechnique )
+{
+	SKey key = { fileName, tangents, compact };
+	TGeometryMap::iterator it = m_Geometry.find( key );
+	if (it == m_Geometry.end())
+	{
+		return NULL;
+	}
+
+	// Geometry created for instancing has no layout of its own, make one the first time a model needs it
+	if (exampleTechnique && !it->second->CreateDefaultLayout( exampleTechnique ))
+	{
+		return NULL;
+	}
+	it->second->AddRef();
+	return it->second;
+}
+
+
+// Create geometry for the given file and options from mesh data already loaded from that file, and add it to the cache. The
+// caller holds the only reference. Returns NULL on failure or if the cache already has this geometry (use Find first)
+CModelGeometry* CGeometryCache::Create( const string& fileName, bool tangents, bool compact, const gen::CMeshCache& mesh,
+                                        TRenderTechnique exampleTechnique, gen::SQuantiseError* quantiseError /*= NULL*/ )
+{
+	SKey key = { fileName, tangents, compact };
+	if (m_Geometry.find( key ) != m_Geometry.end())
+	{
+		return NULL;
+	}
+
+	// Not added to the cache until created, so a failure doesn't try to remove it
+	CModelGeometry* geometry = new CModelGeometry;
+	if (!geometry->Create( mesh, exampleTechnique, compact, quantiseError ))
+	{
+		geometry->Release();
+		return NULL;
+	}
+	geometry->m_Cache = this;
+	m_Geometry[key] = geometry;
+	return geometry;
+}
+
+
+// Get the geometry for the given file and options from the cache, or load the file and create it if not there. A reference is added
+// for the caller. Returns NULL on failure
+CModelGeometry* CGeometryCache::Load( const string& fileName, bool tangents, bool compact, TRenderTechnique exampleTechnique )
+{
+	CModelGeometry* geometry = Find( fileName, tangents, compact, exampleTechnique );
+	if (geometry)
+	{
+		return geometry;
+	}
+
+	// Use CMeshCache class (from another application) to load the given file. The import code is wrapped in the namespace 'gen'
+	// The first load of a file imports it with the CImportXFile class and saves the result as a binary ".xbin" cache file beside it,
+	// later loads use the cache directly with no parsing. The cache is rebuilt automatically if the .x file or tangent option changes
+	gen::CMeshCache mesh;
+	if (mesh.Load( fileName, tangents ) != gen::kSuccess)
+	{
+		return NULL;
+	}
+	return Create( fileName, tangents, compact, mesh, exampleTechnique );
+}
+
+
+// Remove geometry from the cache, called by the geometry when its last reference is released
+void CGeometryCache::Remove( CModelGeometry* geometry )
+{
+	for (TGeometryMap::iterator it = m_Geometry.begin(); it != m_Geometry.end(); ++it)
+	{
+		if (it->second == geometry)
+		{
+			m_Geometry.erase( it );
+			return;
+		}
+	}
+}
+
+
+/////////////////////////////
+// Statistics
+
+// Get the number and memory size of the geometry in the cache, and how much has been shared
+void CGeometryCache::GetStats( SGeometryCacheStats* stats )
+{
+	stats->numGeometries = static_cast<unsigned int>(m_Geometry.size());
+	stats->numReferences = 0;
+	stats->memorySize = 0;
+	stats->sharedSize = 0;
+	for (TGeometryMap::iterator it = m_Geometry.begin(); it != m_Geometry.end(); ++it)
+	{
+		unsigned int refCount = it->second->GetRefCount();
+		stats->numReferences += refCount;
+		stats->memorySize += it->second->GetMemorySize();
+		stats->sharedSize += it->second->GetMemorySize() * (refCount - 1);
+	}
+}
@@ -0,0 +1,110 @@
+//--------------------------------------------------------------------------------------
+//	GeometryCache.h
+//
+//	The geometry cache shares model geometry between all models loaded from the same file
+//	with the same options, so the vertex and index buffers of each are only created once
+//--------------------------------------------------------------------------------------
+
+#ifndef GEOMETRY_CACHE_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define GEOMETRY_CACHE_H_INCLUDED
+
+#include <string>
+#include <map>
+using namespace std;
+
+#include "ModelGeometry.h"
+
+
+// Statistics on the geometry in the cache, see CGeometryCache::GetStats
+struct SGeometryCacheStats
+{
+	unsigned int numGeometries; // Geometry currently in the cache - unique file / options combinations
+	unsigned int numReferences; // References to that geometry, e.g. models using it
+	unsigned int memorySize;    // Vertex and index buffer memory used by the cached geometry (bytes)
+	unsigned int sharedSize;    // Memory that would have been used if each reference had its own copy, less the above (bytes)
+};
+
+
+// Geometry is keyed by the file name and the options that change the vertex data: tangents and the compact vertex layout. The vertex
+// layout doesn't depend on the technique used, so models rendered with different techniques share geometry too
+//
+// The cache only holds pointers, it does not hold a reference. Geometry is returned with a reference added for the caller, and removes
+// itself from the cache when the last reference is released, so the cache only ever contains geometry in use. Only used from the render
+// thread, like the render device
+class CGeometryCache
+{
+/////////////////////////////
+// Private types and member variables
+private:
+
+	struct SKey
+	{
+		string fileName;
+		bool   tangents;
+		bool   compact;
+
+		bool operator<( const SKey& other ) const
+		{
+			if (fileName != other.fileName) return fileName < other.fileName;
+			if (tangents != other.tangents) return tangents < other.tangents;
+			return compact < other.compact;
+		}
+	};
+	typedef map<SKey, CModelGeometry*> TGeometryMap;
+
+	TGeometryMap m_Geometry;
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - creates an empty cache
+	CGeometryCache();
+
+	// Destructor - any geometry still in use is left to its users, but is no longer cached
+	~CGeometryCache();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CGeometryCache( const CGeometryCache& );
+	CGeometryCache& operator=( const CGeometryCache& );
+
+public:
+
+	/////////////////////////////
+	// Geometry access
+
+	// Find the geometry loaded from the given file with the given options. If found, a reference is added for the caller and the
+	// geometry's vertex layout is created from the example technique if it doesn't have one yet. Returns NULL if not in the cache
+	CModelGeometry* Find( const string& fileName, bool tangents, bool compact, TRenderTechnique exampleTechnique );
+
+	// Create geometry for the given file and options from mesh data already loaded from that file, and add it to the cache. The
+	// caller holds the only reference. Returns NULL on failure or if the cache already has this geometry (use Find first)
+	CModelGeometry* Create( const string& fileName, bool tangents, bool compact, const gen::CMeshCache& mesh,
+	                        TRenderTechnique exampleTechnique, gen::SQuantiseError* quantiseError = NULL );
+
+	// Get the geometry for the given file and options from the cache, or load the file and create it if not there (see CModel::Load).
+	// A reference is added for the caller. Returns NULL on failure
+	CModelGeometry* Load( const string& fileName, bool tangents, bool compact, TRenderTechnique exampleTechnique );
+
+	// Remove geometry from the cache, called by the geometry when its last reference is released
+	void Remove( CModelGeometry* geometry );
+
+
+	/////////////////////////////
+	// Statistics
+
+	// Get the number and memory size of the geometry in the cache, and how much has been shared
+	void GetStats( SGeometryCacheStats* stats );
+};
+
+
+// Cache used by models loading from files (see CModel::Load and CAssetLoader)
+extern CGeometryCache g_GeometryCache;
+
+
+#endif // End of header guard - see top of file
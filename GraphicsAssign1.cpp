@@ -27,19 +27,22 @@
 //*****************************************************************************
 
 #include <windows.h>
-#include <d3d10.h>
-#include <d3dx10.h>
-#include <atlbase.h>
-#include <map>
+#include <sstream>
 #include "resource.h"
 
 #include "Defines.h" // General definitions shared by all source files
-#include "Device.h"
+#include "RenderDevice.h" // All rendering goes through the render device, independent of the graphics API
 #include "Model.h"   // Model class - encapsulates working with vertex/index data and world matrix
 #include "Camera.h"  // Camera class - encapsulates the camera's view and projection matrix
 #include "Shader.h"
 #include "Input.h"   // Input functions - not DirectX
 #include "Light.h"
+#include "AssetLoader.h" // Loads models in parallel
+#include "EntityStore.h" // Holds the models in the scene and how to draw them
+#include "JobSystem.h"   // Runs the scene update in parallel
+#include "RenderQueue.h" // Sorts the models to render to minimise state changes
+#include "InstancedModel.h" // Draws many copies of a model at once
+#include "GeometryCache.h"  // Models loaded from the same file share geometry
 
 //--------------------------------------------------------------------------------------
 // Global Scene Variables
@@ -50,14 +53,72 @@
 // The CCamera class handles the view and projections matrice, and provides functions to control the camera
 
 CCamera* Camera;
-map<string, CModel*> models;
-map<int, Light*> lights;
+
+// Every model in the scene (lights included) is held in the entity store along with its material. The store deletes the models when
+// cleared. Handles to the entities used each frame are kept here, so entities are only looked up by name while setting up the scene
+CEntityStore Entities;
+SEntityHandle CubeEntity, Cube2Entity, SphereEntity, TeapotEntity, Teapot2Entity, CarEntity, InsurgentEntity, FloorEntity;
+SEntityHandle Light1Entity, Light2Entity;
+
+// The insurgent's turret: its node in the model's hierarchy (the number of nodes if the model has no turret), the node's default
+// matrix placing it on the vehicle and the angle it has turned from there. The node is found when the scene is set up
+unsigned int InsurgentTurretNode;
+gen::CMatrix4x4 InsurgentTurretDefault;
+float InsurgentTurretAngle;
+
+// Lights are held in the entity store as models, get one back as a light
+Light* GetLight( SEntityHandle light )
+{
+	return static_cast<Light*>(Entities.GetModel( light ));
+}
+
+// The job system spreads the scene update across the processor cores
+CJobSystem* Jobs;
+
+// Entities are animated and their matrices updated in chunks of this many entities, each chunk a job. Large enough that the cost of a
+// job is small compared to its work, small enough to share out between threads in scenes of a few thousand entities. Culling an
+// entity is much less work than updating it, so uses larger chunks
+const unsigned int EntityChunkSize = 256;
+const unsigned int CullChunkSize = 4096;
+
+// Number of models whose matrices were rebuilt and skipped (neither the model nor any of its nodes had moved) by each chunk of entities
+// in the last update, and the number of entities found visible by each culling chunk
+struct SMatrixCounts
+{
+	unsigned int rebuilt;
+	unsigned int skipped;
+};
+vector<SMatrixCounts> ChunkMatrixCounts;
+vector<unsigned int>  ChunkVisibleCounts;
+
+// World bounds of each entity, copied from its model when updated, and whether each entity is visible to the camera (1) or culled (0).
+// Both in the same order as the entity store
+vector<gen::SBounds>  EntityBounds;
+vector<unsigned char> EntityVisible;
+
+// The entities to render this frame - those that are visible, in the order of the entity store
+vector<unsigned int>  RenderList;
+
+// The render list is drawn through the render queue, which sorts it by technique, textures and geometry
+CRenderQueue* Queue;
+
+// A field of small crates around the scene, each a copy of the cube in its own colour. They are all drawn with a single draw call as an
+// instanced model, rather than each being an entity. Crates are placed on a grid, leaving clear the area the other models are in
+CInstancedModel* Crates;
+const unsigned int CrateGridSize = 48;
+const float CrateSpacing = 8.0f;
+const float CrateScale = 0.3f;
+const float CrateClearRadius = 90.0f;
 
 // Light data - stored manually as there is no light class
-D3DXVECTOR3 AmbientColour = D3DXVECTOR3( 0.2f, 0.2f, 0.2f );
+gen::CVector3 AmbientColour = gen::CVector3( 0.2f, 0.2f, 0.2f );
 float SpecularPower = 256.0f;
 float ParallaxDepth = 0.08f; // Overall depth of bumpiness for parallax mapping
 
+// Values sent to the shaders once a frame - camera, lights and other settings. Filled in by the update and sent to the GPU in one go
+// when rendering (see ShaderConstants.h)
+SPerFrameConstants FrameConstants;
+
 // changing lights variables
 
 
@@ -65,6 +126,12 @@ float ParallaxDepth = 0.08f; // Overall depth of bumpiness for parallax mapping
 const float LightOrbitRadius = 20.0f;
 const float LightOrbitSpeed  = 0.5f;
 
+// The insurgent vehicle's turret (a node in its hierarchy) turns continuously
+const float TurretTurnSpeed = 0.8f;
+
+// The sphere spins slowly using the entity animation
+const float SphereSpinSpeed = 0.3f;
+
 // Variables used to setup the Window
 int       g_ViewportWidth;
 int       g_ViewportHeight;
@@ -80,133 +147,387 @@ int       g_ViewportHeight;
 // Create / load the camera, models and textures for the scene
 bool InitScene()
 {
+	Jobs = new CJobSystem;
+
+	// The queue draws blended models after all the others, so they blend with everything behind them
+	Queue = new CRenderQueue( &PerObjectConstants, &PerMaterialConstants, DiffuseMapVar, NormalMapVar );
+	Queue->SetLayer( AdditiveBlendingTechnique, 1 );
+
+
 	//////////////////
 	// Create camera
 
 	Camera = new CCamera();
-	Camera->SetPosition( D3DXVECTOR3(-15, 20,-40) );
-	Camera->SetRotation( D3DXVECTOR3(ToRadians(13.0f), ToRadians(18.0f), 0.0f) ); // ToRadians is a new helper function to convert degrees to radians
+	Camera->SetPosition( gen::CVector3(-15, 20,-40) );
+	Camera->SetRotation( gen::CVector3(ToRadians(13.0f), ToRadians(18.0f), 0.0f) ); // ToRadians is a new helper function to convert degrees to radians
 
 
 	///////////////////////
 	// Load/Create models
-	models["Cube"] = new CModel;
-	models["Cube2"] = new CModel;
-	models["Sphere"] = new CModel;
-	models["Floor"] = new CModel;
-	models["Teapot"] = new CModel;
-	models["Teapot2"] = new CModel;
-	models["Car"] = new CModel;
-	lights[1] = new Light; // starts at 1 instead of 0 to avoid later confusion
-	lights[2] = new Light;
+
+	// Create the models and add them to the entity store in the order they are drawn, keeping the handles of the entities
+	CModel* cube = new CModel;
+	CModel* cube2 = new CModel;
+	CModel* sphere = new CModel;
+	CModel* teapot = new CModel;
+	CModel* teapot2 = new CModel;
+	CModel* car = new CModel;
+	CModel* insurgent = new CModel;
+	CModel* floor = new CModel;
+	Light* light1 = new Light;
+	Light* light2 = new Light;
+	CubeEntity = Entities.Create( cube, "Cube" );
+	Cube2Entity = Entities.Create( cube2, "Cube2" );
+	SphereEntity = Entities.Create( sphere, "Sphere" );
+	TeapotEntity = Entities.Create( teapot, "Teapot" );
+	Teapot2Entity = Entities.Create( teapot2, "Teapot2" );
+	CarEntity = Entities.Create( car, "Car" );
+	InsurgentEntity = Entities.Create( insurgent, "Insurgent" );
+	FloorEntity = Entities.Create( floor, "Floor" );
+	Light1Entity = Entities.Create( light1, "Light1" );
+	Light2Entity = Entities.Create( light2, "Light2" );
+
 	// The model class can load ".X" files. It encapsulates (i.e. hides away from this code) the file loading/parsing and creation of vertex/index buffers
 	// We must pass an example technique used for each model. We can then only render models with techniques that uses matching vertex input data
-	if (!models["Cube"]->  Load( "Cube.x", VertexChangingTexTechnique)) return false;
-	if (!models["Cube2"]->Load("Cube.x", NormalMappingTechnique, true)) return false;
-	if (!models["Sphere"]->Load("Sphere.x", VertexChangingTexTechnique)) return false;
-	if (!models["Teapot"]->Load("Teapot.x", VertexLitTexTechnique)) return false;
-	if (!models["Teapot2"]->Load("Teapot.x", NormalMappingParaTechnique, true)) return false;
-	//if (!Troll->Load("Troll.x", VertexLitTexTechnique)) return false;
-	if (!models["Floor"]-> Load( "Floor.x", VertexTexTechnique)) return false;
-	if (!lights[1]->Load( "Sphere.x", PlainColourTechnique )) return false;
-	if (!lights[2]->Load( "Sphere.x", PlainColourTechnique )) return false;
-	if (!models["Car"]->Load("AstonMartin.x", AdditiveBlendingTechnique)) return false;
+	// The asset loader collects the models to load then parses all the files in parallel - files used by several models are only loaded once
+	// The denser models use the compact vertex layout (last parameter), about half the vertex memory for a small loss of precision
+	CAssetLoader loader;
+	loader.Add( cube, "Cube.x", VertexChangingTexTechnique );
+	loader.Add( cube2, "Cube.x", NormalMappingTechnique, true );
+	loader.Add( sphere, "Sphere.x", VertexChangingTexTechnique, false, true );
+	loader.Add( teapot, "Teapot.x", VertexLitTexTechnique, false, true );
+	loader.Add( teapot2, "Teapot.x", NormalMappingParaTechnique, true, true );
+	//loader.Add( Troll, "Troll.x", VertexLitTexTechnique, false, true );
+	loader.Add( floor, "Floor.x", VertexTexTechnique );
+	loader.Add( light1, "Sphere.x", PlainColourTechnique );
+	loader.Add( light2, "Sphere.x", PlainColourTechnique );
+	loader.Add( car, "AstonMartin.x", AdditiveBlendingTechnique );
+	loader.Add( insurgent, "Insurgent.x", VertexLitTexTechnique );
+	if (!loader.LoadAll()) return false;
+	OutputDebugStringA( loader.GetTimingReport().c_str() );
+
+	// Find the insurgent's turret now its hierarchy is loaded, the turret turns from its default matrix
+	InsurgentTurretNode = insurgent->FindNode( "Frame_Head" );
+	if (InsurgentTurretNode < insurgent->GetNumNodes())
+	{
+		InsurgentTurretDefault = insurgent->GetNodeMatrix( InsurgentTurretNode );
+	}
+	InsurgentTurretAngle = 0.0f;
+
+	// The crates share one copy of the cube geometry, which is the same geometry as the cube model's (from the geometry cache). The
+	// instances never move, so their data is sent to the GPU once
+	Crates = new CInstancedModel;
+	if (!Crates->Load( "Cube.x", InstancedLitColourTechnique )) return false;
+
+	// Report how much geometry memory sharing saved
+	SGeometryCacheStats geometryStats;
+	g_GeometryCache.GetStats( &geometryStats );
+	stringstream geometryReport;
+	geometryReport << "Geometry: " << geometryStats.numGeometries << " unique for " << geometryStats.numReferences << " users, "
+	               << geometryStats.memorySize / 1024 << "KB (" << geometryStats.sharedSize / 1024 << "KB saved by sharing)\n";
+	OutputDebugStringA( geometryReport.str().c_str() );
+
+	float gridOffset = (CrateGridSize - 1) * CrateSpacing * 0.5f;
+	for (unsigned int x = 0; x < CrateGridSize; ++x)
+	{
+		for (unsigned int z = 0; z < CrateGridSize; ++z)
+		{
+			gen::CVector3 position( x * CrateSpacing - gridOffset, 5.0f * CrateScale, z * CrateSpacing - gridOffset );
+			if (position.Length() > CrateClearRadius)
+			{
+				gen::CVector3 rotation( 0.0f, (x * 7 + z * 13) * 0.1f, 0.0f );
+				gen::CVector3 colour( 0.4f + 0.6f * x / CrateGridSize, 0.5f, 0.4f + 0.6f * z / CrateGridSize );
+				Crates->GetInstances().Add( position, rotation, CrateScale, colour );
+			}
+		}
+	}
 
 	
 	
 	// Initial positions
-	models["Cube"]->SetPosition( D3DXVECTOR3(0, 10, 0) );
-	models["Cube2"]->SetPosition(D3DXVECTOR3(-20, 10, 50));
-	models["Sphere"]->SetPosition(D3DXVECTOR3(30, 20, 50));
-	models["Sphere"]->SetScale(0.5f);
-	models["Teapot"]->SetPosition(D3DXVECTOR3(0, 10, 40));
-	models["Teapot2"]->SetPosition(D3DXVECTOR3(0, 20, 40));
-	//Troll->SetPosition(D3DXVECTOR3(-10, 10, 50));
+	cube->SetPosition( gen::CVector3(0, 10, 0) );
+	cube2->SetPosition(gen::CVector3(-20, 10, 50));
+	sphere->SetPosition(gen::CVector3(30, 20, 50));
+	sphere->SetScale(0.5f);
+	Entities.GetAnimation( SphereEntity )->spin = gen::CVector3(0, SphereSpinSpeed, 0);
+	teapot->SetPosition(gen::CVector3(0, 10, 40));
+	teapot2->SetPosition(gen::CVector3(0, 20, 40));
+	//Troll->SetPosition(gen::CVector3(-10, 10, 50));
 	//Troll->SetScale(5.0f);
-	models["Car"]->SetPosition(D3DXVECTOR3(20, 10, 30));
-	models["Car"]->SetScale(3.0f);
-	lights[1]->SetPosition( D3DXVECTOR3(30, 10, 0) );
-	lights[1]->SetScale( 0.1f ); // Nice if size of light reflects its brightness
-	lights[1]->SetInitColour(D3DXVECTOR3(1.0f, 0.0f, 0.7f) * 10);
-	lights[2]->SetPosition( D3DXVECTOR3(-20, 30, 50) );
-	lights[2]->SetScale( 0.2f );
-	lights[2]->SetInitColour(D3DXVECTOR3(1.0f, 0.8f, 0.2f) * 40);
+	car->SetPosition(gen::CVector3(20, 10, 30));
+	car->SetScale(3.0f);
+	insurgent->SetPosition(gen::CVector3(-40, 0, 20));
+	insurgent->SetScale(4.0f);
+	light1->SetPosition( gen::CVector3(30, 10, 0) );
+	light1->SetScale( 0.1f ); // Nice if size of light reflects its brightness
+	light1->SetInitColour(gen::CVector3(1.0f, 0.0f, 0.7f) * 10);
+	light2->SetPosition( gen::CVector3(-20, 30, 50) );
+	light2->SetScale( 0.2f );
+	light2->SetInitColour(gen::CVector3(1.0f, 0.8f, 0.2f) * 40);
 
 
 	//////////////////
 	// Load textures
 
-	if (FAILED( D3DX10CreateShaderResourceViewFromFile( g_pd3dDevice, L"StoneDiffuseSpecular.dds", NULL, NULL, &CubeDiffuseMap,  NULL ) ))
+	CubeDiffuseMap = g_pRenderDevice->LoadTexture( "StoneDiffuseSpecular.dds" );
+	if (!CubeDiffuseMap)
+		return false;
+	FloorDiffuseMap = g_pRenderDevice->LoadTexture( "WoodDiffuseSpecular.dds" );
+	if (!FloorDiffuseMap)
 		return false;
-	if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, L"WoodDiffuseSpecular.dds", NULL, NULL, &FloorDiffuseMap, NULL)))
+	SphereDiffuseMap = g_pRenderDevice->LoadTexture( "BushDiffuseSpecularAlpha.dds" );
+	if (!SphereDiffuseMap)
 		return false;
-	if (FAILED( D3DX10CreateShaderResourceViewFromFile( g_pd3dDevice, L"BushDiffuseSpecularAlpha.dds",  NULL, NULL, &SphereDiffuseMap, NULL ) ))
+	TeapotDiffuseMap = g_pRenderDevice->LoadTexture( "StoneDiffuseSpecular.dds" );
+	if (!TeapotDiffuseMap)
 		return false;
-	if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, L"StoneDiffuseSpecular.dds", NULL, NULL, &TeapotDiffuseMap, NULL)))
+	TrollDiffuseMap = g_pRenderDevice->LoadTexture( "Troll1DiffuseSpecular.dds" );
+	if (!TrollDiffuseMap)
 		return false;
-	if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, L"Troll1DiffuseSpecular.dds", NULL, NULL, &TrollDiffuseMap, NULL)))
+	Cube2DiffuseMap = g_pRenderDevice->LoadTexture( "PatternDiffuseSpecular.dds" );
+	if (!Cube2DiffuseMap)
 		return false;
-	if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, L"PatternDiffuseSpecular.dds", NULL, NULL, &Cube2DiffuseMap, NULL)))
+	Cube2NormalMap = g_pRenderDevice->LoadTexture( "PatternNormal.dds" );
+	if (!Cube2NormalMap)
 		return false;
-	if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, L"PatternNormal.dds", NULL, NULL, &Cube2NormalMap, NULL))) 
+	Teapot2DiffuseMap = g_pRenderDevice->LoadTexture( "WallDiffuseSpecular.dds" );
+	if (!Teapot2DiffuseMap)
 		return false;
-	if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, L"WallDiffuseSpecular.dds", NULL, NULL, &Teapot2DiffuseMap, NULL)))
+	Teapot2NormalMap = g_pRenderDevice->LoadTexture( "WallNormalDepth.dds" );
+	if (!Teapot2NormalMap)
 		return false;
-	if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, L"WallNormalDepth.dds", NULL, NULL, &Teapot2NormalMap, NULL)))
+	CarDiffuseMap = g_pRenderDevice->LoadTexture( "StoneDiffuseSpecular.dds" );
+	if (!CarDiffuseMap)
 		return false;
-	if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, L"StoneDiffuseSpecular.dds", NULL, NULL, &CarDiffuseMap, NULL)))
+	InsurgentDiffuseMap = g_pRenderDevice->LoadTexture( "insurgent.jpg" );
+	if (!InsurgentDiffuseMap)
 		return false;
 
+
+	//////////////////
+	// Materials
+
+	// Technique and textures used to render each entity. The lights use a plain colour, which is updated each frame
+	*Entities.GetMaterial( CubeEntity ) = SMaterial( VertexTexTechnique, CubeDiffuseMap );
+	*Entities.GetMaterial( Cube2Entity ) = SMaterial( NormalMappingTechnique, Cube2DiffuseMap, Cube2NormalMap );
+	*Entities.GetMaterial( SphereEntity ) = SMaterial( VertexChangingTexTechnique, SphereDiffuseMap );
+	*Entities.GetMaterial( TeapotEntity ) = SMaterial( VertexLitTexTechnique, TeapotDiffuseMap );
+	*Entities.GetMaterial( Teapot2Entity ) = SMaterial( NormalMappingParaTechnique, Teapot2DiffuseMap, Teapot2NormalMap );
+	*Entities.GetMaterial( CarEntity ) = SMaterial( AdditiveBlendingTechnique, CarDiffuseMap );
+	*Entities.GetMaterial( InsurgentEntity ) = SMaterial( VertexLitTexTechnique, InsurgentDiffuseMap );
+	*Entities.GetMaterial( FloorEntity ) = SMaterial( VertexTexTechnique, FloorDiffuseMap );
+	*Entities.GetMaterial( Light1Entity ) = SMaterial( PlainColourTechnique );
+	*Entities.GetMaterial( Light2Entity ) = SMaterial( PlainColourTechnique );
+
 	return true;
 }
 
 
+// Animate the entities first to end-1 in the entity store and update their world matrices and bounds, counting the matrices rebuilt
+// and skipped. Each entity only changes its own model, so different ranges of entities can be updated on different threads at the same
+// time
+void UpdateEntities( float frameTime, unsigned int first, unsigned int end, SMatrixCounts* counts )
+{
+	counts->rebuilt = 0;
+	counts->skipped = 0;
+	for (unsigned int entity = first; entity < end; ++entity)
+	{
+		CModel* model = Entities.GetModelAt( entity );
+		const SAnimation& animation = Entities.GetAnimationAt( entity );
+		if (!animation.spin.IsZero())
+		{
+			model->SetRotation( model->GetRotation() + animation.spin * frameTime );
+		}
+		if (model->UpdateMatrix())
+		{
+			++counts->rebuilt;
+		}
+		else
+		{
+			++counts->skipped;
+		}
+		EntityBounds[entity] = model->GetWorldBounds();
+	}
+}
+
+
 // Update the scene - move/rotate each model and the camera, then update their matrices
+// The update is a series of stages, each using the results of the stages before it:
+//   Camera ------------------------------------------------------------------------------+
+//   Scene logic (serial) --> Entity animation and matrices (parallel chunks) --> Culling (parallel chunks) --> Render list
+// The camera depends on nothing else in the scene, so it is updated by a job alongside the other stages and waited for by the first stage
+// that needs it, culling, which also needs the entities' bounds. Every entity is updated exactly as it would be on a single thread, so the
+// results don't depend on the number of threads
 void UpdateScene( float frameTime )
 {
+	//---------------------------
+	// Camera
+
 	// Control camera position and update its matrices (view matrix, projection matrix) each frame
 	// Don't be deceived into thinking that this is a new method to control models - the same code we used previously is in the camera class
-	Camera->Control( frameTime, Key_Up, Key_Down, Key_Left, Key_Right, Key_W, Key_S, Key_A, Key_D );
-	Camera->UpdateMatrices();
+	CJobGroup cameraJobs;
+	Jobs->Run( [frameTime]()
+	{
+		Camera->Control( frameTime, Key_Up, Key_Down, Key_Left, Key_Right, Key_W, Key_S, Key_A, Key_D );
+		Camera->UpdateMatrices();
+	}, &cameraJobs );
+
+
+	//---------------------------
+	// Scene logic
+
+	// Control of individual entities by the keys and by each other - only a few entities, which depend on each other, so run on this
+	// thread. Get the entities updated this frame from their handles
+	CModel* cube = Entities.GetModel( CubeEntity );
+	CModel* teapot2 = Entities.GetModel( Teapot2Entity );
+	CModel* insurgent = Entities.GetModel( InsurgentEntity );
+	Light* light1 = GetLight( Light1Entity );
+	Light* light2 = GetLight( Light2Entity );
 	
-	// Control cube position and update its world matrix each frame
-	models["Cube"]->Control( frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Period, Key_Comma );
-	models["Cube"]->UpdateMatrix();
+	// Control cube position. Model world matrices are only rebuilt when they are next used after the model moves, the matrices of all
+	// entities are brought up to date together in the next stage - static models cost nothing
+	cube->Control( frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Period, Key_Comma );
 	//Cube2->Control(frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Period, Key_Comma);
-	models["Cube2"]->UpdateMatrix();
-	models["Car"]->UpdateMatrix();
+
 	// Update the orbiting light - a bit of a cheat with the static variable [ask the tutor if you want to know what this is]
 	static float Rotate = 0.0f;
-	lights[1]->SetPosition(models["Cube"]->GetPosition() + D3DXVECTOR3(cos(Rotate)*LightOrbitRadius, 0, sin(Rotate)*LightOrbitRadius) );
+	light1->SetPosition(cube->GetPosition() + gen::CVector3(cos(Rotate)*LightOrbitRadius, 0, sin(Rotate)*LightOrbitRadius) );
 	Rotate -= LightOrbitSpeed * frameTime;
-	lights[1]->UpdateMatrix();
-
-	// Second light doesn't move, but do need to make sure its matrix has been calculated - could do this in InitScene instead
-	lights[2]->UpdateMatrix();
 
 	// Sphere brightness/colour calculation
 	float static runtimeFloat = 0.0f;
 	runtimeFloat += frameTime;
-	colourMultiVar->SetFloat(fmod(runtimeFloat, 5.0f)*0.2f);
-	models["Sphere"]->UpdateMatrix();
-
-	models["Teapot2"]->Control(frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Period, Key_Comma);
-	models["Teapot"]->UpdateMatrix();
-	models["Teapot2"]->UpdateMatrix();
-	//Troll->UpdateMatrix();
+	FrameConstants.colourMulti = fmod(runtimeFloat, 5.0f)*0.2f;
+
+	teapot2->Control(frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Period, Key_Comma);
+
+	// Turn the insurgent's turret by rotating its node around its own Y axis. Only that node's matrix is recalculated, the rest of the
+	// model is untouched
+	if (InsurgentTurretNode < insurgent->GetNumNodes())
+	{
+		InsurgentTurretAngle += TurretTurnSpeed * frameTime;
+		gen::CMatrix4x4 turretRotation;
+		turretRotation.MakeRotationY(InsurgentTurretAngle);
+		insurgent->SetNodeMatrix(InsurgentTurretNode, turretRotation * InsurgentTurretDefault);
+	}
 	int runtimeInt = static_cast<int>(runtimeFloat);
 
 	// Light 2, gradualy changing blue value in Light 2
 	float belowTwoSec = fmod(runtimeFloat, 2.0f);
-	lights[1]->SetColour(lights[1]->GetInitColour() * (runtimeInt % 2));
-	lights[2]->SetColour(D3DXVECTOR3(lights[2]->GetInitColour().x, lights[2]->GetInitColour().y, (belowTwoSec > 1.0f ? 1.0f - (belowTwoSec - 1.0f) : belowTwoSec) * lights[2]->GetInitColour().z));
-	g_pLightPosVar->SetRawValue(lights[1]->GetPosition(), 0, 12);  // Send 3 floats (12 bytes) from C++ LightPos variable (x,y,z) to shader counterpart (middle parameter is unused) 
-	g_pLightColourVar->SetRawValue(lights[1]->GetColour(), 0, 12);
-	g_pLight2PosVar->SetRawValue(lights[2]->GetPosition(), 0, 12);
-	g_pLight2ColourVar->SetRawValue(lights[2]->GetColour(), 0, 12);
-	g_pAmbientColourVar->SetRawValue(AmbientColour, 0, 12);
-	g_pSpecularPowerVar->SetFloat(SpecularPower);
-	g_pCameraPosVar->SetRawValue(Camera->GetPosition(), 0, 12);
+	light1->SetColour(light1->GetInitColour() * (runtimeInt % 2));
+	light2->SetColour(gen::CVector3(light2->GetInitColour().x, light2->GetInitColour().y, (belowTwoSec > 1.0f ? 1.0f - (belowTwoSec - 1.0f) : belowTwoSec) * light2->GetInitColour().z));
+	Entities.GetMaterial( Light1Entity )->colour = light1->GetColour(); // Light models are drawn in the light's colour
+	Entities.GetMaterial( Light2Entity )->colour = light2->GetColour();
+
+
+	//---------------------------
+	// Entity animation and matrices
+
+	// Animate every entity and update its matrices, in chunks run in parallel. Counts are kept per chunk and added up afterwards
+	unsigned int numEntities = Entities.GetNumEntities();
+	ChunkMatrixCounts.resize( CJobSystem::GetNumChunks( numEntities, EntityChunkSize ) );
+	EntityBounds.resize( numEntities );
+	Jobs->ParallelFor( numEntities, EntityChunkSize, [frameTime]( unsigned int chunk, unsigned int first, unsigned int end )
+	{
+		UpdateEntities( frameTime, first, end, &ChunkMatrixCounts[chunk] );
+	});
+
+
+	//---------------------------
+	// Culling
+
+	// Test the world bounds of every entity against the camera's view frustum, in chunks run in parallel
+	Jobs->Wait( &cameraJobs );
+	gen::SFrustum frustum;
+	gen::ExtractFrustum( Camera->GetViewProjectionMatrix(), &frustum );
+	EntityVisible.resize( numEntities );
+	ChunkVisibleCounts.resize( CJobSystem::GetNumChunks( numEntities, CullChunkSize ) );
+	Jobs->ParallelFor( numEntities, CullChunkSize, [&frustum]( unsigned int chunk, unsigned int first, unsigned int end )
+	{
+		ChunkVisibleCounts[chunk] = gen::BatchCullBounds( frustum, &EntityBounds[first], &EntityVisible[first], end - first );
+	});
+
+
+	//---------------------------
+	// Render list
+
+	// Only the visible entities are rendered
+	RenderList.clear();
+	for (unsigned int entity = 0; entity < numEntities; ++entity)
+	{
+		if (EntityVisible[entity])
+		{
+			RenderList.push_back( entity );
+		}
+	}
+
+
+	//---------------------------
+	// Shader constants
+
+	// Fill in the rest of the per-frame constants, they are sent to the GPU together when the scene is rendered
+	FrameConstants.viewMatrix = Camera->GetViewMatrix();
+	FrameConstants.projMatrix = Camera->GetProjectionMatrix();
+	FrameConstants.cameraPos = Camera->GetPosition();
+	FrameConstants.light1Pos = light1->GetPosition();
+	FrameConstants.light1Colour = light1->GetColour();
+	FrameConstants.light2Pos = light2->GetPosition();
+	FrameConstants.light2Colour = light2->GetColour();
+	FrameConstants.ambientColour = AmbientColour;
+	FrameConstants.specularPower = SpecularPower;
+	FrameConstants.parallaxDepth = ParallaxDepth;
+
+	// Report the average number of model matrices rebuilt and skipped (nothing had moved), of entities visible and culled, of
+	// state changes made and avoided by the render queue and of constant buffer uploads made and skipped (unchanged) per frame, once a
+	// second
+	static float reportTime = 0.0f;
+	static unsigned int reportFrames = 0;
+	static unsigned int reportRebuilt = 0, reportSkipped = 0, reportVisible = 0, reportEntities = 0;
+	static unsigned int reportStatesSet = 0, reportStatesAvoided = 0;
+	for (unsigned int chunk = 0; chunk < ChunkMatrixCounts.size(); ++chunk)
+	{
+		reportRebuilt += ChunkMatrixCounts[chunk].rebuilt;
+		reportSkipped += ChunkMatrixCounts[chunk].skipped;
+	}
+	for (unsigned int chunk = 0; chunk < ChunkVisibleCounts.size(); ++chunk)
+	{
+		reportVisible += ChunkVisibleCounts[chunk];
+	}
+	reportEntities += numEntities;
+	const SRenderQueueStats& queueStats = Queue->GetStats(); // From the last frame rendered
+	reportStatesSet += queueStats.passesApplied + queueStats.texturesSet + queueStats.geometrySelected;
+	reportStatesAvoided += queueStats.passesAvoided + queueStats.texturesAvoided + queueStats.geometryAvoided;
+	reportTime += frameTime;
+	++reportFrames;
+	if (reportTime >= 1.0f)
+	{
+		stringstream report;
+		report << "World matrices per frame: " << static_cast<float>(reportRebuilt) / reportFrames << " rebuilt, "
+		       << static_cast<float>(reportSkipped) / reportFrames << " skipped (" << Jobs->GetNumThreads() << " threads)\n";
+		report << "Entities per frame: " << static_cast<float>(reportVisible) / reportFrames << " visible, "
+		       << static_cast<float>(reportEntities - reportVisible) / reportFrames << " culled\n";
+		report << "State changes per frame: " << static_cast<float>(reportStatesSet) / reportFrames << " made, "
+		       << static_cast<float>(reportStatesAvoided) / reportFrames << " avoided by sorting\n";
+		CConstantBuffer* constantBuffers[3] = { &PerFrameConstants, &PerMaterialConstants, &PerObjectConstants };
+		const char* constantBufferNames[3] = { "frame", "material", "object" };
+		report << "Constant buffer uploads per frame:";
+		for (unsigned int buffer = 0; buffer < 3; ++buffer)
+		{
+			report << " " << constantBufferNames[buffer] << " " << static_cast<float>(constantBuffers[buffer]->GetNumUploads()) / reportFrames
+			       << " (" << static_cast<float>(constantBuffers[buffer]->GetNumSkipped()) / reportFrames << " skipped)";
+			constantBuffers[buffer]->ResetStats();
+		}
+		report << "\n";
+		OutputDebugStringA( report.str().c_str() );
+		reportTime = 0.0f;
+		reportFrames = 0;
+		reportRebuilt = 0;
+		reportSkipped = 0;
+		reportVisible = 0;
+		reportEntities = 0;
+		reportStatesSet = 0;
+		reportStatesAvoided = 0;
+	}
 }
 
 
@@ -215,8 +536,7 @@ void RenderScene()
 {
 	// Clear the back buffer - before drawing the geometry clear the entire window to a fixed colour
 	float ClearColor[4] = { 0.2f, 0.2f, 0.3f, 1.0f }; // Good idea to match background to ambient colour
-	g_pd3dDevice->ClearRenderTargetView( RenderTargetView, ClearColor );
-	g_pd3dDevice->ClearDepthStencilView( DepthStencilView, D3D10_CLEAR_DEPTH, 1.0f, 0 ); // Clear the depth buffer too
+	g_pRenderDevice->Clear( ClearColor ); // Clears the depth buffer too
 
 
 	//---------------------------
@@ -224,84 +544,43 @@ void RenderScene()
 
 	// Common features for all models, set these once only
 
-	// Pass the camera's matrices to the vertex shader
-	ViewMatrixVar->SetMatrix( (float*)&Camera->GetViewMatrix() );
-	ProjMatrixVar->SetMatrix( (float*)&Camera->GetProjectionMatrix() );
-	ParallaxDepthVar->SetFloat(ParallaxDepth);
+	// Pass the camera's matrices, the lights and other settings to the shaders - a single update of the per-frame constant buffer
+	PerFrameConstants.SetAndUpload( &FrameConstants );
 
 	//---------------------------
 	// Render each model
 	
-	// Constant colours used for models in initial shaders
-	D3DXVECTOR3 Black( 0.0f, 0.0f, 0.0f );
-	D3DXVECTOR3 Blue( 0.0f, 0.0f, 1.0f );
-
-	// Render cube
-	WorldMatrixVar->SetMatrix( (float*)models["Cube"]->GetWorldMatrix() );  // Send the cube's world matrix to the shader
-    DiffuseMapVar->SetResource( CubeDiffuseMap );                 // Send the cube's diffuse/specular map to the shader
-	//ModelColourVar->SetRawValue( Blue, 0, 12 );           // Set a single colour to render the model
-	models["Cube"]->Render(VertexTexTechnique);                         // Pass rendering technique to the model class
-
-	WorldMatrixVar->SetMatrix((float*)models["Cube2"]->GetWorldMatrix());
-	DiffuseMapVar->SetResource(Cube2DiffuseMap);
-	NormalMapVar->SetResource(Cube2NormalMap);               // Send the cube's normal map to the shader
-	models["Cube2"]->Render(NormalMappingTechnique);
-
-	WorldMatrixVar->SetMatrix((float*)models["Sphere"]->GetWorldMatrix());
-	DiffuseMapVar->SetResource(SphereDiffuseMap);
-	models["Sphere"]->Render(VertexChangingTexTechnique);
-
-	WorldMatrixVar->SetMatrix((float*)models["Teapot"]->GetWorldMatrix());
-	DiffuseMapVar->SetResource(TeapotDiffuseMap);
-	models["Teapot"]->Render(VertexLitTexTechnique);
-
-	WorldMatrixVar->SetMatrix((float*)models["Teapot2"]->GetWorldMatrix());
-	DiffuseMapVar->SetResource(Teapot2DiffuseMap);
-	NormalMapVar->SetResource(Teapot2NormalMap);
-	models["Teapot2"]->Render(NormalMappingParaTechnique);
-
-	WorldMatrixVar->SetMatrix((float*)models["Car"]->GetWorldMatrix());
-	DiffuseMapVar->SetResource(CarDiffuseMap);
-	models["Car"]->Render(AdditiveBlendingTechnique);
-
-	//WorldMatrixVar->SetMatrix((float*)Troll->GetWorldMatrix());
-	//DiffuseMapVar->SetResource(TrollDiffuseMap);
-	//Troll->Render(VertexLitTexTechnique);
-
-	// Same for the other models in the scene
-	WorldMatrixVar->SetMatrix( (float*)models["Floor"]->GetWorldMatrix() );
-    DiffuseMapVar->SetResource( FloorDiffuseMap );
-	ModelColourVar->SetRawValue( Black, 0, 12 );
-	models["Floor"]->Render(VertexTexTechnique);
-
-	WorldMatrixVar->SetMatrix( (float*)lights[1]->GetWorldMatrix() );
-	//ModelColourVar->SetRawValue( Light1Colour, 0, 12 );
-	ModelColourVar->SetRawValue(lights[1]->GetColour(), 0, 12);
-	lights[1]->Render( PlainColourTechnique );
-
-	WorldMatrixVar->SetMatrix( (float*)lights[2]->GetWorldMatrix() );
-	//ModelColourVar->SetRawValue( Light2Colour, 0, 12 );
-	ModelColourVar->SetRawValue(lights[2]->GetColour(), 0, 12);
-	lights[2]->Render( PlainColourTechnique );
+	// The crates are opaque, so are drawn before the queue, which draws blended models last
+	Crates->Render( InstancedLitColourTechnique, &PerObjectConstants );
+
+	// Queue each visible entity with its material and render the queue. The queue sorts the entities so each technique is applied
+	// once, and textures and geometry are only selected when they change. The render list was built in the update, in the order of the
+	// entity store (the order the entities were created)
+	Queue->Clear();
+	for (unsigned int item = 0; item < RenderList.size(); ++item)
+	{
+		unsigned int entity = RenderList[item];
+		const SMaterial& material = Entities.GetMaterialAt( entity );
+		Queue->Add( Entities.GetModelAt( entity ), material.technique, material.diffuseMap, material.normalMap, material.colour );
+	}
+	Queue->Render();
+
+	//g_pRenderDevice->SetTexture(DiffuseMapVar, TrollDiffuseMap);
+	//Troll->Render(VertexLitTexTechnique, &PerObjectConstants);
 
 
 	//---------------------------
 	// Display the Scene
 
 	// After we've finished drawing to the off-screen back buffer, we "present" it to the front buffer (the screen)
-	SwapChain->Present( 0, 0 );
+	g_pRenderDevice->Present();
 }
 
 void ReleaseResources()
 {
-	delete models["Cube"];
-	delete models["Cube2"];
-	delete models["Sphere"];
-	delete models["Floor"];
-	delete models["Teapot"];
-	delete models["Teapot2"];
-	delete models["Car"];
-	delete lights[1];
-	delete lights[2];
+	Entities.Clear();
+	delete Queue;
+	delete Crates;
 	delete Camera;
+	delete Jobs;
 }
\ No newline at end of file
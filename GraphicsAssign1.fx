@@ -27,6 +27,19 @@ struct VS_NORMALMAP_INPUT
 	float2 UV      : TEXCOORD0;
 };
 
+// Input for instanced models - the vertex data plus the data of the instance being drawn, the world matrix (as four rows) and colour
+struct VS_INSTANCED_INPUT
+{
+	float3 Pos            : POSITION;
+	float3 Normal         : NORMAL;
+	float2 UV             : TEXCOORD0;
+	float4 InstanceWorld0 : INSTANCEWORLD0;
+	float4 InstanceWorld1 : INSTANCEWORLD1;
+	float4 InstanceWorld2 : INSTANCEWORLD2;
+	float4 InstanceWorld3 : INSTANCEWORLD3;
+	float3 InstanceColour : INSTANCECOLOUR;
+};
+
 // Data output from vertex shader to pixel shader for simple techniques. Again different techniques have different requirements
 struct VS_BASIC_OUTPUT
 {
@@ -51,39 +64,59 @@ struct VS_NORMALMAP_OUTPUT
 	float2 UV           : TEXCOORD0;
 };
 
+struct VS_INSTANCED_OUTPUT
+{
+	float4 ProjPos     : SV_POSITION;
+	float3 WorldPos    : POSITION;
+	float3 WorldNormal : NORMAL;
+	float3 Colour      : COLOR0;
+};
+
 //--------------------------------------------------------------------------------------
 // Global Variables
 //--------------------------------------------------------------------------------------
 // All these variables are created & manipulated in the C++ code and passed into the shader here
 
-// The matrices (4x4 matrix of floats) for transforming from 3D model to 2D projection (used in vertex shader)
-float4x4 WorldMatrix;
-float4x4 ViewMatrix;
-float4x4 ProjMatrix;
+// The variables are grouped into constant buffers by how often they change, the C++ code fills each buffer as a whole from a structure
+// with the same layout (see ShaderConstants.h). Every float3 shares a 16-byte register with the float after it, matching the padding
+// in the structures. Matrices are row_major to match the C++ matrix class, so they are sent without transposing
+
+// Values that change once a frame - the camera's matrices (4x4 matrix of floats) for transforming from 3D world to 2D projection,
+// lights and other settings for the whole scene
+cbuffer PerFrame
+{
+	row_major float4x4 ViewMatrix;
+	row_major float4x4 ProjMatrix;
+	float3 CameraPos;
+	float  SpecularPower;
+	float3 Light1Pos;
+	float  ParallaxDepth;
+	float3 Light1Colour;
+	float  colourMulti; // multiplier for sphere colour. changes over time
+	float3 Light2Pos;
+	float3 Light2Colour;
+	float3 AmbientColour;
+};
+
+// Values that change with the material - a single colour for an entire model, used for light models and the intial basic shader
+cbuffer PerMaterial
+{
+	float3 ModelColour;
+};
+
+// Values that change for each object drawn - the world matrix for transforming the model (or a part of it) into the world
+cbuffer PerObject
+{
+	row_major float4x4 WorldMatrix;
+};
 
 // directional light
 const float3 LightColour = { 1.0f, 0.8f, 0.4f };
 const float3 LightDir = { 0.707f, 0.707f, -0.707f };
 
-// variables for lighting calculation
-float3 Light1Pos;
-float3 Light2Pos;
-float3 Light1Colour;
-float3 Light2Colour;
-float3 AmbientColour;
-float  SpecularPower;
-float3 CameraPos;
-
 // Normal map
 Texture2D NormalMap;
 
-float ParallaxDepth;
-// multiplier for sphere colour. changes over time
-float colourMulti;
-
-// A single colour for an entire model - used for light models and the intial basic shader
-float3 ModelColour;
-
 // Diffuse texture map (the main texture colour) - may contain specular map in alpha channel
 Texture2D DiffuseMap;
 SamplerState Trilinear
@@ -160,6 +193,30 @@ VS_NORMALMAP_OUTPUT NormalMapTransform(VS_NORMALMAP_INPUT vIn)
 
 	return vOut;
 }
+
+// Vertex shader for instanced models. The world matrix variable holds the matrix of the model part being drawn (relative to the
+// instance), the instance's own world matrix then places it in the world
+VS_INSTANCED_OUTPUT InstancedLighting(VS_INSTANCED_INPUT vIn)
+{
+	VS_INSTANCED_OUTPUT vOut;
+
+	// Transform by the part's matrix, then the instance's world matrix built from its four rows
+	float4x4 instanceWorldMatrix = float4x4(vIn.InstanceWorld0, vIn.InstanceWorld1, vIn.InstanceWorld2, vIn.InstanceWorld3);
+	float4 modelPos = float4(vIn.Pos, 1.0f);
+	float4 worldPos = mul(mul(modelPos, WorldMatrix), instanceWorldMatrix);
+	vOut.WorldPos = worldPos.xyz;
+	float4 viewPos = mul(worldPos, ViewMatrix);
+	vOut.ProjPos = mul(viewPos, ProjMatrix);
+
+	// Normals are vectors, so 0.0 in the 4th element
+	float4 modelNormal = float4(vIn.Normal, 0.0f);
+	vOut.WorldNormal = mul(mul(modelNormal, WorldMatrix), instanceWorldMatrix).xyz;
+
+	// Each instance has its own colour
+	vOut.Colour = vIn.InstanceColour;
+
+	return vOut;
+}
 //--------------------------------------------------------------------------------------
 // Pixel Shaders
 //--------------------------------------------------------------------------------------
@@ -363,6 +420,38 @@ float4 NormalMapLightingPara(VS_NORMALMAP_OUTPUT vOut) : SV_Target
 }
 
 
+// Lighting for instanced models, the same lights as VertexLitDiffuseMap but with the instance colour in place of a texture
+float4 InstancedLitColour(VS_INSTANCED_OUTPUT vOut) : SV_Target
+{
+	float3 worldNormal = normalize(vOut.WorldNormal);
+	float3 CameraDir = normalize(CameraPos - vOut.WorldPos.xyz);
+
+	//// LIGHT 1
+	float3 Light1Dir = normalize(Light1Pos - vOut.WorldPos.xyz);
+	float3 DiffuseLight1 = Light1Colour * saturate(dot(worldNormal.xyz, Light1Dir));
+	float3 halfway = normalize(Light1Dir + CameraDir);
+	float3 SpecularLight1 = DiffuseLight1 * pow(saturate(dot(worldNormal.xyz, halfway)), SpecularPower);
+
+	//// LIGHT 2
+	float3 Light2Dir = normalize(Light2Pos - vOut.WorldPos.xyz);
+	float Light2Dist = length(Light2Pos - vOut.WorldPos.xyz);
+	float3 DiffuseLight2 = (Light2Colour * saturate(dot(worldNormal.xyz, Light2Dir))) / Light2Dist;
+	halfway = normalize(Light2Dir + CameraDir);
+	float3 SpecularLight2 = (Light2Colour / Light2Dist) * pow(saturate(dot(worldNormal.xyz, halfway)), SpecularPower);
+
+	// Sum the lights, adding the ambient once
+	float3 DiffuseLight = AmbientColour + DiffuseLight1 + DiffuseLight2;
+	float3 SpecularLight = SpecularLight1 + SpecularLight2;
+
+	// Combine the instance colour with the lighting, the specular material is white
+	float4 combinedColour;
+	combinedColour.rgb = vOut.Colour * DiffuseLight + SpecularLight;
+	combinedColour.a = 1.0f;
+
+	return combinedColour;
+}
+
+
 RasterizerState CullNone  // Cull none of the polygons, i.e. show both sides
 {
 	CullMode = None;
@@ -496,6 +585,21 @@ technique10 AdditiveBlendingTech
 		SetGeometryShader(NULL);
 		SetPixelShader(CompileShader(ps_4_0, SimplePixelShader()));
 
+		SetBlendState(NoBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+		SetRasterizerState(CullBack);
+		SetDepthStencilState(DepthWritesOn, 0);
+	}
+}
+
+// Render instanced models lit, each instance in its own colour. Models rendered with this technique must be instanced models
+technique10 InstancedLitColourTech
+{
+	pass P0
+	{
+		SetVertexShader(CompileShader(vs_4_0, InstancedLighting()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_4_0, InstancedLitColour()));
+
 		SetBlendState(NoBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
 		SetRasterizerState(CullBack);
 		SetDepthStencilState(DepthWritesOn, 0);
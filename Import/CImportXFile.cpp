@@ -11,21 +11,130 @@
 		V1.0    Created 12/06/06 - LN
 **************************************************************************************************/
 
+#include <stdio.h>
+#include <string.h>
 #include <algorithm>
-#include <numeric>
+#include <new>
 using namespace std;
 
-#define INITGUID
-#include <windows.h>
-#include <dxfile.h>
-#include <rmxfguid.h>
-#include <rmxftmpl.h>
-
 #include "CImportXFile.h"
+#include "MeshOptimise.h"
+#include "CMappedFile.h"
 
 namespace gen
 {
 
+/*-----------------------------------------------------------------------------------------
+	Local helpers
+-----------------------------------------------------------------------------------------*/
+
+namespace
+{
+	// Move per-vertex data to match a new vertex order, given the new position of each vertex.
+	// Empty lists are left unchanged
+	template <class T>
+	void RemapVertexData
+	(
+		const vector<TUInt32>& vertexRemap,
+		vector<T>*             pData
+	)
+	{
+		if (pData->empty())
+		{
+			return;
+		}
+		vector<T> newData( pData->size() );
+		for (TUInt32 iVertex = 0; iVertex < pData->size(); ++iVertex)
+		{
+			newData[vertexRemap[iVertex]] = (*pData)[iVertex];
+		}
+		pData->swap( newData );
+	}
+
+	// Hash table mapping a vertex / normal index pair to a vertex index, used when matching face
+	// lists. Open addressing with linear probing in a single array, the table doubles in size
+	// when half full
+	class CVertexNormalTable
+	{
+	public:
+		CVertexNormalTable() : m_iNumEntries( 0 ) {}
+
+		// Find the vertex for the given vertex / normal pair. If the pair is not present it is
+		// added with the given new vertex index, returned through a pointer. Returns true if the
+		// pair was added
+		bool FindOrAdd
+		(
+			const TUInt32 iVertex,
+			const TUInt32 iNormal,
+			TUInt32*      piNewVertex
+		)
+		{
+			if (2 * (m_iNumEntries + 1) > m_Entries.size())
+			{
+				Grow();
+			}
+			SEntry* pEntry = Find( iVertex, iNormal );
+			if (pEntry->iVertex == iVertex && pEntry->iNormal == iNormal)
+			{
+				*piNewVertex = pEntry->iNewVertex;
+				return false;
+			}
+			pEntry->iVertex = iVertex;
+			pEntry->iNormal = iNormal;
+			pEntry->iNewVertex = *piNewVertex;
+			++m_iNumEntries;
+			return true;
+		}
+
+	private:
+		static const TUInt32 kiEmpty = 0xffffffff;
+
+		struct SEntry
+		{
+			TUInt32 iVertex;
+			TUInt32 iNormal;
+			TUInt32 iNewVertex;
+		};
+
+		// Find the entry for the given pair, or the empty entry where it should be added
+		SEntry* Find
+		(
+			const TUInt32 iVertex,
+			const TUInt32 iNormal
+		)
+		{
+			TUInt32 iMask = static_cast<TUInt32>(m_Entries.size()) - 1;
+			TUInt32 iSlot = (iVertex * 0x9e3779b1u ^ iNormal * 0x85ebca6bu) & iMask;
+			while (m_Entries[iSlot].iVertex != kiEmpty &&
+			       (m_Entries[iSlot].iVertex != iVertex || m_Entries[iSlot].iNormal != iNormal))
+			{
+				iSlot = (iSlot + 1) & iMask;
+			}
+			return &m_Entries[iSlot];
+		}
+
+		// Double the table size (minimum 256 entries) and re-insert existing entries
+		void Grow()
+		{
+			vector<SEntry> oldEntries;
+			oldEntries.swap( m_Entries );
+			SEntry emptyEntry = { kiEmpty, kiEmpty, kiEmpty };
+			m_Entries.resize( oldEntries.empty() ? 256 : oldEntries.size() * 2, emptyEntry );
+			for (TUInt32 iEntry = 0; iEntry < oldEntries.size(); ++iEntry)
+			{
+				if (oldEntries[iEntry].iVertex != kiEmpty)
+				{
+					*Find( oldEntries[iEntry].iVertex, oldEntries[iEntry].iNormal ) = oldEntries[iEntry];
+				}
+			}
+		}
+
+		vector<SEntry> m_Entries;
+		TUInt32        m_iNumEntries;
+	};
+}
+
+
 /*-----------------------------------------------------------------------------------------
 	CImportXFile public member functions
 -----------------------------------------------------------------------------------------*/
@@ -70,7 +179,6 @@ bool CImportXFile::IsXFile
 //		kFileError:			Missing file or not an X-file
 //		kInvalidData:		The file could not be parsed correctly, or contains invalid data
 //		kOutOfSystemMemory:	...
-//		kSystemFailure:		X-file API failure
 EImportError CImportXFile::ImportFile
 (
 	const string& sFileName
@@ -81,49 +189,87 @@ EImportError CImportXFile::ImportFile
 	// Wipe any existing data
 	m_Frames.clear();
 	m_Meshes.clear();
+	m_Materials.clear();
 	m_bImported = false;
+	m_bOptimised = false;
 
-	// Ensure the file is an X-file
-	if (!IsXFile( sFileName ))
+	// Map the file into memory - it is then parsed in place with no intermediate copy
+	CMappedFile file;
+	if (!file.Open( sFileName ))
 	{
 		return kFileError;
 	}
 
-	// Create X-File object
-	ID3DXFile* pXFile;
-	EImportError eError = PrepareXFileObject( &pXFile );
-	if (eError != kSuccess)
+	return ImportFile( file.GetData(), file.GetSize() );
+
+	GEN_ENDGUARD;
+}
+
+
+// Import a Microsoft X-File held in memory, e.g. a memory mapped file or one from an archive.
+// The data is parsed in place and need only remain valid for the duration of the call
+// Possible return values:
+//		kSuccess:			...
+//		kFileError:			Not an X-file
+//		kInvalidData:		The file could not be parsed correctly, or contains invalid data
+//		kOutOfSystemMemory:	...
+EImportError CImportXFile::ImportFile
+(
+	const TUInt8* pData,
+	const TUInt32 iSize
+)
+{
+	GEN_GUARD;
+
+	// Wipe any existing data
+	m_Frames.clear();
+	m_Meshes.clear();
+	m_Materials.clear();
+	m_NamedMaterials.clear();
+	m_bImported = false;
+	m_bOptimised = false;
+
+	// Ensure the data is an X-file
+	if (!pData || iSize < 4 || pData[0] != 'x' || pData[1] != 'o' || pData[2] != 'f' || pData[3] != ' ')
 	{
-		return eError;
+		return kFileError;
 	}
 
-	// Get X-File enumerator
-	ID3DXFileEnumObject* pXFileEnumer;
-	eError = GetXFileEnumerator( sFileName, pXFile, &pXFileEnumer );
-	if (eError != kSuccess)
+	// Only text X-files are supported
+	CXFileTokeniser tokeniser( pData, iSize );
+	if (!tokeniser.ReadHeader())
 	{
-		pXFile->Release();
-		return eError;
+		return kInvalidData;
 	}
 
-	// Parse X file to create frame hierachy and meshes
-	eError = ParseXFile( pXFileEnumer );
-
-	// Release X-File interfaces
-	pXFileEnumer->Release();
-	pXFile->Release();
+	// Parse X file to create frame hierachy and meshes, then split into meshes containing only one
+	// material each. Array sizes are read from the file, so a corrupt file can ask for more memory
+	// than is available. The guards in the functions called pass out of memory exceptions through
+	// unchanged (see GEN_CATCHGUARD) to be caught here
+	EImportError eError;
+	try
+	{
+		eError = ParseXFile( tokeniser );
+		if (eError == kSuccess)
+		{
+			SplitMeshes();
+		}
+	}
+	catch (bad_alloc&)
+	{
+		eError = kOutOfSystemMemory;
+	}
+	m_NamedMaterials.clear();
 
 	// Check for errors
 	if (eError != kSuccess)
 	{
 		m_Frames.clear();
 		m_Meshes.clear();
+		m_Materials.clear();
 		return eError;
 	}
 
-	// Split into meshes containing only one material each
-	SplitMeshes();
-
 	// Mark file as loaded
 	m_bImported = true;
 
@@ -133,6 +279,63 @@ EImportError CImportXFile::ImportFile
 }
 
 
+// Reorder the faces and vertices of each sub-mesh to make good use of the GPU vertex caches
+// (see MeshOptimise.h). An optional stage after a successful import, the geometry is unchanged.
+// Does nothing if the meshes have already been optimised
+void CImportXFile::OptimiseMeshes()
+{
+	GEN_GUARD;
+
+	if (m_bOptimised)
+	{
+		return;
+	}
+
+	for (TUInt32 iMesh = 0; iMesh < m_Meshes.size(); ++iMesh)
+	{
+		// Unclutter code with a reference to the mesh
+		SXFileMesh& mesh = m_Meshes[iMesh];
+		if (mesh.faces.empty())
+		{
+			continue;
+		}
+		TUInt32 iNumFaces = static_cast<TUInt32>(mesh.faces.size());
+		TUInt32 iNumVertices = static_cast<TUInt32>(mesh.vertices.size());
+
+		// Faces are three contiguous indices, so the face list can be used as an index list
+		TUInt32* pIndices = mesh.faces[0].aiVertex;
+		OptimiseFaceOrder( pIndices, iNumFaces, iNumVertices );
+		TXFileInts vertexRemap( iNumVertices );
+		OptimiseVertexOrder( pIndices, iNumFaces, iNumVertices, &vertexRemap[0] );
+
+		// Move vertex data to match the new vertex order
+		RemapVertexData( vertexRemap, &mesh.vertices );
+		RemapVertexData( vertexRemap, &mesh.normals );
+		RemapVertexData( vertexRemap, &mesh.textureCoords );
+		RemapVertexData( vertexRemap, &mesh.vertexColours );
+		for (TUInt32 iBone = 0; iBone < mesh.bones.size(); ++iBone)
+		{
+			TXFileBoneWeights& weights = mesh.bones[iBone].weights;
+			for (TUInt32 iWeight = 0; iWeight < weights.size(); ++iWeight)
+			{
+				weights[iWeight].iVertexIndex = vertexRemap[weights[iWeight].iVertexIndex];
+			}
+		}
+		if (!mesh.duplicateIndices.empty())
+		{
+			RemapVertexData( vertexRemap, &mesh.duplicateIndices );
+			for (TUInt32 iVertex = 0; iVertex < iNumVertices; ++iVertex)
+			{
+				mesh.duplicateIndices[iVertex] = vertexRemap[mesh.duplicateIndices[iVertex]];
+			}
+		}
+	}
+	m_bOptimised = m_bImported;
+
+	GEN_ENDGUARD;
+}
+
+
 /////////////////////////////////////
 // Data access
 
@@ -259,6 +462,10 @@ EImportError CImportXFile::GetSubMesh
 		}
 	}
 
+	// Bounds of the vertex positions, the first element of each vertex
+	CalculateBounds( pOutSubMesh->vertices, pOutSubMesh->vertexSize, pOutSubMesh->numVertices,
+	                 &pOutSubMesh->bounds );
+
 	// Calculate bone influences if necessary
 	if (pOutSubMesh->hasSkinningData)
 	{
@@ -292,7 +499,7 @@ EImportError CImportXFile::GetSubMesh
 
 		// Normalise vertex bone weights (ensure they add up to 1)
 		TUInt8* pVert = pOutSubMesh->vertices;
-		for (TUInt32 vert = 0; vert < pOutSubMesh->vertexSize; ++vert)
+		for (TUInt32 vert = 0; vert < pOutSubMesh->numVertices; ++vert)
 		{
 			TFloat32* pVertBoneWeights = reinterpret_cast<TFloat32*>(pVert + boneWeightsOffset);
 			TUInt8* pVertBoneIndices = reinterpret_cast<TUInt8*>(pVert + boneIndicesOffset);
@@ -316,22 +523,38 @@ EImportError CImportXFile::GetSubMesh
 		}
 	}
 
-	// Pre-size face array
-	pOutSubMesh->numFaces = static_cast<TUInt32>(m_Meshes[iSubMesh].faces.size());
-	pOutSubMesh->faces = new SMeshFace[pOutSubMesh->numFaces];
-
 	// Get material from material map (all faces in sub-mesh have the same material at this point)
 	pOutSubMesh->material = m_Meshes[iSubMesh].materialMap.front();
 
+	// Use 16-bit indices unless there are too many vertices, then pre-size face array
+	pOutSubMesh->numFaces = static_cast<TUInt32>(m_Meshes[iSubMesh].faces.size());
+	pOutSubMesh->indexSize = (pOutSubMesh->numVertices <= kiMaxVertices16) ? sizeof(TUInt16) :
+	                                                                         sizeof(TUInt32);
+	pOutSubMesh->faces = new TUInt8[pOutSubMesh->numFaces * 3 * pOutSubMesh->indexSize];
+
 	// Loop through faces outputing to given sub-mesh
 	TXFileFaces::const_iterator itFace = m_Meshes[iSubMesh].faces.begin();
-	TXFileFaces::const_iterator itFaceEnd = m_Meshes[iSubMesh].faces.end();
-	for (TUInt32 iFace = 0; iFace < pOutSubMesh->numFaces; ++iFace)
+	if (pOutSubMesh->indexSize == sizeof(TUInt16))
+	{
+		SMeshFace* pFaces = reinterpret_cast<SMeshFace*>(pOutSubMesh->faces);
+		for (TUInt32 iFace = 0; iFace < pOutSubMesh->numFaces; ++iFace)
+		{
+			pFaces[iFace].aiVertex[0] = static_cast<TUInt16>(itFace->aiVertex[0]);
+			pFaces[iFace].aiVertex[1] = static_cast<TUInt16>(itFace->aiVertex[1]);
+			pFaces[iFace].aiVertex[2] = static_cast<TUInt16>(itFace->aiVertex[2]);
+			++itFace;
+		}
+	}
+	else
 	{
-		pOutSubMesh->faces[iFace].aiVertex[0] = itFace->aiVertex[0];
-		pOutSubMesh->faces[iFace].aiVertex[1] = itFace->aiVertex[1];
-		pOutSubMesh->faces[iFace].aiVertex[2] = itFace->aiVertex[2];
-		++itFace;
+		SMeshFace32* pFaces = reinterpret_cast<SMeshFace32*>(pOutSubMesh->faces);
+		for (TUInt32 iFace = 0; iFace < pOutSubMesh->numFaces; ++iFace)
+		{
+			pFaces[iFace].aiVertex[0] = itFace->aiVertex[0];
+			pFaces[iFace].aiVertex[1] = itFace->aiVertex[1];
+			pFaces[iFace].aiVertex[2] = itFace->aiVertex[2];
+			++itFace;
+		}
 	}
 
 	return kSuccess;
@@ -430,127 +653,6 @@ void CImportXFile::GetMaterial
 }
 
 
-/*-----------------------------------------------------------------------------------------
-	X-File API support
------------------------------------------------------------------------------------------*/
-
-// Prepare and return an X-file object
-// Possible return values:
-//		kSuccess:			...
-//		kOutOfSystemMemory:	...
-//		kSystemFailure:		Problem registering X-file templates or other API error
-EImportError CImportXFile::PrepareXFileObject
-(
-	ID3DXFile** ppXFile
-)
-{
-	GEN_GUARD;
-
-	HRESULT xFileError = D3DXFileCreate( ppXFile );
-	if (xFileError != S_OK)
-	{
-		*ppXFile = 0;
-		switch (xFileError)
-		{
-		case E_OUTOFMEMORY:
-			return kOutOfSystemMemory;
-
-		case E_POINTER:
-			GEN_ERROR( "Invalid parameter to D3DXFileCreate" );
-
-		default:
-			return kSystemFailure;
-		}
-	}
-
-    // Register templates for d3drm, skinning and patch extensions.
-    xFileError = (*ppXFile)->RegisterTemplates( (void*)D3DRM_XTEMPLATES, D3DRM_XTEMPLATE_BYTES );
-	if (xFileError != S_OK)
-	{
-        (*ppXFile)->Release();
-		*ppXFile = 0;
-		switch (xFileError)
-		{
-		case D3DXFERR_BADVALUE: 
-			GEN_ERROR( "Invalid parameter to RegisterTemplates" );
-
-		default:
-			return kSystemFailure;
-		}
-    }
-
-    xFileError = (*ppXFile)->RegisterTemplates( (void*)XSKINEXP_TEMPLATES, strlen(XSKINEXP_TEMPLATES) );
-	if (xFileError != S_OK)
-	{
-        (*ppXFile)->Release();
-		switch (xFileError)
-		{
-		case D3DXFERR_BADVALUE:
-			GEN_ERROR( "Invalid parameter to RegisterTemplates" );
-
-		default:
-			return kSystemFailure;
-		}
-    }
-
-    xFileError = (*ppXFile)->RegisterTemplates( (void*)XEXTENSIONS_TEMPLATES, strlen(XEXTENSIONS_TEMPLATES) );
-	if (xFileError != S_OK)
-	{
-        (*ppXFile)->Release();
-		*ppXFile = 0;
-		switch (xFileError)
-		{
-		case D3DXFERR_BADVALUE:
-			GEN_ERROR( "Invalid parameter to RegisterTemplates" );
-
-		default:
-			return kInvalidData;
-		}
-    }
-
-	return kSuccess;
-
-	GEN_ENDGUARD;
-}
-
-
-// Prepare and return an X-file enumerator given a filename and an X-file object
-// Possible return values:
-//		kSuccess:			...
-//		kInvalidData:		The file could not be parsed correctly, or contains invalid data
-//		kSystemFailure:		X-file API error
-EImportError CImportXFile::GetXFileEnumerator
-(
-	const string&         sFilename,
-	ID3DXFile*            pXFile,
-	ID3DXFileEnumObject** ppXFileEnumer
-)
-{
-	GEN_GUARD;
-
-	HRESULT xFileError =
-		pXFile->CreateEnumObject( (LPVOID)sFilename.c_str(), DXFILELOAD_FROMFILE, ppXFileEnumer );
-	if (xFileError != S_OK)
-	{
-		switch (xFileError)
-		{
-		case D3DXFERR_PARSEERROR:
-			return kInvalidData;
-
-		case D3DXFERR_BADVALUE:
-			GEN_ERROR( "Invalid parameter to CreateEnumObject" );
-
-		default:
-			return kSystemFailure;
-		}
-	}
-
-	return kSuccess;
-
-	GEN_ENDGUARD;
-}
-
-
 /*-----------------------------------------------------------------------------------------
 	X-File parsing
 -----------------------------------------------------------------------------------------*/
@@ -562,7 +664,7 @@ EImportError CImportXFile::GetXFileEnumerator
 //		kInvalidData:		The file could not be parsed correctly, or contains invalid data
 EImportError CImportXFile::ParseXFile
 (
-	ID3DXFileEnumObject* pXFileEnumer
+	CXFileTokeniser& tokeniser
 )
 {
 	GEN_GUARD;
@@ -578,61 +680,58 @@ EImportError CImportXFile::ParseXFile
 	m_Frames[0].defaultMatrix = CMatrix4x4::kIdentity;
 	m_Frames[0].offsetMatrix = CMatrix4x4::kIdentity;
 
-	// Get number of child objects for the current object
-	TUInt32 iNumChildren;
-	EImportError eError = GetXFileNumChildren( pXFileEnumer, &iNumChildren );
-	if (eError != kSuccess)
-	{
-		return kInvalidData;
-	}
-
-	// For each child object
-	for (TUInt32 iChild = 0; iChild < iNumChildren; ++iChild)
+	// For each top level object
+	EImportError eError = kSuccess;
+	string sType, sName;
+	while (!tokeniser.AtEnd())
 	{
-		// Get child data and ID
-		ID3DXFileData* pChildData;
-		GUID childGUID;
-		eError = GetXFileChild( pXFileEnumer, iChild, &pChildData, &childGUID );
-		if (eError != kSuccess)
+		if (!tokeniser.ReadObjectStart( &sType, &sName ))
 		{
 			return kInvalidData;
 		}
-		
+
 		// Found child frame
-		if (childGUID == TID_D3DRMFrame)
+		if (sType == "Frame")
 		{
 			++m_Frames[0].iNumChildren;
-			eError = ParseXFileFrame( pChildData, 0 );
+			eError = ParseXFileFrame( tokeniser, sName, 0 );
 		}
 
 		// Found child frame transformation matrix
-		else if (childGUID == TID_D3DRMFrameTransformMatrix)
+		else if (sType == "FrameTransformMatrix")
 		{
-			CMatrix4x4 transMat;
-			TUInt32 iSize = 16 * sizeof(TFloat32);
-			TUInt8* pDest = reinterpret_cast<TUInt8*>(&m_Frames[0].defaultMatrix.e00);
-			eError = CopyXFileData( pChildData, pDest, &iSize );
+			eError = ReadFrameMatrixData( tokeniser, 0 );
 		}
 
 		// Found child mesh
-		else if (childGUID == TID_D3DRMMesh)
+		else if (sType == "Mesh")
+		{
+			eError = ParseXFileMesh( tokeniser, 0 );
+		}
+
+		// Found material that meshes may refer to by name
+		else if (sType == "Material")
 		{
-			eError = ParseXFileMesh( pChildData, 0 );
+			m_NamedMaterials.push_back( SXFileMaterial() );
+			eError = ReadMaterial( tokeniser, sName, &m_NamedMaterials.back() );
 		}
 
-		// Release current child data before moving to the next or quiting on error
-		pChildData->Release();
+		// Found template definition, header or unknown data - ignore
+		else
+		{
+			eError = tokeniser.SkipObject() ? kSuccess : kInvalidData;
+		}
 
 		// Return any errors found
 		if (eError != kSuccess)
 		{
 			return eError;
 		}
-	}		
+	}
 
 	// Make a single global material list for all meshes
 	MakeGlobalMaterialList();
-	
+
 	// Validate bones and match them to their frames
 	eError = ProcessBones();
 	if (eError != kSuccess)
@@ -653,8 +752,9 @@ EImportError CImportXFile::ParseXFile
 //		kInvalidData:		The file could not be parsed correctly, or contains invalid data
 EImportError CImportXFile::ParseXFileFrame
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iParentFrame
+	CXFileTokeniser& tokeniser,
+	const string&    sName,
+	const TUInt32    iParentFrame
 )
 {
 	GEN_GUARD;
@@ -663,73 +763,67 @@ EImportError CImportXFile::ParseXFileFrame
 	TUInt32 iCurrFrame = static_cast<TUInt32>(m_Frames.size());
 	m_Frames.push_back( SXFileFrame() );
 
-	// Get name for frame
-	EImportError eError = GetXFileDataName( pXFileData, m_Frames[iCurrFrame].sName );
-	if (eError != kSuccess)
-	{
-		return eError;
-	}
-
-	// Initialise other frame values
+	// Initialise frame values
+	m_Frames[iCurrFrame].sName = sName;
 	m_Frames[iCurrFrame].iDepth = m_Frames[iParentFrame].iDepth + 1;
 	m_Frames[iCurrFrame].iParentIndex = iParentFrame;
 	m_Frames[iCurrFrame].iNumChildren = 0;
 	m_Frames[iCurrFrame].defaultMatrix = CMatrix4x4::kIdentity;
 	m_Frames[iCurrFrame].offsetMatrix = CMatrix4x4::kIdentity;
 
-	// Get number of child objects for the current object
-	TUInt32 iNumChildren;
-	eError = GetXFileNumChildren( pXFileData, &iNumChildren );
-	if (eError != kSuccess)
-	{
-		return kInvalidData;
-	}
-
 	// For each child object
-	for (TUInt32 iChild = 0; iChild < iNumChildren; ++iChild)
+	EImportError eError = kSuccess;
+	string sType, sChildName;
+	while (!tokeniser.AtObjectEnd())
 	{
-		// Get child data and ID
-		ID3DXFileData* pChildData;
-		GUID childGUID;
-		eError = GetXFileChild( pXFileData, iChild, &pChildData, &childGUID );
-		if (eError != kSuccess)
+		// Ignore references to other objects
+		if (tokeniser.AtReference())
+		{
+			if (!tokeniser.ReadReference( &sChildName ))
+			{
+				return kInvalidData;
+			}
+			continue;
+		}
+
+		if (!tokeniser.ReadObjectStart( &sType, &sChildName ))
 		{
 			return kInvalidData;
 		}
-		
+
 		// Found child frame
-		if (childGUID == TID_D3DRMFrame)
+		if (sType == "Frame")
 		{
 			++m_Frames[iCurrFrame].iNumChildren;
-			eError = ParseXFileFrame( pChildData, iCurrFrame );
+			eError = ParseXFileFrame( tokeniser, sChildName, iCurrFrame );
 		}
 
 		// Found child frame transformation matrix
-		else if (childGUID == TID_D3DRMFrameTransformMatrix)
+		else if (sType == "FrameTransformMatrix")
 		{
-			CMatrix4x4 transMat;
-			TUInt32 iSize = 16 * sizeof(TFloat32);
-			TUInt8* pDest = reinterpret_cast<TUInt8*>(&m_Frames[iCurrFrame].defaultMatrix.e00);
-			eError = CopyXFileData( pChildData, pDest, &iSize );
+			eError = ReadFrameMatrixData( tokeniser, iCurrFrame );
 		}
 
 		// Found child mesh
-		else if (childGUID == TID_D3DRMMesh)
+		else if (sType == "Mesh")
 		{
-			eError = ParseXFileMesh( pChildData, iCurrFrame );
+			eError = ParseXFileMesh( tokeniser, iCurrFrame );
 		}
 
-		// Release current child data before moving to the next or quiting on error
-		pChildData->Release();
+		// Found unknown frame data - ignore
+		else
+		{
+			eError = tokeniser.SkipObject() ? kSuccess : kInvalidData;
+		}
 
 		// Return any errors found
 		if (eError != kSuccess)
 		{
 			return eError;
 		}
-	}		
+	}
 
-	return kSuccess;
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
 	GEN_ENDGUARD;
 }
@@ -738,8 +832,8 @@ EImportError CImportXFile::ParseXFileFrame
 // Create a new mesh in the given frame and parse its data from the X-File
 EImportError CImportXFile::ParseXFileMesh
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iCurrFrame
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iCurrFrame
 )
 {
 	GEN_GUARD;
@@ -755,97 +849,98 @@ EImportError CImportXFile::ParseXFileMesh
 	m_Meshes[iCurrMesh].iMaxBonesPerFace = 0;
 
 	// Read vertices and faces for the mesh
-	EImportError eError = ReadMeshData( pXFileData, iCurrMesh );
+	EImportError eError = ReadMeshData( tokeniser, iCurrMesh );
 	if (eError != kSuccess)
 	{
 		return eError;
 	}
 
 	// Counter for bones read from child data objects
-	TUInt32 iCurrBone = 0; 
-
-	// Get number of child objects for the current object
-	TUInt32 iNumChildren;
-	eError = GetXFileNumChildren( pXFileData, &iNumChildren );
-	if (eError != kSuccess)
-	{
-		return kInvalidData;
-	}
+	TUInt32 iCurrBone = 0;
 
 	// For each child object
-	for (TUInt32 iChild = 0; iChild < iNumChildren; ++iChild)
+	string sType, sName;
+	while (!tokeniser.AtObjectEnd())
 	{
-		// Get child data and ID
-		ID3DXFileData* pChildData;
-		GUID childGUID;
-		eError = GetXFileChild( pXFileData, iChild, &pChildData, &childGUID );
-		if (eError != kSuccess)
+		// Ignore references to other objects
+		if (tokeniser.AtReference())
+		{
+			if (!tokeniser.ReadReference( &sName ))
+			{
+				return kInvalidData;
+			}
+			continue;
+		}
+
+		if (!tokeniser.ReadObjectStart( &sType, &sName ))
 		{
 			return kInvalidData;
 		}
 
 		// Found normal data
-		if (childGUID == TID_D3DRMMeshNormals)
+		if (sType == "MeshNormals")
 		{
-			eError = ReadNormalData( pChildData, iCurrMesh );
+			eError = ReadNormalData( tokeniser, iCurrMesh );
 		}
 
 		// Found texture coordinate data
-		else if (childGUID == TID_D3DRMMeshTextureCoords)
+		else if (sType == "MeshTextureCoords")
 		{
-			eError = ReadTextureUVData( pChildData, iCurrMesh );
+			eError = ReadTextureUVData( tokeniser, iCurrMesh );
 		}
 
 		// Found vertex colour data
-		else if (childGUID == TID_D3DRMMeshVertexColors)
+		else if (sType == "MeshVertexColors")
 		{
-			eError = ReadVertexColourData( pChildData, iCurrMesh );
+			eError = ReadVertexColourData( tokeniser, iCurrMesh );
 		}
 
 		// Found material list
-		else if (childGUID == TID_D3DRMMeshMaterialList)
+		else if (sType == "MeshMaterialList")
 		{
-			eError = ReadMaterialData( pChildData, iCurrMesh );
+			eError = ReadMaterialData( tokeniser, iCurrMesh );
 		}
 
 		// Found vertex duplication list
-		else if (childGUID == DXFILEOBJ_VertexDuplicationIndices)
+		else if (sType == "VertexDuplicationIndices")
 		{
-			eError = ReadDuplicationData( pChildData, iCurrMesh );
+			eError = ReadDuplicationData( tokeniser, iCurrMesh );
 		}
 
 		// Found face adjacency data
-		else if (childGUID == DXFILEOBJ_FaceAdjacency)
+		else if (sType == "FaceAdjacency")
 		{
-			eError = ReadAdjacencyData( pChildData, iCurrMesh );
+			eError = ReadAdjacencyData( tokeniser, iCurrMesh );
 		}
 
 		// Found skinning definition
-		else if (childGUID == DXFILEOBJ_XSkinMeshHeader)
+		else if (sType == "XSkinMeshHeader")
 		{
-			eError = ReadSkinDefnData( pChildData, iCurrMesh );
+			eError = ReadSkinDefnData( tokeniser, iCurrMesh );
 		}
 
 		// Found skin weights
-		else if (childGUID == DXFILEOBJ_SkinWeights)
+		else if (sType == "SkinWeights")
 		{
-			eError = ReadSkinWeightsData( pChildData, iCurrMesh, iCurrBone );
+			eError = ReadSkinWeightsData( tokeniser, iCurrMesh, iCurrBone );
 			++iCurrBone;
 		}
 
 		// Found unknown mesh data
 		else
 		{
-			eError = kSuccess; // Won't flag this as failure though
+			// Won't flag this as failure though
+			eError = tokeniser.SkipObject() ? kSuccess : kInvalidData;
 		}
 
 		if (eError != kSuccess)
 		{
 			return eError;
 		}
-
-		// Release current child data before moving to the next
-		pChildData->Release();
+	}
+	if (!tokeniser.ReadObjectEnd())
+	{
+		return kInvalidData;
 	}
 
 	// Check if not enough bones
@@ -867,71 +962,59 @@ EImportError CImportXFile::ParseXFileMesh
 	X-File template parsing
 -----------------------------------------------------------------------------------------*/
 
-// Read vertex and face data from a mesh template
-EImportError CImportXFile::ReadMeshData
+// Read a frame transform matrix template
+EImportError CImportXFile::ReadFrameMatrixData
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iMesh
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iFrame
 )
 {
 	GEN_GUARD;
 
-	// Lock mesh data pointer
-	TUInt32 iMeshDataSize = 0;
-	const TUInt8* pMeshDataStart;
-	EImportError eError = LockXFileData( pXFileData, &pMeshDataStart, &iMeshDataSize );
-	if (eError != kSuccess)
+	if (!tokeniser.ReadFloats( &m_Frames[iFrame].defaultMatrix.e00, 16 ) ||
+	    !tokeniser.ReadObjectEnd())
 	{
 		return kInvalidData;
 	}
-	const TUInt8* pMeshData = pMeshDataStart;
+
+	return kSuccess;
+
+	GEN_ENDGUARD;
+}
+
+// Read vertex and face data from a mesh template
+EImportError CImportXFile::ReadMeshData
+(
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iMesh
+)
+{
+	GEN_GUARD;
 
 	// Get vertices
 	TUInt32 iNumVertices;
-	ReadXFileLockedUInt( pMeshData, &iNumVertices );
+	if (!tokeniser.ReadUInt( &iNumVertices ) || !tokeniser.CanContain( iNumVertices, 3 ))
+	{
+		return kInvalidData;
+	}
+
+	// Size the array in one allocation from the count, then read all the vertices straight into
+	// it as a single run of floats (CVector3 is three packed floats)
 	m_Meshes[iMesh].vertices.resize( iNumVertices );
-	for (TUInt32 iVertex = 0; iVertex < iNumVertices; ++iVertex)
+	if (iNumVertices > 0 && !tokeniser.ReadFloats( &m_Meshes[iMesh].vertices[0].x, iNumVertices * 3 ))
 	{
-		TUInt8* pDest = reinterpret_cast<TUInt8*>(&m_Meshes[iMesh].vertices[iVertex]);
-		ReadXFileLockedData( pMeshData, pDest, sizeof(CVector3) );
+		return kInvalidData;
 	}
 
 	// Read faces - they can be general polygons - convert them all to triangles
-	TUInt32 iNumFaces;
-	ReadXFileLockedUInt( pMeshData, &iNumFaces );
-	m_Meshes[iMesh].origFaceEdges.resize( iNumFaces ); // See below
-	for (TUInt32 iFace = 0; iFace < iNumFaces; ++iFace)
+	if (!ReadXFileFaces( tokeniser, iNumVertices, &m_Meshes[iMesh].faces,
+	                     &m_Meshes[iMesh].origFaceEdges ))
 	{
-		TUInt32 iNumEdges;
-		ReadXFileLockedUInt( pMeshData, &iNumEdges );
+		return kInvalidData;
+	}
 
-		// Store original number of edges for normal face validation below
-		m_Meshes[iMesh].origFaceEdges[iFace] = iNumEdges;
+	return kSuccess;
 
-		// Read first index of polygon, then use successive pairs of indices to form triangles
-		// with this first one
-		TUInt32 iFirstIndex, iIndexA, iIndexB;
-		ReadXFileLockedUInt( pMeshData, &iFirstIndex );
-		ReadXFileLockedUInt( pMeshData, &iIndexA );
-		for (TUInt32 iEdge = 2; iEdge < iNumEdges; ++iEdge)
-		{
-			ReadXFileLockedUInt( pMeshData, &iIndexB );
-			SXFileFace face = { iFirstIndex, iIndexA, iIndexB };
-			m_Meshes[iMesh].faces.push_back( face );
-			iIndexA = iIndexB;
-		}
-	}
-
-	// Unlock mesh data
-	pXFileData->Unlock();
-
-	// Validate amount of data read
-	if (static_cast<TUInt32>(pMeshData - pMeshDataStart) != iMeshDataSize)
-	{
-		return kInvalidData;
-	}
-
-	return kSuccess;
 	GEN_ENDGUARD;
 }
 
@@ -939,8 +1022,8 @@ EImportError CImportXFile::ReadMeshData
 // Read a normal data mesh template
 EImportError CImportXFile::ReadNormalData
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iMesh
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iMesh
 )
 {
 	GEN_GUARD;
@@ -951,64 +1034,26 @@ EImportError CImportXFile::ReadNormalData
 		return kInvalidData;
 	}
 
-	// Get normal data
-	const TUInt8* pNormalData;
-	EImportError eError = LockXFileData( pXFileData, &pNormalData );
-	if (eError != kSuccess)
-	{
-		return kInvalidData;
-	}
-
 	// Read normals
 	TUInt32 iNumNormals;
-	ReadXFileLockedUInt( pNormalData, &iNumNormals );
-	m_Meshes[iMesh].normals.resize( iNumNormals );
-	for (TUInt32 iNormal = 0; iNormal < iNumNormals; ++iNormal)
+	if (!tokeniser.ReadUInt( &iNumNormals ) || !tokeniser.CanContain( iNumNormals, 3 ))
 	{
-		TUInt8* pDest = reinterpret_cast<TUInt8*>(&m_Meshes[iMesh].normals[iNormal]);
-		ReadXFileLockedData( pNormalData, pDest, sizeof(CVector3) );
+		return kInvalidData;
 	}
-
-	// Verify that normal face list matches face list
-	TUInt32 iNumNormalFaces;
-	ReadXFileLockedUInt( pNormalData, &iNumNormalFaces );
-	if (iNumNormalFaces != m_Meshes[iMesh].origFaceEdges.size())
+	m_Meshes[iMesh].normals.resize( iNumNormals );
+	if (iNumNormals > 0 && !tokeniser.ReadFloats( &m_Meshes[iMesh].normals[0].x, iNumNormals * 3 ))
 	{
-		pXFileData->Unlock();
 		return kInvalidData;
 	}
 
-	// Read normal faces - they can be general polygons - convert them all to triangles
-	for (TUInt32 iFace = 0; iFace < iNumNormalFaces; ++iFace)
+	// Read normal faces, verifying that normal face list matches face list
+	if (!ReadXFileFaces( tokeniser, iNumNormals, &m_Meshes[iMesh].normalFaces,
+	                     &m_Meshes[iMesh].origFaceEdges ))
 	{
-		TUInt32 iNumEdges;
-		ReadXFileLockedUInt( pNormalData, &iNumEdges );
-
-		// Check number of edges against original face data
-		if (iNumEdges != m_Meshes[iMesh].origFaceEdges[iFace])
-		{
-			pXFileData->Unlock();
-			return kInvalidData;
-		}
-
-		// Read first index of polygon, then use successive pairs of indices to form triangles
-		// with this first one
-		TUInt32 iFirstIndex, iIndexA, iIndexB;
-		ReadXFileLockedUInt( pNormalData, &iFirstIndex );
-		ReadXFileLockedUInt( pNormalData, &iIndexA );
-		for (TUInt32 iEdge = 2; iEdge < iNumEdges; ++iEdge)
-		{
-			ReadXFileLockedUInt( pNormalData, &iIndexB );
-			SXFileFace face = { iFirstIndex, iIndexA, iIndexB };
-			m_Meshes[iMesh].normalFaces.push_back( face );
-			iIndexA = iIndexB;
-		}
+		return kInvalidData;
 	}
 
-	// Finished with normal data
-	pXFileData->Unlock();
-
-	return kSuccess;
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
 	GEN_ENDGUARD;
 }
@@ -1016,8 +1061,8 @@ EImportError CImportXFile::ReadNormalData
 // Read a texture coordinate mesh template
 EImportError CImportXFile::ReadTextureUVData
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iMesh
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iMesh
 )
 {
 	GEN_GUARD;
@@ -1028,33 +1073,21 @@ EImportError CImportXFile::ReadTextureUVData
 		return kInvalidData;
 	}
 
-	// Get texture coordinate data
-	const TUInt8* pTexCoordData;
-	EImportError eError = LockXFileData( pXFileData, &pTexCoordData );
-	if (eError != kSuccess)
-	{
-		return kInvalidData;
-	}
-
 	// Read texture coordinates
 	TUInt32 iNumTextureCoords;
-	ReadXFileLockedUInt( pTexCoordData, &iNumTextureCoords );
-	if (iNumTextureCoords != m_Meshes[iMesh].vertices.size())
+	if (!tokeniser.ReadUInt( &iNumTextureCoords ) ||
+	    iNumTextureCoords != m_Meshes[iMesh].vertices.size())
 	{
-		pXFileData->Unlock();
 		return kInvalidData;
 	}
 	m_Meshes[iMesh].textureCoords.resize( iNumTextureCoords );
-	for (TUInt32 iUV = 0; iUV < iNumTextureCoords; ++iUV)
+	if (iNumTextureCoords > 0 &&
+	    !tokeniser.ReadFloats( &m_Meshes[iMesh].textureCoords[0].fU, iNumTextureCoords * 2 ))
 	{
-		TUInt8* pDest = reinterpret_cast<TUInt8*>(&m_Meshes[iMesh].textureCoords[iUV]);
-		ReadXFileLockedData( pTexCoordData, pDest, sizeof(SXFileUV) );
+		return kInvalidData;
 	}
 
-	// Finished with texture coordinate data
-	pXFileData->Unlock();
-
-	return kSuccess;
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
 	GEN_ENDGUARD;
 }
@@ -1062,8 +1095,8 @@ EImportError CImportXFile::ReadTextureUVData
 // Read a vertex colour mesh template, any vertices not assigned a colour will get white
 EImportError CImportXFile::ReadVertexColourData
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iMesh
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iMesh
 )
 {
 	GEN_GUARD;
@@ -1074,43 +1107,37 @@ EImportError CImportXFile::ReadVertexColourData
 		return kInvalidData;
 	}
 
-	// Get vertex colour data
-	const TUInt8* pVertexColourData;
-	EImportError eError = LockXFileData( pXFileData, &pVertexColourData );
-	if (eError != kSuccess)
+	// Read vertex colours
+	TUInt32 iNumVertexColours;
+	if (!tokeniser.ReadUInt( &iNumVertexColours ))
 	{
 		return kInvalidData;
 	}
 
-	// Read vertex colours
-	TUInt32 iNumVertexColours;
-	ReadXFileLockedUInt( pVertexColourData, &iNumVertexColours );
-
 	// All colours default to white if not assigned
 	// TODO: Could split mesh into sections with and without vertex colours - not worth it?
 	SXFileRGBAColour defaultColour = { 1.0f, 1.0f, 1.0f, 1.0f };
-	m_Meshes[iMesh].vertexColours.resize( iNumVertexColours, defaultColour );
+	m_Meshes[iMesh].vertexColours.resize( m_Meshes[iMesh].vertices.size(), defaultColour );
 	for (TUInt32 iColour = 0; iColour < iNumVertexColours; ++iColour)
 	{
 		TUInt32 iVertexIndex;
-		ReadXFileLockedUInt( pVertexColourData, &iVertexIndex );
-		TUInt8* pDest = reinterpret_cast<TUInt8*>(&m_Meshes[iMesh].vertexColours[iVertexIndex]);
-		ReadXFileLockedData( pVertexColourData, pDest, sizeof(SXFileRGBAColour) );
+		if (!tokeniser.ReadUInt( &iVertexIndex ) || iVertexIndex >= m_Meshes[iMesh].vertices.size() ||
+		    !tokeniser.ReadFloats( &m_Meshes[iMesh].vertexColours[iVertexIndex].fRed, 4 ))
+		{
+			return kInvalidData;
+		}
 	}
 
-	// Finished with vertex colour data
-	pXFileData->Unlock();
-
-	return kSuccess;
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
 	GEN_ENDGUARD;
 }
 
-// Read a vertex colour mesh template
+// Read a material list mesh template
 EImportError CImportXFile::ReadMaterialData
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iMesh
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iMesh
 )
 {
 	GEN_GUARD;
@@ -1121,41 +1148,30 @@ EImportError CImportXFile::ReadMaterialData
 		return kInvalidData;
 	}
 
-	// Get material data
-	const TUInt8* pMaterialData;
-	EImportError eError = LockXFileData( pXFileData, &pMaterialData );
-	if (eError != kSuccess)
-	{
-		return kInvalidData;
-	}
-
-	// Read number of materials and initialise material list
+	// Read number of materials - the materials themselves are read from child objects below
 	TUInt32 iNumMaterials;
-	ReadXFileLockedUInt( pMaterialData, &iNumMaterials );
-	for (TUInt32 iMaterial = 0; iMaterial < iNumMaterials; ++iMaterial)
+	if (!tokeniser.ReadUInt( &iNumMaterials ))
 	{
-		SXFileMaterial material = 
-		{
-			"",
-			{ 1.0f, 1.0f, 1.0f, 1.0f },
-			20.0f, { 0.0f, 0.0f, 0.0f },
-			{ 0.0f, 0.0f, 0.0f },
-			""
-		};
-		m_Meshes[iMesh].materials.push_back( material );
+		return kInvalidData;
 	}
 
 	// Read face materials - matching the original face list before it was split into triangles.
 	// Will convert to match the new (triangle-only) face list
 	TUInt32 iNumFaceMaterials;
-	ReadXFileLockedUInt( pMaterialData, &iNumFaceMaterials );
+	if (!tokeniser.ReadUInt( &iNumFaceMaterials ))
+	{
+		return kInvalidData;
+	}
 
 	// Handle undocumented case with only one face material - all faces use same material
 	if (iNumFaceMaterials == 1 && m_Meshes[iMesh].origFaceEdges.size() != 1)
 	{
 		// Read the single face material
 		TUInt32 iFaceMaterial;
-		ReadXFileLockedUInt( pMaterialData, &iFaceMaterial );
+		if (!tokeniser.ReadUInt( &iFaceMaterial ))
+		{
+			return kInvalidData;
+		}
 
 		// Create a full face material list from this value
 		m_Meshes[iMesh].faceMaterials.resize( m_Meshes[iMesh].faces.size(), iFaceMaterial );
@@ -1164,7 +1180,6 @@ EImportError CImportXFile::ReadMaterialData
 	{
 		if (iNumFaceMaterials != m_Meshes[iMesh].origFaceEdges.size())
 		{
-			pXFileData->Unlock();
 			return kInvalidData;
 		}
 		m_Meshes[iMesh].faceMaterials.resize( m_Meshes[iMesh].faces.size() );
@@ -1172,7 +1187,10 @@ EImportError CImportXFile::ReadMaterialData
 		for (TUInt32 iOrigFace = 0; iOrigFace < iNumFaceMaterials; ++iOrigFace)
 		{
 			TUInt32 iMaterial;
-			ReadXFileLockedUInt( pMaterialData, &iMaterial );
+			if (!tokeniser.ReadUInt( &iMaterial ))
+			{
+				return kInvalidData;
+			}
 			m_Meshes[iMesh].faceMaterials[iFace] = iMaterial;
 			++iFace;
 			for (TUInt32 iEdge = 3; iEdge < m_Meshes[iMesh].origFaceEdges[iOrigFace]; ++iEdge)
@@ -1183,130 +1201,115 @@ EImportError CImportXFile::ReadMaterialData
 		}
 	}
 
-	// Finished with material data
-	pXFileData->Unlock();
-
 
-	// Counter for materials read from optional data objects
-	TUInt32 iMaterialsRead = 0;
-
-	// Get number of child objects for the current object
-	TUInt32 iNumMatListChildren;
-	eError = GetXFileNumChildren( pXFileData, &iNumMatListChildren );
-	if (eError != kSuccess)
+	// Read materials from child objects, either full material templates or references to
+	// materials declared at the top level of the file
+	m_Meshes[iMesh].materials.reserve( iNumMaterials );
+	string sType, sName;
+	while (!tokeniser.AtObjectEnd())
 	{
-		return kInvalidData;
-	}
-
-	// For each child object
-	for (TUInt32 iMatListChild = 0; iMatListChild < iNumMatListChildren; ++iMatListChild)
-	{
-		// Get child data and ID
-		ID3DXFileData* pMatListChildData;
-		GUID matListChildGUID;
-		eError = GetXFileChild( pXFileData, iMatListChild, &pMatListChildData, &matListChildGUID );
-		if (eError != kSuccess)
+		// Found reference to a named material
+		if (tokeniser.AtReference())
 		{
-			return kInvalidData;
-		}
-
-		// Found material in material list
-		if (matListChildGUID == TID_D3DRMMaterial)
-		{
-			// Check if too many materials
-			if (iMaterialsRead >= m_Meshes[iMesh].materials.size())
+			if (!tokeniser.ReadReference( &sName ))
 			{
-				pMatListChildData->Release();
 				return kInvalidData;
 			}
 
-			// Read material name
-			EImportError eError =
-				GetXFileDataName( pMatListChildData, m_Meshes[iMesh].materials[iMaterialsRead].sName );
-			if (eError != kSuccess)
+			TXFileMaterials::const_iterator itMaterial = m_NamedMaterials.begin();
+			while (itMaterial != m_NamedMaterials.end() && itMaterial->sName != sName)
+			{
+				++itMaterial;
+			}
+			if (itMaterial == m_NamedMaterials.end())
 			{
-				pMatListChildData->Release();
 				return kInvalidData;
 			}
+			m_Meshes[iMesh].materials.push_back( *itMaterial );
+			continue;
+		}
 
-			// Get material data (11 floats in material template up to optional data)
-			// Fills in all of SXFileMaterial between name & texture name TODO a bit dodgy
-			TUInt32 iSize = 11 * sizeof(TFloat32);
-			TUInt8* pDest = 
-				reinterpret_cast<TUInt8*>(&m_Meshes[iMesh].materials[iMaterialsRead].faceColour);
-			CopyXFileData( pMatListChildData, pDest, &iSize );
-
+		if (!tokeniser.ReadObjectStart( &sType, &sName ))
+		{
+			return kInvalidData;
+		}
 
-			// Get number of child objects for the current object
-			TUInt32 iNumMatChildren;
-			eError = GetXFileNumChildren( pMatListChildData, &iNumMatChildren );
+		// Found material in material list
+		if (sType == "Material")
+		{
+			m_Meshes[iMesh].materials.push_back( SXFileMaterial() );
+			EImportError eError = ReadMaterial( tokeniser, sName, &m_Meshes[iMesh].materials.back() );
 			if (eError != kSuccess)
 			{
-				pMatListChildData->Release();
-				return kInvalidData;
+				return eError;
 			}
+		}
 
-			// For each child object
-			for (TUInt32 iMatChild = 0; iMatChild < iNumMatChildren; ++iMatChild)
-			{
-				// Get child data and ID
-				ID3DXFileData* pMatChildData;
-				GUID matChildGUID;
-				eError = GetXFileChild( pMatListChildData, iMatChild,
-				                        &pMatChildData, &matChildGUID );
-				if (eError != kSuccess)
-				{
-					pMatListChildData->Release();
-					return kInvalidData;
-				}
+		// Found unknown material list data - ignore
+		else if (!tokeniser.SkipObject())
+		{
+			return kInvalidData;
+		}
+	}
 
-				// Found texture filename in material
-				if (matChildGUID == TID_D3DRMTextureFilename)
-				{
-					const TUInt8* pFileNameData;
-					EImportError eError = LockXFileData( pMatChildData, &pFileNameData );
-					if (eError != kSuccess)
-					{
-						pMatChildData->Release();
-						pMatListChildData->Release();
-						return kInvalidData;
-					}
-					m_Meshes[iMesh].materials[iMaterialsRead].sTextureName = 
-						reinterpret_cast<const char*>(pFileNameData);
-					pMatChildData->Unlock();
-				}
+	// Check if wrong number of materials
+	if (m_Meshes[iMesh].materials.size() != iNumMaterials)
+	{
+		return kInvalidData;
+	}
 
-				// Found unknown material data
-				else
-				{
-					// Ignore
-				}
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
-				// Release material child data before moving to the next
-				pMatChildData->Release();
-			}
+	GEN_ENDGUARD;
+}
 
-			// Increase nubmer of materials that have been found and read
-			++iMaterialsRead;
-		}
+// Read a single material template (found in a material list or at the top level of the file)
+EImportError CImportXFile::ReadMaterial
+(
+	CXFileTokeniser& tokeniser,
+	const string&    sName,
+	SXFileMaterial*  pMaterial
+)
+{
+	GEN_GUARD;
 
-		// Found unknown material list data
-		else
-		{
-			// Ignore
-		}
+	pMaterial->sName = sName;
 
-		// Release material list child data before moving to the next
-		pMatListChildData->Release();
+	// Read material colours (11 floats in material template up to optional data)
+	if (!tokeniser.ReadFloats( &pMaterial->faceColour.fRed, 4 ) ||
+	    !tokeniser.ReadFloat( &pMaterial->fSpecularPower ) ||
+	    !tokeniser.ReadFloats( &pMaterial->specularColour.fRed, 3 ) ||
+	    !tokeniser.ReadFloats( &pMaterial->emmisiveColour.fRed, 3 ))
+	{
+		return kInvalidData;
 	}
 
-	// Check if not enough materials
-	if (iMaterialsRead != m_Meshes[iMesh].materials.size())
+	// For each child object
+	string sType, sChildName;
+	while (!tokeniser.AtObjectEnd())
 	{
-		return kInvalidData;
+		if (!tokeniser.ReadObjectStart( &sType, &sChildName ))
+		{
+			return kInvalidData;
+		}
+
+		// Found texture filename in material
+		if (sType == "TextureFilename")
+		{
+			if (!tokeniser.ReadString( &pMaterial->sTextureName ) || !tokeniser.ReadObjectEnd())
+			{
+				return kInvalidData;
+			}
+		}
+
+		// Found unknown material data - ignore
+		else if (!tokeniser.SkipObject())
+		{
+			return kInvalidData;
+		}
 	}
 
-	return kSuccess;
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
 	GEN_ENDGUARD;
 }
@@ -1314,8 +1317,8 @@ EImportError CImportXFile::ReadMaterialData
 // Read a vertex duplication mesh template
 EImportError CImportXFile::ReadDuplicationData
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iMesh
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iMesh
 )
 {
 	GEN_GUARD;
@@ -1326,33 +1329,24 @@ EImportError CImportXFile::ReadDuplicationData
 		return kInvalidData;
 	}
 
-	// Get vertex duplication data
-	const TUInt8* pDuplicationData;
-	EImportError eError = LockXFileData( pXFileData, &pDuplicationData );
-	if (eError != kSuccess)
-	{
-		return kInvalidData;
-	}
-
 	// Read duplicaton indices, also fetch number of unique vertices
 	TUInt32 iNumDuplicationIndices;
-	ReadXFileLockedUInt( pDuplicationData, &iNumDuplicationIndices );
-	if (iNumDuplicationIndices != m_Meshes[iMesh].vertices.size())
+	if (!tokeniser.ReadUInt( &iNumDuplicationIndices ) ||
+	    iNumDuplicationIndices != m_Meshes[iMesh].vertices.size() ||
+	    !tokeniser.ReadUInt( &m_Meshes[iMesh].iNumUniqueVertices ))
 	{
-		pXFileData->Unlock();
 		return kInvalidData;
 	}
-	ReadXFileLockedUInt( pDuplicationData, &m_Meshes[iMesh].iNumUniqueVertices );
 	m_Meshes[iMesh].duplicateIndices.resize( iNumDuplicationIndices );
 	for (TUInt32 iIndex = 0; iIndex < iNumDuplicationIndices; ++iIndex)
 	{
-		ReadXFileLockedUInt( pDuplicationData, &m_Meshes[iMesh].duplicateIndices[iIndex] );
+		if (!tokeniser.ReadUInt( &m_Meshes[iMesh].duplicateIndices[iIndex] ))
+		{
+			return kInvalidData;
+		}
 	}
 
-	// Finished with vertex duplication data
-	pXFileData->Unlock();
-
-	return kSuccess;
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
 	GEN_ENDGUARD;
 }
@@ -1361,8 +1355,8 @@ EImportError CImportXFile::ReadDuplicationData
 // TODO: Unknown usage
 EImportError CImportXFile::ReadAdjacencyData
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iMesh
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iMesh
 )
 {
 	GEN_GUARD;
@@ -1373,27 +1367,22 @@ EImportError CImportXFile::ReadAdjacencyData
 		return kInvalidData;
 	}
 
-	// Get face adjacency data
-	const TUInt8* pAdjacencyData;
-	EImportError eError = LockXFileData( pXFileData, &pAdjacencyData );
-	if (eError != kSuccess)
+	// Read face adjacency list
+	TUInt32 iNumAdjacencyIndices;
+	if (!tokeniser.ReadUInt( &iNumAdjacencyIndices ))
 	{
 		return kInvalidData;
 	}
-
-	// Read face adjacency list
-	TUInt32 iNumAdjacencyIndices;
-	ReadXFileLockedUInt( pAdjacencyData, &iNumAdjacencyIndices );
 	m_Meshes[iMesh].adjacencyIndices.resize( iNumAdjacencyIndices );
 	for (TUInt32 iIndex = 0; iIndex < iNumAdjacencyIndices; ++iIndex)
 	{
-		ReadXFileLockedUInt( pAdjacencyData, &m_Meshes[iMesh].adjacencyIndices[iIndex] );
+		if (!tokeniser.ReadUInt( &m_Meshes[iMesh].adjacencyIndices[iIndex] ))
+		{
+			return kInvalidData;
+		}
 	}
 
-	// Finished with face adjacency data
-	pXFileData->Unlock();
-
-	return kSuccess;
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
 	GEN_ENDGUARD;
 }
@@ -1401,8 +1390,8 @@ EImportError CImportXFile::ReadAdjacencyData
 // Read skinning header mesh template
 EImportError CImportXFile::ReadSkinDefnData
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iMesh
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iMesh
 )
 {
 	GEN_GUARD;
@@ -1413,21 +1402,17 @@ EImportError CImportXFile::ReadSkinDefnData
 		return kInvalidData;
 	}
 
-	// Get skinning definition data
-	const TUInt8* pSkinDefnData;
-	EImportError eError = LockXFileData( pXFileData, &pSkinDefnData );
-	if (eError != kSuccess)
+	// Read maximum weights info and number of bones used (all WORDs)
+	TUInt32 iMaxBonesPerVertex, iMaxBonesPerFace, iNumBones;
+	if (!tokeniser.ReadUInt( &iMaxBonesPerVertex ) || !tokeniser.ReadUInt( &iMaxBonesPerFace ) ||
+	    !tokeniser.ReadUInt( &iNumBones ))
 	{
 		return kInvalidData;
 	}
+	m_Meshes[iMesh].iMaxBonesPerVertex = static_cast<TUInt16>(iMaxBonesPerVertex);
+	m_Meshes[iMesh].iMaxBonesPerFace = static_cast<TUInt16>(iMaxBonesPerFace);
 
-	// Read maximum weights info
-	ReadXFileLockedUInt16( pSkinDefnData, &m_Meshes[iMesh].iMaxBonesPerVertex );
-	ReadXFileLockedUInt16( pSkinDefnData, &m_Meshes[iMesh].iMaxBonesPerFace );
-
-	// Get number of bones used and initialise bone structures
-	TUInt16 iNumBones;
-	ReadXFileLockedUInt16( pSkinDefnData, &iNumBones );
+	// Initialise bone structures
 	for (TUInt32 iBone = 0; iBone < iNumBones; ++iBone)
 	{
 		SXFileBone bone;
@@ -1436,10 +1421,7 @@ EImportError CImportXFile::ReadSkinDefnData
 		m_Meshes[iMesh].bones.push_back( bone );
 	}
 
-	// Finished with skinning definition data
-	pXFileData->Unlock();
-
-	return kSuccess;
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
 	GEN_ENDGUARD;
 }
@@ -1447,9 +1429,9 @@ EImportError CImportXFile::ReadSkinDefnData
 // Read a skinning weights mesh template
 EImportError CImportXFile::ReadSkinWeightsData
 (
-	ID3DXFileData* pXFileData,
-	const TUInt32  iMesh,
-	const TUInt32  iBone
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iMesh,
+	const TUInt32    iBone
 )
 {
 	GEN_GUARD;
@@ -1460,279 +1442,124 @@ EImportError CImportXFile::ReadSkinWeightsData
 		return kInvalidData;
 	}
 
-	// Get skin weights data
-	const TUInt8* pSkinWeightData;
-	EImportError eError = LockXFileData( pXFileData, &pSkinWeightData );
-	if (eError != kSuccess)
+	// Read name of bone
+	SXFileBone& bone = m_Meshes[iMesh].bones[iBone];
+	if (!tokeniser.ReadString( &bone.sFrameName ))
 	{
 		return kInvalidData;
 	}
 
-	// Read name of bone
-	m_Meshes[iMesh].bones[iBone].sFrameName = reinterpret_cast<const char*>(pSkinWeightData);
-	pSkinWeightData += m_Meshes[iMesh].bones[iBone].sFrameName.length() + 1;
-
 	// Read number of weights
 	TUInt32 iNumWeights;
-	ReadXFileLockedUInt( pSkinWeightData, &iNumWeights );
-	m_Meshes[iMesh].bones[iBone].weights.resize( iNumWeights );
+	if (!tokeniser.ReadUInt( &iNumWeights ) || !tokeniser.CanContain( iNumWeights, 2 ))
+	{
+		return kInvalidData;
+	}
+	bone.weights.resize( iNumWeights );
 
-	// Read skinning indices, weights and offset matrix
+	// Read skinning indices, weights and offset matrix. Indices are used to place the weights in the
+	// vertex data, so must refer to vertices already read
 	for (TUInt32 iIndex = 0; iIndex < iNumWeights; ++iIndex)
 	{
-		ReadXFileLockedUInt( pSkinWeightData,
-		                     &m_Meshes[iMesh].bones[iBone].weights[iIndex].iVertexIndex );
+		if (!tokeniser.ReadUInt( &bone.weights[iIndex].iVertexIndex ) ||
+		    bone.weights[iIndex].iVertexIndex >= m_Meshes[iMesh].vertices.size())
+		{
+			return kInvalidData;
+		}
 	}
 
 	for (TUInt32 iWeight = 0; iWeight < iNumWeights; ++iWeight)
 	{
-		TUInt8* pDest = 
-			reinterpret_cast<TUInt8*>(&m_Meshes[iMesh].bones[iBone].weights[iWeight].fWeight);
-		ReadXFileLockedData( pSkinWeightData, pDest, sizeof(TFloat32) );
+		if (!tokeniser.ReadFloat( &bone.weights[iWeight].fWeight ))
+		{
+			return kInvalidData;
+		}
 	}
 
-	TUInt8* pDest = reinterpret_cast<TUInt8*>(&m_Meshes[iMesh].bones[iBone].offsetMatrix);
-	ReadXFileLockedData( pSkinWeightData, pDest, 16 * sizeof(TFloat32) );
-
-	// Finished with skin weight data
-	pXFileData->Unlock();
-
-	return kSuccess;
-
-	GEN_ENDGUARD;
-}
-
-
-/*-----------------------------------------------------------------------------------------
-	X-File parsing
------------------------------------------------------------------------------------------*/
-
-EImportError CImportXFile::GetXFileNumChildren
-(
-	ID3DXFileEnumObject* pXFileEnumer, 
-	TUInt32*             iNumChildren
-)
-{
-	GEN_GUARD;
-
-	HRESULT xFileError = pXFileEnumer->GetChildren( reinterpret_cast<DWORD*>(iNumChildren) );
-	if (xFileError != S_OK)
+	if (!tokeniser.ReadFloats( &bone.offsetMatrix.e00, 16 ))
 	{
 		return kInvalidData;
 	}
 
-	return kSuccess;
+	return tokeniser.ReadObjectEnd() ? kSuccess : kInvalidData;
 
 	GEN_ENDGUARD;
 }
 
-EImportError CImportXFile::GetXFileNumChildren
-(
-	ID3DXFileData* pXFileData,
-	TUInt32*       iNumChildren
-)
-{
-	GEN_GUARD;
-
-	HRESULT xFileError = pXFileData->GetChildren( reinterpret_cast<DWORD*>(iNumChildren) );
-	if (xFileError != S_OK)
-	{
-		return kInvalidData;
-	}
-
-	return kSuccess;
-
-	GEN_ENDGUARD;
-}
 
+/*-----------------------------------------------------------------------------------------
+	X-File parsing support
+-----------------------------------------------------------------------------------------*/
 
-EImportError CImportXFile::GetXFileChild
+// Read the faces of a mesh or normal template - they can be general polygons, they are all
+// converted to triangles. Indices must be less than the given number of vertices / normals. The
+// number of edges of each original face is checked against (or if empty stored into) the given list
+bool CImportXFile::ReadXFileFaces
 (
-	ID3DXFileEnumObject* pXFileEnumer,
-	const TUInt32        iChild, 
-	ID3DXFileData**      ppChildData, 
-	GUID*                pChildGUID
+	CXFileTokeniser& tokeniser,
+	const TUInt32    iNumIndices,
+	TXFileFaces*     pFaces,
+	TXFileInts*      pFaceEdges
 )
 {
 	GEN_GUARD;
 
-	HRESULT xFileError = pXFileEnumer->GetChild( iChild, ppChildData );
-	if (xFileError != S_OK)
+	TUInt32 iNumFaces;
+	if (!tokeniser.ReadUInt( &iNumFaces ) || !tokeniser.CanContain( iNumFaces, 4 ))
 	{
-		GEN_ASSERT( xFileError != D3DXFERR_NOMOREOBJECTS, "Invalid child ID" );
-		return kInvalidData;
+		return false;
 	}
 
-	xFileError = (*ppChildData)->GetType( pChildGUID );
-	GEN_ASSERT( xFileError == S_OK, "Failure getting X-File GUID" );
-
-	return kSuccess;
-
-	GEN_ENDGUARD;
-}
-
-EImportError CImportXFile::GetXFileChild
-(
-	ID3DXFileData*  pXFileData,
-	const TUInt32   iChild, 
-	ID3DXFileData** ppChildData, 
-	GUID*           pChildGUID
-)
-{
-	GEN_GUARD;
-
-	HRESULT xFileError = pXFileData->GetChild( iChild, ppChildData );
-	if (xFileError != S_OK)
+	// Store original number of edges (mesh faces) or validate against them (normal faces)
+	bool bStoreEdges = pFaceEdges->empty();
+	if (bStoreEdges)
 	{
-		GEN_ASSERT( xFileError != D3DXFERR_NOMOREOBJECTS, "Invalid child ID" );
-		return kInvalidData;
+		pFaceEdges->resize( iNumFaces );
 	}
-
-	xFileError = (*ppChildData)->GetType( pChildGUID );
-	GEN_ASSERT( xFileError == S_OK, "Failure getting X-File GUID" );
-
-	return kSuccess;
-
-	GEN_ENDGUARD;
-}
-
-
-EImportError CImportXFile::GetXFileDataName
-(
-	ID3DXFileData* pXFileData,
-	string&        sName
-)
-{
-	GEN_GUARD;
-
-	DWORD iDataSize;
-	HRESULT xFileError = pXFileData->GetName( NULL, &iDataSize );
-	if (!iDataSize)
+	else if (iNumFaces != pFaceEdges->size())
 	{
-		sName = "";
+		return false;
 	}
-	else
+
+	// Most faces are triangles, reserve on that basis
+	pFaces->reserve( iNumFaces );
+	for (TUInt32 iFace = 0; iFace < iNumFaces; ++iFace)
 	{
-		char* szName = new char[iDataSize];
-		if (!szName)
+		TUInt32 iNumEdges;
+		if (!tokeniser.ReadUInt( &iNumEdges ) || iNumEdges < 3)
 		{
-			return kOutOfSystemMemory;
+			return false;
 		}
-		xFileError = pXFileData->GetName( szName, &iDataSize );
-		GEN_ASSERT( xFileError == S_OK, "Failure getting X-File name" );
-		sName = szName;
-		delete[] szName;
-	}
-
-	return kSuccess;
-
-	GEN_ENDGUARD;
-}
-
-
-EImportError CImportXFile::LockXFileData
-(
-	ID3DXFileData* pXFileData,
-    const TUInt8** ppLockData,
-    TUInt32*       pSize /*= 0*/
-)
-{
-	GEN_GUARD;
- 
-	DWORD iActualSize;
-	HRESULT xFileError = 
-		pXFileData->Lock( &iActualSize, reinterpret_cast<const void**>(ppLockData) );
-	GEN_ASSERT( xFileError == S_OK, "Unexpected failure in Lock" );
-	if (pSize)
-	{
-		if (*pSize != 0 && *pSize != iActualSize)
+		if (bStoreEdges)
 		{
-			pXFileData->Unlock();
-			return kInvalidData;
+			(*pFaceEdges)[iFace] = iNumEdges;
+		}
+		else if (iNumEdges != (*pFaceEdges)[iFace])
+		{
+			return false;
 		}
-		*pSize = iActualSize;
-	}
-
-	return kSuccess;
-
-	GEN_ENDGUARD;
-}
-
-void CImportXFile::UnlockXFileData
-(
-	ID3DXFileData* pXFileData
-)
-{
-	GEN_GUARD;
- 
-	pXFileData->Unlock();
-
-	GEN_ENDGUARD;
-}
-
 
-EImportError CImportXFile::CopyXFileData
-(
-	ID3DXFileData* pXFileData,
-    TUInt8*        pDest,
-    TUInt32*       pSize
-)
-{
-	GEN_GUARD;
- 
-	const TUInt8* pLockData;
-	EImportError eError = LockXFileData( pXFileData, &pLockData, pSize );
-	if (eError != kSuccess)
-	{
-		return eError;
+		// Read first index of polygon, then use successive pairs of indices to form triangles
+		// with this first one
+		TUInt32 iFirstIndex, iIndexA, iIndexB;
+		if (!tokeniser.ReadUInt( &iFirstIndex ) || iFirstIndex >= iNumIndices ||
+		    !tokeniser.ReadUInt( &iIndexA ) || iIndexA >= iNumIndices)
+		{
+			return false;
+		}
+		for (TUInt32 iEdge = 2; iEdge < iNumEdges; ++iEdge)
+		{
+			if (!tokeniser.ReadUInt( &iIndexB ) || iIndexB >= iNumIndices)
+			{
+				return false;
+			}
+			SXFileFace face = { iFirstIndex, iIndexA, iIndexB };
+			pFaces->push_back( face );
+			iIndexA = iIndexB;
+		}
 	}
-	memcpy( pDest, pLockData, *pSize );
-	UnlockXFileData( pXFileData );
-
-	return kSuccess;
-
-	GEN_ENDGUARD;
-}
-
-void CImportXFile::ReadXFileLockedData
-(
-	const TUInt8*& pMeshData,
-	TUInt8*        pDest,
-	const TUInt32  iSize
-)
-{
-	GEN_GUARD;
- 
-	memcpy( pDest, pMeshData, iSize );
-	pMeshData += iSize;
-
-	GEN_ENDGUARD;
-}
-
-void CImportXFile::ReadXFileLockedUInt
-(
-	const TUInt8*& pMeshData,
-	TUInt32*       piDest
-)
-{
-	GEN_GUARD;
- 
-	memcpy( piDest, pMeshData, 4 );
-	pMeshData += 4;
-
-	GEN_ENDGUARD;
-}
 
-void CImportXFile::ReadXFileLockedUInt16
-(
-	const TUInt8*& pMeshData,
-	TUInt16*       piDest
-)
-{
-	GEN_GUARD;
- 
-	memcpy( piDest, pMeshData, 2 );
-	pMeshData += 2;
+	return true;
 
 	GEN_ENDGUARD;
 }
@@ -1782,100 +1609,104 @@ void CImportXFile::MatchFaceLists
 
 	if (!mesh.normals.empty())
 	{
-		// Maximum vertices (and normals) possible is the total number of indices in the original
-		// face lists (if each index was different). Use std library accumulate from <numeric>
-		TUInt32 iMaxVertices = accumulate( mesh.origFaceEdges.begin(), 
-		                                   mesh.origFaceEdges.end(), 0 );
+		// Normal used by each vertex, vertices not yet used by any face are marked with the number
+		// of normals. Extended as new vertices are created
+		TUInt32 iOldNumVertices = static_cast<TUInt32>(mesh.vertices.size());
+		TUInt32 iUnused = static_cast<TUInt32>(mesh.normals.size());
+		TXFileInts normalMap( iOldNumVertices, iUnused );
 
-		// Create empty vertex and normal maps - use max vertex value as unused marker
-		TXFileInts vertexMap( iMaxVertices, iMaxVertices );
-		TXFileInts normalMap( iMaxVertices, iMaxVertices );
+		// Original vertex copied by each new vertex created by this process
+		TXFileInts vertexDups;
 
-		// Table of vertex duplicates created by this process, each entry is next copy of vertex
-		TXFileInts vertexDup( iMaxVertices, iMaxVertices );
+		// Hard-edged meshes have more normals than vertices, and nearly every extra normal ends
+		// up on its own copy of a vertex. Reserve for that many new vertices up front - the
+		// arrays still grow if there are more
+		TUInt32 iExpectedDups = (iUnused > iOldNumVertices) ? iUnused - iOldNumVertices : 0;
+		normalMap.reserve( iOldNumVertices + iExpectedDups );
+		vertexDups.reserve( iExpectedDups );
 
-		// May need to duplicate vertices, count from original number of vertices
-		TUInt32 iNewNumVertices = static_cast<TUInt32>(mesh.vertices.size()); 
+		// Vertex created for each vertex/normal pair that didn't match the normal first used
+		// with the vertex
+		CVertexNormalTable vertexNormalTable;
 
 		// Create vertex and normal mapping tables
 		for (TUInt32 iFace = 0; iFace != mesh.faces.size(); ++iFace)
 		{
 			// Unclutter code with references to current faces (vertex and normal)
 			SXFileFace& vertexFace = mesh.faces[iFace];
-			SXFileFace& normalFace = mesh.normalFaces[iFace];
+			const SXFileFace& normalFace = mesh.normalFaces[iFace];
 
 			// For each face edge
 			for (int i = 0; i < 3; ++i)
 			{
-				// Will try to use vertex face index for the normal face index, if unused then OK
-				if (normalMap[vertexFace.aiVertex[i]] == iMaxVertices) 
+				TUInt32 iVertex = vertexFace.aiVertex[i];
+				TUInt32 iNormal = normalFace.aiVertex[i];
+
+				// The first normal used with a vertex is assigned to it, and most later uses of
+				// the vertex will have the same normal
+				if (normalMap[iVertex] == iUnused)
 				{
-					// Use the vertex face index for both vertices and normals
-					vertexMap[vertexFace.aiVertex[i]] = vertexFace.aiVertex[i];
-					normalMap[vertexFace.aiVertex[i]] = normalFace.aiVertex[i];
+					normalMap[iVertex] = iNormal;
 				}
-				// otherwise the vertex face index has already been used...
-				else
+				else if (normalMap[iVertex] != iNormal)
 				{
-					// See if the normal face index is correct for this vertex or the duplicates
-					// already created
-					TUInt32 iVert = vertexFace.aiVertex[i];
-					while (normalMap[iVert] != normalFace.aiVertex[i] &&
-					       vertexDup[iVert] != iMaxVertices)
-					{
-						iVert = vertexDup[iVert];
-					}
-					// Can't find correct normal face index on any of this vertices copies, so
-					// create another copy
-					if (normalMap[iVert] != normalFace.aiVertex[i])
+					// Otherwise use the copy of the vertex made for this normal, creating it if
+					// this pair hasn't been seen before
+					TUInt32 iNewVertex = iOldNumVertices + static_cast<TUInt32>(vertexDups.size());
+					if (vertexNormalTable.FindOrAdd( iVertex, iNormal, &iNewVertex ))
 					{
-						// Add new vertex index
-						vertexMap[iNewNumVertices] = vertexFace.aiVertex[i];
-						normalMap[iNewNumVertices] = normalFace.aiVertex[i];
-						vertexDup[iVert] = iNewNumVertices;
-
-						// Update the face indices to point at this new vertex
-						vertexFace.aiVertex[i] = iNewNumVertices;
-						++iNewNumVertices;
-					}
-					else
-					{
-						// Update the face indices to point at appropriate vertex duplicate
-						vertexFace.aiVertex[i] = iVert;
+						vertexDups.push_back( iVertex );
+						normalMap.push_back( iNormal );
 					}
+					vertexFace.aiVertex[i] = iNewVertex;
 				}
 			}
 		}
 
-		// Add any required duplicate vertex data (if necessary)
-		TUInt32 iOldNumVertices = static_cast<TUInt32>(mesh.vertices.size());
-		if (iNewNumVertices > iOldNumVertices)
+		// Add any required duplicate vertex data. Each array is sized once and the new vertices
+		// written directly
+		TUInt32 iNumDups = static_cast<TUInt32>(vertexDups.size());
+		if (iNumDups > 0)
 		{
-			// For every added vertex...
-			for (TUInt32 iVertex = iOldNumVertices; iVertex < iNewNumVertices; ++iVertex)
+			mesh.vertices.resize( iOldNumVertices + iNumDups );
+			for (TUInt32 iDup = 0; iDup < iNumDups; ++iDup)
 			{
-				// Use the vertex map to duplicate the various vertex data
-				mesh.vertices.push_back( mesh.vertices[vertexMap[iVertex]] );
-				if (!mesh.textureCoords.empty())
+				mesh.vertices[iOldNumVertices + iDup] = mesh.vertices[vertexDups[iDup]];
+			}
+			if (!mesh.textureCoords.empty())
+			{
+				mesh.textureCoords.resize( iOldNumVertices + iNumDups );
+				for (TUInt32 iDup = 0; iDup < iNumDups; ++iDup)
 				{
-					mesh.textureCoords.push_back( mesh.textureCoords[vertexMap[iVertex]] );
+					mesh.textureCoords[iOldNumVertices + iDup] = mesh.textureCoords[vertexDups[iDup]];
 				}
-				if (!mesh.vertexColours.empty())
+			}
+			if (!mesh.vertexColours.empty())
+			{
+				mesh.vertexColours.resize( iOldNumVertices + iNumDups );
+				for (TUInt32 iDup = 0; iDup < iNumDups; ++iDup)
 				{
-					mesh.vertexColours.push_back( mesh.vertexColours[vertexMap[iVertex]] );
+					mesh.vertexColours[iOldNumVertices + iDup] = mesh.vertexColours[vertexDups[iDup]];
 				}
-				if (!mesh.duplicateIndices.empty())
+			}
+			if (!mesh.duplicateIndices.empty())
+			{
+				mesh.duplicateIndices.resize( iOldNumVertices + iNumDups );
+				for (TUInt32 iDup = 0; iDup < iNumDups; ++iDup)
 				{
-					mesh.duplicateIndices.push_back( mesh.duplicateIndices[vertexMap[iVertex]] );
+					mesh.duplicateIndices[iOldNumVertices + iDup] = mesh.duplicateIndices[vertexDups[iDup]];
 				}
 			}
 		}
 
-		// Build full updated normal list and replace original normals
+		// Build full updated normal list and replace original normals. Vertices not used by any
+		// face are given a zero normal
+		TUInt32 iNewNumVertices = iOldNumVertices + iNumDups;
 		TXFileVectors newNormals( iNewNumVertices );
 		for (TUInt32 iNormal = 0; iNormal < iNewNumVertices; ++iNormal)
 		{
-			newNormals[iNormal] = mesh.normals[normalMap[iNormal]];
+			newNormals[iNormal] = (normalMap[iNormal] == iUnused) ? CVector3::kOrigin :
+			                                                        mesh.normals[normalMap[iNormal]];
 		}
 		mesh.normals.swap( newNormals );
 	}
@@ -2014,63 +1845,124 @@ EImportError CImportXFile::ProcessBones()
 	Mesh processing
 -----------------------------------------------------------------------------------------*/
 
-// Split each mesh into a set of meshes - each of which contains only a single material
+// Split each mesh into a set of meshes - each of which contains only a single material. The faces
+// of each mesh are bucketed by material in a single pass, then each new mesh is sized once and
+// filled from its bucket
 void CImportXFile::SplitMeshes()
 {
 	GEN_GUARD;
 
-	TUInt32 iNumOrigMeshes = static_cast<TUInt32>(m_Meshes.size());
-	for (TUInt32 iMesh = 0; iMesh < iNumOrigMeshes; ++iMesh)
+	TXFileMeshes newMeshes;
+	for (TUInt32 iMesh = 0; iMesh < m_Meshes.size(); ++iMesh)
 	{
-		TUInt32 iMaxVertices = static_cast<TUInt32>(m_Meshes[iMesh].vertices.size());
+		// Unclutter code with a reference to the mesh
+		const SXFileMesh& mesh = m_Meshes[iMesh];
+		TUInt32 iNumMaterials = static_cast<TUInt32>(mesh.materials.size());
+		TUInt32 iNumFaces = static_cast<TUInt32>(mesh.faceMaterials.size());
 
-		for (TUInt32 iMaterial = 0; iMaterial < m_Meshes[iMesh].materials.size(); ++iMaterial)
+		// Count faces using each material, then convert to the start of each material's faces in
+		// a list of faces sorted by material. Faces with an invalid material are dropped
+		TXFileInts materialStarts( iNumMaterials + 1, 0 );
+		for (TUInt32 iFace = 0; iFace < iNumFaces; ++iFace)
+		{
+			if (mesh.faceMaterials[iFace] < iNumMaterials)
+			{
+				++materialStarts[mesh.faceMaterials[iFace] + 1];
+			}
+		}
+		for (TUInt32 iMaterial = 0; iMaterial < iNumMaterials; ++iMaterial)
 		{
-			SXFileMesh newMesh;
-			newMesh.iParentFrame = m_Meshes[iMesh].iParentFrame;
-			newMesh.materials.push_back( m_Meshes[iMesh].materials[iMaterial] );
-			newMesh.materialMap.push_back( m_Meshes[iMesh].materialMap[iMaterial] );
+			materialStarts[iMaterial + 1] += materialStarts[iMaterial];
+		}
+		TXFileInts sortedFaces( materialStarts[iNumMaterials] );
+		TXFileInts nextFace( materialStarts.begin(), materialStarts.end() - 1 );
+		for (TUInt32 iFace = 0; iFace < iNumFaces; ++iFace)
+		{
+			if (mesh.faceMaterials[iFace] < iNumMaterials)
+			{
+				sortedFaces[nextFace[mesh.faceMaterials[iFace]]++] = iFace;
+			}
+		}
+
+		// Map from original vertex to vertex in the new mesh, along with the material of the new
+		// mesh each entry was made for, so the map needn't be cleared between materials
+		TUInt32 iMaxVertices = static_cast<TUInt32>(mesh.vertices.size());
+		TXFileInts vertexMap( iMaxVertices );
+		TXFileInts vertexMapMaterial( iMaxVertices, iNumMaterials );
 
-			TXFileInts vertexMap( iMaxVertices, iMaxVertices );
+		// Original vertex used by each vertex in the new mesh
+		TXFileInts newVertices;
+		newVertices.reserve( iMaxVertices );
 
-			for (TUInt32 iFace = 0; iFace < m_Meshes[iMesh].faceMaterials.size(); ++iFace)
+		for (TUInt32 iMaterial = 0; iMaterial < iNumMaterials; ++iMaterial)
+		{
+			TUInt32 iFirstFace = materialStarts[iMaterial];
+			TUInt32 iNumNewFaces = materialStarts[iMaterial + 1] - iFirstFace;
+			if (iNumNewFaces == 0)
+			{
+				continue;
+			}
+
+			newMeshes.push_back( SXFileMesh() );
+			SXFileMesh& newMesh = newMeshes.back();
+			newMesh.iParentFrame = mesh.iParentFrame;
+			newMesh.materials.push_back( mesh.materials[iMaterial] );
+			newMesh.materialMap.push_back( mesh.materialMap[iMaterial] );
+			newMesh.faceMaterials.resize( iNumNewFaces, 0 );
+
+			// Remap face indices, assigning new vertices in order of first use
+			newVertices.clear();
+			newMesh.faces.resize( iNumNewFaces );
+			for (TUInt32 iNewFace = 0; iNewFace < iNumNewFaces; ++iNewFace)
 			{
-				if (m_Meshes[iMesh].faceMaterials[iFace] == iMaterial)
+				const SXFileFace& face = mesh.faces[sortedFaces[iFirstFace + iNewFace]];
+				for (TUInt32 iIndex = 0; iIndex < 3; ++iIndex)
 				{
-					newMesh.faceMaterials.push_back( 0 );
-					SXFileFace newFace;
-					for (TUInt32 iIndex = 0; iIndex < 3; ++iIndex)
+					TUInt32 iVert = face.aiVertex[iIndex];
+					if (vertexMapMaterial[iVert] != iMaterial)
 					{
-						TUInt32 iVert = m_Meshes[iMesh].faces[iFace].aiVertex[iIndex];
-						if (vertexMap[iVert] == iMaxVertices)
-						{
-							vertexMap[iVert] = static_cast<TUInt32>(newMesh.vertices.size());
-							newMesh.vertices.push_back( m_Meshes[iMesh].vertices[iVert] );
-							if (m_Meshes[iMesh].normals.size() > 0)
-							{
-								newMesh.normals.push_back( m_Meshes[iMesh].normals[iVert] );
-							}
-							if (m_Meshes[iMesh].textureCoords.size() > 0)
-							{
-								newMesh.textureCoords.push_back( m_Meshes[iMesh].textureCoords[iVert] );
-							}
-							if (m_Meshes[iMesh].vertexColours.size() > 0)
-							{
-								newMesh.vertexColours.push_back( m_Meshes[iMesh].vertexColours[iVert] );
-							}
-						}
-						newFace.aiVertex[iIndex] = vertexMap[iVert];
+						vertexMapMaterial[iVert] = iMaterial;
+						vertexMap[iVert] = static_cast<TUInt32>(newVertices.size());
+						newVertices.push_back( iVert );
 					}
-					newMesh.faces.push_back( newFace );
+					newMesh.faces[iNewFace].aiVertex[iIndex] = vertexMap[iVert];
 				}
 			}
-			if (newMesh.vertices.size() > 0)
+
+			// Copy vertex data used by the new mesh
+			TUInt32 iNumNewVertices = static_cast<TUInt32>(newVertices.size());
+			newMesh.vertices.resize( iNumNewVertices );
+			for (TUInt32 iVert = 0; iVert < iNumNewVertices; ++iVert)
 			{
-				m_Meshes.push_back( newMesh );
+				newMesh.vertices[iVert] = mesh.vertices[newVertices[iVert]];
+			}
+			if (!mesh.normals.empty())
+			{
+				newMesh.normals.resize( iNumNewVertices );
+				for (TUInt32 iVert = 0; iVert < iNumNewVertices; ++iVert)
+				{
+					newMesh.normals[iVert] = mesh.normals[newVertices[iVert]];
+				}
+			}
+			if (!mesh.textureCoords.empty())
+			{
+				newMesh.textureCoords.resize( iNumNewVertices );
+				for (TUInt32 iVert = 0; iVert < iNumNewVertices; ++iVert)
+				{
+					newMesh.textureCoords[iVert] = mesh.textureCoords[newVertices[iVert]];
+				}
+			}
+			if (!mesh.vertexColours.empty())
+			{
+				newMesh.vertexColours.resize( iNumNewVertices );
+				for (TUInt32 iVert = 0; iVert < iNumNewVertices; ++iVert)
+				{
+					newMesh.vertexColours[iVert] = mesh.vertexColours[newVertices[iVert]];
+				}
 			}
 		}
 	}
-	m_Meshes.erase( m_Meshes.begin(), m_Meshes.begin() + iNumOrigMeshes );
+	m_Meshes.swap( newMeshes );
 
 	GEN_ENDGUARD;
 }
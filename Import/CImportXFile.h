@@ -9,6 +9,9 @@
 
 	Change history:
 		V1.0    Created 12/06/06 - LN
+		V1.1    Native text X-file parser replaces the ID3DXFile API
+		V1.2    Files are memory mapped and parsed in place, added import from memory
+		V1.3    Optional vertex cache optimisation of the imported meshes
 **************************************************************************************************/
 
 #ifndef GEN_C_IMPORT_XFILE_H_INCLUDED
@@ -16,12 +19,11 @@
 
 #include <vector>
 using namespace std;
-#include <d3d9.h>
-#include <d3dx9.h>
 
 #include "CVector3.h"
 #include "CMatrix4x4.h"
 #include "MeshData.h"
+#include "CXFileTokeniser.h"
 
 namespace gen
 {
@@ -49,6 +51,7 @@ public:
 	CImportXFile()
 	{
 		m_bImported = false;
+		m_bOptimised = false;
 	}
 
 private:
@@ -66,7 +69,7 @@ public:
 	// File import
 
 	// Return import status
-	bool IsImported()
+	bool IsImported() const
 	{
 		return m_bImported;
 	}
@@ -77,12 +80,35 @@ public:
 	//		kFileError:			Missing file or not an X-file
 	//		kInvalidData:		The file could not be parsed correctly, or contains invalid data
 	//		kOutOfSystemMemory:	...
-	//		kSystemFailure:		X-file API failure
 	EImportError ImportFile
 	(
 		const string& sXName
 	);
 
+	// Import a Microsoft X-File held in memory, e.g. a memory mapped file or one from an archive.
+	// The data is parsed in place and need only remain valid for the duration of the call
+	// Possible return values:
+	//		kSuccess:			...
+	//		kFileError:			Not an X-file
+	//		kInvalidData:		The file could not be parsed correctly, or contains invalid data
+	//		kOutOfSystemMemory:	...
+	EImportError ImportFile
+	(
+		const TUInt8* pData,
+		const TUInt32 iSize
+	);
+
+	// Reorder the faces and vertices of each sub-mesh to make good use of the GPU vertex caches
+	// (see MeshOptimise.h). An optional stage after a successful import, the geometry is unchanged.
+	// Does nothing if the meshes have already been optimised
+	void OptimiseMeshes();
+
+	// Return true if the meshes have been reordered by OptimiseMeshes since the last import
+	bool IsOptimised() const
+	{
+		return m_bOptimised;
+	}
+
 
 	/////////////////////////////////////
 	// Data access
@@ -115,7 +141,7 @@ public:
 	// Possible return values:
 	//		kSuccess:			...
 	//		kOutOfSystemMemory:	...
-	EImportError CImportXFile::GetSubMesh
+	EImportError GetSubMesh
 	(
 		const TUInt32 iSubMesh,
 		SSubMesh*     pSubMesh,
@@ -338,32 +364,6 @@ private:
 	typedef vector<SXFileMesh> TXFileMeshes;
 
 
-	/////////////////////////////////////
-	// X-File API support
-
-	// Prepare and return an X-file object
-	// Possible return values:
-	//		kSuccess:			...
-	//		kOutOfSystemMemory:	...
-	//		kSystemFailure:		Problem registering X-file templates or other API error
-	EImportError PrepareXFileObject
-	(
-		ID3DXFile** ppXFile
-	);
-
-	// Prepare and return an X-file enumerator given a filename and an X-file object
-	// Possible return values:
-	//		kSuccess:			...
-	//		kInvalidData:		The file could not be parsed correctly, or contains invalid data
-	//		kSystemFailure:		X-file API error
-	EImportError GetXFileEnumerator
-	(
-		const string&         sFilename,
-		ID3DXFile*            pXFile,
-		ID3DXFileEnumObject** ppXFileEnumer
-	);
-
-
 	/////////////////////////////////////
 	// X-File parsing
 
@@ -374,7 +374,7 @@ private:
 	//		kInvalidData:		The file could not be parsed correctly, or contains invalid data
 	EImportError ParseXFile
 	(
-		ID3DXFileEnumObject* pXFileEnumer
+		CXFileTokeniser& tokeniser
 	);
 
 	// Create a new frame and parse the X-File to add all the contained frames and meshes. Any
@@ -384,163 +384,118 @@ private:
 	//		kInvalidData:		The file could not be parsed correctly, or contains invalid data
 	EImportError ParseXFileFrame
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iParentFrame
+		CXFileTokeniser& tokeniser,
+		const string&    sName,
+		const TUInt32    iParentFrame
 	);
 
 
 	// X-File parsing - collect mesh data
 	EImportError ParseXFileMesh
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iCurrFrame
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iCurrFrame
 	);
 
 
 	/////////////////////////////////////
 	// X-File template parsing
+	// Each function is called after the opening brace of its template and reads up to and
+	// including the closing brace. Except ReadMeshData, which leaves the mesh's child objects
+
+	// Read a frame transform matrix template
+	EImportError ReadFrameMatrixData
+	(
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iFrame
+	);
 
 	// Read vertex and face data from a mesh template
 	EImportError ReadMeshData
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iMesh
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iMesh
 	);
 
 	// Read a normal data mesh template
 	EImportError ReadNormalData
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iMesh
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iMesh
 	);
 
 	// Read a texture coordinate mesh template
 	EImportError ReadTextureUVData
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iMesh
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iMesh
 	);
 
 	// Read a vertex colour mesh template
 	EImportError ReadVertexColourData
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iMesh
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iMesh
 	);
 
-	// Read a vertex colour mesh template
+	// Read a material list mesh template
 	EImportError ReadMaterialData
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iMesh
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iMesh
+	);
+
+	// Read a single material template (found in a material list or at the top level of the file)
+	EImportError ReadMaterial
+	(
+		CXFileTokeniser& tokeniser,
+		const string&    sName,
+		SXFileMaterial*  pMaterial
 	);
 
 	// Read a vertex duplication mesh template
 	EImportError ReadDuplicationData
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iMesh
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iMesh
 	);
 
 	// Read a adjacancy data mesh template
 	EImportError ReadAdjacencyData
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iMesh
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iMesh
 	);
 
 	// Read skinning header mesh template
 	EImportError ReadSkinDefnData
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iMesh
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iMesh
 	);
 
 	// Read a skinning weights mesh template
 	EImportError ReadSkinWeightsData
 	(
-		ID3DXFileData* pXFileData,
-		const TUInt32  iMesh,
-		const TUInt32  iBone
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iMesh,
+		const TUInt32    iBone
 	);
 
 
 	/////////////////////////////////////
 	// X-File parsing support
 
-	EImportError GetXFileNumChildren
-	(
-		ID3DXFileEnumObject* pXFileEnumer, 
-		TUInt32*             iNumChildren
-	);
-
-	EImportError GetXFileNumChildren
-	(
-		ID3DXFileData* pXFileData,
-		TUInt32*       iNumChildren
-	);
-
-
-	EImportError GetXFileChild
-	(
-		ID3DXFileEnumObject* pXFileEnumer,
-		const TUInt32        iChild, 
-		ID3DXFileData**      ppChildData, 
-		GUID*                pChildGUID
-	);
-
-	EImportError GetXFileChild
-	(
-		ID3DXFileData*  pXFileData,
-		const TUInt32   iChild, 
-		ID3DXFileData** ppChildData, 
-		GUID*           pChildGUID
-	);
-
-
-	EImportError GetXFileDataName
-	(
-		ID3DXFileData* pXFileData,
-		string&        sName
-	);
-
-
-	EImportError LockXFileData
-	(
-		ID3DXFileData* pXFileData,
-		const TUInt8** ppLockData,
-		TUInt32*       pSize = 0
-	);
-
-	void UnlockXFileData
+	// Read the faces of a mesh or normal template - they can be general polygons, they are all
+	// converted to triangles. Indices must be less than the given number of vertices / normals.
+	// The number of edges of each original face is checked against (or if empty stored into) the
+	// given list
+	bool ReadXFileFaces
 	(
-		ID3DXFileData* pXFileData
-	);
-
-	EImportError CopyXFileData
-	(
-		ID3DXFileData* pXFileData,
-		TUInt8*        pDest,
-		TUInt32*       pSize
-	);
-
-	void ReadXFileLockedData
-	(
-		const   TUInt8*& pMeshData,
-		TUInt8*	         pDest,
-		const   TUInt32  iSize
-	);
-
-	void ReadXFileLockedUInt
-	(
-		const TUInt8*& pMeshData,
-		TUInt32*       piDest
-	);
-
-	void ReadXFileLockedUInt16
-	(
-		const TUInt8*& pMeshData,
-		TUInt16*       piDest
+		CXFileTokeniser& tokeniser,
+		const TUInt32    iNumIndices,
+		TXFileFaces*     pFaces,
+		TXFileInts*      pFaceEdges
 	);
 
 
@@ -589,8 +544,9 @@ private:
 		Data
 	---------------------------------------------------------------------------------------------*/
 
-	// Has any data been loaded into the lists below
+	// Has any data been loaded into the lists below, and has it been optimised
 	bool            m_bImported;
+	bool            m_bOptimised;
 
 	// The list of frames forms a flattened depth-first hierarchy
 	TXFileFrames    m_Frames;
@@ -600,6 +556,10 @@ private:
 
 	// Global list of materials used by all the meshes
 	TXFileMaterials m_Materials;
+
+	// Materials declared at the top level of the file, which material lists refer to by name.
+	// Only used during parsing
+	TXFileMaterials m_NamedMaterials;
 };
 
 
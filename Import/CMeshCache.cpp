@@ -0,0 +1,692 @@
+/**************************************************************************************************
+	Module:       CMeshCache.cpp
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Compiled binary mesh cache (.xbin) - the final output of an X-file import stored in a form
+	that can be memory mapped and used directly with no parsing
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <new>
+using namespace std;
+
+#include "CMeshCache.h"
+#include "Error.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Cache file format
+-----------------------------------------------------------------------------------------*/
+
+// A cache file is a header followed by a node table, sub-mesh table, material table, the
+// vertex and face data of each sub-mesh and a string table. All offsets are in bytes from the
+// start of the file and all sections are aligned to 16 bytes so the file can be mapped and
+// used in place. Strings are referenced by offset into the string table and length. Data is
+// stored in the native (little-endian) byte order
+
+namespace
+{
+	// Increase the version whenever the format or import output changes - old caches will then
+	// be rebuilt on next load
+	const TUInt8  kacCacheMagic[4] = { 'X', 'B', 'I', 'N' };
+	const TUInt32 kiCacheVersion = 5;
+	const TUInt32 kiCacheAlignment = 16;
+
+	// Import option flags. Only the tangents option is part of the source hash - the optimised
+	// flag records whether the meshes went through the vertex cache optimisation
+	const TUInt32 kiCacheTangents  = 1;
+	const TUInt32 kiCacheOptimised = 2;
+
+	// Sub-mesh vertex component flags
+	const TUInt32 kiHasSkinningData  = 1;
+	const TUInt32 kiHasNormals       = 2;
+	const TUInt32 kiHasTangents      = 4;
+	const TUInt32 kiHasTextureCoords = 8;
+	const TUInt32 kiHasVertexColours = 16;
+
+	struct SCacheHeader
+	{
+		TUInt8  acMagic[4];
+		TUInt32 iVersion;
+		TUInt64 iSourceHash;
+		TUInt32 iOptions;
+		TUInt32 iSize;
+		TUInt32 iNumNodes;
+		TUInt32 iNodesOffset;
+		TUInt32 iNumSubMeshes;
+		TUInt32 iSubMeshesOffset;
+		TUInt32 iNumMaterials;
+		TUInt32 iMaterialsOffset;
+		TUInt32 iStringsOffset;
+		TUInt32 iStringsSize;
+	};
+
+	struct SCacheNode
+	{
+		TUInt32  iName;
+		TUInt32  iNameLength;
+		TUInt32  iDepth;
+		TUInt32  iParent;
+		TUInt32  iNumChildren;
+		TFloat32 afPositionMatrix[16];
+		TFloat32 afInvMeshOffset[16];
+	};
+
+	struct SCacheSubMesh
+	{
+		TUInt32  iNode;
+		TUInt32  iMaterial;
+		TUInt32  iComponents;
+		TUInt32  iVertexSize;
+		TUInt32  iNumVertices;
+		TUInt32  iVerticesOffset;
+		TUInt32  iNumFaces;
+		TUInt32  iIndexSize;
+		TUInt32  iFacesOffset;
+		TFloat32 afBoundsCentre[3];
+		TFloat32 afBoundsExtents[3];
+		TFloat32 fBoundsRadius;
+	};
+
+	struct SCacheMaterial
+	{
+		TUInt32     iRenderMethod;
+		SColourRGBA diffuseColour;
+		SColourRGBA specularColour;
+		TFloat32    fSpecularPower;
+		TUInt32     iNumTextures;
+		TUInt32     aiTextureName[kiMaxTextures];
+		TUInt32     aiTextureNameLength[kiMaxTextures];
+	};
+
+
+	// Append data to a cache image, first padding the image to the cache alignment. Returns the
+	// offset of the data in the image
+	TUInt32 AppendData
+	(
+		vector<TUInt8>* pImage,
+		const void*     pData,
+		const size_t    iSize
+	)
+	{
+		pImage->resize( (pImage->size() + kiCacheAlignment - 1) & ~(kiCacheAlignment - 1) );
+		TUInt32 iOffset = static_cast<TUInt32>(pImage->size());
+		if (iSize > 0)
+		{
+			const TUInt8* pBytes = static_cast<const TUInt8*>(pData);
+			pImage->insert( pImage->end(), pBytes, pBytes + iSize );
+		}
+		return iOffset;
+	}
+
+	// Add a string to a string table, setting its offset and length
+	void AppendString
+	(
+		vector<char>* pStrings,
+		const string& sString,
+		TUInt32*      piOffset,
+		TUInt32*      piLength
+	)
+	{
+		*piOffset = static_cast<TUInt32>(pStrings->size());
+		*piLength = static_cast<TUInt32>(sString.length());
+		pStrings->insert( pStrings->end(), sString.begin(), sString.end() );
+	}
+
+	// Returns true if a table of the given number of elements and element size, at the given
+	// offset, lies entirely within an image of the given size and is aligned for in-place use
+	bool IsValidRange
+	(
+		const TUInt32 iOffset,
+		const TUInt32 iCount,
+		const TUInt32 iElementSize,
+		const TUInt32 iImageSize
+	)
+	{
+		return (iOffset % kiCacheAlignment) == 0 &&
+		       static_cast<TUInt64>(iOffset) + static_cast<TUInt64>(iCount) * iElementSize <= iImageSize;
+	}
+
+	// Return the size of a vertex with the given components, as written by CImportXFile::GetSubMesh:
+	// position, skinning data (4 float weights & 4 byte bone indices), normal, tangent, UV and a
+	// float colour
+	TUInt32 GetVertexSize
+	(
+		const TUInt32 iComponents
+	)
+	{
+		return 12 + ((iComponents & kiHasSkinningData)  ? 20 : 0) +
+		            ((iComponents & kiHasNormals)       ? 12 : 0) +
+		            ((iComponents & kiHasTangents)      ? 12 : 0) +
+		            ((iComponents & kiHasTextureCoords) ?  8 : 0) +
+		            ((iComponents & kiHasVertexColours) ? 16 : 0);
+	}
+
+	// Returns true if every index in a face list of the given index size (2 or 4) is less than the
+	// given number of vertices
+	bool AreValidFaces
+	(
+		const TUInt8* pFaces,
+		const TUInt32 iNumFaces,
+		const TUInt32 iIndexSize,
+		const TUInt32 iNumVertices
+	)
+	{
+		for (TUInt32 iIndex = 0; iIndex < iNumFaces * 3; ++iIndex)
+		{
+			TUInt32 iVertex = (iIndexSize == sizeof(TUInt16)) ?
+			                  reinterpret_cast<const TUInt16*>(pFaces)[iIndex] :
+			                  reinterpret_cast<const TUInt32*>(pFaces)[iIndex];
+			if (iVertex >= iNumVertices)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Loading
+-----------------------------------------------------------------------------------------*/
+
+// Load an X-file through its cache, may request tangents to be calculated for all sub-meshes.
+// Uses the existing cache file if it is up to date, otherwise imports the X-file and writes a
+// new cache. Failure to write the cache is not an error, the imported data is still available
+// Possible return values:
+//		kSuccess:			...
+//		kFileError:			Missing file or not an X-file
+//		kInvalidData:		The file could not be parsed correctly, or contains invalid data
+//		kOutOfSystemMemory:	...
+EImportError CMeshCache::Load
+(
+	const string& sXFileName,
+	const bool    bTangents /*= false*/
+)
+{
+	GEN_GUARD;
+
+	Close();
+
+	// Hash the source file - the cache is only used if it was built from identical contents
+	CMappedFile sourceFile;
+	if (!sourceFile.Open( sXFileName ))
+	{
+		return kFileError;
+	}
+	TUInt64 iSourceHash = HashSource( sourceFile.GetData(), sourceFile.GetSize(), bTangents );
+
+	// Use existing cache if it is valid and up to date. The cache is for rendering, so one built
+	// offline from an unoptimised import is rebuilt
+	string sCacheName = GetCacheFileName( sXFileName, bTangents );
+	if (m_File.Open( sCacheName ) && SetImage( m_File.GetData(), m_File.GetSize(), iSourceHash ))
+	{
+		if (IsOptimised())
+		{
+			return kSuccess;
+		}
+		m_pData = 0;
+		m_iSize = 0;
+	}
+	m_File.Close();
+
+	// Otherwise import the X-file from the already mapped data and build a new cache image, with
+	// the faces and vertices optimised for the GPU caches
+	CImportXFile import;
+	EImportError eError = import.ImportFile( sourceFile.GetData(), sourceFile.GetSize() );
+	if (eError != kSuccess)
+	{
+		return eError;
+	}
+	import.OptimiseMeshes();
+	eError = Build( import, bTangents, iSourceHash, &m_Image );
+	if (eError != kSuccess)
+	{
+		return eError;
+	}
+
+	// Save the cache for next time, then use the image in memory
+	WriteImage( sCacheName, m_Image );
+	if (!SetImage( &m_Image[0], static_cast<TUInt32>(m_Image.size()), iSourceHash ))
+	{
+		m_Image.clear();
+		return kInvalidData;
+	}
+
+	return kSuccess;
+
+	GEN_ENDGUARD;
+}
+
+
+// Release the cache data, invalidating any sub-mesh pointers previously returned
+void CMeshCache::Close()
+{
+	m_pData = 0;
+	m_iSize = 0;
+	m_File.Close();
+	vector<TUInt8>().swap( m_Image );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Data access
+-----------------------------------------------------------------------------------------*/
+
+// Return true if the sub-meshes were optimised for the GPU vertex caches when the cache was built
+bool CMeshCache::IsOptimised() const
+{
+	return m_pData && (reinterpret_cast<const SCacheHeader*>(m_pData)->iOptions & kiCacheOptimised) != 0;
+}
+
+// Get number of nodes in the mesh hierarchy
+TUInt32 CMeshCache::GetNumNodes() const
+{
+	return m_pData ? reinterpret_cast<const SCacheHeader*>(m_pData)->iNumNodes : 0;
+}
+
+// Get a single node from the mesh hierarchy, returned through a pointer
+void CMeshCache::GetNode
+(
+	const TUInt32    iNode,
+	SMeshNode* const pOutNode
+) const
+{
+	GEN_GUARD;
+	GEN_ASSERT_OPT( iNode < GetNumNodes(), "Invalid parameter" );
+
+	const SCacheHeader* pHeader = reinterpret_cast<const SCacheHeader*>(m_pData);
+	const SCacheNode& node =
+		reinterpret_cast<const SCacheNode*>(m_pData + pHeader->iNodesOffset)[iNode];
+
+	pOutNode->name = GetString( node.iName, node.iNameLength );
+	pOutNode->depth = node.iDepth;
+	pOutNode->parent = node.iParent;
+	pOutNode->numChildren = node.iNumChildren;
+	pOutNode->positionMatrix = CMatrix4x4( node.afPositionMatrix );
+	pOutNode->invMeshOffset = CMatrix4x4( node.afInvMeshOffset );
+
+	GEN_ENDGUARD;
+}
+
+
+// Get number of sub-meshes
+TUInt32 CMeshCache::GetNumSubMeshes() const
+{
+	return m_pData ? reinterpret_cast<const SCacheHeader*>(m_pData)->iNumSubMeshes : 0;
+}
+
+// Get the specification and data for given submesh, returned through a pointer. The vertex and
+// face pointers refer to data held by the cache - they must not be written or deleted
+void CMeshCache::GetSubMesh
+(
+	const TUInt32 iSubMesh,
+	SSubMesh*     pOutSubMesh
+) const
+{
+	GEN_GUARD;
+	GEN_ASSERT_OPT( iSubMesh < GetNumSubMeshes(), "Invalid parameter" );
+
+	const SCacheHeader* pHeader = reinterpret_cast<const SCacheHeader*>(m_pData);
+	const SCacheSubMesh& subMesh =
+		reinterpret_cast<const SCacheSubMesh*>(m_pData + pHeader->iSubMeshesOffset)[iSubMesh];
+
+	pOutSubMesh->node = subMesh.iNode;
+	pOutSubMesh->material = subMesh.iMaterial;
+	pOutSubMesh->hasSkinningData = (subMesh.iComponents & kiHasSkinningData) != 0;
+	pOutSubMesh->hasNormals = (subMesh.iComponents & kiHasNormals) != 0;
+	pOutSubMesh->hasTangents = (subMesh.iComponents & kiHasTangents) != 0;
+	pOutSubMesh->hasTextureCoords = (subMesh.iComponents & kiHasTextureCoords) != 0;
+	pOutSubMesh->hasVertexColours = (subMesh.iComponents & kiHasVertexColours) != 0;
+	pOutSubMesh->vertexSize = subMesh.iVertexSize;
+
+	// SSubMesh uses non-const pointers as imported sub-meshes are owned by the caller
+	pOutSubMesh->numVertices = subMesh.iNumVertices;
+	pOutSubMesh->vertices = const_cast<TUInt8*>(m_pData + subMesh.iVerticesOffset);
+	pOutSubMesh->numFaces = subMesh.iNumFaces;
+	pOutSubMesh->faces = const_cast<TUInt8*>(m_pData + subMesh.iFacesOffset);
+	pOutSubMesh->indexSize = subMesh.iIndexSize;
+	memcpy( &pOutSubMesh->bounds.centre.x, subMesh.afBoundsCentre, sizeof(subMesh.afBoundsCentre) );
+	memcpy( &pOutSubMesh->bounds.extents.x, subMesh.afBoundsExtents, sizeof(subMesh.afBoundsExtents) );
+	pOutSubMesh->bounds.radius = subMesh.fBoundsRadius;
+
+	GEN_ENDGUARD;
+}
+
+
+// Get the number of materials used in the mesh (across all submeshes)
+TUInt32 CMeshCache::GetNumMaterials() const
+{
+	return m_pData ? reinterpret_cast<const SCacheHeader*>(m_pData)->iNumMaterials : 0;
+}
+
+// Get specification of a given material, returned through a pointer
+void CMeshCache::GetMaterial
+(
+	const TUInt32        iMaterial,
+	SMeshMaterial* const pOutMaterial
+) const
+{
+	GEN_GUARD;
+	GEN_ASSERT_OPT( iMaterial < GetNumMaterials(), "Invalid parameter" );
+
+	const SCacheHeader* pHeader = reinterpret_cast<const SCacheHeader*>(m_pData);
+	const SCacheMaterial& material =
+		reinterpret_cast<const SCacheMaterial*>(m_pData + pHeader->iMaterialsOffset)[iMaterial];
+
+	pOutMaterial->renderMethod = static_cast<ERenderMethod>(material.iRenderMethod);
+	pOutMaterial->diffuseColour = material.diffuseColour;
+	pOutMaterial->specularColour = material.specularColour;
+	pOutMaterial->specularPower = material.fSpecularPower;
+	pOutMaterial->numTextures = material.iNumTextures;
+	for (TUInt32 iTexture = 0; iTexture < kiMaxTextures; ++iTexture)
+	{
+		pOutMaterial->textureFileNames[iTexture] =
+			GetString( material.aiTextureName[iTexture], material.aiTextureNameLength[iTexture] );
+	}
+
+	GEN_ENDGUARD;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Cache building
+-----------------------------------------------------------------------------------------*/
+
+// Build a cache image in memory from an imported X-file, for the given import options and hash
+// of the source file. Records whether the import was optimised. Used by Load, or by tools to
+// build caches offline
+// Possible return values:
+//		kSuccess:			...
+//		kInvalidData:		The import has not been completed
+//		kOutOfSystemMemory:	...
+EImportError CMeshCache::Build
+(
+	const CImportXFile& import,
+	const bool          bTangents,
+	const TUInt64       iSourceHash,
+	vector<TUInt8>*     pImage
+)
+{
+	GEN_GUARD;
+
+	if (!import.IsImported())
+	{
+		return kInvalidData;
+	}
+
+	try
+	{
+		SCacheHeader header;
+		memset( &header, 0, sizeof(header) );
+		memcpy( header.acMagic, kacCacheMagic, sizeof(header.acMagic) );
+		header.iVersion = kiCacheVersion;
+		header.iSourceHash = iSourceHash;
+		header.iOptions = (bTangents ? kiCacheTangents : 0) | (import.IsOptimised() ? kiCacheOptimised : 0);
+		header.iNumNodes = import.GetNumNodes();
+		header.iNumSubMeshes = import.GetNumSubMeshes();
+		header.iNumMaterials = import.GetNumMaterials();
+
+		vector<SCacheNode>     nodes( header.iNumNodes );
+		vector<SCacheSubMesh>  subMeshes( header.iNumSubMeshes );
+		vector<SCacheMaterial> materials( header.iNumMaterials );
+		vector<char>           strings;
+
+		// Header is written last when all offsets are known, reserve space for it now
+		pImage->clear();
+		AppendData( pImage, &header, sizeof(header) );
+
+		// Nodes
+		for (TUInt32 iNode = 0; iNode < header.iNumNodes; ++iNode)
+		{
+			SMeshNode meshNode;
+			import.GetNode( iNode, &meshNode );
+
+			SCacheNode& node = nodes[iNode];
+			AppendString( &strings, meshNode.name, &node.iName, &node.iNameLength );
+			node.iDepth = meshNode.depth;
+			node.iParent = meshNode.parent;
+			node.iNumChildren = meshNode.numChildren;
+			memcpy( node.afPositionMatrix, &meshNode.positionMatrix.e00, sizeof(node.afPositionMatrix) );
+			memcpy( node.afInvMeshOffset, &meshNode.invMeshOffset.e00, sizeof(node.afInvMeshOffset) );
+		}
+
+		// Sub-mesh vertex and face data, exactly as provided by the import
+		for (TUInt32 iSubMesh = 0; iSubMesh < header.iNumSubMeshes; ++iSubMesh)
+		{
+			SSubMesh meshSubMesh;
+			EImportError eError = import.GetSubMesh( iSubMesh, &meshSubMesh, bTangents );
+			if (eError != kSuccess)
+			{
+				return eError;
+			}
+
+			SCacheSubMesh& subMesh = subMeshes[iSubMesh];
+			subMesh.iNode = meshSubMesh.node;
+			subMesh.iMaterial = meshSubMesh.material;
+			subMesh.iComponents = (meshSubMesh.hasSkinningData  ? kiHasSkinningData  : 0) |
+			                      (meshSubMesh.hasNormals       ? kiHasNormals       : 0) |
+			                      (meshSubMesh.hasTangents      ? kiHasTangents      : 0) |
+			                      (meshSubMesh.hasTextureCoords ? kiHasTextureCoords : 0) |
+			                      (meshSubMesh.hasVertexColours ? kiHasVertexColours : 0);
+			subMesh.iVertexSize = meshSubMesh.vertexSize;
+			subMesh.iNumVertices = meshSubMesh.numVertices;
+			subMesh.iNumFaces = meshSubMesh.numFaces;
+			subMesh.iIndexSize = meshSubMesh.indexSize;
+			memcpy( subMesh.afBoundsCentre, &meshSubMesh.bounds.centre.x, sizeof(subMesh.afBoundsCentre) );
+			memcpy( subMesh.afBoundsExtents, &meshSubMesh.bounds.extents.x, sizeof(subMesh.afBoundsExtents) );
+			subMesh.fBoundsRadius = meshSubMesh.bounds.radius;
+
+			// Import allocates the sub-mesh data, release it once copied
+			subMesh.iVerticesOffset = AppendData( pImage, meshSubMesh.vertices,
+			                                      meshSubMesh.numVertices * meshSubMesh.vertexSize );
+			subMesh.iFacesOffset = AppendData( pImage, meshSubMesh.faces,
+			                                   meshSubMesh.numFaces * 3 * meshSubMesh.indexSize );
+			delete[] meshSubMesh.vertices;
+			delete[] meshSubMesh.faces;
+		}
+
+		// Materials
+		for (TUInt32 iMaterial = 0; iMaterial < header.iNumMaterials; ++iMaterial)
+		{
+			SMeshMaterial meshMaterial;
+			import.GetMaterial( iMaterial, &meshMaterial );
+
+			SCacheMaterial& material = materials[iMaterial];
+			material.iRenderMethod = meshMaterial.renderMethod;
+			material.diffuseColour = meshMaterial.diffuseColour;
+			material.specularColour = meshMaterial.specularColour;
+			material.fSpecularPower = meshMaterial.specularPower;
+			material.iNumTextures = meshMaterial.numTextures;
+			for (TUInt32 iTexture = 0; iTexture < kiMaxTextures; ++iTexture)
+			{
+				AppendString( &strings, meshMaterial.textureFileNames[iTexture],
+				              &material.aiTextureName[iTexture], &material.aiTextureNameLength[iTexture] );
+			}
+		}
+
+		// Tables and strings
+		header.iNodesOffset = AppendData( pImage, nodes.empty() ? 0 : &nodes[0],
+		                                  nodes.size() * sizeof(SCacheNode) );
+		header.iSubMeshesOffset = AppendData( pImage, subMeshes.empty() ? 0 : &subMeshes[0],
+		                                      subMeshes.size() * sizeof(SCacheSubMesh) );
+		header.iMaterialsOffset = AppendData( pImage, materials.empty() ? 0 : &materials[0],
+		                                      materials.size() * sizeof(SCacheMaterial) );
+		header.iStringsSize = static_cast<TUInt32>(strings.size());
+		header.iStringsOffset = AppendData( pImage, strings.empty() ? 0 : &strings[0], strings.size() );
+		header.iSize = static_cast<TUInt32>(pImage->size());
+
+		memcpy( &(*pImage)[0], &header, sizeof(header) );
+	}
+	catch (bad_alloc&)
+	{
+		pImage->clear();
+		return kOutOfSystemMemory;
+	}
+
+	return kSuccess;
+
+	GEN_ENDGUARD;
+}
+
+
+// Hash the contents of a source X-file together with the import options and cache version.
+// Uses 64-bit FNV-1a, which is more than fast enough compared to the cost of an import
+TUInt64 CMeshCache::HashSource
+(
+	const TUInt8* pData,
+	const TUInt32 iSize,
+	const bool    bTangents
+)
+{
+	const TUInt64 kiFNVPrime = 0x100000001b3ull;
+	TUInt64 iHash = 0xcbf29ce484222325ull;
+	for (TUInt32 i = 0; i < iSize; ++i)
+	{
+		iHash = (iHash ^ pData[i]) * kiFNVPrime;
+	}
+	iHash = (iHash ^ kiCacheVersion) * kiFNVPrime;
+	iHash = (iHash ^ (bTangents ? kiCacheTangents : 0)) * kiFNVPrime;
+	return iHash;
+}
+
+
+// Get the name of the cache file used for a given X-file and import options. The extension is
+// replaced, a separate cache is used when tangents are requested
+string CMeshCache::GetCacheFileName
+(
+	const string& sXFileName,
+	const bool    bTangents
+)
+{
+	string sBaseName = sXFileName;
+	string::size_type iExtension = sBaseName.find_last_of( '.' );
+	if (iExtension != string::npos && sBaseName.find_first_of( "/\\", iExtension ) == string::npos)
+	{
+		sBaseName.erase( iExtension );
+	}
+	return sBaseName + (bTangents ? "_tangents.xbin" : ".xbin");
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Private functions
+-----------------------------------------------------------------------------------------*/
+
+// Validate a cache image against the expected source hash and, if valid, use it as the current
+// cache data. The image must remain valid until the cache is closed
+bool CMeshCache::SetImage
+(
+	const TUInt8* pData,
+	const TUInt32 iSize,
+	const TUInt64 iSourceHash
+)
+{
+	GEN_GUARD;
+
+	// Check header identifies an up to date cache of the correct size
+	if (iSize < sizeof(SCacheHeader))
+	{
+		return false;
+	}
+	const SCacheHeader* pHeader = reinterpret_cast<const SCacheHeader*>(pData);
+	if (memcmp( pHeader->acMagic, kacCacheMagic, sizeof(kacCacheMagic) ) != 0 ||
+	    pHeader->iVersion != kiCacheVersion || pHeader->iSourceHash != iSourceHash ||
+	    pHeader->iSize != iSize)
+	{
+		return false;
+	}
+
+	// Check all tables and data lie within the image
+	if (!IsValidRange( pHeader->iNodesOffset, pHeader->iNumNodes, sizeof(SCacheNode), iSize ) ||
+	    !IsValidRange( pHeader->iSubMeshesOffset, pHeader->iNumSubMeshes, sizeof(SCacheSubMesh), iSize ) ||
+	    !IsValidRange( pHeader->iMaterialsOffset, pHeader->iNumMaterials, sizeof(SCacheMaterial), iSize ) ||
+	    !IsValidRange( pHeader->iStringsOffset, pHeader->iStringsSize, 1, iSize ))
+	{
+		return false;
+	}
+
+	// Check each sub-mesh's data lies within the image, its node and material are in the tables, its
+	// vertex size matches its components and its faces only use its own vertices. Any failure makes
+	// the cache invalid, so it is rebuilt from the X-file
+	const SCacheSubMesh* pSubMeshes =
+		reinterpret_cast<const SCacheSubMesh*>(pData + pHeader->iSubMeshesOffset);
+	for (TUInt32 iSubMesh = 0; iSubMesh < pHeader->iNumSubMeshes; ++iSubMesh)
+	{
+		const SCacheSubMesh& subMesh = pSubMeshes[iSubMesh];
+		if (subMesh.iNode >= pHeader->iNumNodes || subMesh.iMaterial >= pHeader->iNumMaterials ||
+		    (subMesh.iIndexSize != sizeof(TUInt16) && subMesh.iIndexSize != sizeof(TUInt32)) ||
+		    subMesh.iVertexSize != GetVertexSize( subMesh.iComponents ) ||
+		    !IsValidRange( subMesh.iVerticesOffset, subMesh.iNumVertices, subMesh.iVertexSize, iSize ) ||
+		    !IsValidRange( subMesh.iFacesOffset, subMesh.iNumFaces, 3 * subMesh.iIndexSize, iSize ) ||
+		    !AreValidFaces( pData + subMesh.iFacesOffset, subMesh.iNumFaces, subMesh.iIndexSize,
+		                    subMesh.iNumVertices ))
+		{
+			return false;
+		}
+	}
+
+	m_pData = pData;
+	m_iSize = iSize;
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+
+// Write a cache image to a file
+bool CMeshCache::WriteImage
+(
+	const string&         sCacheName,
+	const vector<TUInt8>& image
+)
+{
+	GEN_GUARD;
+
+	FILE* pFile = fopen( sCacheName.c_str(), "wb" );
+	if (!pFile)
+	{
+		return false;
+	}
+	size_t iWritten = fwrite( &image[0], 1, image.size(), pFile );
+	bool bClosed = (fclose( pFile ) == 0);
+	if (iWritten != image.size() || !bClosed)
+	{
+		// Don't leave a partial cache behind (it would be rejected on load anyway)
+		remove( sCacheName.c_str() );
+		return false;
+	}
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+
+// Get a string from the cache string table, strings outside the table are returned empty
+string CMeshCache::GetString
+(
+	const TUInt32 iOffset,
+	const TUInt32 iLength
+) const
+{
+	const SCacheHeader* pHeader = reinterpret_cast<const SCacheHeader*>(m_pData);
+	if (static_cast<TUInt64>(iOffset) + iLength > pHeader->iStringsSize)
+	{
+		return string();
+	}
+	const char* pString = reinterpret_cast<const char*>(m_pData + pHeader->iStringsOffset) + iOffset;
+	return string( pString, iLength );
+}
+
+
+} // namespace gen
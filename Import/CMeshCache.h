@@ -0,0 +1,207 @@
+/**************************************************************************************************
+	Module:       CMeshCache.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Compiled binary mesh cache (.xbin) - the final output of an X-file import stored in a form
+	that can be memory mapped and used directly with no parsing
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#ifndef GEN_C_MESH_CACHE_H_INCLUDED
+#define GEN_C_MESH_CACHE_H_INCLUDED
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "MeshData.h"
+#include "CImportXFile.h"
+#include "CMappedFile.h"
+
+namespace gen
+{
+
+// A mesh cache holds the nodes, sub-meshes and materials of an imported X-file exactly as
+// CImportXFile provides them: the interleaved vertex stream and face array of each sub-mesh, the
+// flattened node hierarchy and the material table. The cache for a file is written next to it
+// the first time it is loaded. Later loads map the cache and return pointers into it, skipping
+// parsing, face matching, splitting, tangent calculation and vertex cache optimisation entirely -
+// the header records that the cached meshes are already optimised.
+//
+// Each cache stores a hash of the source file contents and the import options used. A cache is
+// rebuilt automatically if the source changes, the options differ or the format version changes.
+// Data access follows CImportXFile, but sub-mesh data is owned by the cache - the vertex and face
+// pointers are read-only and only valid until the cache is closed or destroyed
+class CMeshCache
+{
+	GEN_CLASS( CMeshCache )
+
+/*-----------------------------------------------------------------------------------------
+	Constructors/Destructors
+-----------------------------------------------------------------------------------------*/
+public:
+	// Constructor
+	CMeshCache() : m_pData( 0 ), m_iSize( 0 ) {}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CMeshCache( const CMeshCache& );
+	CMeshCache& operator=( const CMeshCache& );
+
+
+/*-----------------------------------------------------------------------------------------
+	Public interface
+-----------------------------------------------------------------------------------------*/
+public:
+
+	/////////////////////////////////////
+	// Loading
+
+	// Load an X-file through its cache, may request tangents to be calculated for all sub-meshes.
+	// Uses the existing cache file if it is up to date, otherwise imports the X-file and writes a
+	// new cache. Failure to write the cache is not an error, the imported data is still available
+	// Possible return values:
+	//		kSuccess:			...
+	//		kFileError:			Missing file or not an X-file
+	//		kInvalidData:		The file could not be parsed correctly, or contains invalid data
+	//		kOutOfSystemMemory:	...
+	EImportError Load
+	(
+		const string& sXFileName,
+		const bool    bTangents = false
+	);
+
+	// Release the cache data, invalidating any sub-mesh pointers previously returned
+	void Close();
+
+	// Return load status
+	bool IsLoaded() const
+	{
+		return m_pData != 0;
+	}
+
+
+	/////////////////////////////////////
+	// Data access
+
+	// Return true if the sub-meshes were optimised for the GPU vertex caches when the cache was
+	// built (see CImportXFile::OptimiseMeshes). Caches written by Load are always optimised
+	bool IsOptimised() const;
+
+	// Get number of nodes in the mesh hierarchy
+	TUInt32 GetNumNodes() const;
+
+	// Get a single node from the mesh hierarchy, returned through a pointer
+	void GetNode
+	(
+		const TUInt32    iNode,
+		SMeshNode* const pNode
+	) const;
+
+	// Get number of sub-meshes
+	TUInt32 GetNumSubMeshes() const;
+
+	// Get the specification and data for given submesh, returned through a pointer. The vertex
+	// and face pointers refer to data held by the cache - they must not be written or deleted
+	void GetSubMesh
+	(
+		const TUInt32 iSubMesh,
+		SSubMesh*     pSubMesh
+	) const;
+
+	// Get the number of materials used in the mesh (across all submeshes)
+	TUInt32 GetNumMaterials() const;
+
+	// Get specification of a given material, returned through a pointer
+	void GetMaterial
+	(
+		const TUInt32        iMaterial,
+		SMeshMaterial* const pMaterial
+	) const;
+
+
+	/////////////////////////////////////
+	// Cache building
+
+	// Build a cache image in memory from an imported X-file, for the given import options and hash
+	// of the source file. Records whether the import was optimised. Used by Load, or by tools to
+	// build caches offline
+	// Possible return values:
+	//		kSuccess:			...
+	//		kInvalidData:		The import has not been completed
+	//		kOutOfSystemMemory:	...
+	static EImportError Build
+	(
+		const CImportXFile& import,
+		const bool          bTangents,
+		const TUInt64       iSourceHash,
+		vector<TUInt8>*     pImage
+	);
+
+	// Hash the contents of a source X-file together with the import options and cache version
+	static TUInt64 HashSource
+	(
+		const TUInt8* pData,
+		const TUInt32 iSize,
+		const bool    bTangents
+	);
+
+	// Get the name of the cache file used for a given X-file and import options
+	static string GetCacheFileName
+	(
+		const string& sXFileName,
+		const bool    bTangents
+	);
+
+
+/*-----------------------------------------------------------------------------------------
+	Private interface
+-----------------------------------------------------------------------------------------*/
+private:
+
+	// Validate a cache image against the expected source hash and, if valid, use it as the
+	// current cache data. The image must remain valid until the cache is closed
+	bool SetImage
+	(
+		const TUInt8* pData,
+		const TUInt32 iSize,
+		const TUInt64 iSourceHash
+	);
+
+	// Write a cache image to a file
+	static bool WriteImage
+	(
+		const string&         sCacheName,
+		const vector<TUInt8>& image
+	);
+
+	// Get a string from the cache string table
+	string GetString
+	(
+		const TUInt32 iOffset,
+		const TUInt32 iLength
+	) const;
+
+
+	/*---------------------------------------------------------------------------------------------
+		Data
+	---------------------------------------------------------------------------------------------*/
+
+	// Current cache image - points into either the mapped cache file or an image built in memory
+	const TUInt8*  m_pData;
+	TUInt32        m_iSize;
+
+	// Storage for the image
+	CMappedFile    m_File;
+	vector<TUInt8> m_Image;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_MESH_CACHE_H_INCLUDED
@@ -0,0 +1,460 @@
+/**************************************************************************************************
+	Module:       CXFileTokeniser.cpp
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Tokeniser for Microsoft DirectX text .X files ("xof 0303txt"), works in a single pass over a
+	memory buffer with no platform dependencies
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26 - Replaces the ID3DXFile API used by CImportXFile
+**************************************************************************************************/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CXFileTokeniser.h"
+#include "Error.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Local helpers
+-----------------------------------------------------------------------------------------*/
+
+namespace
+{
+	// Character classes used by the tokeniser - avoiding <ctype.h> as it is locale dependent
+	inline bool IsDigit( const char c )
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	inline bool IsIdentifierStart( const char c )
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+	}
+
+	inline bool IsIdentifierChar( const char c )
+	{
+		return IsIdentifierStart( c ) || IsDigit( c ) || c == '-' || c == '.';
+	}
+
+	// Powers of ten for float conversion, exact in double precision up to 10^22
+	const TFloat64 kafPowersOf10[] =
+	{
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	const TInt32 kiMaxExactPower = 22;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	File header
+-----------------------------------------------------------------------------------------*/
+
+// Read the 16 byte X-file header, e.g. "xof 0303txt 0032". Returns false if the header is
+// invalid or the file is not in text format (binary and compressed X-files not supported)
+bool CXFileTokeniser::ReadHeader()
+{
+	GEN_GUARD;
+
+	const TUInt32 kiHeaderSize = 16;
+	if (m_pEnd - m_pCurr < static_cast<ptrdiff_t>(kiHeaderSize))
+	{
+		return false;
+	}
+
+	// Magic number, 4 digit version (e.g. 0303), format ("txt ") and float size (0032 or 0064)
+	if (memcmp( m_pCurr, "xof ", 4 ) != 0 || memcmp( m_pCurr + 8, "txt ", 4 ) != 0 ||
+	    (memcmp( m_pCurr + 12, "0032", 4 ) != 0 && memcmp( m_pCurr + 12, "0064", 4 ) != 0))
+	{
+		return false;
+	}
+
+	m_pCurr += kiHeaderSize;
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Objects
+-----------------------------------------------------------------------------------------*/
+
+// Read the start of a data object: template type, optional name, optional GUID and the
+// opening brace, e.g. "Frame Frame_World {". The name is returned empty if not present
+bool CXFileTokeniser::ReadObjectStart
+(
+	string* psType,
+	string* psName
+)
+{
+	GEN_GUARD;
+
+	if (!ReadIdentifier( psType ))
+	{
+		return false;
+	}
+
+	// Optional name
+	SkipSeparators();
+	psName->clear();
+	if (m_pCurr != m_pEnd && IsIdentifierStart( *m_pCurr ))
+	{
+		ReadIdentifier( psName );
+		SkipSeparators();
+	}
+
+	// Optional GUID - not needed, objects are identified by their template type
+	if (m_pCurr != m_pEnd && *m_pCurr == '<')
+	{
+		const char* pGUIDEnd = static_cast<const char*>(memchr( m_pCurr, '>', m_pEnd - m_pCurr ));
+		if (!pGUIDEnd)
+		{
+			return false;
+		}
+		m_pCurr = pGUIDEnd + 1;
+		SkipSeparators();
+	}
+
+	if (m_pCurr == m_pEnd || *m_pCurr != '{')
+	{
+		return false;
+	}
+	++m_pCurr;
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+// Read the closing brace of the current data object
+bool CXFileTokeniser::ReadObjectEnd()
+{
+	GEN_GUARD;
+
+	if (!AtObjectEnd())
+	{
+		return false;
+	}
+	++m_pCurr;
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+// Skip the remainder of the current data object, including any nested objects, up to and
+// including its closing brace. Used for templates and unsupported data
+bool CXFileTokeniser::SkipObject()
+{
+	GEN_GUARD;
+
+	TUInt32 iDepth = 1;
+	while (iDepth > 0)
+	{
+		SkipSeparators();
+		if (m_pCurr == m_pEnd)
+		{
+			return false;
+		}
+
+		const char c = *m_pCurr++;
+		if (c == '{')
+		{
+			++iDepth;
+		}
+		else if (c == '}')
+		{
+			--iDepth;
+		}
+		else if (c == '"')
+		{
+			// Skip strings in case they contain braces
+			const char* pStringEnd = static_cast<const char*>(memchr( m_pCurr, '"', m_pEnd - m_pCurr ));
+			if (!pStringEnd)
+			{
+				return false;
+			}
+			m_pCurr = pStringEnd + 1;
+		}
+	}
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+// Read a reference to a named object, e.g. "{ MaterialName }", returning the name
+bool CXFileTokeniser::ReadReference
+(
+	string* psName
+)
+{
+	GEN_GUARD;
+
+	if (!AtReference())
+	{
+		return false;
+	}
+	++m_pCurr;
+
+	// Reference may be by name, GUID or both - only names are supported
+	if (!ReadIdentifier( psName ))
+	{
+		return false;
+	}
+	SkipSeparators();
+	if (m_pCurr != m_pEnd && *m_pCurr == '<')
+	{
+		const char* pGUIDEnd = static_cast<const char*>(memchr( m_pCurr, '>', m_pEnd - m_pCurr ));
+		if (!pGUIDEnd)
+		{
+			return false;
+		}
+		m_pCurr = pGUIDEnd + 1;
+	}
+	return ReadObjectEnd();
+
+	GEN_ENDGUARD;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Data values
+-----------------------------------------------------------------------------------------*/
+
+// Read an unsigned integer (DWORD / WORD in X-file templates)
+bool CXFileTokeniser::ReadUInt
+(
+	TUInt32* piValue
+)
+{
+	GEN_GUARD_OPT;
+
+	SkipSeparators();
+	if (m_pCurr == m_pEnd || !IsDigit( *m_pCurr ))
+	{
+		return false;
+	}
+
+	TUInt32 iValue = 0;
+	do
+	{
+		iValue = iValue * 10 + (*m_pCurr - '0');
+		++m_pCurr;
+	} while (m_pCurr != m_pEnd && IsDigit( *m_pCurr ));
+
+	*piValue = iValue;
+	return true;
+
+	GEN_ENDGUARD_OPT;
+}
+
+// Read a floating point value. Digits are accumulated into an integer mantissa and scaled by an
+// exact power of ten, which is much faster than strtod and gives the same result for the fixed
+// point values written by exporters. Long mantissas or large exponents fall back to strtod
+bool CXFileTokeniser::ReadFloat
+(
+	TFloat32* pfValue
+)
+{
+	GEN_GUARD_OPT;
+
+	SkipSeparators();
+	const char* pStart = m_pCurr;
+
+	bool bNegative = false;
+	if (m_pCurr != m_pEnd && (*m_pCurr == '-' || *m_pCurr == '+'))
+	{
+		bNegative = (*m_pCurr == '-');
+		++m_pCurr;
+	}
+
+	// Integer and fraction digits into a single mantissa
+	TUInt64 iMantissa = 0;
+	TInt32  iNumDigits = 0;
+	TInt32  iExponent = 0;
+	bool    bAnyDigits = false;
+	while (m_pCurr != m_pEnd && IsDigit( *m_pCurr ))
+	{
+		iMantissa = iMantissa * 10 + (*m_pCurr - '0');
+		if (iMantissa) ++iNumDigits;
+		bAnyDigits = true;
+		++m_pCurr;
+	}
+	if (m_pCurr != m_pEnd && *m_pCurr == '.')
+	{
+		++m_pCurr;
+		while (m_pCurr != m_pEnd && IsDigit( *m_pCurr ))
+		{
+			iMantissa = iMantissa * 10 + (*m_pCurr - '0');
+			if (iMantissa) ++iNumDigits;
+			--iExponent;
+			bAnyDigits = true;
+			++m_pCurr;
+		}
+	}
+	if (!bAnyDigits)
+	{
+		m_pCurr = pStart;
+		return false;
+	}
+
+	// Optional exponent
+	if (m_pCurr != m_pEnd && (*m_pCurr == 'e' || *m_pCurr == 'E'))
+	{
+		const char* pExponentStart = m_pCurr++;
+		bool bNegativeExp = false;
+		if (m_pCurr != m_pEnd && (*m_pCurr == '-' || *m_pCurr == '+'))
+		{
+			bNegativeExp = (*m_pCurr == '-');
+			++m_pCurr;
+		}
+		if (m_pCurr == m_pEnd || !IsDigit( *m_pCurr ))
+		{
+			m_pCurr = pExponentStart; // Not an exponent, leave for next token
+		}
+		else
+		{
+			TInt32 iExplicitExp = 0;
+			while (m_pCurr != m_pEnd && IsDigit( *m_pCurr ))
+			{
+				if (iExplicitExp < 10000) iExplicitExp = iExplicitExp * 10 + (*m_pCurr - '0');
+				++m_pCurr;
+			}
+			iExponent += bNegativeExp ? -iExplicitExp : iExplicitExp;
+		}
+	}
+
+	// Fast path when mantissa and power of ten are both exact doubles
+	TFloat64 fValue;
+	if (iNumDigits <= 15 && iExponent >= -kiMaxExactPower && iExponent <= kiMaxExactPower)
+	{
+		fValue = static_cast<TFloat64>(iMantissa);
+		if (iExponent < 0)
+		{
+			fValue /= kafPowersOf10[-iExponent];
+		}
+		else
+		{
+			fValue *= kafPowersOf10[iExponent];
+		}
+		if (bNegative) fValue = -fValue;
+	}
+	else
+	{
+		// Rare case - strtod needs a terminated string, so copy the token out
+		string sToken( pStart, m_pCurr );
+		fValue = strtod( sToken.c_str(), 0 );
+	}
+
+	*pfValue = static_cast<TFloat32>(fValue);
+	return true;
+
+	GEN_ENDGUARD_OPT;
+}
+
+// Read a number of floating point values into consecutive memory, e.g. a vector or matrix
+bool CXFileTokeniser::ReadFloats
+(
+	TFloat32*     pfValues,
+	const TUInt32 iCount
+)
+{
+	GEN_GUARD_OPT;
+
+	for (TUInt32 i = 0; i < iCount; ++i)
+	{
+		if (!ReadFloat( &pfValues[i] ))
+		{
+			return false;
+		}
+	}
+	return true;
+
+	GEN_ENDGUARD_OPT;
+}
+
+// Read a quoted string
+bool CXFileTokeniser::ReadString
+(
+	string* psValue
+)
+{
+	GEN_GUARD;
+
+	SkipSeparators();
+	if (m_pCurr == m_pEnd || *m_pCurr != '"')
+	{
+		return false;
+	}
+	++m_pCurr;
+
+	const char* pStringEnd = static_cast<const char*>(memchr( m_pCurr, '"', m_pEnd - m_pCurr ));
+	if (!pStringEnd)
+	{
+		return false;
+	}
+	psValue->assign( m_pCurr, pStringEnd );
+	m_pCurr = pStringEnd + 1;
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Private functions
+-----------------------------------------------------------------------------------------*/
+
+// Skip white space, separators and comments. Called before every token
+void CXFileTokeniser::SkipSeparators()
+{
+	while (m_pCurr != m_pEnd)
+	{
+		const char c = *m_pCurr;
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == ';')
+		{
+			++m_pCurr;
+		}
+		else if (c == '#' || (c == '/' && m_pCurr + 1 != m_pEnd && m_pCurr[1] == '/'))
+		{
+			const char* pLineEnd = static_cast<const char*>(memchr( m_pCurr, '\n', m_pEnd - m_pCurr ));
+			m_pCurr = pLineEnd ? pLineEnd + 1 : m_pEnd;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+// Read a name or template type identifier
+bool CXFileTokeniser::ReadIdentifier
+(
+	string* psName
+)
+{
+	SkipSeparators();
+	if (m_pCurr == m_pEnd || !IsIdentifierStart( *m_pCurr ))
+	{
+		return false;
+	}
+
+	const char* pStart = m_pCurr;
+	do
+	{
+		++m_pCurr;
+	} while (m_pCurr != m_pEnd && IsIdentifierChar( *m_pCurr ));
+
+	psName->assign( pStart, m_pCurr );
+	return true;
+}
+
+
+} // namespace gen
@@ -0,0 +1,183 @@
+/**************************************************************************************************
+	Module:       CXFileTokeniser.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Tokeniser for Microsoft DirectX text .X files ("xof 0303txt"), works in a single pass over a
+	memory buffer with no platform dependencies
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26 - Replaces the ID3DXFile API used by CImportXFile
+**************************************************************************************************/
+
+#ifndef GEN_C_XFILE_TOKENISER_H_INCLUDED
+#define GEN_C_XFILE_TOKENISER_H_INCLUDED
+
+#include <string>
+using namespace std;
+
+#include "GenDefines.h"
+
+namespace gen
+{
+
+// Reads the tokens of a text X-file from a memory buffer. The buffer is not copied and must stay
+// valid while the tokeniser is in use. X-file separators (',' and ';') are treated the same as
+// white space - the data layout is known from the template being read so they carry no extra
+// information. Comments ('//' or '#' to end of line) are skipped. All read functions return false
+// on unexpected or malformed data and never read beyond the end of the buffer
+class CXFileTokeniser
+{
+	GEN_CLASS( CXFileTokeniser )
+
+/*-----------------------------------------------------------------------------------------
+	Constructors/Destructors
+-----------------------------------------------------------------------------------------*/
+public:
+	// Constructor takes the buffer to tokenise
+	CXFileTokeniser
+	(
+		const TUInt8* pData,
+		const TUInt32 iSize
+	) : m_pCurr( reinterpret_cast<const char*>(pData) ),
+	    m_pEnd( reinterpret_cast<const char*>(pData) + iSize )
+	{
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CXFileTokeniser( const CXFileTokeniser& );
+	CXFileTokeniser& operator=( const CXFileTokeniser& );
+
+
+/*-----------------------------------------------------------------------------------------
+	Public interface
+-----------------------------------------------------------------------------------------*/
+public:
+
+	/////////////////////////////////////
+	// File header
+
+	// Read the 16 byte X-file header, e.g. "xof 0303txt 0032". Returns false if the header is
+	// invalid or the file is not in text format (binary and compressed X-files not supported)
+	bool ReadHeader();
+
+
+	/////////////////////////////////////
+	// Objects
+
+	// Returns true if there are no more tokens in the buffer
+	bool AtEnd()
+	{
+		SkipSeparators();
+		return m_pCurr == m_pEnd;
+	}
+
+	// Returns true if the next token closes the current object ('}')
+	bool AtObjectEnd()
+	{
+		SkipSeparators();
+		return m_pCurr != m_pEnd && *m_pCurr == '}';
+	}
+
+	// Returns true if the next token is a reference to a named object, e.g. "{ MaterialName }"
+	bool AtReference()
+	{
+		SkipSeparators();
+		return m_pCurr != m_pEnd && *m_pCurr == '{';
+	}
+
+	// Read the start of a data object: template type, optional name, optional GUID and the
+	// opening brace, e.g. "Frame Frame_World {". The name is returned empty if not present
+	bool ReadObjectStart
+	(
+		string* psType,
+		string* psName
+	);
+
+	// Read the closing brace of the current data object
+	bool ReadObjectEnd();
+
+	// Skip the remainder of the current data object, including any nested objects, up to and
+	// including its closing brace. Used for templates and unsupported data
+	bool SkipObject();
+
+	// Read a reference to a named object, e.g. "{ MaterialName }", returning the name
+	bool ReadReference
+	(
+		string* psName
+	);
+
+
+	/////////////////////////////////////
+	// Data values
+
+	// Returns true if the remainder of the buffer is large enough to hold the given number of
+	// elements of the given number of values each - a value needs at least one digit and a
+	// separator. Used to validate element counts before sizing arrays from them
+	bool CanContain
+	(
+		const TUInt32 iNumElements,
+		const TUInt32 iValuesPerElement
+	) const
+	{
+		return static_cast<TUInt64>(iNumElements) * iValuesPerElement * 2 <=
+		       static_cast<TUInt64>(m_pEnd - m_pCurr);
+	}
+
+	// Read an unsigned integer (DWORD / WORD in X-file templates)
+	bool ReadUInt
+	(
+		TUInt32* piValue
+	);
+
+	// Read a floating point value
+	bool ReadFloat
+	(
+		TFloat32* pfValue
+	);
+
+	// Read a number of floating point values into consecutive memory, e.g. a vector or matrix
+	bool ReadFloats
+	(
+		TFloat32*     pfValues,
+		const TUInt32 iCount
+	);
+
+	// Read a quoted string
+	bool ReadString
+	(
+		string* psValue
+	);
+
+
+/*-----------------------------------------------------------------------------------------
+	Private interface
+-----------------------------------------------------------------------------------------*/
+private:
+
+	// Skip white space, separators and comments. Called before every token
+	void SkipSeparators();
+
+	// Read a name or template type identifier
+	bool ReadIdentifier
+	(
+		string* psName
+	);
+
+
+	/*---------------------------------------------------------------------------------------------
+		Data
+	---------------------------------------------------------------------------------------------*/
+
+	// Current read position and end of buffer
+	const char* m_pCurr;
+	const char* m_pEnd;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_XFILE_TOKENISER_H_INCLUDED
@@ -8,8 +8,10 @@
 #ifndef GEN_COLOUR_H_INCLUDED
 #define GEN_COLOUR_H_INCLUDED
 
-#include <d3d10.h>
-#include <d3dx10.h>
+#if defined(_WIN32)
+	#include <d3d10.h>
+	#include <d3dx10.h>
+#endif
 
 #include "GenDefines.h"
 
@@ -33,6 +35,8 @@ struct SColourRGBA
 };
 
 
+#if defined(_WIN32)
+
 // Reinterpret a SColourRGBA as a D3DXCOLOR - in various forms (const & ptr)
 inline D3DXCOLOR& ToD3DXCOLOR( SColourRGBA& colour )
 {
@@ -44,6 +48,8 @@ inline const D3DXCOLOR& ToD3DXCOLOR( const SColourRGBA& colour )
 	return *reinterpret_cast<const D3DXCOLOR*>(&colour);
 }
 
+#endif // defined(_WIN32)
+
 
 } // namespace gen
 
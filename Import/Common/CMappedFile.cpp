@@ -0,0 +1,131 @@
+/**************************************************************************************************
+	Module:       CMappedFile.cpp
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Read-only memory mapped file - gives direct access to file contents without copying them
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include "CMappedFile.h"
+#include "Error.h"
+
+namespace gen
+{
+
+// Open and map the given file, closing any file already open. Returns false if the file cannot
+// be opened, is empty or cannot be mapped
+bool CMappedFile::Open
+(
+	const string& sFileName
+)
+{
+	GEN_GUARD;
+
+	Close();
+	if (!sFileName.length())
+	{
+		return false;
+	}
+
+#if defined(_WIN32)
+	HANDLE hFile = CreateFileA( sFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+	                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	// Empty files and those over 4GB are not supported
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx( hFile, &fileSize ) || fileSize.QuadPart == 0 || fileSize.HighPart != 0)
+	{
+		CloseHandle( hFile );
+		return false;
+	}
+
+	// The view keeps the mapping alive, so both handles can be closed once it is created
+	HANDLE hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+	CloseHandle( hFile );
+	if (!hMapping)
+	{
+		return false;
+	}
+	void* pView = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+	CloseHandle( hMapping );
+	if (!pView)
+	{
+		return false;
+	}
+	m_pData = static_cast<const TUInt8*>(pView);
+	m_iSize = fileSize.LowPart;
+
+#else
+	int iFile = open( sFileName.c_str(), O_RDONLY );
+	if (iFile < 0)
+	{
+		return false;
+	}
+
+	// Empty files and those over 4GB are not supported
+	struct stat fileStat;
+	if (fstat( iFile, &fileStat ) != 0 || fileStat.st_size <= 0 ||
+	    static_cast<TUInt64>(fileStat.st_size) > 0xffffffffull)
+	{
+		close( iFile );
+		return false;
+	}
+
+	// The mapping stays valid after the file descriptor is closed
+	void* pView = mmap( 0, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, iFile, 0 );
+	close( iFile );
+	if (pView == MAP_FAILED)
+	{
+		return false;
+	}
+	madvise( pView, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL );
+	m_pData = static_cast<const TUInt8*>(pView);
+	m_iSize = static_cast<TUInt32>(fileStat.st_size);
+#endif
+
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+
+// Unmap and close the file, does nothing if no file is open
+void CMappedFile::Close()
+{
+	if (!m_pData)
+	{
+		return;
+	}
+
+#if defined(_WIN32)
+	UnmapViewOfFile( m_pData );
+#else
+	munmap( const_cast<TUInt8*>(m_pData), m_iSize );
+#endif
+
+	m_pData = 0;
+	m_iSize = 0;
+}
+
+
+} // namespace gen
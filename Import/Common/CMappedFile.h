@@ -0,0 +1,99 @@
+/**************************************************************************************************
+	Module:       CMappedFile.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Read-only memory mapped file - gives direct access to file contents without copying them
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#ifndef GEN_C_MAPPED_FILE_H_INCLUDED
+#define GEN_C_MAPPED_FILE_H_INCLUDED
+
+#include <string>
+using namespace std;
+
+#include "GenDefines.h"
+
+namespace gen
+{
+
+// Maps the entire contents of a file into memory for reading. The operating system pages the data
+// in on demand, so there is no read call and no copy into a separate buffer. The file data is
+// valid until the file is closed or the object destroyed. Uses file mappings on Windows and mmap
+// on POSIX systems
+class CMappedFile
+{
+	GEN_CLASS( CMappedFile )
+
+/*-----------------------------------------------------------------------------------------
+	Constructors/Destructors
+-----------------------------------------------------------------------------------------*/
+public:
+	// Default constructor - no file open
+	CMappedFile() : m_pData( 0 ), m_iSize( 0 ) {}
+
+	// Destructor closes the file if open
+	~CMappedFile()
+	{
+		Close();
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CMappedFile( const CMappedFile& );
+	CMappedFile& operator=( const CMappedFile& );
+
+
+/*-----------------------------------------------------------------------------------------
+	Public interface
+-----------------------------------------------------------------------------------------*/
+public:
+
+	// Open and map the given file, closing any file already open. Returns false if the file
+	// cannot be opened, is empty or cannot be mapped
+	bool Open
+	(
+		const string& sFileName
+	);
+
+	// Unmap and close the file, does nothing if no file is open
+	void Close();
+
+	// Returns true if a file is currently open and mapped
+	bool IsOpen() const
+	{
+		return m_pData != 0;
+	}
+
+	// Pointer to the mapped file contents, or 0 if no file open
+	const TUInt8* GetData() const
+	{
+		return m_pData;
+	}
+
+	// Size of the mapped file in bytes, or 0 if no file open
+	TUInt32 GetSize() const
+	{
+		return m_iSize;
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Data
+---------------------------------------------------------------------------------------------*/
+private:
+
+	// Start and size of mapped file contents
+	const TUInt8* m_pData;
+	TUInt32       m_iSize;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_MAPPED_FILE_H_INCLUDED
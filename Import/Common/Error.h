@@ -9,11 +9,14 @@
 
 	Change history:
 		V1.0    Created 04/08/05 - LN
+		V1.1    Guards pass out of memory exceptions through unchanged
 **************************************************************************************************/
 
 #ifndef GEN_ERROR_H_INCLUDED
 #define GEN_ERROR_H_INCLUDED
 
+#include <new>
+
 #include "GenDefines.h"
 #include "CFatalException.h"
 
@@ -54,7 +57,9 @@ namespace gen
 
 // Exception guards are macro code blocks for functions that catch all exceptions and rethrow
 // them as CFatalException types. These are repeatedly rethrown, generating a call stack, until
-// picked up and displayed when thrown into a sentry block (see below)
+// picked up and displayed when thrown into a sentry block (see below). Out of memory exceptions
+// (bad_alloc) are rethrown unchanged, so a function that can recover from them, e.g. by returning
+// kOutOfSystemMemory, can catch them from any depth of guarded calls
 
 // Start a guarded block with a GEN_GUARD statement
 #define GEN_GUARD\
@@ -64,6 +69,7 @@ namespace gen
 // Use GEN_CATCHGUARD as a catch all handler on an existing try block
 #define GEN_CATCHGUARD\
 	catch( gen::CFatalException& e ) { e.AppendToCallStack( __FUNCTION__, ObjectName() ); throw e; }\
+	catch( std::bad_alloc& ) { throw; }\
 	catch( ... ) { throw gen::CFatalException( __FILE__, __FUNCTION__, ObjectName() ); }
 
 // Finish a guarded block with a GEN_ENDGUARD statement
@@ -81,6 +87,9 @@ namespace gen
 	}\
 	catch( gen::CFatalException& e )\
 	{ e.AppendToCallStack( __FUNCTION__, ObjectName(), true ); e.Display(); exit( EXIT_FAILURE ); }\
+	catch( std::bad_alloc& )\
+	{ gen::CFatalException e( "Out of Memory", __FILE__, __LINE__ ); \
+	  e.AppendToCallStack( __FUNCTION__, ObjectName(), true ); e.Display(); exit( EXIT_FAILURE ); }\
 	catch( ... )\
 	{ gen::CFatalException e( "Unknown Exception", __FILE__, __LINE__ ); \
 	  e.AppendToCallStack( __FUNCTION__, ObjectName(), true ); e.Display(); exit( EXIT_FAILURE ); }
@@ -0,0 +1,50 @@
+/**************************************************************************************************
+	Module:       GCCDefines.cpp
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Utility functions for GCC / Clang platforms (Linux and other POSIX systems)
+
+	Copyright 2026, DirectX_Experiments contributors. Based on MSDefines.cpp, copyright 2005-2006
+	University of Central Lancashire and Laurent Noel
+
+	Change history:
+		V1.0    Created 17/10/26 - Portable import tools, mirrors MSDefines.cpp
+**************************************************************************************************/
+
+#if !defined(_MSC_VER) // Only compiled on non-Microsoft platforms, see MSDefines.cpp for those
+
+#include <stdio.h>
+
+#include "GenDefines.h"
+#include "Error.h"
+
+namespace gen
+{
+
+/*------------------------------------------------------------------------------------------------
+	OS-specific GUI support
+ ------------------------------------------------------------------------------------------------*/
+
+// No system message box on these platforms - message is written to stderr instead. Defaults to
+// having an OK button only, but can request Yes/No buttons. Return value is whether the Yes or OK
+// button was "pressed" - always true for OK, always false for Yes/No (no user to ask)
+bool SystemMessageBox
+(
+	const string& sMessage, // Main message to display
+	const string& sCaption, // Caption to display at top of box
+	const bool    bYesNo    // Display Yes and No buttons instead of OK
+)
+{
+	GEN_GUARD;
+
+	fprintf( stderr, "%s\n\n%s\n", sCaption.c_str(), sMessage.c_str() );
+	return !bYesNo;
+
+	GEN_ENDGUARD;
+}
+
+
+} // namespace gen
+
+#endif // !defined(_MSC_VER)
@@ -0,0 +1,95 @@
+/**************************************************************************************************
+	Module:       GCCDefines.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Utility functions for GCC / Clang platforms (Linux and other POSIX systems)
+
+	Copyright 2026, DirectX_Experiments contributors. Based on MSDefines.h, copyright 2005-2006
+	University of Central Lancashire and Laurent Noel
+
+	Change history:
+		V1.0    Created 17/10/26 - Portable import tools, mirrors MSDefines.h
+**************************************************************************************************/
+
+#ifndef GEN_GCC_DEFINES_H_INCLUDED
+#define GEN_GCC_DEFINES_H_INCLUDED
+
+#include <string>
+using namespace std;
+
+namespace gen
+{
+
+/*------------------------------------------------------------------------------------------------
+	Compiler settings
+ ------------------------------------------------------------------------------------------------*/
+
+// Check compiler options
+#if !defined(__EXCEPTIONS) && !defined(__cpp_exceptions)
+	#error "Bad compiler option: C++ exception handling must be enabled"
+#endif
+
+
+/*------------------------------------------------------------------------------------------------
+	Macros
+ ------------------------------------------------------------------------------------------------*/
+
+// Prefix to align a structure or class in memory to a multiple of the given amount
+#define GEN_ALIGN(a) __attribute__((aligned(a)))
+
+
+/*------------------------------------------------------------------------------------------------
+	Constants
+ ------------------------------------------------------------------------------------------------*/
+
+// Define compiler name
+#if defined(__clang__)
+	static const string ksCompiler = "Clang";
+#else
+	static const string ksCompiler = "GCC";
+#endif
+
+
+// String locale
+const string ksPathSeparator = "/";
+const string ksNewline = "\n";
+
+
+/*------------------------------------------------------------------------------------------------
+	Types
+ ------------------------------------------------------------------------------------------------*/
+
+// Typedefs for fixed size types
+typedef signed char        TInt8;
+typedef signed short       TInt16;
+typedef signed int         TInt32;
+typedef signed long long   TInt64;
+
+typedef unsigned char      TUInt8;
+typedef unsigned short     TUInt16;
+typedef unsigned int       TUInt32;
+typedef unsigned long long TUInt64;
+
+typedef float              TFloat32;
+typedef double             TFloat64;
+
+
+/*------------------------------------------------------------------------------------------------
+	GUI support
+ ------------------------------------------------------------------------------------------------*/
+
+// No system message box on these platforms - message is written to stderr instead. Defaults to
+// having an OK button only, but can request Yes/No buttons. Return value is whether the Yes or OK
+// button was "pressed" - always true for OK, always false for Yes/No (no user to ask)
+bool SystemMessageBox
+(
+	const string& sMessage,                       // Main message to display
+	const string& sCaption = "TL-Engine Extreme", // Caption to display at top of box
+	const bool    bYesNo = false                  // Display Yes and No buttons instead of OK
+);
+
+
+} // namespace gen
+
+#endif // GEN_GCC_DEFINES_H_INCLUDED
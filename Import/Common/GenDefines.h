@@ -20,8 +20,10 @@ using namespace std;
 // Include platform specific definitions
 #if defined (_MSC_VER)
 	#include "MSDefines.h" // _MSC_VER is only defined on Microsoft compilers
+#elif defined (__GNUC__)
+	#include "GCCDefines.h" // GCC and Clang (used for import tools on Linux)
 #else
-	#error "Unsupported OS/compiler - only Windows and Visual Studio supported at present"
+	#error "Unsupported OS/compiler - only Visual Studio, GCC and Clang supported at present"
 #endif
 
 namespace gen
@@ -32,7 +34,7 @@ namespace gen
  ------------------------------------------------------------------------------------------------*/
 
 // Define constant if we have IEC 559 (= IEEE 754) conformant floats (used in maths classes)
-#if defined(__STDC_IEC_559__) || defined(_MSC_VER) // Check for C99 constant or MS compiler
+#if defined(__STDC_IEC_559__) || defined(_MSC_VER) || defined(__GNUC__) // C99 constant or known compilers
 	#define IEC_559_FLOATS
 #endif
 
@@ -11,6 +11,8 @@
 		V1.0    Created 23/09/05 - LN
 **************************************************************************************************/
 
+#if defined(_MSC_VER) // Only compiled on Microsoft platforms, see GCCDefines.cpp for others
+
 #include <Windows.h>
 #include <AtlBase.h> // Used for string conversion macros (CA2CT below)
 
@@ -72,3 +74,5 @@ bool SystemMessageBox
 
 
 } // namespace gen
+
+#endif // defined(_MSC_VER)
@@ -70,13 +70,178 @@ enum ERoundingMethod
 };
 
 
+/*-----------------------------------------------------------------------------------------
+	Math precision
+-----------------------------------------------------------------------------------------*/
+// The TFloat32 versions of Sqrt, InvSqrt, Sin, Cos and SinCos below can use fast approximations
+// in place of the standard library. Define one of these in the project settings to select them:
+//     GEN_FAST_MATH      - errors of a few units in the last place (ulps)
+//     GEN_FAST_MATH_LOW  - relative errors of about 5e-6 for InvSqrt / Sqrt and absolute errors of
+//                          about 4e-5 for the trigonometry
+// Otherwise the exact (standard library) versions are used. A specific precision can also be
+// requested for a single call, e.g. InvSqrt<kMathLow>( x ). Whether the approximations are faster
+// depends on the platform: hardware square roots (SSE) are hard to beat, trigonometry is often
+// faster. MeasureMathPrecision (MathBenchmark.h) reports the errors and timings of each function
+// at each precision, check it before choosing
+//
+// The approximations use only float arithmetic with a fixed order of operations, so results are
+// identical on every platform and build (so long as the compiler doesn't fuse multiply-adds, which
+// the default MSVC /fp:precise doesn't do). The trigonometry is accurate for angles up to about
+// +/-10000 radians, InvSqrt requires x > 0 and Sqrt x >= 0
+
+enum EMathPrecision
+{
+	kMathExact, // Standard library functions
+	kMathHigh,  // Approximations with errors of a few ulps
+	kMathLow,   // Approximations with errors of about 1e-5 (see above)
+};
+
+// Precision used by the functions without an explicit precision
+#if defined(GEN_FAST_MATH_LOW)
+	const EMathPrecision keMathPrecision = kMathLow;
+#elif defined(GEN_FAST_MATH)
+	const EMathPrecision keMathPrecision = kMathHigh;
+#else
+	const EMathPrecision keMathPrecision = kMathExact;
+#endif
+
+
+// 1 / Sqrt at the given precision. Approximations start with an estimate from the bit pattern
+// of the float (halving the exponent), refined by Newton-Raphson iterations
+template <EMathPrecision ePrecision> inline TFloat32 InvSqrt( const TFloat32 x )
+{
+	if (ePrecision == kMathExact)
+	{
+		return 1.0f / sqrtf( x );
+	}
+
+	union { TFloat32 f; TInt32 i; } bits;
+	bits.f = x;
+	bits.i = 0x5f375a86 - (bits.i >> 1);
+	TFloat32 y = bits.f;
+	TFloat32 halfX = 0.5f * x;
+	y = y * (1.5f - halfX * y * y);
+	y = y * (1.5f - halfX * y * y);
+	if (ePrecision == kMathHigh)
+	{
+		y = y * (1.5f - halfX * y * y);
+	}
+	return y;
+}
+
+// Sqrt at the given precision. Approximations use x * InvSqrt( x )
+template <EMathPrecision ePrecision> inline TFloat32 Sqrt( const TFloat32 x )
+{
+	if (ePrecision == kMathExact)
+	{
+		return sqrtf( x );
+	}
+	return x * InvSqrt<ePrecision>( x );
+}
+
+
+// Reduce an angle to the range -pi/4 to pi/4, returning the quadrant q so that the angle was
+// reduced + q * pi/2. Pi/2 is split into three parts so each product with q is exact for
+// q < 8192 (Cody & Waite method)
+inline TInt32 ReduceAngle
+(
+	const TFloat32 x,
+	TFloat32*      pReduced
+)
+{
+	TInt32 quadrant = static_cast<TInt32>(x * (2.0f / kfPi) + (x >= 0.0f ? 0.5f : -0.5f));
+	TFloat32 q = static_cast<TFloat32>(quadrant);
+	*pReduced = ((x - q * 1.5703125f) - q * 4.837512969970703125e-4f) - q * 7.54978995489188216e-8f;
+	return quadrant;
+}
+
+// Sin and cos of angles from -pi/4 to pi/4 at the given (non-exact) precision, using polynomial
+// approximations (minimax polynomials for kMathHigh, Taylor series for kMathLow)
+template <EMathPrecision ePrecision> inline TFloat32 SinReduced( const TFloat32 r )
+{
+	TFloat32 r2 = r * r;
+	if (ePrecision == kMathLow)
+	{
+		return r + r * r2 * (-1.6666667e-1f + r2 * 8.3333333e-3f);
+	}
+	return r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+}
+template <EMathPrecision ePrecision> inline TFloat32 CosReduced( const TFloat32 r )
+{
+	TFloat32 r2 = r * r;
+	if (ePrecision == kMathLow)
+	{
+		return 1.0f - 0.5f * r2 + r2 * r2 * (4.1666667e-2f + r2 * -1.3888889e-3f);
+	}
+	return 1.0f - 0.5f * r2 +
+	       r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+}
+
+// Sin at the given precision
+template <EMathPrecision ePrecision> inline TFloat32 Sin( const TFloat32 x )
+{
+	if (ePrecision == kMathExact)
+	{
+		return sinf( x );
+	}
+	TFloat32 r;
+	TInt32 quadrant = ReduceAngle( x, &r );
+	TFloat32 result = (quadrant & 1) ? CosReduced<ePrecision>( r ) : SinReduced<ePrecision>( r );
+	return (quadrant & 2) ? -result : result;
+}
+
+// Cos at the given precision
+template <EMathPrecision ePrecision> inline TFloat32 Cos( const TFloat32 x )
+{
+	if (ePrecision == kMathExact)
+	{
+		return cosf( x );
+	}
+	TFloat32 r;
+	TInt32 quadrant = ReduceAngle( x, &r ) + 1; // Cos x = Sin (x + pi/2)
+	TFloat32 result = (quadrant & 1) ? CosReduced<ePrecision>( r ) : SinReduced<ePrecision>( r );
+	return (quadrant & 2) ? -result : result;
+}
+
+// Sin and cos at the given precision, approximations share the angle reduction
+template <EMathPrecision ePrecision> inline void SinCos
+(
+	const TFloat32 x,
+	TFloat32*      pSin,
+	TFloat32*      pCos
+)
+{
+	if (ePrecision == kMathExact)
+	{
+		*pSin = sinf( x );
+		*pCos = cosf( x );
+		return;
+	}
+	TFloat32 r;
+	TInt32 quadrant = ReduceAngle( x, &r );
+	TFloat32 s = SinReduced<ePrecision>( r );
+	TFloat32 c = CosReduced<ePrecision>( r );
+	switch (quadrant & 3)
+	{
+		case 0:  *pSin = s;  *pCos = c;  break;
+		case 1:  *pSin = c;  *pCos = -s; break;
+		case 2:  *pSin = -s; *pCos = -c; break;
+		default: *pSin = -c; *pCos = s;  break;
+	}
+}
+
+
 /*-----------------------------------------------------------------------------------------
 	Platform-specific basic operations
 -----------------------------------------------------------------------------------------*/
 // Many versions provided here to allow mixing of parameter types for these basic functions
 
 inline TUInt32 Abs( const TInt32 x ) { return abs( static_cast<int>(x) ); }
+#if defined(_MSC_VER)
 inline TUInt64 Abs( const TInt64 x ) { return _abs64( x ); }
+#else
+inline TUInt64 Abs( const TInt64 x ) { return llabs( x ); }
+#endif
 inline TFloat32 Abs( const TFloat32 x ) { return fabsf( x ); }
 inline TFloat64 Abs( const TFloat64 x ) { return fabs( x ); }
 
@@ -104,7 +269,7 @@ inline TFloat64 Floor( const TFloat64 x ) { return floor( x ); }
 inline TFloat32 Ceil( const TFloat32 x ) { return ceilf( x ); }
 inline TFloat64 Ceil( const TFloat64 x ) { return ceil( x ); }
 
-inline TFloat32 Sqrt( const TFloat32 x ) { return sqrtf( x ); }
+inline TFloat32 Sqrt( const TFloat32 x ) { return Sqrt<keMathPrecision>( x ); }
 inline TFloat64 Sqrt( const TFloat64 x ) { return sqrt( x ); }
 inline TFloat32 Sqrt( const TInt32 x ) { return Sqrt( static_cast<TFloat32>(x) ); }
 inline TFloat64 Sqrt( const TInt64 x ) { return Sqrt( static_cast<TFloat64>(x) ); }
@@ -130,9 +295,9 @@ inline TFloat64 Pow( const TInt64 x, const TInt64 y ) { return Pow( static_cast<
 inline TFloat64 Pow( const TInt32 x, const TInt64 y ) { return Pow( static_cast<TFloat64>(x), y ); }
 inline TFloat64 Pow( const TInt64 x, const TInt32 y ) { return Pow( x, static_cast<TFloat64>(y) ); }
 
-inline TFloat32 Sin( const TFloat32 x ) { return sinf( x ); }
+inline TFloat32 Sin( const TFloat32 x ) { return Sin<keMathPrecision>( x ); }
 inline TFloat64 Sin( const TFloat64 x ) { return sin( x ); }
-inline TFloat32 Cos( const TFloat32 x ) { return cosf( x ); }
+inline TFloat32 Cos( const TFloat32 x ) { return Cos<keMathPrecision>( x ); }
 inline TFloat64 Cos( const TFloat64 x ) { return cos( x ); }
 inline TFloat32 Tan( const TFloat32 x ) { return tanf( x ); }
 inline TFloat64 Tan( const TFloat64 x ) { return tan( x ); }
@@ -159,7 +324,7 @@ inline TFloat32 InvSqrt( const TFloat32 x )
 	GEN_GUARD_OPT;
 	GEN_ASSERT_OPT( x != 0.0f, "Invalid parameter" );
 
-	return 1.0f / Sqrt( x );
+	return InvSqrt<keMathPrecision>( x );
 
 	GEN_ENDGUARD_OPT;
 }
@@ -190,8 +355,7 @@ inline void SinCos
 	TFloat32* pCos
 )
 {
-    *pSin = Sin( x );
-    *pCos = Cos( x );
+	SinCos<keMathPrecision>( x, pSin, pCos );
 }
 
 // Get both sin and cos of x, more efficient than calling functions seperately
@@ -23,10 +23,109 @@
 #include "CMatrix2x2.h"
 #include "CMatrix3x3.h"
 #include "CQuaternion.h"
+#include "MathSIMD.h"
 
 namespace gen
 {
 
+#if defined(GEN_SIMD_SSE)
+
+/*-----------------------------------------------------------------------------------------
+	SIMD helpers
+-----------------------------------------------------------------------------------------*/
+
+namespace
+{
+	// Return the given row vector (four elements) multiplied by the matrix with the given rows.
+	// Sums are made in the same order as the scalar code
+	inline __m128 SIMDRowTransform
+	(
+		const __m128 v,
+		const __m128 r0,
+		const __m128 r1,
+		const __m128 r2,
+		const __m128 r3
+	)
+	{
+		__m128 vOut = _mm_mul_ps( SIMDSplat<0>( v ), r0 );
+		vOut = _mm_add_ps( vOut, _mm_mul_ps( SIMDSplat<1>( v ), r1 ) );
+		vOut = _mm_add_ps( vOut, _mm_mul_ps( SIMDSplat<2>( v ), r2 ) );
+		return _mm_add_ps( vOut, _mm_mul_ps( SIMDSplat<3>( v ), r3 ) );
+	}
+
+	// As above, but using only the first three elements of the row vector and the first three
+	// rows of the matrix (i.e. the upper-left 3x3 matrix of an affine matrix)
+	inline __m128 SIMDRowTransform3x3
+	(
+		const __m128 v,
+		const __m128 r0,
+		const __m128 r1,
+		const __m128 r2
+	)
+	{
+		__m128 vOut = _mm_mul_ps( SIMDSplat<0>( v ), r0 );
+		vOut = _mm_add_ps( vOut, _mm_mul_ps( SIMDSplat<1>( v ), r1 ) );
+		return _mm_add_ps( vOut, _mm_mul_ps( SIMDSplat<2>( v ), r2 ) );
+	}
+
+	// Return cross product of the x, y & z elements of two vectors, w element is 0 if both w
+	// elements are finite
+	inline __m128 SIMDCross
+	(
+		const __m128 v1,
+		const __m128 v2
+	)
+	{
+		__m128 v1YZX = _mm_shuffle_ps( v1, v1, _MM_SHUFFLE(3, 0, 2, 1) );
+		__m128 v2YZX = _mm_shuffle_ps( v2, v2, _MM_SHUFFLE(3, 0, 2, 1) );
+		__m128 vOut = _mm_sub_ps( _mm_mul_ps( v1, v2YZX ), _mm_mul_ps( v1YZX, v2 ) );
+		return _mm_shuffle_ps( vOut, vOut, _MM_SHUFFLE(3, 0, 2, 1) );
+	}
+
+	// 2x2 matrix operations for the block-wise general inverse. Each 2x2 matrix is held in one
+	// vector as (m00, m01, m10, m11). The adjugate of a 2x2 matrix A is written A#
+
+	// Return A*B
+	inline __m128 SIMDMat2Mul
+	(
+		const __m128 a,
+		const __m128 b
+	)
+	{
+		return _mm_add_ps( _mm_mul_ps( a, _mm_shuffle_ps( b, b, _MM_SHUFFLE(3, 0, 3, 0) ) ),
+		                   _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 3, 0, 1) ),
+		                               _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 2, 1, 2) ) ) );
+	}
+
+	// Return A#*B
+	inline __m128 SIMDMat2AdjMul
+	(
+		const __m128 a,
+		const __m128 b
+	)
+	{
+		return _mm_sub_ps( _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(0, 0, 3, 3) ), b ),
+		                   _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 2, 1, 1) ),
+		                               _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 0, 3, 2) ) ) );
+	}
+
+	// Return A*B#
+	inline __m128 SIMDMat2MulAdj
+	(
+		const __m128 a,
+		const __m128 b
+	)
+	{
+		return _mm_sub_ps( _mm_mul_ps( a, _mm_shuffle_ps( b, b, _MM_SHUFFLE(0, 3, 0, 3) ) ),
+		                   _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 3, 0, 1) ),
+		                               _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 2, 1, 2) ) ) );
+	}
+
+} // anonymous namespace
+
+#endif // GEN_SIMD_SSE
+
+
 /*-----------------------------------------------------------------------------------------
 	Constructors/Destructors
 -----------------------------------------------------------------------------------------*/
@@ -1875,6 +1974,55 @@ void CMatrix4x4::InvertAffine()
 
 // Return the inverse of given matrix assuming only that it is an affine matrix
 CMatrix4x4 InverseAffine( const CMatrix4x4& m )
+{
+#if defined(GEN_SIMD_SSE)
+	GEN_GUARD;
+
+	__m128 r0 = SIMDLoad( &m.e00 );
+	__m128 r1 = SIMDLoad( &m.e10 );
+	__m128 r2 = SIMDLoad( &m.e20 );
+	__m128 r3 = SIMDLoad( &m.e30 );
+
+	// The columns of the inverse of the upper left 3x3 are cross products of its rows divided by
+	// the determinant. Clear the w elements first so the cross products have w = 0
+	const __m128 maskXYZ = SIMDMaskXYZ();
+	r0 = _mm_and_ps( r0, maskXYZ );
+	r1 = _mm_and_ps( r1, maskXYZ );
+	r2 = _mm_and_ps( r2, maskXYZ );
+	__m128 c0 = SIMDCross( r1, r2 );
+	__m128 c1 = SIMDCross( r2, r0 );
+	__m128 c2 = SIMDCross( r0, r1 );
+	__m128 det = _mm_mul_ps( r0, c0 );
+	det = _mm_add_ps( _mm_add_ps( SIMDSplat<0>( det ), SIMDSplat<1>( det ) ), SIMDSplat<2>( det ) );
+	GEN_ASSERT( !IsZero(_mm_cvtss_f32( det )), "Singular matrix" );
+	__m128 invDet = _mm_div_ps( _mm_set1_ps( 1.0f ), det );
+	c0 = _mm_mul_ps( c0, invDet );
+	c1 = _mm_mul_ps( c1, invDet );
+	c2 = _mm_mul_ps( c2, invDet );
+
+	// Transpose columns to rows, the fourth column becomes the zero right column of the result
+	__m128 c3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+
+	// Transform negative translation by inverted 3x3 to get inverse translation
+	r3 = _mm_sub_ps( _mm_setzero_ps(), _mm_and_ps( r3, maskXYZ ) );
+	r3 = SIMDRowTransform3x3( r3, c0, c1, c2 );
+
+	CMatrix4x4 mOut;
+	SIMDStore( &mOut.e00, c0 );
+	SIMDStore( &mOut.e10, c1 );
+	SIMDStore( &mOut.e20, c2 );
+	SIMDStore( &mOut.e30, _mm_or_ps( _mm_and_ps( r3, maskXYZ ), _mm_set_ps( 1.0f, 0.0f, 0.0f, 0.0f ) ) );
+	return mOut;
+
+	GEN_ENDGUARD;
+#else
+	return InverseAffineScalar( m );
+#endif
+}
+
+// Return the inverse of given matrix assuming only that it is an affine matrix - scalar version
+CMatrix4x4 InverseAffineScalar( const CMatrix4x4& m )
 {
 	GEN_GUARD;
 
@@ -1970,6 +2118,68 @@ void CMatrix4x4::Invert()
 // Return the inverse of given matrix. Most general, least efficient inverse function
 // Suitable for non-affine matrices (e.g. a perspective projection matrix)
 CMatrix4x4 Inverse( const CMatrix4x4& m )
+{
+#if defined(GEN_SIMD_SSE)
+	GEN_GUARD;
+
+	// Block-wise inverse: the matrix is split into 2x2 matrices  | A B |, then the inverse is
+	//                                                             | C D |
+	// (1/det) * | X Y | with X# = |D|A - B(D#C), Y# = |B|C - D(A#B)#, Z# = |C|B - A(D#C)#,
+	//           | Z W |      W# = |A|D - C(A#B) and det = |A||D| + |B||C| - trace((A#B)(D#C))
+	__m128 r0 = SIMDLoad( &m.e00 );
+	__m128 r1 = SIMDLoad( &m.e10 );
+	__m128 r2 = SIMDLoad( &m.e20 );
+	__m128 r3 = SIMDLoad( &m.e30 );
+	__m128 a = _mm_movelh_ps( r0, r1 );
+	__m128 b = _mm_movehl_ps( r1, r0 );
+	__m128 c = _mm_movelh_ps( r2, r3 );
+	__m128 d = _mm_movehl_ps( r3, r2 );
+
+	// Determinants of the 2x2 matrices as (|A|, |B|, |C|, |D|)
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps( _mm_shuffle_ps( r0, r2, _MM_SHUFFLE(2, 0, 2, 0) ),
+		            _mm_shuffle_ps( r1, r3, _MM_SHUFFLE(3, 1, 3, 1) ) ),
+		_mm_mul_ps( _mm_shuffle_ps( r0, r2, _MM_SHUFFLE(3, 1, 3, 1) ),
+		            _mm_shuffle_ps( r1, r3, _MM_SHUFFLE(2, 0, 2, 0) ) ) );
+	__m128 detA = SIMDSplat<0>( detSub );
+	__m128 detB = SIMDSplat<1>( detSub );
+	__m128 detC = SIMDSplat<2>( detSub );
+	__m128 detD = SIMDSplat<3>( detSub );
+
+	__m128 dAdjC = SIMDMat2AdjMul( d, c );
+	__m128 aAdjB = SIMDMat2AdjMul( a, b );
+	__m128 x = _mm_sub_ps( _mm_mul_ps( detD, a ), SIMDMat2Mul( b, dAdjC ) );
+	__m128 w = _mm_sub_ps( _mm_mul_ps( detA, d ), SIMDMat2Mul( c, aAdjB ) );
+	__m128 y = _mm_sub_ps( _mm_mul_ps( detB, c ), SIMDMat2MulAdj( d, aAdjB ) );
+	__m128 z = _mm_sub_ps( _mm_mul_ps( detC, b ), SIMDMat2MulAdj( a, dAdjC ) );
+
+	__m128 trace = SIMDSum( _mm_mul_ps( aAdjB, _mm_shuffle_ps( dAdjC, dAdjC, _MM_SHUFFLE(3, 1, 2, 0) ) ) );
+	__m128 det = _mm_sub_ps( _mm_add_ps( _mm_mul_ps( detA, detD ), _mm_mul_ps( detB, detC ) ), trace );
+	GEN_ASSERT( !IsZero(_mm_cvtss_f32( det )), "Singular matrix" );
+
+	// Scale by 1/det, with the signs needed to make the adjugates of X, Y, Z & W
+	__m128 invDet = _mm_div_ps( _mm_set_ps( 1.0f, -1.0f, -1.0f, 1.0f ), det );
+	x = _mm_mul_ps( x, invDet );
+	y = _mm_mul_ps( y, invDet );
+	z = _mm_mul_ps( z, invDet );
+	w = _mm_mul_ps( w, invDet );
+
+	// Reorder elements to complete the adjugates and build the rows of the result
+	CMatrix4x4 mOut;
+	SIMDStore( &mOut.e00, _mm_shuffle_ps( x, y, _MM_SHUFFLE(1, 3, 1, 3) ) );
+	SIMDStore( &mOut.e10, _mm_shuffle_ps( x, y, _MM_SHUFFLE(0, 2, 0, 2) ) );
+	SIMDStore( &mOut.e20, _mm_shuffle_ps( z, w, _MM_SHUFFLE(1, 3, 1, 3) ) );
+	SIMDStore( &mOut.e30, _mm_shuffle_ps( z, w, _MM_SHUFFLE(0, 2, 0, 2) ) );
+	return mOut;
+
+	GEN_ENDGUARD;
+#else
+	return InverseScalar( m );
+#endif
+}
+
+// Return the inverse of given matrix using cofactors - scalar version
+CMatrix4x4 InverseScalar( const CMatrix4x4& m )
 {
 	GEN_GUARD;
 
@@ -3115,13 +3325,7 @@ CVector4 operator*
 	const CMatrix4x4& m
 )
 {
-    CVector4 vOut;
-    vOut.x = v.x*m.e00 + v.y*m.e10 + v.z*m.e20 + v.w*m.e30;
-    vOut.y = v.x*m.e01 + v.y*m.e11 + v.z*m.e21 + v.w*m.e31;
-    vOut.z = v.x*m.e02 + v.y*m.e12 + v.z*m.e22 + v.w*m.e32;
-    vOut.w = v.x*m.e03 + v.y*m.e13 + v.z*m.e23 + v.w*m.e33;
-
-    return vOut;
+	return m.Transform( v );
 }
 
 // Matrix-vector multiplication (order is important - this is an unusual order for matrices
@@ -3145,35 +3349,92 @@ CVector4 operator*
 // Return the given vector transformed by this matrix (pre-multiplication: V' = V*M)
 CVector4 CMatrix4x4::Transform(	const CVector4& v ) const
 {
+#if defined(GEN_SIMD_SSE)
 	CVector4 vOut;
-	vOut.x = v.x*e00 + v.y*e10 + v.z*e20 + v.w*e30;
-	vOut.y = v.x*e01 + v.y*e11 + v.z*e21 + v.w*e31;
-	vOut.z = v.x*e02 + v.y*e12 + v.z*e22 + v.w*e32;
-	vOut.w = v.x*e03 + v.y*e13 + v.z*e23 + v.w*e33;
-
+	SIMDStore( &vOut.x, SIMDRowTransform( SIMDLoad( &v.x ), SIMDLoad( &e00 ), SIMDLoad( &e10 ),
+	                                      SIMDLoad( &e20 ), SIMDLoad( &e30 ) ) );
 	return vOut;
+#else
+	return TransformScalar( *this, v );
+#endif
 }
 
 // Return the given CVector3 transformed by this matrix (pre-multiplication: V' = V*M)
 // Assuming it is a vector rather then a point, i.e. assume the vector's 4th element is 0
 CVector3 CMatrix4x4::TransformVector( const CVector3& v ) const
 {
-	CVector3 vOut;
-	vOut.x = v.x*e00 + v.y*e10 + v.z*e20;
-	vOut.y = v.x*e01 + v.y*e11 + v.z*e21;
-	vOut.z = v.x*e02 + v.y*e12 + v.z*e22;
-
-	return vOut;
+#if defined(GEN_SIMD_SSE)
+	__m128 vOut = _mm_mul_ps( _mm_set1_ps( v.x ), SIMDLoad( &e00 ) );
+	vOut = _mm_add_ps( vOut, _mm_mul_ps( _mm_set1_ps( v.y ), SIMDLoad( &e10 ) ) );
+	vOut = _mm_add_ps( vOut, _mm_mul_ps( _mm_set1_ps( v.z ), SIMDLoad( &e20 ) ) );
+	TFloat32 afOut[4];
+	SIMDStore( afOut, vOut );
+	return CVector3( afOut[0], afOut[1], afOut[2] );
+#else
+	return TransformVectorScalar( *this, v );
+#endif
 }
 
 // Return the given CVector3 transformed by this matrix (pre-multiplication: V' = V*M)
 // Assuming it is a point rather then a vector, i.e. assume the vector's 4th element is 1
 CVector3 CMatrix4x4::TransformPoint( const CVector3& p ) const
+{
+#if defined(GEN_SIMD_SSE)
+	__m128 pOut = _mm_mul_ps( _mm_set1_ps( p.x ), SIMDLoad( &e00 ) );
+	pOut = _mm_add_ps( pOut, _mm_mul_ps( _mm_set1_ps( p.y ), SIMDLoad( &e10 ) ) );
+	pOut = _mm_add_ps( pOut, _mm_mul_ps( _mm_set1_ps( p.z ), SIMDLoad( &e20 ) ) );
+	pOut = _mm_add_ps( pOut, SIMDLoad( &e30 ) );
+	TFloat32 afOut[4];
+	SIMDStore( afOut, pOut );
+	return CVector3( afOut[0], afOut[1], afOut[2] );
+#else
+	return TransformPointScalar( *this, p );
+#endif
+}
+
+
+// Vector-matrix multiplication, same as CMatrix4x4::Transform - scalar version
+CVector4 TransformScalar
+(
+	const CMatrix4x4& m,
+	const CVector4&   v
+)
+{
+	CVector4 vOut;
+	vOut.x = v.x*m.e00 + v.y*m.e10 + v.z*m.e20 + v.w*m.e30;
+	vOut.y = v.x*m.e01 + v.y*m.e11 + v.z*m.e21 + v.w*m.e31;
+	vOut.z = v.x*m.e02 + v.y*m.e12 + v.z*m.e22 + v.w*m.e32;
+	vOut.w = v.x*m.e03 + v.y*m.e13 + v.z*m.e23 + v.w*m.e33;
+
+	return vOut;
+}
+
+// Vector-matrix multiplication, same as CMatrix4x4::TransformVector - scalar version
+CVector3 TransformVectorScalar
+(
+	const CMatrix4x4& m,
+	const CVector3&   v
+)
+{
+	CVector3 vOut;
+	vOut.x = v.x*m.e00 + v.y*m.e10 + v.z*m.e20;
+	vOut.y = v.x*m.e01 + v.y*m.e11 + v.z*m.e21;
+	vOut.z = v.x*m.e02 + v.y*m.e12 + v.z*m.e22;
+
+	return vOut;
+}
+
+// Point-matrix multiplication, same as CMatrix4x4::TransformPoint - scalar version
+CVector3 TransformPointScalar
+(
+	const CMatrix4x4& m,
+	const CVector3&   p
+)
 {
 	CVector3 pOut;
-	pOut.x = p.x*e00 + p.y*e10 + p.z*e20 + e30;
-	pOut.y = p.x*e01 + p.y*e11 + p.z*e21 + e31;
-	pOut.z = p.x*e02 + p.y*e12 + p.z*e22 + e32;
+	pOut.x = p.x*m.e00 + p.y*m.e10 + p.z*m.e20 + m.e30;
+	pOut.y = p.x*m.e01 + p.y*m.e11 + p.z*m.e21 + m.e31;
+	pOut.z = p.x*m.e02 + p.y*m.e12 + p.z*m.e22 + m.e32;
 
 	return pOut;
 }
@@ -3185,6 +3446,10 @@ CVector3 CMatrix4x4::TransformPoint( const CVector3& p ) const
 // Post-multiply this matrix by the given one
 CMatrix4x4& CMatrix4x4::operator*=( const CMatrix4x4& m )
 {
+#if defined(GEN_SIMD_SSE)
+	// SIMD version reads both matrices fully before writing, so no special case for self
+	*this = *this * m;
+#else
 	if ( this == &m )
 	{
 		// Special case of multiplying by self - no copy optimisations so use binary version
@@ -3226,6 +3491,7 @@ CMatrix4x4& CMatrix4x4::operator*=( const CMatrix4x4& m )
 		e31 = t1;
 		e32 = t2;
 	}
+#endif
 	return *this;
 }
 
@@ -3236,6 +3502,46 @@ CMatrix4x4 operator*
 	const CMatrix4x4& m1,
 	const CMatrix4x4& m2
 )
+{
+#if defined(GEN_SIMD_AVX)
+	// Two rows of the result at once: each half of a 256-bit register holds a row of m1 / result
+	__m256 r01 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>(&m2.e00) );
+	__m256 r11 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>(&m2.e10) );
+	__m256 r21 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>(&m2.e20) );
+	__m256 r31 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>(&m2.e30) );
+	CMatrix4x4 mOut;
+	for (TUInt32 iRow = 0; iRow < 4; iRow += 2)
+	{
+		__m256 rows = _mm256_loadu_ps( &m1.e00 + iRow * 4 );
+		__m256 rowsOut = _mm256_mul_ps( _mm256_shuffle_ps( rows, rows, _MM_SHUFFLE(0, 0, 0, 0) ), r01 );
+		rowsOut = _mm256_add_ps( rowsOut, _mm256_mul_ps( _mm256_shuffle_ps( rows, rows, _MM_SHUFFLE(1, 1, 1, 1) ), r11 ) );
+		rowsOut = _mm256_add_ps( rowsOut, _mm256_mul_ps( _mm256_shuffle_ps( rows, rows, _MM_SHUFFLE(2, 2, 2, 2) ), r21 ) );
+		rowsOut = _mm256_add_ps( rowsOut, _mm256_mul_ps( _mm256_shuffle_ps( rows, rows, _MM_SHUFFLE(3, 3, 3, 3) ), r31 ) );
+		_mm256_storeu_ps( &mOut.e00 + iRow * 4, rowsOut );
+	}
+	return mOut;
+#elif defined(GEN_SIMD_SSE)
+	__m128 r0 = SIMDLoad( &m2.e00 );
+	__m128 r1 = SIMDLoad( &m2.e10 );
+	__m128 r2 = SIMDLoad( &m2.e20 );
+	__m128 r3 = SIMDLoad( &m2.e30 );
+	CMatrix4x4 mOut;
+	SIMDStore( &mOut.e00, SIMDRowTransform( SIMDLoad( &m1.e00 ), r0, r1, r2, r3 ) );
+	SIMDStore( &mOut.e10, SIMDRowTransform( SIMDLoad( &m1.e10 ), r0, r1, r2, r3 ) );
+	SIMDStore( &mOut.e20, SIMDRowTransform( SIMDLoad( &m1.e20 ), r0, r1, r2, r3 ) );
+	SIMDStore( &mOut.e30, SIMDRowTransform( SIMDLoad( &m1.e30 ), r0, r1, r2, r3 ) );
+	return mOut;
+#else
+	return MultiplyScalar( m1, m2 );
+#endif
+}
+
+// General matrix-matrix multiplication - scalar version
+CMatrix4x4 MultiplyScalar
+(
+	const CMatrix4x4& m1,
+	const CMatrix4x4& m2
+)
 {
 	CMatrix4x4 mOut;
 
@@ -3266,6 +3572,10 @@ CMatrix4x4 operator*
 // Post-multiply this matrix by the given one assuming they are both affine
 CMatrix4x4& CMatrix4x4::MultiplyAffine( const CMatrix4x4& m )
 {
+#if defined(GEN_SIMD_SSE)
+	// SIMD version reads both matrices fully before writing, so no special case for self
+	*this = gen::MultiplyAffine( *this, m );
+#else
 	if ( this == &m )
 	{
 		// Special case of multiplying by self - no copy optimisations so use binary version
@@ -3299,6 +3609,7 @@ CMatrix4x4& CMatrix4x4::MultiplyAffine( const CMatrix4x4& m )
 		e30 = t0;
 		e31 = t1;
 	}
+#endif
 
 	return *this;
 }
@@ -3309,6 +3620,31 @@ CMatrix4x4 MultiplyAffine
 	const CMatrix4x4& m1,
 	const CMatrix4x4& m2
 )
+{
+#if defined(GEN_SIMD_SSE)
+	// Right column of the result is forced to (0,0,0,1) as the matrices are assumed affine
+	const __m128 maskXYZ = SIMDMaskXYZ();
+	__m128 r0 = SIMDLoad( &m2.e00 );
+	__m128 r1 = SIMDLoad( &m2.e10 );
+	__m128 r2 = SIMDLoad( &m2.e20 );
+	CMatrix4x4 mOut;
+	SIMDStore( &mOut.e00, _mm_and_ps( SIMDRowTransform3x3( SIMDLoad( &m1.e00 ), r0, r1, r2 ), maskXYZ ) );
+	SIMDStore( &mOut.e10, _mm_and_ps( SIMDRowTransform3x3( SIMDLoad( &m1.e10 ), r0, r1, r2 ), maskXYZ ) );
+	SIMDStore( &mOut.e20, _mm_and_ps( SIMDRowTransform3x3( SIMDLoad( &m1.e20 ), r0, r1, r2 ), maskXYZ ) );
+	__m128 r3 = _mm_add_ps( SIMDRowTransform3x3( SIMDLoad( &m1.e30 ), r0, r1, r2 ), SIMDLoad( &m2.e30 ) );
+	SIMDStore( &mOut.e30, _mm_or_ps( _mm_and_ps( r3, maskXYZ ), _mm_set_ps( 1.0f, 0.0f, 0.0f, 0.0f ) ) );
+	return mOut;
+#else
+	return MultiplyAffineScalar( m1, m2 );
+#endif
+}
+
+// Matrix-matrix multiplication assuming both matrices are affine - scalar version
+CMatrix4x4 MultiplyAffineScalar
+(
+	const CMatrix4x4& m1,
+	const CMatrix4x4& m2
+)
 {
 	CMatrix4x4 mOut;
 
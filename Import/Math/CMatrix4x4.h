@@ -48,6 +48,9 @@
 // - As the matrix is stored in rows, the [] operator is provided to returns CVector4/CVector3
 //   references to the actual matrix data. This is highly convenient/efficient but non-portable,
 //   i.e. the [] operator is not guaranteed to work on all compilers (though it will on most)
+// - Matrices are 16-byte aligned for SIMD access. Multiplication, transformation and inverse
+//   functions have SIMD implementations selected at compile time (see MathSIMD.h), the portable
+//   scalar versions are also available (see end of file)
 
 #ifndef GEN_C_MATRIX_4X4_H_INCLUDED
 #define GEN_C_MATRIX_4X4_H_INCLUDED
@@ -67,7 +70,7 @@ class CMatrix3x3;
 class CQuaternion;
 
 
-class CMatrix4x4
+class GEN_ALIGN(16) CMatrix4x4
 {
 	GEN_CLASS( CMatrix4x4 );
 
@@ -1346,7 +1349,9 @@ TFloat32 Cofactor
 );
 
 // Return the inverse of given matrix. Most general, least efficient inverse function.
-// Suitable for non-affine matrices (e.g. a perspective projection matrix)
+// Suitable for non-affine matrices (e.g. a perspective projection matrix). The SIMD version uses
+// a different method to the scalar one, elements of the results may differ by up to about 1e-5
+// (relative to the element where it is larger than 1)
 CMatrix4x4 Inverse( const CMatrix4x4& m );
 
 
@@ -1422,6 +1427,49 @@ CMatrix4x4 MatrixFaceDirection
 );
 
 
+/*-----------------------------------------------------------------------------------------
+	Scalar Implementations
+-----------------------------------------------------------------------------------------*/
+// Portable versions of the functions that have SIMD implementations (see MathSIMD.h). The
+// functions above use these when SIMD is unavailable or disabled. Available to test and
+// benchmark the SIMD versions
+
+// Vector-matrix multiplication, same as CMatrix4x4::Transform
+CVector4 TransformScalar
+(
+	const CMatrix4x4& m,
+	const CVector4&   v
+);
+
+// Point-matrix and vector-matrix multiplication, same as CMatrix4x4::TransformPoint/Vector
+CVector3 TransformPointScalar
+(
+	const CMatrix4x4& m,
+	const CVector3&   p
+);
+CVector3 TransformVectorScalar
+(
+	const CMatrix4x4& m,
+	const CVector3&   v
+);
+
+// General and affine matrix-matrix multiplication
+CMatrix4x4 MultiplyScalar
+(
+	const CMatrix4x4& m1,
+	const CMatrix4x4& m2
+);
+CMatrix4x4 MultiplyAffineScalar
+(
+	const CMatrix4x4& m1,
+	const CMatrix4x4& m2
+);
+
+// General and affine matrix inverse
+CMatrix4x4 InverseScalar( const CMatrix4x4& m );
+CMatrix4x4 InverseAffineScalar( const CMatrix4x4& m );
+
+
 } // namespace gen
 
 #endif // GEN_C_MATRIX_4X4_H_INCLUDED
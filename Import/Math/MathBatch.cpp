@@ -0,0 +1,1034 @@
+/**************************************************************************************************
+	Module:       MathBatch.cpp
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Batch maths operations - the same operation applied to whole arrays of vectors, quaternions
+	or transforms, using SIMD where available (see MathSIMD.h)
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#include <cstddef>
+#include <cstring>
+
+#include "MathBatch.h"
+#include "MathSIMD.h"
+#include "Error.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Local helpers
+-----------------------------------------------------------------------------------------*/
+
+namespace
+{
+	// Transform a single vector, same result as the SIMD kernels
+	inline CVector3 TransformOne
+	(
+		const CMatrix4x4&     m,
+		const EBatchTransform eTransform,
+		const CVector3&       v
+	)
+	{
+		if (eTransform == kBatchPoints)
+		{
+			return TransformPointScalar( m, v );
+		}
+		CVector3 vOut = TransformVectorScalar( m, v );
+		return (eTransform == kBatchNormals) ? Normalise( vOut ) : vOut;
+	}
+
+
+#if defined(GEN_SIMD_SSE)
+
+	//---------------------------------
+	// Arithmetic for both SSE and AVX registers, so the kernels can be written once
+
+	inline __m128 SIMDAdd( const __m128 a, const __m128 b ) { return _mm_add_ps( a, b ); }
+	inline __m128 SIMDSub( const __m128 a, const __m128 b ) { return _mm_sub_ps( a, b ); }
+	inline __m128 SIMDMul( const __m128 a, const __m128 b ) { return _mm_mul_ps( a, b ); }
+	inline __m128 SIMDDiv( const __m128 a, const __m128 b ) { return _mm_div_ps( a, b ); }
+	inline __m128 SIMDMin( const __m128 a, const __m128 b ) { return _mm_min_ps( a, b ); }
+	inline __m128 SIMDSqrt( const __m128 a ) { return _mm_sqrt_ps( a ); }
+	inline __m128 SIMDAbs( const __m128 a ) { return _mm_andnot_ps( _mm_set1_ps( -0.0f ), a ); }
+	inline __m128 SIMDZeroIfLess( const __m128 a, const __m128 b, const __m128 v )
+	{
+		return _mm_andnot_ps( _mm_cmplt_ps( a, b ), v );
+	}
+	inline __m128 SIMDNegateIfLess( const __m128 a, const __m128 b, const __m128 v )
+	{
+		return _mm_xor_ps( _mm_and_ps( _mm_cmplt_ps( a, b ), _mm_set1_ps( -0.0f ) ), v );
+	}
+	inline __m128 SIMDSelectIfLess( const __m128 a, const __m128 b, const __m128 vLess, const __m128 v )
+	{
+		__m128 mask = _mm_cmplt_ps( a, b );
+		return _mm_or_ps( _mm_and_ps( mask, vLess ), _mm_andnot_ps( mask, v ) );
+	}
+	inline void SIMDSet( const TFloat32 f, __m128* pOut ) { *pOut = _mm_set1_ps( f ); }
+
+	// 1 / Sqrt, using the same method as the scalar InvSqrt at the selected math precision (see
+	// BaseMath.h) so results match
+	inline __m128 SIMDInvSqrt( const __m128 x )
+	{
+		if (keMathPrecision == kMathExact)
+		{
+			return _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( x ) );
+		}
+
+		__m128i bits = _mm_sub_epi32( _mm_set1_epi32( 0x5f375a86 ), _mm_srai_epi32( _mm_castps_si128( x ), 1 ) );
+		__m128 y = _mm_castsi128_ps( bits );
+		__m128 halfX = _mm_mul_ps( _mm_set1_ps( 0.5f ), x );
+		__m128 threeHalves = _mm_set1_ps( 1.5f );
+		y = _mm_mul_ps( y, _mm_sub_ps( threeHalves, _mm_mul_ps( _mm_mul_ps( halfX, y ), y ) ) );
+		y = _mm_mul_ps( y, _mm_sub_ps( threeHalves, _mm_mul_ps( _mm_mul_ps( halfX, y ), y ) ) );
+		if (keMathPrecision == kMathHigh)
+		{
+			y = _mm_mul_ps( y, _mm_sub_ps( threeHalves, _mm_mul_ps( _mm_mul_ps( halfX, y ), y ) ) );
+		}
+		return y;
+	}
+
+#if defined(GEN_SIMD_AVX)
+	inline __m256 SIMDAdd( const __m256 a, const __m256 b ) { return _mm256_add_ps( a, b ); }
+	inline __m256 SIMDSub( const __m256 a, const __m256 b ) { return _mm256_sub_ps( a, b ); }
+	inline __m256 SIMDMul( const __m256 a, const __m256 b ) { return _mm256_mul_ps( a, b ); }
+	inline __m256 SIMDDiv( const __m256 a, const __m256 b ) { return _mm256_div_ps( a, b ); }
+	inline __m256 SIMDMin( const __m256 a, const __m256 b ) { return _mm256_min_ps( a, b ); }
+	inline __m256 SIMDSqrt( const __m256 a ) { return _mm256_sqrt_ps( a ); }
+	inline __m256 SIMDAbs( const __m256 a ) { return _mm256_andnot_ps( _mm256_set1_ps( -0.0f ), a ); }
+	inline __m256 SIMDZeroIfLess( const __m256 a, const __m256 b, const __m256 v )
+	{
+		return _mm256_andnot_ps( _mm256_cmp_ps( a, b, _CMP_LT_OQ ), v );
+	}
+	inline __m256 SIMDNegateIfLess( const __m256 a, const __m256 b, const __m256 v )
+	{
+		return _mm256_xor_ps( _mm256_and_ps( _mm256_cmp_ps( a, b, _CMP_LT_OQ ), _mm256_set1_ps( -0.0f ) ), v );
+	}
+	inline __m256 SIMDSelectIfLess( const __m256 a, const __m256 b, const __m256 vLess, const __m256 v )
+	{
+		return _mm256_blendv_ps( v, vLess, _mm256_cmp_ps( a, b, _CMP_LT_OQ ) );
+	}
+	inline void SIMDSet( const TFloat32 f, __m256* pOut ) { *pOut = _mm256_set1_ps( f ); }
+
+	// Combine two SSE registers into an AVX register
+	inline __m256 SIMDCombine( const __m128 low, const __m128 high )
+	{
+		return _mm256_insertf128_ps( _mm256_castps128_ps256( low ), high, 1 );
+	}
+
+	// 1 / Sqrt as above. AVX has no 256-bit integer operations for the approximations, so they
+	// are done in two halves
+	inline __m256 SIMDInvSqrt( const __m256 x )
+	{
+		if (keMathPrecision == kMathExact)
+		{
+			return _mm256_div_ps( _mm256_set1_ps( 1.0f ), _mm256_sqrt_ps( x ) );
+		}
+		return SIMDCombine( SIMDInvSqrt( _mm256_castps256_ps128( x ) ), SIMDInvSqrt( _mm256_extractf128_ps( x, 1 ) ) );
+	}
+#endif
+
+	// Register type and number of elements used by the quaternion kernels
+#if defined(GEN_SIMD_AVX)
+	typedef __m256 TSIMDFloats;
+	const TUInt32 kiSIMDWidth = 8;
+#else
+	typedef __m128 TSIMDFloats;
+	const TUInt32 kiSIMDWidth = 4;
+#endif
+
+
+	//---------------------------------
+	// Vector transformation
+
+	// Register type holding the given number of floats. Kernel data is templated on the width
+	// rather than the register type, as the compiler drops the alignment attributes of __m128 and
+	// __m256 when they are used as template arguments
+	template <TUInt32 iWidth> struct SSIMDRegister;
+	template <> struct SSIMDRegister<4> { typedef __m128 TReg; };
+#if defined(GEN_SIMD_AVX)
+	template <> struct SSIMDRegister<8> { typedef __m256 TReg; };
+#endif
+
+	// The matrix elements used by the kernel, each splatted across a register of the given width
+	template <TUInt32 iWidth> struct SSIMDMatrix
+	{
+		typedef typename SSIMDRegister<iWidth>::TReg TReg;
+
+		TReg e00, e01, e02;
+		TReg e10, e11, e12;
+		TReg e20, e21, e22;
+		TReg e30, e31, e32;
+		TReg epsilon;
+
+		SSIMDMatrix( const CMatrix4x4& m )
+		{
+			SIMDSet( m.e00, &e00 ); SIMDSet( m.e01, &e01 ); SIMDSet( m.e02, &e02 );
+			SIMDSet( m.e10, &e10 ); SIMDSet( m.e11, &e11 ); SIMDSet( m.e12, &e12 );
+			SIMDSet( m.e20, &e20 ); SIMDSet( m.e21, &e21 ); SIMDSet( m.e22, &e22 );
+			SIMDSet( m.e30, &e30 ); SIMDSet( m.e31, &e31 ); SIMDSet( m.e32, &e32 );
+			SIMDSet( kfEpsilon, &epsilon );
+		}
+	};
+
+	// Transform vectors held in structure-of-arrays form. Same operations in the same order as
+	// the scalar TransformPoint/TransformVector and Normalise functions
+	template <TUInt32 iWidth> inline void SIMDTransformSoA
+	(
+		const SSIMDMatrix<iWidth>&          m,
+		const EBatchTransform               eTransform,
+		typename SSIMDMatrix<iWidth>::TReg* pX,
+		typename SSIMDMatrix<iWidth>::TReg* pY,
+		typename SSIMDMatrix<iWidth>::TReg* pZ
+	)
+	{
+		typedef typename SSIMDMatrix<iWidth>::TReg TReg;
+
+		TReg x = SIMDAdd( SIMDAdd( SIMDMul( *pX, m.e00 ), SIMDMul( *pY, m.e10 ) ), SIMDMul( *pZ, m.e20 ) );
+		TReg y = SIMDAdd( SIMDAdd( SIMDMul( *pX, m.e01 ), SIMDMul( *pY, m.e11 ) ), SIMDMul( *pZ, m.e21 ) );
+		TReg z = SIMDAdd( SIMDAdd( SIMDMul( *pX, m.e02 ), SIMDMul( *pY, m.e12 ) ), SIMDMul( *pZ, m.e22 ) );
+		if (eTransform == kBatchPoints)
+		{
+			x = SIMDAdd( x, m.e30 );
+			y = SIMDAdd( y, m.e31 );
+			z = SIMDAdd( z, m.e32 );
+		}
+		else if (eTransform == kBatchNormals)
+		{
+			// Zero length vectors become zero vectors
+			TReg lengthSq = SIMDAdd( SIMDAdd( SIMDMul( x, x ), SIMDMul( y, y ) ), SIMDMul( z, z ) );
+			TReg invLength = SIMDInvSqrt( lengthSq );
+			x = SIMDZeroIfLess( lengthSq, m.epsilon, SIMDMul( x, invLength ) );
+			y = SIMDZeroIfLess( lengthSq, m.epsilon, SIMDMul( y, invLength ) );
+			z = SIMDZeroIfLess( lengthSq, m.epsilon, SIMDMul( z, invLength ) );
+		}
+		*pX = x;
+		*pY = y;
+		*pZ = z;
+	}
+
+
+	//---------------------------------
+	// Conversion between strided streams and structure-of-arrays form
+
+	// Load four vectors from a stream into structure-of-arrays form
+	inline void SIMDLoadSoA
+	(
+		const TUInt8* pIn,
+		const TUInt32 iStride,
+		__m128*       pX,
+		__m128*       pY,
+		__m128*       pZ
+	)
+	{
+		if (iStride == sizeof(CVector3))
+		{
+			// Plain array: three loads of (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3) then shuffle
+			const TFloat32* pf = reinterpret_cast<const TFloat32*>(pIn);
+			__m128 a = SIMDLoad( pf );
+			__m128 b = SIMDLoad( pf + 4 );
+			__m128 c = SIMDLoad( pf + 8 );
+			__m128 bc = _mm_shuffle_ps( b, c, _MM_SHUFFLE(1, 1, 2, 2) );
+			*pX = _mm_shuffle_ps( a, bc, _MM_SHUFFLE(2, 0, 3, 0) );
+			__m128 ab = _mm_shuffle_ps( a, b, _MM_SHUFFLE(0, 0, 1, 1) );
+			bc = _mm_shuffle_ps( b, c, _MM_SHUFFLE(2, 2, 3, 3) );
+			*pY = _mm_shuffle_ps( ab, bc, _MM_SHUFFLE(2, 0, 2, 0) );
+			ab = _mm_shuffle_ps( a, b, _MM_SHUFFLE(1, 1, 2, 2) );
+			__m128 cc = _mm_shuffle_ps( c, c, _MM_SHUFFLE(3, 3, 0, 0) );
+			*pZ = _mm_shuffle_ps( ab, cc, _MM_SHUFFLE(2, 0, 2, 0) );
+		}
+		else
+		{
+			const CVector3& v0 = *reinterpret_cast<const CVector3*>(pIn);
+			const CVector3& v1 = *reinterpret_cast<const CVector3*>(pIn + iStride);
+			const CVector3& v2 = *reinterpret_cast<const CVector3*>(pIn + 2 * iStride);
+			const CVector3& v3 = *reinterpret_cast<const CVector3*>(pIn + 3 * iStride);
+			*pX = _mm_set_ps( v3.x, v2.x, v1.x, v0.x );
+			*pY = _mm_set_ps( v3.y, v2.y, v1.y, v0.y );
+			*pZ = _mm_set_ps( v3.z, v2.z, v1.z, v0.z );
+		}
+	}
+
+	// Store four vectors in structure-of-arrays form to a stream. Non-temporal stores may be
+	// requested for a plain array, the output must then be 16-byte aligned
+	inline void SIMDStoreSoA
+	(
+		TUInt8*       pOut,
+		const TUInt32 iStride,
+		const __m128  x,
+		const __m128  y,
+		const __m128  z,
+		const bool    bStream
+	)
+	{
+		if (iStride == sizeof(CVector3))
+		{
+			// Plain array: shuffle to (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3) then three stores
+			__m128 xy01 = _mm_unpacklo_ps( x, y );
+			__m128 xy23 = _mm_unpackhi_ps( x, y );
+			__m128 zx = _mm_shuffle_ps( z, x, _MM_SHUFFLE(1, 1, 0, 0) );
+			__m128 a = _mm_shuffle_ps( xy01, zx, _MM_SHUFFLE(2, 0, 1, 0) );
+			__m128 yz = _mm_shuffle_ps( y, z, _MM_SHUFFLE(1, 1, 1, 1) );
+			__m128 b = _mm_shuffle_ps( yz, xy23, _MM_SHUFFLE(1, 0, 2, 0) );
+			__m128 zx23 = _mm_shuffle_ps( z, xy23, _MM_SHUFFLE(2, 2, 2, 2) );
+			__m128 yz3 = _mm_shuffle_ps( xy23, z, _MM_SHUFFLE(3, 3, 3, 3) );
+			__m128 c = _mm_shuffle_ps( zx23, yz3, _MM_SHUFFLE(2, 0, 2, 0) );
+
+			TFloat32* pf = reinterpret_cast<TFloat32*>(pOut);
+			if (bStream)
+			{
+				_mm_stream_ps( pf, a );
+				_mm_stream_ps( pf + 4, b );
+				_mm_stream_ps( pf + 8, c );
+			}
+			else
+			{
+				SIMDStore( pf, a );
+				SIMDStore( pf + 4, b );
+				SIMDStore( pf + 8, c );
+			}
+		}
+		else
+		{
+			TFloat32 afX[4], afY[4], afZ[4];
+			SIMDStore( afX, x );
+			SIMDStore( afY, y );
+			SIMDStore( afZ, z );
+			for (TUInt32 i = 0; i < 4; ++i)
+			{
+				*reinterpret_cast<CVector3*>(pOut + i * iStride) = CVector3( afX[i], afY[i], afZ[i] );
+			}
+		}
+	}
+
+	// Load four quaternions from a stream into structure-of-arrays form
+	inline void SIMDLoadQuatsSoA
+	(
+		const TUInt8* pIn,
+		const TUInt32 iStride,
+		__m128*       pW,
+		__m128*       pX,
+		__m128*       pY,
+		__m128*       pZ
+	)
+	{
+		__m128 q0 = SIMDLoad( reinterpret_cast<const TFloat32*>(pIn) );
+		__m128 q1 = SIMDLoad( reinterpret_cast<const TFloat32*>(pIn + iStride) );
+		__m128 q2 = SIMDLoad( reinterpret_cast<const TFloat32*>(pIn + 2 * iStride) );
+		__m128 q3 = SIMDLoad( reinterpret_cast<const TFloat32*>(pIn + 3 * iStride) );
+		_MM_TRANSPOSE4_PS( q0, q1, q2, q3 );
+		*pW = q0;
+		*pX = q1;
+		*pY = q2;
+		*pZ = q3;
+	}
+
+	// Store four rows of four floats in structure-of-arrays form to a stream: quaternions, or
+	// one row of each of four matrices
+	inline void SIMDStoreRowsSoA
+	(
+		TUInt8*       pOut,
+		const TUInt32 iStride,
+		__m128        a,
+		__m128        b,
+		__m128        c,
+		__m128        d
+	)
+	{
+		_MM_TRANSPOSE4_PS( a, b, c, d );
+		SIMDStore( reinterpret_cast<TFloat32*>(pOut), a );
+		SIMDStore( reinterpret_cast<TFloat32*>(pOut + iStride), b );
+		SIMDStore( reinterpret_cast<TFloat32*>(pOut + 2 * iStride), c );
+		SIMDStore( reinterpret_cast<TFloat32*>(pOut + 3 * iStride), d );
+	}
+
+#if defined(GEN_SIMD_AVX)
+	// Eight element versions of the above, as two groups of four
+	inline void SIMDLoadSoA
+	(
+		const TUInt8* pIn,
+		const TUInt32 iStride,
+		__m256*       pX,
+		__m256*       pY,
+		__m256*       pZ
+	)
+	{
+		__m128 x0, y0, z0, x1, y1, z1;
+		SIMDLoadSoA( pIn, iStride, &x0, &y0, &z0 );
+		SIMDLoadSoA( pIn + 4 * iStride, iStride, &x1, &y1, &z1 );
+		*pX = SIMDCombine( x0, x1 );
+		*pY = SIMDCombine( y0, y1 );
+		*pZ = SIMDCombine( z0, z1 );
+	}
+	inline void SIMDStoreSoA
+	(
+		TUInt8*       pOut,
+		const TUInt32 iStride,
+		const __m256  x,
+		const __m256  y,
+		const __m256  z,
+		const bool    bStream
+	)
+	{
+		SIMDStoreSoA( pOut, iStride, _mm256_castps256_ps128( x ), _mm256_castps256_ps128( y ),
+		              _mm256_castps256_ps128( z ), bStream );
+		SIMDStoreSoA( pOut + 4 * iStride, iStride, _mm256_extractf128_ps( x, 1 ),
+		              _mm256_extractf128_ps( y, 1 ), _mm256_extractf128_ps( z, 1 ), bStream );
+	}
+	inline void SIMDLoadQuatsSoA
+	(
+		const TUInt8* pIn,
+		const TUInt32 iStride,
+		__m256*       pW,
+		__m256*       pX,
+		__m256*       pY,
+		__m256*       pZ
+	)
+	{
+		__m128 w0, x0, y0, z0, w1, x1, y1, z1;
+		SIMDLoadQuatsSoA( pIn, iStride, &w0, &x0, &y0, &z0 );
+		SIMDLoadQuatsSoA( pIn + 4 * iStride, iStride, &w1, &x1, &y1, &z1 );
+		*pW = SIMDCombine( w0, w1 );
+		*pX = SIMDCombine( x0, x1 );
+		*pY = SIMDCombine( y0, y1 );
+		*pZ = SIMDCombine( z0, z1 );
+	}
+	inline void SIMDStoreRowsSoA
+	(
+		TUInt8*       pOut,
+		const TUInt32 iStride,
+		const __m256  a,
+		const __m256  b,
+		const __m256  c,
+		const __m256  d
+	)
+	{
+		SIMDStoreRowsSoA( pOut, iStride, _mm256_castps256_ps128( a ), _mm256_castps256_ps128( b ),
+		                  _mm256_castps256_ps128( c ), _mm256_castps256_ps128( d ) );
+		SIMDStoreRowsSoA( pOut + 4 * iStride, iStride, _mm256_extractf128_ps( a, 1 ),
+		                  _mm256_extractf128_ps( b, 1 ), _mm256_extractf128_ps( c, 1 ),
+		                  _mm256_extractf128_ps( d, 1 ) );
+	}
+#endif
+
+
+	//---------------------------------
+	// Quaternion blending
+
+	// Largest cos theta for which slerp is used rather than lerp, matches the AreEqual test in
+	// the Slerp function (within 3 units in the last place of 1)
+	const TFloat32 kfSlerpCosLimit = 1.0f - 3.0f / (1 << 24);
+
+	// Parameters for blending, each splatted across a register
+	struct SSIMDBlend
+	{
+		TSIMDFloats t, oneMinusT;
+		__m128      t4, oneMinusT4; // For the interpolation of whole quaternion-transforms
+		TSIMDFloats zero, one, epsilon, slerpCosLimit;
+
+		SSIMDBlend( const TFloat32 fT )
+		{
+			SIMDSet( fT, &t );
+			SIMDSet( 1.0f - fT, &oneMinusT );
+			SIMDSet( fT, &t4 );
+			SIMDSet( 1.0f - fT, &oneMinusT4 );
+			SIMDSet( 0.0f, &zero );
+			SIMDSet( 1.0f, &one );
+			SIMDSet( kfEpsilon, &epsilon );
+			SIMDSet( kfSlerpCosLimit, &slerpCosLimit );
+		}
+	};
+
+	// Sin of angles from 0 to pi/2 (Taylor series, error < 1e-7)
+	template <class TReg> inline TReg SIMDSin( const TReg x )
+	{
+		TReg c3, c5, c7, c9, c11;
+		SIMDSet( -1.0f / 6.0f, &c3 );
+		SIMDSet( 1.0f / 120.0f, &c5 );
+		SIMDSet( -1.0f / 5040.0f, &c7 );
+		SIMDSet( 1.0f / 362880.0f, &c9 );
+		SIMDSet( -1.0f / 39916800.0f, &c11 );
+		TReg x2 = SIMDMul( x, x );
+		TReg poly = SIMDAdd( c9, SIMDMul( x2, c11 ) );
+		poly = SIMDAdd( c7, SIMDMul( x2, poly ) );
+		poly = SIMDAdd( c5, SIMDMul( x2, poly ) );
+		poly = SIMDAdd( c3, SIMDMul( x2, poly ) );
+		return SIMDAdd( x, SIMDMul( SIMDMul( x, x2 ), poly ) );
+	}
+
+	// ACos of values from 0 to 1 (Abramowitz & Stegun 4.4.46, error < 2e-8)
+	template <class TReg> inline TReg SIMDACos( const TReg x, const TReg one )
+	{
+		TReg c0, c1, c2, c3, c4, c5, c6, c7;
+		SIMDSet( 1.5707963050f, &c0 );
+		SIMDSet( -0.2145988016f, &c1 );
+		SIMDSet( 0.0889789874f, &c2 );
+		SIMDSet( -0.0501743046f, &c3 );
+		SIMDSet( 0.0308918810f, &c4 );
+		SIMDSet( -0.0170881256f, &c5 );
+		SIMDSet( 0.0066700901f, &c6 );
+		SIMDSet( -0.0012624911f, &c7 );
+		TReg poly = SIMDAdd( c6, SIMDMul( x, c7 ) );
+		poly = SIMDAdd( c5, SIMDMul( x, poly ) );
+		poly = SIMDAdd( c4, SIMDMul( x, poly ) );
+		poly = SIMDAdd( c3, SIMDMul( x, poly ) );
+		poly = SIMDAdd( c2, SIMDMul( x, poly ) );
+		poly = SIMDAdd( c1, SIMDMul( x, poly ) );
+		poly = SIMDAdd( c0, SIMDMul( x, poly ) );
+		return SIMDMul( SIMDSqrt( SIMDSub( one, x ) ), poly );
+	}
+
+	// Normalised linear interpolation of quaternions in structure-of-arrays form, result in the
+	// first set. Same operations in the same order as the scalar NLerp function
+	inline void SIMDNLerpSoA
+	(
+		const SSIMDBlend&  blend,
+		TSIMDFloats*       pW,
+		TSIMDFloats*       pX,
+		TSIMDFloats*       pY,
+		TSIMDFloats*       pZ,
+		const TSIMDFloats& w1,
+		const TSIMDFloats& x1,
+		const TSIMDFloats& y1,
+		const TSIMDFloats& z1
+	)
+	{
+		TSIMDFloats w = SIMDAdd( SIMDMul( *pW, blend.oneMinusT ), SIMDMul( w1, blend.t ) );
+		TSIMDFloats x = SIMDAdd( SIMDMul( *pX, blend.oneMinusT ), SIMDMul( x1, blend.t ) );
+		TSIMDFloats y = SIMDAdd( SIMDMul( *pY, blend.oneMinusT ), SIMDMul( y1, blend.t ) );
+		TSIMDFloats z = SIMDAdd( SIMDMul( *pZ, blend.oneMinusT ), SIMDMul( z1, blend.t ) );
+
+		// Zero length quaternions become zero quaternions
+		TSIMDFloats normSq = SIMDAdd( SIMDAdd( SIMDAdd( SIMDMul( w, w ), SIMDMul( x, x ) ),
+		                                       SIMDMul( y, y ) ), SIMDMul( z, z ) );
+		TSIMDFloats invLength = SIMDInvSqrt( normSq );
+		*pW = SIMDZeroIfLess( normSq, blend.epsilon, SIMDMul( w, invLength ) );
+		*pX = SIMDZeroIfLess( normSq, blend.epsilon, SIMDMul( x, invLength ) );
+		*pY = SIMDZeroIfLess( normSq, blend.epsilon, SIMDMul( y, invLength ) );
+		*pZ = SIMDZeroIfLess( normSq, blend.epsilon, SIMDMul( z, invLength ) );
+	}
+
+	// Spherical linear interpolation of quaternions in structure-of-arrays form, result in the
+	// first set. Follows the scalar Slerp function, but with both routes round the circle and the
+	// small angle case calculated together
+	inline void SIMDSlerpSoA
+	(
+		const SSIMDBlend&  blend,
+		TSIMDFloats*       pW,
+		TSIMDFloats*       pX,
+		TSIMDFloats*       pY,
+		TSIMDFloats*       pZ,
+		const TSIMDFloats& w1,
+		const TSIMDFloats& x1,
+		const TSIMDFloats& y1,
+		const TSIMDFloats& z1
+	)
+	{
+		TSIMDFloats cosTheta = SIMDAdd( SIMDAdd( SIMDAdd( SIMDMul( *pW, w1 ), SIMDMul( *pX, x1 ) ),
+		                                         SIMDMul( *pY, y1 ) ), SIMDMul( *pZ, z1 ) );
+
+		// Slerp weights using the angle for the short route round the circle
+		TSIMDFloats absCosTheta = SIMDMin( SIMDAbs( cosTheta ), blend.one );
+		TSIMDFloats theta = SIMDACos( absCosTheta, blend.one );
+		TSIMDFloats invSinTheta = SIMDDiv( blend.one, SIMDSin( theta ) );
+		TSIMDFloats weight0 = SIMDMul( SIMDSin( SIMDMul( blend.oneMinusT, theta ) ), invSinTheta );
+		TSIMDFloats weight1 = SIMDMul( SIMDSin( SIMDMul( blend.t, theta ) ), invSinTheta );
+
+		// Use lerp weights for small angles, and negate the first weight for the opposite route
+		weight0 = SIMDSelectIfLess( absCosTheta, blend.slerpCosLimit, weight0, blend.oneMinusT );
+		weight1 = SIMDSelectIfLess( absCosTheta, blend.slerpCosLimit, weight1, blend.t );
+		weight0 = SIMDNegateIfLess( cosTheta, blend.zero, weight0 );
+
+		*pW = SIMDAdd( SIMDMul( *pW, weight0 ), SIMDMul( w1, weight1 ) );
+		*pX = SIMDAdd( SIMDMul( *pX, weight0 ), SIMDMul( x1, weight1 ) );
+		*pY = SIMDAdd( SIMDMul( *pY, weight0 ), SIMDMul( y1, weight1 ) );
+		*pZ = SIMDAdd( SIMDMul( *pZ, weight0 ), SIMDMul( z1, weight1 ) );
+	}
+
+	// Blend one block of kiSIMDWidth quaternions or quaternion-transforms. For transforms every
+	// float is first linearly interpolated (giving the position and scale), then the quaternions
+	// are replaced by the nlerp or slerp result. The inputs are loaded before any output is
+	// written so the output may be the same as either input
+	void SIMDBlendBlock
+	(
+		const SSIMDBlend& blend,
+		const bool        bSlerp,
+		const TUInt8*     pIn0,
+		const TUInt8*     pIn1,
+		const TUInt32     iStride,
+		const TUInt32     iQuatOffset,
+		TUInt8*           pOut
+	)
+	{
+		TSIMDFloats w0, x0, y0, z0, w1, x1, y1, z1;
+		SIMDLoadQuatsSoA( pIn0 + iQuatOffset, iStride, &w0, &x0, &y0, &z0 );
+		SIMDLoadQuatsSoA( pIn1 + iQuatOffset, iStride, &w1, &x1, &y1, &z1 );
+
+		if (iStride != sizeof(CQuaternion))
+		{
+			const TFloat32* pf0 = reinterpret_cast<const TFloat32*>(pIn0);
+			const TFloat32* pf1 = reinterpret_cast<const TFloat32*>(pIn1);
+			TFloat32* pfOut = reinterpret_cast<TFloat32*>(pOut);
+			for (TUInt32 i = 0; i < kiSIMDWidth * iStride / sizeof(TFloat32); i += 4)
+			{
+				SIMDStore( pfOut + i, _mm_add_ps( _mm_mul_ps( SIMDLoad( pf0 + i ), blend.oneMinusT4 ),
+				                                  _mm_mul_ps( SIMDLoad( pf1 + i ), blend.t4 ) ) );
+			}
+		}
+
+		if (bSlerp)
+		{
+			SIMDSlerpSoA( blend, &w0, &x0, &y0, &z0, w1, x1, y1, z1 );
+		}
+		else
+		{
+			SIMDNLerpSoA( blend, &w0, &x0, &y0, &z0, w1, x1, y1, z1 );
+		}
+		SIMDStoreRowsSoA( pOut + iQuatOffset, iStride, w0, x0, y0, z0 );
+	}
+
+	// Blend arrays of quaternions or quaternion-transforms a block at a time. Any remaining
+	// elements are copied into a zero-filled block, so every element gets the same calculation
+	void SIMDBlendArrays
+	(
+		const TFloat32 t,
+		const bool     bSlerp,
+		const TUInt8*  pIn0,
+		const TUInt8*  pIn1,
+		const TUInt32  iStride,
+		const TUInt32  iQuatOffset,
+		TUInt8*        pOut,
+		const TUInt32  iNumElements
+	)
+	{
+		SSIMDBlend blend( t );
+		TUInt32 iElement = 0;
+		for (; iElement + kiSIMDWidth <= iNumElements; iElement += kiSIMDWidth)
+		{
+			TUInt32 iOffset = iElement * iStride;
+			SIMDBlendBlock( blend, bSlerp, pIn0 + iOffset, pIn1 + iOffset, iStride, iQuatOffset,
+			                pOut + iOffset );
+		}
+		if (iElement < iNumElements)
+		{
+			TUInt8 aBlock0[kiSIMDWidth * sizeof(CQuatTransform)];
+			TUInt8 aBlock1[kiSIMDWidth * sizeof(CQuatTransform)];
+			TUInt32 iOffset = iElement * iStride;
+			TUInt32 iSize = (iNumElements - iElement) * iStride;
+			memset( aBlock0, 0, sizeof(aBlock0) );
+			memset( aBlock1, 0, sizeof(aBlock1) );
+			memcpy( aBlock0, pIn0 + iOffset, iSize );
+			memcpy( aBlock1, pIn1 + iOffset, iSize );
+			SIMDBlendBlock( blend, bSlerp, aBlock0, aBlock1, iStride, iQuatOffset, aBlock0 );
+			memcpy( pOut + iOffset, aBlock0, iSize );
+		}
+	}
+
+
+	//---------------------------------
+	// Quaternion-transform to matrix conversion
+
+	// Convert a block of kiSIMDWidth quaternion-transforms to matrices. Same operations in the
+	// same order as the CMatrix4x4 constructor from quaternion, position and scale
+	void SIMDGetMatrixBlock
+	(
+		const CQuatTransform* pTransforms,
+		CMatrix4x4*           pMatrices
+	)
+	{
+		const TUInt8* pIn = reinterpret_cast<const TUInt8*>(pTransforms);
+		const TUInt32 iStride = sizeof(CQuatTransform);
+		TSIMDFloats qw, qx, qy, qz, posX, posY, posZ, scaleX, scaleY, scaleZ;
+		SIMDLoadQuatsSoA( pIn + offsetof(CQuatTransform, quat), iStride, &qw, &qx, &qy, &qz );
+		SIMDLoadSoA( pIn + offsetof(CQuatTransform, pos), iStride, &posX, &posY, &posZ );
+		SIMDLoadSoA( pIn + offsetof(CQuatTransform, scale), iStride, &scaleX, &scaleY, &scaleZ );
+
+		TSIMDFloats zero, one, two;
+		SIMDSet( 0.0f, &zero );
+		SIMDSet( 1.0f, &one );
+		SIMDSet( 2.0f, &two );
+
+		// Precalculate some values from the quaternion
+		TSIMDFloats xx = SIMDMul( two, qx );
+		TSIMDFloats yy = SIMDMul( two, qy );
+		TSIMDFloats zz = SIMDMul( two, qz );
+		TSIMDFloats xy = SIMDMul( xx, qy );
+		TSIMDFloats yz = SIMDMul( yy, qz );
+		TSIMDFloats zx = SIMDMul( zz, qx );
+		TSIMDFloats wx = SIMDMul( qw, xx );
+		TSIMDFloats wy = SIMDMul( qw, yy );
+		TSIMDFloats wz = SIMDMul( qw, zz );
+		xx = SIMDMul( xx, qx );
+		yy = SIMDMul( yy, qy );
+		zz = SIMDMul( zz, qz );
+
+		// Build each row for all the matrices, then transpose into the matrices
+		TUInt8* pOut = reinterpret_cast<TUInt8*>(pMatrices);
+		const TUInt32 iRowSize = 4 * sizeof(TFloat32);
+		SIMDStoreRowsSoA( pOut, sizeof(CMatrix4x4),
+		                  SIMDMul( scaleX, SIMDSub( SIMDSub( one, yy ), zz ) ),
+		                  SIMDMul( scaleX, SIMDAdd( xy, wz ) ),
+		                  SIMDMul( scaleX, SIMDSub( zx, wy ) ), zero );
+		SIMDStoreRowsSoA( pOut + iRowSize, sizeof(CMatrix4x4),
+		                  SIMDMul( scaleY, SIMDSub( xy, wz ) ),
+		                  SIMDMul( scaleY, SIMDSub( SIMDSub( one, xx ), zz ) ),
+		                  SIMDMul( scaleY, SIMDAdd( yz, wx ) ), zero );
+		SIMDStoreRowsSoA( pOut + 2 * iRowSize, sizeof(CMatrix4x4),
+		                  SIMDMul( scaleZ, SIMDAdd( zx, wy ) ),
+		                  SIMDMul( scaleZ, SIMDSub( yz, wx ) ),
+		                  SIMDMul( scaleZ, SIMDSub( SIMDSub( one, xx ), yy ) ), zero );
+		SIMDStoreRowsSoA( pOut + 3 * iRowSize, sizeof(CMatrix4x4), posX, posY, posZ, one );
+	}
+
+#endif // GEN_SIMD_SSE
+
+} // anonymous namespace
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch Vector Transformation
+-----------------------------------------------------------------------------------------*/
+
+// Transform a strided stream of vectors by the given matrix
+void BatchTransform
+(
+	const CMatrix4x4&     m,
+	const EBatchTransform eTransform,
+	const TUInt8*         pIn,
+	const TUInt32         iInStride,
+	TUInt8*               pOut,
+	const TUInt32         iOutStride,
+	const TUInt32         iNumVectors
+)
+{
+	GEN_GUARD;
+
+#if defined(GEN_SIMD_SSE)
+	TUInt32 iVector = 0;
+
+	// Use non-temporal stores for large plain array outputs. The output must be 16-byte aligned,
+	// so transform single vectors first until it is
+	bool bStream = (iOutStride == sizeof(CVector3) && pIn != pOut &&
+	                iNumVectors * sizeof(CVector3) >= kiBatchStreamingBytes &&
+	                (reinterpret_cast<size_t>(pOut) & 3) == 0);
+	if (bStream)
+	{
+		while ((reinterpret_cast<size_t>(pOut + iVector * iOutStride) & 15) != 0)
+		{
+			*reinterpret_cast<CVector3*>(pOut + iVector * iOutStride) =
+				TransformOne( m, eTransform, *reinterpret_cast<const CVector3*>(pIn + iVector * iInStride) );
+			++iVector;
+		}
+	}
+
+#if defined(GEN_SIMD_AVX)
+	// Eight vectors at a time
+	SSIMDMatrix<8> m256( m );
+	for (; iVector + 8 <= iNumVectors; iVector += 8)
+	{
+		__m256 x, y, z;
+		SIMDLoadSoA( pIn + iVector * iInStride, iInStride, &x, &y, &z );
+		SIMDTransformSoA( m256, eTransform, &x, &y, &z );
+		SIMDStoreSoA( pOut + iVector * iOutStride, iOutStride, x, y, z, bStream );
+	}
+#endif
+
+	// Four vectors at a time
+	SSIMDMatrix<4> m128( m );
+	for (; iVector + 4 <= iNumVectors; iVector += 4)
+	{
+		__m128 x, y, z;
+		SIMDLoadSoA( pIn + iVector * iInStride, iInStride, &x, &y, &z );
+		SIMDTransformSoA( m128, eTransform, &x, &y, &z );
+		SIMDStoreSoA( pOut + iVector * iOutStride, iOutStride, x, y, z, bStream );
+	}
+	if (bStream)
+	{
+		_mm_sfence(); // Make non-temporal stores visible before any following stores
+	}
+
+	// Remaining vectors one at a time
+	for (; iVector < iNumVectors; ++iVector)
+	{
+		*reinterpret_cast<CVector3*>(pOut + iVector * iOutStride) =
+			TransformOne( m, eTransform, *reinterpret_cast<const CVector3*>(pIn + iVector * iInStride) );
+	}
+#else
+	BatchTransformScalar( m, eTransform, pIn, iInStride, pOut, iOutStride, iNumVectors );
+#endif
+
+	GEN_ENDGUARD;
+}
+
+
+// Portable version of BatchTransform, transforms one vector at a time
+void BatchTransformScalar
+(
+	const CMatrix4x4&     m,
+	const EBatchTransform eTransform,
+	const TUInt8*         pIn,
+	const TUInt32         iInStride,
+	TUInt8*               pOut,
+	const TUInt32         iOutStride,
+	const TUInt32         iNumVectors
+)
+{
+	GEN_GUARD;
+
+	for (TUInt32 iVector = 0; iVector < iNumVectors; ++iVector)
+	{
+		*reinterpret_cast<CVector3*>(pOut + iVector * iOutStride) =
+			TransformOne( m, eTransform, *reinterpret_cast<const CVector3*>(pIn + iVector * iInStride) );
+	}
+
+	GEN_ENDGUARD;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch Quaternion Blending
+-----------------------------------------------------------------------------------------*/
+
+// Normalised linear interpolation of two arrays of quaternions with parameter t
+void BatchNLerp
+(
+	const CQuaternion* pQuats0,
+	const CQuaternion* pQuats1,
+	const TFloat32     t,
+	CQuaternion*       pQuatsOut,
+	const TUInt32      iNumQuats
+)
+{
+	GEN_GUARD;
+
+#if defined(GEN_SIMD_SSE)
+	SIMDBlendArrays( t, false, reinterpret_cast<const TUInt8*>(pQuats0),
+	                 reinterpret_cast<const TUInt8*>(pQuats1), sizeof(CQuaternion), 0,
+	                 reinterpret_cast<TUInt8*>(pQuatsOut), iNumQuats );
+#else
+	BatchNLerpScalar( pQuats0, pQuats1, t, pQuatsOut, iNumQuats );
+#endif
+
+	GEN_ENDGUARD;
+}
+
+// Spherical linear interpolation of two arrays of quaternions with parameter t
+void BatchSlerp
+(
+	const CQuaternion* pQuats0,
+	const CQuaternion* pQuats1,
+	const TFloat32     t,
+	CQuaternion*       pQuatsOut,
+	const TUInt32      iNumQuats
+)
+{
+	GEN_GUARD;
+
+#if defined(GEN_SIMD_SSE)
+	if (t >= 0.0f && t <= 1.0f) // Range supported by SIMD sin approximation
+	{
+		SIMDBlendArrays( t, true, reinterpret_cast<const TUInt8*>(pQuats0),
+		                 reinterpret_cast<const TUInt8*>(pQuats1), sizeof(CQuaternion), 0,
+		                 reinterpret_cast<TUInt8*>(pQuatsOut), iNumQuats );
+		return;
+	}
+#endif
+	BatchSlerpScalar( pQuats0, pQuats1, t, pQuatsOut, iNumQuats );
+
+	GEN_ENDGUARD;
+}
+
+// Interpolation of two arrays of quaternion-transforms with parameter t. Positions and scales use
+// linear interpolation, quaternions use normalised linear interpolation
+void BatchNLerp
+(
+	const CQuatTransform* pTransforms0,
+	const CQuatTransform* pTransforms1,
+	const TFloat32        t,
+	CQuatTransform*       pTransformsOut,
+	const TUInt32         iNumTransforms
+)
+{
+	GEN_GUARD;
+
+#if defined(GEN_SIMD_SSE)
+	SIMDBlendArrays( t, false, reinterpret_cast<const TUInt8*>(pTransforms0),
+	                 reinterpret_cast<const TUInt8*>(pTransforms1), sizeof(CQuatTransform),
+	                 offsetof(CQuatTransform, quat), reinterpret_cast<TUInt8*>(pTransformsOut),
+	                 iNumTransforms );
+#else
+	BatchNLerpScalar( pTransforms0, pTransforms1, t, pTransformsOut, iNumTransforms );
+#endif
+
+	GEN_ENDGUARD;
+}
+
+// Interpolation of two arrays of quaternion-transforms with parameter t. Positions and scales use
+// linear interpolation, quaternions use spherical linear interpolation
+void BatchSlerp
+(
+	const CQuatTransform* pTransforms0,
+	const CQuatTransform* pTransforms1,
+	const TFloat32        t,
+	CQuatTransform*       pTransformsOut,
+	const TUInt32         iNumTransforms
+)
+{
+	GEN_GUARD;
+
+#if defined(GEN_SIMD_SSE)
+	if (t >= 0.0f && t <= 1.0f) // Range supported by SIMD sin approximation
+	{
+		SIMDBlendArrays( t, true, reinterpret_cast<const TUInt8*>(pTransforms0),
+		                 reinterpret_cast<const TUInt8*>(pTransforms1), sizeof(CQuatTransform),
+		                 offsetof(CQuatTransform, quat), reinterpret_cast<TUInt8*>(pTransformsOut),
+		                 iNumTransforms );
+		return;
+	}
+#endif
+	BatchSlerpScalar( pTransforms0, pTransforms1, t, pTransformsOut, iNumTransforms );
+
+	GEN_ENDGUARD;
+}
+
+// Convert an array of quaternion-transforms to matrices
+void BatchGetMatrix
+(
+	const CQuatTransform* pTransforms,
+	CMatrix4x4*           pMatrices,
+	const TUInt32         iNumTransforms
+)
+{
+	GEN_GUARD;
+
+#if defined(GEN_SIMD_SSE)
+	TUInt32 iTransform = 0;
+	for (; iTransform + kiSIMDWidth <= iNumTransforms; iTransform += kiSIMDWidth)
+	{
+		SIMDGetMatrixBlock( pTransforms + iTransform, pMatrices + iTransform );
+	}
+
+	// Remaining transforms converted as a zero-filled block
+	if (iTransform < iNumTransforms)
+	{
+		TUInt8 aBlock[kiSIMDWidth * sizeof(CQuatTransform)];
+		CMatrix4x4 aMatrices[kiSIMDWidth];
+		TUInt32 iNumRemaining = iNumTransforms - iTransform;
+		memset( aBlock, 0, sizeof(aBlock) );
+		memcpy( aBlock, pTransforms + iTransform, iNumRemaining * sizeof(CQuatTransform) );
+		SIMDGetMatrixBlock( reinterpret_cast<const CQuatTransform*>(aBlock), aMatrices );
+		for (TUInt32 i = 0; i < iNumRemaining; ++i)
+		{
+			pMatrices[iTransform + i] = aMatrices[i];
+		}
+	}
+#else
+	BatchGetMatrixScalar( pTransforms, pMatrices, iNumTransforms );
+#endif
+
+	GEN_ENDGUARD;
+}
+
+
+// Portable versions of the functions above, process one element at a time
+void BatchNLerpScalar
+(
+	const CQuaternion* pQuats0,
+	const CQuaternion* pQuats1,
+	const TFloat32     t,
+	CQuaternion*       pQuatsOut,
+	const TUInt32      iNumQuats
+)
+{
+	GEN_GUARD;
+
+	for (TUInt32 i = 0; i < iNumQuats; ++i)
+	{
+		NLerp( pQuats0[i], pQuats1[i], t, pQuatsOut[i] );
+	}
+
+	GEN_ENDGUARD;
+}
+
+void BatchSlerpScalar
+(
+	const CQuaternion* pQuats0,
+	const CQuaternion* pQuats1,
+	const TFloat32     t,
+	CQuaternion*       pQuatsOut,
+	const TUInt32      iNumQuats
+)
+{
+	GEN_GUARD;
+
+	for (TUInt32 i = 0; i < iNumQuats; ++i)
+	{
+		Slerp( pQuats0[i], pQuats1[i], t, pQuatsOut[i] );
+	}
+
+	GEN_ENDGUARD;
+}
+
+void BatchNLerpScalar
+(
+	const CQuatTransform* pTransforms0,
+	const CQuatTransform* pTransforms1,
+	const TFloat32        t,
+	CQuatTransform*       pTransformsOut,
+	const TUInt32         iNumTransforms
+)
+{
+	GEN_GUARD;
+
+	for (TUInt32 i = 0; i < iNumTransforms; ++i)
+	{
+		NLerp( pTransforms0[i], pTransforms1[i], t, pTransformsOut[i] );
+	}
+
+	GEN_ENDGUARD;
+}
+
+void BatchSlerpScalar
+(
+	const CQuatTransform* pTransforms0,
+	const CQuatTransform* pTransforms1,
+	const TFloat32        t,
+	CQuatTransform*       pTransformsOut,
+	const TUInt32         iNumTransforms
+)
+{
+	GEN_GUARD;
+
+	for (TUInt32 i = 0; i < iNumTransforms; ++i)
+	{
+		Slerp( pTransforms0[i], pTransforms1[i], t, pTransformsOut[i] );
+	}
+
+	GEN_ENDGUARD;
+}
+
+void BatchGetMatrixScalar
+(
+	const CQuatTransform* pTransforms,
+	CMatrix4x4*           pMatrices,
+	const TUInt32         iNumTransforms
+)
+{
+	GEN_GUARD;
+
+	for (TUInt32 i = 0; i < iNumTransforms; ++i)
+	{
+		pMatrices[i] = CMatrix4x4( pTransforms[i].quat, pTransforms[i].pos, pTransforms[i].scale );
+	}
+
+	GEN_ENDGUARD;
+}
+
+
+} // namespace gen
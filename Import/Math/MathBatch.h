@@ -0,0 +1,227 @@
+/**************************************************************************************************
+	Module:       MathBatch.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Batch maths operations - the same operation applied to whole arrays of vectors, quaternions
+	or transforms, using SIMD where available (see MathSIMD.h)
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#ifndef GEN_MATH_BATCH_H_INCLUDED
+#define GEN_MATH_BATCH_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "GenDefines.h"
+#include "CVector3.h"
+#include "CMatrix4x4.h"
+#include "CQuaternion.h"
+#include "CQuatTransform.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Batch Vector Transformation
+-----------------------------------------------------------------------------------------*/
+// Vectors are given as strided streams: a pointer to the first CVector3 and the number of bytes
+// from one to the next. The stride is sizeof(CVector3) for a plain array, or the vertex size to
+// access the positions, normals etc. in a vertex stream such as SSubMesh::vertices. The input and
+// output may be the same stream to transform in place, but must not otherwise overlap
+//
+// Groups of vectors are converted to structure-of-arrays form (all x's, all y's, all z's) and
+// transformed four at a time (eight with AVX). Results are identical to transforming each vector
+// with the CMatrix4x4 member functions. Large outputs to a plain array use non-temporal stores,
+// which don't pull the output into the cache
+
+// How each vector is transformed
+enum EBatchTransform
+{
+	kBatchPoints,  // Transform as points, as CMatrix4x4::TransformPoint (w = 1)
+	kBatchVectors, // Transform as vectors, as CMatrix4x4::TransformVector (w = 0)
+	kBatchNormals, // Transform as vectors then normalise (as Normalise function), this is correct
+	               // for normals if the matrix has no non-uniform scaling
+};
+
+// Outputs to a plain array of at least this many bytes use non-temporal stores (about the size
+// of a typical L2 cache, smaller outputs are likely to be used again while still in the cache)
+const TUInt32 kiBatchStreamingBytes = 512 * 1024;
+
+// Transform a strided stream of vectors by the given matrix
+void BatchTransform
+(
+	const CMatrix4x4&     m,
+	const EBatchTransform eTransform,
+	const TUInt8*         pIn,
+	const TUInt32         iInStride,
+	TUInt8*               pOut,
+	const TUInt32         iOutStride,
+	const TUInt32         iNumVectors
+);
+
+// Transform an array of vectors by the given matrix, the output array is resized to match
+inline void BatchTransform
+(
+	const CMatrix4x4&       m,
+	const EBatchTransform   eTransform,
+	const vector<CVector3>& vectors,
+	vector<CVector3>*       pOutVectors
+)
+{
+	pOutVectors->resize( vectors.size() );
+	if (!vectors.empty())
+	{
+		BatchTransform( m, eTransform, reinterpret_cast<const TUInt8*>(&vectors[0]), sizeof(CVector3),
+		                reinterpret_cast<TUInt8*>(&(*pOutVectors)[0]), sizeof(CVector3),
+		                static_cast<TUInt32>(vectors.size()) );
+	}
+}
+
+// Transform an array of vectors by the given matrix in place
+inline void BatchTransform
+(
+	const CMatrix4x4&     m,
+	const EBatchTransform eTransform,
+	vector<CVector3>*     pVectors
+)
+{
+	if (!pVectors->empty())
+	{
+		TUInt8* pVectorData = reinterpret_cast<TUInt8*>(&(*pVectors)[0]);
+		BatchTransform( m, eTransform, pVectorData, sizeof(CVector3), pVectorData, sizeof(CVector3),
+		                static_cast<TUInt32>(pVectors->size()) );
+	}
+}
+
+// Portable version of BatchTransform, transforms one vector at a time. Available to test and
+// benchmark the SIMD version
+void BatchTransformScalar
+(
+	const CMatrix4x4&     m,
+	const EBatchTransform eTransform,
+	const TUInt8*         pIn,
+	const TUInt32         iInStride,
+	TUInt8*               pOut,
+	const TUInt32         iOutStride,
+	const TUInt32         iNumVectors
+);
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch Quaternion Blending
+-----------------------------------------------------------------------------------------*/
+// Blend whole poses (e.g. one quaternion or quaternion-transform per bone of a skeleton) with a
+// single interpolation parameter, processing four elements at a time (eight with AVX). Each
+// output element is the blend of the matching elements from the two input arrays. The output may
+// be the same array as either input
+//
+// The nlerp functions give identical results to the NLerp functions for single quaternions or
+// quaternion-transforms. The slerp functions use polynomial approximations of sin and acos, so
+// results differ from the Slerp functions by less than 1e-6 (about 5e-5 with GEN_FAST_MATH_LOW,
+// see BaseMath.h). This requires t in the range 0 to 1, other values are passed to the Slerp
+// functions one element at a time
+
+// Normalised linear interpolation of two arrays of quaternions with parameter t
+void BatchNLerp
+(
+	const CQuaternion* pQuats0,
+	const CQuaternion* pQuats1,
+	const TFloat32     t,
+	CQuaternion*       pQuatsOut,
+	const TUInt32      iNumQuats
+);
+
+// Spherical linear interpolation of two arrays of quaternions with parameter t
+void BatchSlerp
+(
+	const CQuaternion* pQuats0,
+	const CQuaternion* pQuats1,
+	const TFloat32     t,
+	CQuaternion*       pQuatsOut,
+	const TUInt32      iNumQuats
+);
+
+// Interpolation of two arrays of quaternion-transforms with parameter t. Positions and scales use
+// linear interpolation, quaternions use normalised linear interpolation
+void BatchNLerp
+(
+	const CQuatTransform* pTransforms0,
+	const CQuatTransform* pTransforms1,
+	const TFloat32        t,
+	CQuatTransform*       pTransformsOut,
+	const TUInt32         iNumTransforms
+);
+
+// Interpolation of two arrays of quaternion-transforms with parameter t. Positions and scales use
+// linear interpolation, quaternions use spherical linear interpolation
+void BatchSlerp
+(
+	const CQuatTransform* pTransforms0,
+	const CQuatTransform* pTransforms1,
+	const TFloat32        t,
+	CQuatTransform*       pTransformsOut,
+	const TUInt32         iNumTransforms
+);
+
+// Convert an array of quaternion-transforms to matrices. Gives identical results to constructing
+// each matrix with CMatrix4x4( quat, pos, scale ) - the same as CQuatTransform::GetMatrix for
+// normalised quaternions, but without renormalising the matrix rows
+void BatchGetMatrix
+(
+	const CQuatTransform* pTransforms,
+	CMatrix4x4*           pMatrices,
+	const TUInt32         iNumTransforms
+);
+
+// Portable versions of the functions above, process one element at a time using the functions
+// for single quaternions and quaternion-transforms. Available to test and benchmark the SIMD
+// versions
+void BatchNLerpScalar
+(
+	const CQuaternion* pQuats0,
+	const CQuaternion* pQuats1,
+	const TFloat32     t,
+	CQuaternion*       pQuatsOut,
+	const TUInt32      iNumQuats
+);
+void BatchSlerpScalar
+(
+	const CQuaternion* pQuats0,
+	const CQuaternion* pQuats1,
+	const TFloat32     t,
+	CQuaternion*       pQuatsOut,
+	const TUInt32      iNumQuats
+);
+void BatchNLerpScalar
+(
+	const CQuatTransform* pTransforms0,
+	const CQuatTransform* pTransforms1,
+	const TFloat32        t,
+	CQuatTransform*       pTransformsOut,
+	const TUInt32         iNumTransforms
+);
+void BatchSlerpScalar
+(
+	const CQuatTransform* pTransforms0,
+	const CQuatTransform* pTransforms1,
+	const TFloat32        t,
+	CQuatTransform*       pTransformsOut,
+	const TUInt32         iNumTransforms
+);
+void BatchGetMatrixScalar
+(
+	const CQuatTransform* pTransforms,
+	CMatrix4x4*           pMatrices,
+	const TUInt32         iNumTransforms
+);
+
+
+} // namespace gen
+
+#endif // GEN_MATH_BATCH_H_INCLUDED
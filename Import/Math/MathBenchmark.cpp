@@ -0,0 +1,615 @@
+/**************************************************************************************************
+	Module:       MathBenchmark.cpp
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Microbenchmarks comparing the SIMD implementations of maths functions with the portable
+	scalar versions
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "MathBenchmark.h"
+#include "MathSIMD.h"
+#include "CVector3.h"
+#include "CVector4.h"
+#include "CMatrix4x4.h"
+#include "MathBatch.h"
+#include "MathCull.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Local helpers
+-----------------------------------------------------------------------------------------*/
+
+namespace
+{
+	// Number of inputs used by each benchmark - small enough that the data stays in the cache,
+	// so the benchmarks measure the arithmetic rather than memory access
+	const TUInt32 kiNumInputs = 64;
+
+	// Simple repeatable random number generator, returns values from -1 to 1
+	class CBenchmarkRandom
+	{
+	public:
+		CBenchmarkRandom() : m_iState( 12345 ) {}
+
+		TFloat32 Next()
+		{
+			m_iState = m_iState * 1664525u + 1013904223u;
+			return static_cast<TFloat32>(m_iState >> 8) / static_cast<TFloat32>(1 << 23) - 1.0f;
+		}
+
+	private:
+		TUInt32 m_iState;
+	};
+
+	// Return a random affine matrix with a rotation, scaling from 0.5 to 2 and translation
+	CMatrix4x4 RandomAffine( CBenchmarkRandom* pRandom )
+	{
+		CVector3 position( pRandom->Next() * 100.0f, pRandom->Next() * 100.0f, pRandom->Next() * 100.0f );
+		CVector3 angles( pRandom->Next() * kfPi, pRandom->Next() * kfPi, pRandom->Next() * kfPi );
+		CVector3 scale( 1.25f + pRandom->Next() * 0.75f, 1.25f + pRandom->Next() * 0.75f,
+		                1.25f + pRandom->Next() * 0.75f );
+		return CMatrix4x4( position, angles, kZXY, scale );
+	}
+
+	// Return the largest difference between the elements of two results (each is a type made
+	// only of floats, e.g. CVector3 or CMatrix4x4). Differences are relative to the size of the
+	// second result's element where that is larger than 1, so large elements such as matrix
+	// translations don't swamp the comparison
+	template <class TResult> TFloat32 MaxDifference
+	(
+		const TResult& result1,
+		const TResult& result2
+	)
+	{
+		const TFloat32* pf1 = reinterpret_cast<const TFloat32*>(&result1);
+		const TFloat32* pf2 = reinterpret_cast<const TFloat32*>(&result2);
+		TFloat32 fMax = 0.0f;
+		for (TUInt32 i = 0; i < sizeof(TResult) / sizeof(TFloat32); ++i)
+		{
+			fMax = Max( fMax, Abs( pf1[i] - pf2[i] ) / Max( 1.0f, Abs( pf2[i] ) ) );
+		}
+		return fMax;
+	}
+
+	// Call a function the given number of times, cycling through the inputs, and return the
+	// average time per call in nanoseconds. Results are stored so the calls can't be optimised
+	// away, the final result for each input is left in the given array
+	template <class TResult, class TFunction> TFloat64 TimeFunction
+	(
+		const TUInt32 iIterations,
+		TFunction     function,
+		TResult*      pResults
+	)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (TUInt32 i = 0; i < iIterations; ++i)
+		{
+			pResults[i % kiNumInputs] = function( i % kiNumInputs );
+		}
+		chrono::duration<TFloat64, nano> time = chrono::steady_clock::now() - start;
+		return time.count() / iIterations;
+	}
+
+	// Time the SIMD and scalar versions of a function and add the comparison to the results
+	template <class TResult, class TSIMDFunction, class TScalarFunction> void Compare
+	(
+		const char*             sFunction,
+		const TUInt32           iIterations,
+		TSIMDFunction           simdFunction,
+		TScalarFunction         scalarFunction,
+		vector<SMathBenchmark>* pResults
+	)
+	{
+		TResult aSIMDResults[kiNumInputs];
+		TResult aScalarResults[kiNumInputs];
+
+		SMathBenchmark result;
+		result.function = sFunction;
+		result.scalarTime = TimeFunction( iIterations, scalarFunction, aScalarResults );
+		result.simdTime = TimeFunction( iIterations, simdFunction, aSIMDResults );
+		result.maxDifference = 0.0f;
+		result.mismatches = 0;
+		for (TUInt32 i = 0; i < Min( iIterations, kiNumInputs ); ++i)
+		{
+			result.maxDifference = Max( result.maxDifference,
+			                            MaxDifference( aSIMDResults[i], aScalarResults[i] ) );
+		}
+		pResults->push_back( result );
+	}
+
+	// Time one batch transform called the given number of times on a stream, return the average
+	// time per vector in nanoseconds
+	template <class TFunction> TFloat64 TimeBatch
+	(
+		const TUInt32 iIterations,
+		const TUInt32 iNumVectors,
+		TFunction     function
+	)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (TUInt32 i = 0; i < iIterations; ++i)
+		{
+			function();
+		}
+		chrono::duration<TFloat64, nano> time = chrono::steady_clock::now() - start;
+		return time.count() / (static_cast<TFloat64>(iIterations) * iNumVectors);
+	}
+
+	// Time the SIMD and scalar versions of a batch transform from one stream to another and add
+	// the comparison to the results
+	void CompareBatch
+	(
+		const char*             sFunction,
+		const TUInt32           iIterations,
+		const CMatrix4x4&       m,
+		const EBatchTransform   eTransform,
+		const vector<TUInt8>&   input,
+		const TUInt32           iStride,
+		vector<SMathBenchmark>* pResults
+	)
+	{
+		const TUInt32 iNumVectors = static_cast<TUInt32>(input.size()) / iStride;
+		vector<TUInt8> simdOutput( input.size() );
+		vector<TUInt8> scalarOutput( input.size() );
+
+		SMathBenchmark result;
+		result.function = sFunction;
+		result.scalarTime = TimeBatch( iIterations, iNumVectors, [&]()
+		{
+			BatchTransformScalar( m, eTransform, &input[0], iStride, &scalarOutput[0], iStride, iNumVectors );
+		} );
+		result.simdTime = TimeBatch( iIterations, iNumVectors, [&]()
+		{
+			BatchTransform( m, eTransform, &input[0], iStride, &simdOutput[0], iStride, iNumVectors );
+		} );
+		result.maxDifference = 0.0f;
+		result.mismatches = 0;
+		for (TUInt32 i = 0; i < iNumVectors; ++i)
+		{
+			result.maxDifference =
+				Max( result.maxDifference,
+				     MaxDifference( *reinterpret_cast<const CVector3*>(&simdOutput[i * iStride]),
+				                    *reinterpret_cast<const CVector3*>(&scalarOutput[i * iStride]) ) );
+		}
+		pResults->push_back( result );
+	}
+
+	// Time the SIMD and scalar versions of a function applied to whole arrays of the given
+	// result type, and add the comparison to the results. Each function is given the output
+	// array, times are per element
+	template <class TResult, class TSIMDFunction, class TScalarFunction> void CompareArrays
+	(
+		const char*             sFunction,
+		const TUInt32           iIterations,
+		const TUInt32           iNumElements,
+		TSIMDFunction           simdFunction,
+		TScalarFunction         scalarFunction,
+		vector<SMathBenchmark>* pResults
+	)
+	{
+		vector<TResult> simdResults( iNumElements );
+		vector<TResult> scalarResults( iNumElements );
+
+		SMathBenchmark result;
+		result.function = sFunction;
+		result.scalarTime = TimeBatch( iIterations, iNumElements, [&]() { scalarFunction( &scalarResults[0] ); } );
+		result.simdTime = TimeBatch( iIterations, iNumElements, [&]() { simdFunction( &simdResults[0] ); } );
+		result.maxDifference = 0.0f;
+		result.mismatches = 0;
+		for (TUInt32 i = 0; i < iNumElements; ++i)
+		{
+			result.maxDifference = Max( result.maxDifference, MaxDifference( simdResults[i], scalarResults[i] ) );
+		}
+		pResults->push_back( result );
+	}
+
+	// Number of inputs used to measure the errors of each function
+	const TUInt32 kiNumPrecisionInputs = 1 << 18;
+
+	// Return the size of one unit in the last place of a TFloat32 with the given value
+	TFloat64 ULPSize( const TFloat64 x )
+	{
+		int iExponent;
+		frexp( static_cast<TFloat64>(static_cast<TFloat32>(x)), &iExponent );
+		return ldexp( 1.0, iExponent - 24 );
+	}
+
+	// Measure the errors of a function against a 64-bit reference over the given inputs, and time
+	// it over the first few of them. The function returns one or two results (e.g. sin and cos)
+	// in an array, and the reference function gives the matching 64-bit results
+	template <class TFunction, class TReference> void MeasurePrecision
+	(
+		const char*             sFunction,
+		const char*             sPrecision,
+		const TUInt32           iIterations,
+		const vector<TFloat32>& inputs,
+		const TUInt32           iNumResults,
+		TFunction               function,
+		TReference              reference,
+		vector<SMathPrecision>* pResults
+	)
+	{
+		SMathPrecision result;
+		result.function = string( sFunction ) + " (" + sPrecision + ")";
+		result.maxULPError = 0.0;
+		result.maxError = 0.0;
+		for (TUInt32 i = 0; i < inputs.size(); ++i)
+		{
+			TFloat32 afResults[2];
+			TFloat64 afReferences[2];
+			function( inputs[i], afResults );
+			reference( static_cast<TFloat64>(inputs[i]), afReferences );
+			for (TUInt32 j = 0; j < iNumResults; ++j)
+			{
+				TFloat64 fError = Abs( afResults[j] - afReferences[j] );
+				result.maxError = Max( result.maxError, fError );
+				if (afReferences[j] != 0.0)
+				{
+					result.maxULPError = Max( result.maxULPError, fError / ULPSize( afReferences[j] ) );
+				}
+			}
+		}
+
+		TFloat32 aafTimingResults[kiNumInputs][2];
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (TUInt32 i = 0; i < iIterations; ++i)
+		{
+			function( inputs[i % kiNumInputs], aafTimingResults[i % kiNumInputs] );
+		}
+		chrono::duration<TFloat64, nano> time = chrono::steady_clock::now() - start;
+		result.time = time.count() / iIterations;
+
+		pResults->push_back( result );
+	}
+
+	// Measure each function at one precision
+	template <EMathPrecision ePrecision> void MeasureFunctions
+	(
+		const char*             sPrecision,
+		const TUInt32           iIterations,
+		const vector<TFloat32>& roots,
+		const vector<TFloat32>& angles,
+		vector<SMathPrecision>* pResults
+	)
+	{
+		MeasurePrecision( "Sqrt", sPrecision, iIterations, roots, 1,
+			[]( TFloat32 x, TFloat32* pf ) { pf[0] = Sqrt<ePrecision>( x ); },
+			[]( TFloat64 x, TFloat64* pf ) { pf[0] = sqrt( x ); },
+			pResults );
+		MeasurePrecision( "InvSqrt", sPrecision, iIterations, roots, 1,
+			[]( TFloat32 x, TFloat32* pf ) { pf[0] = InvSqrt<ePrecision>( x ); },
+			[]( TFloat64 x, TFloat64* pf ) { pf[0] = 1.0 / sqrt( x ); },
+			pResults );
+		MeasurePrecision( "Sin", sPrecision, iIterations, angles, 1,
+			[]( TFloat32 x, TFloat32* pf ) { pf[0] = Sin<ePrecision>( x ); },
+			[]( TFloat64 x, TFloat64* pf ) { pf[0] = sin( x ); },
+			pResults );
+		MeasurePrecision( "Cos", sPrecision, iIterations, angles, 1,
+			[]( TFloat32 x, TFloat32* pf ) { pf[0] = Cos<ePrecision>( x ); },
+			[]( TFloat64 x, TFloat64* pf ) { pf[0] = cos( x ); },
+			pResults );
+		MeasurePrecision( "SinCos", sPrecision, iIterations, angles, 2,
+			[]( TFloat32 x, TFloat32* pf ) { SinCos<ePrecision>( x, &pf[0], &pf[1] ); },
+			[]( TFloat64 x, TFloat64* pf ) { pf[0] = sin( x ); pf[1] = cos( x ); },
+			pResults );
+	}
+
+} // anonymous namespace
+
+
+/*-----------------------------------------------------------------------------------------
+	Benchmarks
+-----------------------------------------------------------------------------------------*/
+
+// Time the CMatrix4x4 functions with SIMD implementations (multiplication, inverse, vector
+// transforms) against their scalar versions. Each function is called the given number of times
+// on a small set of random matrices. Results are appended to the given list
+void BenchmarkMatrix4x4
+(
+	const TUInt32           iIterations,
+	vector<SMathBenchmark>* pResults
+)
+{
+	// Random affine matrices (typical of hierarchy updates), and general matrices made by
+	// multiplying them by a perspective projection
+	CBenchmarkRandom random;
+	CMatrix4x4 aAffine[kiNumInputs];
+	CMatrix4x4 aGeneral[kiNumInputs];
+	CVector4   aVector4s[kiNumInputs];
+	CVector3   aVector3s[kiNumInputs];
+	CMatrix4x4 projection( 1.5f, 0.0f, 0.0f, 0.0f,
+	                       0.0f, 2.0f, 0.0f, 0.0f,
+	                       0.0f, 0.0f, 1.0f, 1.0f,
+	                       0.0f, 0.0f, -1.0f, 0.0f );
+	for (TUInt32 i = 0; i < kiNumInputs; ++i)
+	{
+		aAffine[i] = RandomAffine( &random );
+		aGeneral[i] = MultiplyScalar( aAffine[i], projection );
+		aVector4s[i] = CVector4( random.Next(), random.Next(), random.Next(), 1.0f );
+		aVector3s[i] = CVector3( random.Next(), random.Next(), random.Next() );
+	}
+
+	// Each function is given the input index and pairs it with the next input where two are needed
+	Compare<CMatrix4x4>( "CMatrix4x4 * CMatrix4x4", iIterations,
+		[&]( TUInt32 i ) { return aGeneral[i] * aGeneral[(i + 1) % kiNumInputs]; },
+		[&]( TUInt32 i ) { return MultiplyScalar( aGeneral[i], aGeneral[(i + 1) % kiNumInputs] ); },
+		pResults );
+	Compare<CMatrix4x4>( "MultiplyAffine", iIterations,
+		[&]( TUInt32 i ) { return MultiplyAffine( aAffine[i], aAffine[(i + 1) % kiNumInputs] ); },
+		[&]( TUInt32 i ) { return MultiplyAffineScalar( aAffine[i], aAffine[(i + 1) % kiNumInputs] ); },
+		pResults );
+	Compare<CMatrix4x4>( "InverseAffine", iIterations,
+		[&]( TUInt32 i ) { return InverseAffine( aAffine[i] ); },
+		[&]( TUInt32 i ) { return InverseAffineScalar( aAffine[i] ); },
+		pResults );
+	Compare<CMatrix4x4>( "Inverse", iIterations,
+		[&]( TUInt32 i ) { return Inverse( aGeneral[i] ); },
+		[&]( TUInt32 i ) { return InverseScalar( aGeneral[i] ); },
+		pResults );
+	Compare<CVector4>( "Transform", iIterations,
+		[&]( TUInt32 i ) { return aGeneral[i].Transform( aVector4s[i] ); },
+		[&]( TUInt32 i ) { return TransformScalar( aGeneral[i], aVector4s[i] ); },
+		pResults );
+	Compare<CVector3>( "TransformPoint", iIterations,
+		[&]( TUInt32 i ) { return aAffine[i].TransformPoint( aVector3s[i] ); },
+		[&]( TUInt32 i ) { return TransformPointScalar( aAffine[i], aVector3s[i] ); },
+		pResults );
+	Compare<CVector3>( "TransformVector", iIterations,
+		[&]( TUInt32 i ) { return aAffine[i].TransformVector( aVector3s[i] ); },
+		[&]( TUInt32 i ) { return TransformVectorScalar( aAffine[i], aVector3s[i] ); },
+		pResults );
+}
+
+
+// Time the batch vector transforms (see MathBatch.h) against their scalar versions, for plain
+// arrays and vertex streams. Each is run the given number of times over an array of vectors,
+// times are per vector. Results are appended to the given list
+void BenchmarkBatchTransform
+(
+	const TUInt32           iIterations,
+	vector<SMathBenchmark>* pResults
+)
+{
+	// A cache-sized plain array, a plain array large enough to use non-temporal stores and a
+	// vertex stream with the size of a typical vertex (position, normal, tangent, UV)
+	const TUInt32 kiSmallVectors = 4096;
+	const TUInt32 kiLargeVectors = 4 * kiBatchStreamingBytes / sizeof(CVector3);
+	const TUInt32 kiVertexSize = 44;
+
+	CBenchmarkRandom random;
+	CMatrix4x4 m = RandomAffine( &random );
+	vector<TUInt8> smallArray( kiSmallVectors * sizeof(CVector3) );
+	vector<TUInt8> largeArray( kiLargeVectors * sizeof(CVector3) );
+	vector<TUInt8> vertices( kiSmallVectors * kiVertexSize );
+	TFloat32* pf = reinterpret_cast<TFloat32*>(&smallArray[0]);
+	for (TUInt32 i = 0; i < smallArray.size() / sizeof(TFloat32); ++i)
+	{
+		pf[i] = random.Next();
+	}
+	pf = reinterpret_cast<TFloat32*>(&largeArray[0]);
+	for (TUInt32 i = 0; i < largeArray.size() / sizeof(TFloat32); ++i)
+	{
+		pf[i] = random.Next();
+	}
+	pf = reinterpret_cast<TFloat32*>(&vertices[0]);
+	for (TUInt32 i = 0; i < vertices.size() / sizeof(TFloat32); ++i)
+	{
+		pf[i] = random.Next();
+	}
+
+	// The large array is transformed fewer times to keep the run time similar
+	const TUInt32 iLargeIterations = Max( 1u, iIterations * kiSmallVectors / kiLargeVectors );
+	CompareBatch( "Batch points (array)", iIterations, m, kBatchPoints, smallArray,
+	              sizeof(CVector3), pResults );
+	CompareBatch( "Batch normals (array)", iIterations, m, kBatchNormals, smallArray,
+	              sizeof(CVector3), pResults );
+	CompareBatch( "Batch points (large array)", iLargeIterations, m, kBatchPoints, largeArray,
+	              sizeof(CVector3), pResults );
+	CompareBatch( "Batch points (vertices)", iIterations, m, kBatchPoints, vertices,
+	              kiVertexSize, pResults );
+	CompareBatch( "Batch normals (vertices)", iIterations, m, kBatchNormals, vertices,
+	              kiVertexSize, pResults );
+}
+
+
+// Time the batch quaternion blending and pose to matrix functions (see MathBatch.h) against
+// their scalar versions, using poses the size of a typical skeleton. Each is run the given number
+// of times, times are per bone
+void BenchmarkPoseBlend
+(
+	const TUInt32           iIterations,
+	vector<SMathBenchmark>* pResults
+)
+{
+	// Two random poses for a 60 bone skeleton
+	const TUInt32 kiNumBones = 60;
+	CBenchmarkRandom random;
+	vector<CQuatTransform> pose0( kiNumBones );
+	vector<CQuatTransform> pose1( kiNumBones );
+	for (TUInt32 i = 0; i < kiNumBones; ++i)
+	{
+		pose0[i] = CQuatTransform( RandomAffine( &random ) );
+		pose1[i] = CQuatTransform( RandomAffine( &random ) );
+	}
+	vector<CQuaternion> quats0( kiNumBones );
+	vector<CQuaternion> quats1( kiNumBones );
+	for (TUInt32 i = 0; i < kiNumBones; ++i)
+	{
+		quats0[i] = pose0[i].quat;
+		quats1[i] = pose1[i].quat;
+	}
+
+	const TFloat32 t = 0.3f;
+	CompareArrays<CQuaternion>( "BatchNLerp (quaternions)", iIterations, kiNumBones,
+		[&]( CQuaternion* pOut ) { BatchNLerp( &quats0[0], &quats1[0], t, pOut, kiNumBones ); },
+		[&]( CQuaternion* pOut ) { BatchNLerpScalar( &quats0[0], &quats1[0], t, pOut, kiNumBones ); },
+		pResults );
+	CompareArrays<CQuaternion>( "BatchSlerp (quaternions)", iIterations, kiNumBones,
+		[&]( CQuaternion* pOut ) { BatchSlerp( &quats0[0], &quats1[0], t, pOut, kiNumBones ); },
+		[&]( CQuaternion* pOut ) { BatchSlerpScalar( &quats0[0], &quats1[0], t, pOut, kiNumBones ); },
+		pResults );
+	CompareArrays<CQuatTransform>( "BatchNLerp (transforms)", iIterations, kiNumBones,
+		[&]( CQuatTransform* pOut ) { BatchNLerp( &pose0[0], &pose1[0], t, pOut, kiNumBones ); },
+		[&]( CQuatTransform* pOut ) { BatchNLerpScalar( &pose0[0], &pose1[0], t, pOut, kiNumBones ); },
+		pResults );
+	CompareArrays<CQuatTransform>( "BatchSlerp (transforms)", iIterations, kiNumBones,
+		[&]( CQuatTransform* pOut ) { BatchSlerp( &pose0[0], &pose1[0], t, pOut, kiNumBones ); },
+		[&]( CQuatTransform* pOut ) { BatchSlerpScalar( &pose0[0], &pose1[0], t, pOut, kiNumBones ); },
+		pResults );
+	CompareArrays<CMatrix4x4>( "BatchGetMatrix", iIterations, kiNumBones,
+		[&]( CMatrix4x4* pOut ) { BatchGetMatrix( &pose0[0], pOut, kiNumBones ); },
+		[&]( CMatrix4x4* pOut ) { BatchGetMatrixScalar( &pose0[0], pOut, kiNumBones ); },
+		pResults );
+}
+
+
+// Time frustum culling against its scalar version, for 100,000 random bounds spread around a
+// camera
+void BenchmarkFrustumCull
+(
+	const TUInt32           iIterations,
+	vector<SMathBenchmark>* pResults
+)
+{
+	// Camera at the origin looking along the Z axis, with a 60 degree field of view and a view
+	// distance of 1000. Bounds are placed at random in a cube around the camera twice the view
+	// distance across
+	const TUInt32 kiNumBounds = 100000;
+	const TFloat32 kfFarDistance = 1000.0f;
+	const TFloat32 kfNearDistance = 1.0f;
+	TFloat32 fYScale = 1.0f / Tan( kfPi / 6.0f );
+	TFloat32 fDepthScale = kfFarDistance / (kfFarDistance - kfNearDistance);
+	CMatrix4x4 viewProj = CMatrix4x4::kIdentity;
+	viewProj.e00 = fYScale / 1.33f;
+	viewProj.e11 = fYScale;
+	viewProj.e22 = fDepthScale;
+	viewProj.e23 = 1.0f;
+	viewProj.e32 = -kfNearDistance * fDepthScale;
+	viewProj.e33 = 0.0f;
+	SFrustum frustum;
+	ExtractFrustum( viewProj, &frustum );
+
+	CBenchmarkRandom random;
+	vector<SBounds> bounds( kiNumBounds );
+	for (TUInt32 i = 0; i < kiNumBounds; ++i)
+	{
+		bounds[i].centre = CVector3( random.Next(), random.Next(), random.Next() ) * kfFarDistance;
+		bounds[i].extents = CVector3( 3.0f + random.Next() * 2.0f, 3.0f + random.Next() * 2.0f,
+		                              3.0f + random.Next() * 2.0f );
+		bounds[i].radius = bounds[i].extents.Length();
+	}
+
+	vector<TUInt8> simdVisible( kiNumBounds );
+	vector<TUInt8> scalarVisible( kiNumBounds );
+	TUInt32 iNumVisible = 0;
+	SMathBenchmark result;
+	result.scalarTime = TimeBatch( iIterations, kiNumBounds, [&]()
+	{
+		BatchCullBoundsScalar( frustum, &bounds[0], &scalarVisible[0], kiNumBounds );
+	} );
+	result.simdTime = TimeBatch( iIterations, kiNumBounds, [&]()
+	{
+		iNumVisible = BatchCullBounds( frustum, &bounds[0], &simdVisible[0], kiNumBounds );
+	} );
+	result.maxDifference = 0.0f;
+	result.mismatches = 0;
+	for (TUInt32 i = 0; i < kiNumBounds; ++i)
+	{
+		result.mismatches += (simdVisible[i] != scalarVisible[i]) ? 1 : 0;
+	}
+
+	stringstream function;
+	function << "BatchCullBounds (" << iNumVisible << " of " << kiNumBounds << " visible)";
+	result.function = function.str();
+	pResults->push_back( result );
+}
+
+
+// Measure the errors of the TFloat32 Sqrt, InvSqrt, Sin, Cos and SinCos functions at each
+// precision against 64-bit results. Each function is also timed for the given number of calls.
+// Results are appended to the given list
+void MeasureMathPrecision
+(
+	const TUInt32           iIterations,
+	vector<SMathPrecision>* pResults
+)
+{
+	// Inputs spread evenly over the angle range and logarithmically over the square root range.
+	// Shuffled so timings aren't helped by predictable branches
+	CBenchmarkRandom random;
+	vector<TFloat32> roots( kiNumPrecisionInputs );
+	vector<TFloat32> angles( kiNumPrecisionInputs );
+	for (TUInt32 i = 0; i < kiNumPrecisionInputs; ++i)
+	{
+		TFloat64 fFraction = static_cast<TFloat64>(i) / (kiNumPrecisionInputs - 1);
+		roots[i] = static_cast<TFloat32>(pow( 10.0, -4.0 + 8.0 * fFraction ));
+		angles[i] = static_cast<TFloat32>(2.0 * kfPi64 * (2.0 * fFraction - 1.0));
+	}
+	for (TUInt32 i = kiNumPrecisionInputs - 1; i > 0; --i)
+	{
+		TUInt32 j = static_cast<TUInt32>((random.Next() + 1.0f) * 0.5f * i);
+		swap( roots[i], roots[j] );
+		swap( angles[i], angles[j] );
+	}
+
+	MeasureFunctions<kMathExact>( "exact", iIterations, roots, angles, pResults );
+	MeasureFunctions<kMathHigh>( "high", iIterations, roots, angles, pResults );
+	MeasureFunctions<kMathLow>( "low", iIterations, roots, angles, pResults );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Reporting
+-----------------------------------------------------------------------------------------*/
+
+// Return a text report of benchmark results, one line per function
+string MathBenchmarkReport( const vector<SMathBenchmark>& results )
+{
+	stringstream report;
+	report << "SIMD: " << ksMathSIMD << ksNewline;
+	for (TUInt32 i = 0; i < results.size(); ++i)
+	{
+		const SMathBenchmark& result = results[i];
+		report << left << setw( 28 ) << result.function << right << fixed << setprecision( 2 )
+		       << " scalar " << setw( 7 ) << result.scalarTime << "ns, SIMD " << setw( 7 )
+		       << result.simdTime << "ns, speedup " << setw( 5 ) << result.scalarTime / result.simdTime
+		       << "x, max difference " << scientific << setprecision( 1 ) << result.maxDifference;
+		if (result.mismatches > 0)
+		{
+			report << ", " << result.mismatches << " mismatches";
+		}
+		report << ksNewline;
+	}
+	return report.str();
+}
+
+// Return a text report of precision results, one line per function and precision
+string MathPrecisionReport( const vector<SMathPrecision>& results )
+{
+	stringstream report;
+	for (TUInt32 i = 0; i < results.size(); ++i)
+	{
+		const SMathPrecision& result = results[i];
+		report << left << setw( 18 ) << result.function << right << fixed << setprecision( 1 )
+		       << " max error " << setw( 9 ) << result.maxULPError << " ulps ("
+		       << scientific << setprecision( 1 ) << result.maxError << "), time "
+		       << fixed << setprecision( 2 ) << setw( 6 ) << result.time << "ns" << ksNewline;
+	}
+	return report.str();
+}
+
+
+} // namespace gen
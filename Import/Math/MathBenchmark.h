@@ -0,0 +1,105 @@
+/**************************************************************************************************
+	Module:       MathBenchmark.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Microbenchmarks comparing the SIMD implementations of maths functions with the portable
+	scalar versions
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#ifndef GEN_MATH_BENCHMARK_H_INCLUDED
+#define GEN_MATH_BENCHMARK_H_INCLUDED
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "GenDefines.h"
+
+namespace gen
+{
+
+// Timing of one function, comparing its SIMD and scalar implementations on the same data
+struct SMathBenchmark
+{
+	string   function;
+	TFloat64 scalarTime;    // Average time per call (nanoseconds)
+	TFloat64 simdTime;      // --"--
+	TFloat32 maxDifference; // Largest difference between any element of the two results,
+	                        // relative to the element where it is larger than 1
+	TUInt32  mismatches;    // Number of yes/no results that differ, for functions with no
+	                        // numeric results (zero for the others)
+};
+
+// Time the CMatrix4x4 functions with SIMD implementations (multiplication, inverse, vector
+// transforms) against their scalar versions. Each function is called the given number of times
+// on a small set of random matrices. Results are appended to the given list
+void BenchmarkMatrix4x4
+(
+	const TUInt32           iIterations,
+	vector<SMathBenchmark>* pResults
+);
+
+// Time the batch vector transforms (see MathBatch.h) against their scalar versions, for plain
+// arrays and vertex streams. Each is run the given number of times over an array of vectors,
+// times are per vector. Results are appended to the given list
+void BenchmarkBatchTransform
+(
+	const TUInt32           iIterations,
+	vector<SMathBenchmark>* pResults
+);
+
+// Time the batch quaternion blending and pose to matrix functions (see MathBatch.h) against
+// their scalar versions, using poses the size of a typical skeleton. Each is run the given number
+// of times, times are per bone. Results are appended to the given list
+void BenchmarkPoseBlend
+(
+	const TUInt32           iIterations,
+	vector<SMathBenchmark>* pResults
+);
+
+// Time frustum culling (see MathCull.h) against its scalar version, for 100,000 random bounds
+// spread around a camera, under a tenth of them visible. Each is run the given number of times,
+// times are per bounds. The number of bounds given different visibility is the mismatch count.
+// Results are appended to the given list
+void BenchmarkFrustumCull
+(
+	const TUInt32           iIterations,
+	vector<SMathBenchmark>* pResults
+);
+
+// Return a text report of benchmark results, one line per function
+string MathBenchmarkReport( const vector<SMathBenchmark>& results );
+
+
+// Errors and timing of one function at one precision (see EMathPrecision in BaseMath.h)
+struct SMathPrecision
+{
+	string   function;    // Function name and precision
+	TFloat64 maxULPError; // Largest error in units in the last place of the exact result
+	TFloat64 maxError;    // Largest absolute error
+	TFloat64 time;        // Average time per call (nanoseconds)
+};
+
+// Measure the errors of the TFloat32 Sqrt, InvSqrt, Sin, Cos and SinCos functions at each
+// precision against 64-bit results, over the ranges typically used (square roots of 1e-4 to 1e4,
+// angles of -2pi to 2pi). Each function is also timed for the given number of calls. Results are
+// appended to the given list
+void MeasureMathPrecision
+(
+	const TUInt32           iIterations,
+	vector<SMathPrecision>* pResults
+);
+
+// Return a text report of precision results, one line per function and precision
+string MathPrecisionReport( const vector<SMathPrecision>& results );
+
+
+} // namespace gen
+
+#endif // GEN_MATH_BENCHMARK_H_INCLUDED
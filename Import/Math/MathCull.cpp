@@ -0,0 +1,322 @@
+/**************************************************************************************************
+	Module:       MathCull.cpp
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Bounding volumes and view frustum culling - bounds for meshes and their instances, and a
+	batch test of whole arrays of bounds against a camera's view frustum
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#include "MathCull.h"
+#include "MathSIMD.h"
+#include "Error.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Local helpers
+-----------------------------------------------------------------------------------------*/
+
+namespace
+{
+	// Test one bounds against a frustum, same operations in the same order as the SIMD kernel
+	inline bool IsVisible
+	(
+		const SFrustum& frustum,
+		const SBounds&  bounds
+	)
+	{
+		if (bounds.radius < 0.0f)
+		{
+			return false;
+		}
+		for (TUInt32 iPlane = 0; iPlane < 6; ++iPlane)
+		{
+			const CVector4& plane = frustum.planes[iPlane];
+			TFloat32 fDistance = plane.x * bounds.centre.x + plane.y * bounds.centre.y + plane.z * bounds.centre.z + plane.w;
+			TFloat32 fBoxReach = Abs( plane.x ) * bounds.extents.x + Abs( plane.y ) * bounds.extents.y +
+			                     Abs( plane.z ) * bounds.extents.z;
+			if (fDistance + Min( bounds.radius, fBoxReach ) < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Return a plane normalised so that its normal has unit length
+	inline CVector4 NormalisePlane( const CVector4& plane )
+	{
+		TFloat32 fLength = Sqrt( plane.x * plane.x + plane.y * plane.y + plane.z * plane.z );
+		if (IsZero( fLength ))
+		{
+			return plane;
+		}
+		TFloat32 fInvLength = 1.0f / fLength;
+		return CVector4( plane.x * fInvLength, plane.y * fInvLength, plane.z * fInvLength, plane.w * fInvLength );
+	}
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Bounding Volumes
+-----------------------------------------------------------------------------------------*/
+
+// Calculate the bounds of a strided stream of points
+void CalculateBounds
+(
+	const TUInt8*  pPoints,
+	const TUInt32  iStride,
+	const TUInt32  iNumPoints,
+	SBounds*       pBounds
+)
+{
+	GEN_GUARD;
+
+	if (iNumPoints == 0)
+	{
+		pBounds->centre = CVector3::kZero;
+		pBounds->extents = CVector3::kZero;
+		pBounds->radius = -1.0f;
+		return;
+	}
+
+	// Box first, then the sphere about its centre
+	CVector3 minPoint = *reinterpret_cast<const CVector3*>(pPoints);
+	CVector3 maxPoint = minPoint;
+	const TUInt8* pPoint = pPoints + iStride;
+	for (TUInt32 iPoint = 1; iPoint < iNumPoints; ++iPoint, pPoint += iStride)
+	{
+		const CVector3& point = *reinterpret_cast<const CVector3*>(pPoint);
+		minPoint = CVector3( Min( minPoint.x, point.x ), Min( minPoint.y, point.y ), Min( minPoint.z, point.z ) );
+		maxPoint = CVector3( Max( maxPoint.x, point.x ), Max( maxPoint.y, point.y ), Max( maxPoint.z, point.z ) );
+	}
+	pBounds->centre = (minPoint + maxPoint) * 0.5f;
+	pBounds->extents = (maxPoint - minPoint) * 0.5f;
+
+	TFloat32 fMaxDistanceSq = 0.0f;
+	pPoint = pPoints;
+	for (TUInt32 iPoint = 0; iPoint < iNumPoints; ++iPoint, pPoint += iStride)
+	{
+		const CVector3& point = *reinterpret_cast<const CVector3*>(pPoint);
+		fMaxDistanceSq = Max( fMaxDistanceSq, (point - pBounds->centre).LengthSquared() );
+	}
+	pBounds->radius = Sqrt( fMaxDistanceSq );
+
+	GEN_ENDGUARD;
+}
+
+// Return the bounds of the given bounds after transformation by an affine matrix
+SBounds TransformBounds
+(
+	const SBounds&    bounds,
+	const CMatrix4x4& m
+)
+{
+	if (bounds.radius < 0.0f)
+	{
+		return bounds;
+	}
+
+	// Each axis of the new box reaches as far as the sum of the reaches of the transformed axes
+	// of the old box
+	SBounds outBounds;
+	outBounds.centre = m.TransformPoint( bounds.centre );
+	outBounds.extents.x = Abs( m.e00 ) * bounds.extents.x + Abs( m.e10 ) * bounds.extents.y + Abs( m.e20 ) * bounds.extents.z;
+	outBounds.extents.y = Abs( m.e01 ) * bounds.extents.x + Abs( m.e11 ) * bounds.extents.y + Abs( m.e21 ) * bounds.extents.z;
+	outBounds.extents.z = Abs( m.e02 ) * bounds.extents.x + Abs( m.e12 ) * bounds.extents.y + Abs( m.e22 ) * bounds.extents.z;
+	CVector3 scale = m.GetScale();
+	outBounds.radius = bounds.radius * Max( Max( scale.x, scale.y ), scale.z );
+	return outBounds;
+}
+
+// Return bounds enclosing both of the given bounds
+SBounds MergeBounds
+(
+	const SBounds& bounds0,
+	const SBounds& bounds1
+)
+{
+	if (bounds0.radius < 0.0f)
+	{
+		return bounds1;
+	}
+	if (bounds1.radius < 0.0f)
+	{
+		return bounds0;
+	}
+
+	CVector3 min0 = bounds0.centre - bounds0.extents, max0 = bounds0.centre + bounds0.extents;
+	CVector3 min1 = bounds1.centre - bounds1.extents, max1 = bounds1.centre + bounds1.extents;
+	CVector3 minPoint( Min( min0.x, min1.x ), Min( min0.y, min1.y ), Min( min0.z, min1.z ) );
+	CVector3 maxPoint( Max( max0.x, max1.x ), Max( max0.y, max1.y ), Max( max0.z, max1.z ) );
+
+	SBounds outBounds;
+	outBounds.centre = (minPoint + maxPoint) * 0.5f;
+	outBounds.extents = (maxPoint - minPoint) * 0.5f;
+	outBounds.radius = Max( (bounds0.centre - outBounds.centre).Length() + bounds0.radius,
+	                        (bounds1.centre - outBounds.centre).Length() + bounds1.radius );
+	return outBounds;
+}
+
+// Return the given bounds enlarged by a distance in all directions
+SBounds ExpandBounds
+(
+	const SBounds& bounds,
+	const TFloat32 fDistance
+)
+{
+	if (bounds.radius < 0.0f)
+	{
+		return bounds;
+	}
+
+	SBounds outBounds;
+	outBounds.centre = bounds.centre;
+	outBounds.extents = bounds.extents + CVector3( fDistance, fDistance, fDistance );
+	outBounds.radius = bounds.radius + fDistance;
+	return outBounds;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	View Frustum
+-----------------------------------------------------------------------------------------*/
+
+// Extract the frustum planes from a view-projection matrix. Clip space coordinates are a point
+// multiplied by each column of the matrix, and a point is inside the frustum if -w <= x <= w,
+// -w <= y <= w and 0 <= z <= w. So each plane is a sum or difference of columns
+void ExtractFrustum
+(
+	const CMatrix4x4& viewProj,
+	SFrustum*         pFrustum
+)
+{
+	const CMatrix4x4& m = viewProj;
+	CVector4 column0( m.e00, m.e10, m.e20, m.e30 );
+	CVector4 column1( m.e01, m.e11, m.e21, m.e31 );
+	CVector4 column2( m.e02, m.e12, m.e22, m.e32 );
+	CVector4 column3( m.e03, m.e13, m.e23, m.e33 );
+	pFrustum->planes[0] = NormalisePlane( column3 + column0 ); // Left
+	pFrustum->planes[1] = NormalisePlane( column3 - column0 ); // Right
+	pFrustum->planes[2] = NormalisePlane( column3 + column1 ); // Bottom
+	pFrustum->planes[3] = NormalisePlane( column3 - column1 ); // Top
+	pFrustum->planes[4] = NormalisePlane( column2 );           // Near
+	pFrustum->planes[5] = NormalisePlane( column3 - column2 ); // Far
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch Frustum Culling
+-----------------------------------------------------------------------------------------*/
+
+// Test an array of bounds against a frustum, four bounds at a time
+TUInt32 BatchCullBounds
+(
+	const SFrustum& frustum,
+	const SBounds*  pBounds,
+	TUInt8*         pVisible,
+	const TUInt32   iNumBounds
+)
+{
+	GEN_GUARD;
+
+#if defined(GEN_SIMD_SSE)
+	// Plane elements splatted across registers, and the absolute values of the normals
+	__m128 aPlaneX[6], aPlaneY[6], aPlaneZ[6], aPlaneW[6], aAbsX[6], aAbsY[6], aAbsZ[6];
+	for (TUInt32 iPlane = 0; iPlane < 6; ++iPlane)
+	{
+		const CVector4& plane = frustum.planes[iPlane];
+		aPlaneX[iPlane] = _mm_set1_ps( plane.x );
+		aPlaneY[iPlane] = _mm_set1_ps( plane.y );
+		aPlaneZ[iPlane] = _mm_set1_ps( plane.z );
+		aPlaneW[iPlane] = _mm_set1_ps( plane.w );
+		aAbsX[iPlane] = _mm_set1_ps( Abs( plane.x ) );
+		aAbsY[iPlane] = _mm_set1_ps( Abs( plane.y ) );
+		aAbsZ[iPlane] = _mm_set1_ps( Abs( plane.z ) );
+	}
+	const __m128 zero = _mm_setzero_ps();
+
+	TUInt32 iNumVisible = 0;
+	TUInt32 iBounds = 0;
+	for (; iBounds + 4 <= iNumBounds; iBounds += 4)
+	{
+		// Bounds to structure-of-arrays form
+		const SBounds& b0 = pBounds[iBounds];
+		const SBounds& b1 = pBounds[iBounds + 1];
+		const SBounds& b2 = pBounds[iBounds + 2];
+		const SBounds& b3 = pBounds[iBounds + 3];
+		__m128 centreX = _mm_set_ps( b3.centre.x, b2.centre.x, b1.centre.x, b0.centre.x );
+		__m128 centreY = _mm_set_ps( b3.centre.y, b2.centre.y, b1.centre.y, b0.centre.y );
+		__m128 centreZ = _mm_set_ps( b3.centre.z, b2.centre.z, b1.centre.z, b0.centre.z );
+		__m128 extentsX = _mm_set_ps( b3.extents.x, b2.extents.x, b1.extents.x, b0.extents.x );
+		__m128 extentsY = _mm_set_ps( b3.extents.y, b2.extents.y, b1.extents.y, b0.extents.y );
+		__m128 extentsZ = _mm_set_ps( b3.extents.z, b2.extents.z, b1.extents.z, b0.extents.z );
+		__m128 radius = _mm_set_ps( b3.radius, b2.radius, b1.radius, b0.radius );
+
+		// Accumulate a mask of bounds outside any plane, starting with the empty bounds
+		__m128 outside = _mm_cmplt_ps( radius, zero );
+		for (TUInt32 iPlane = 0; iPlane < 6; ++iPlane)
+		{
+			__m128 distance = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( aPlaneX[iPlane], centreX ),
+			                                                      _mm_mul_ps( aPlaneY[iPlane], centreY ) ),
+			                                          _mm_mul_ps( aPlaneZ[iPlane], centreZ ) ), aPlaneW[iPlane] );
+			__m128 boxReach = _mm_add_ps( _mm_add_ps( _mm_mul_ps( aAbsX[iPlane], extentsX ), _mm_mul_ps( aAbsY[iPlane], extentsY ) ),
+			                              _mm_mul_ps( aAbsZ[iPlane], extentsZ ) );
+			__m128 reach = _mm_min_ps( boxReach, radius ); // Same result as scalar Min( radius, boxReach ), neither is NaN
+			outside = _mm_or_ps( outside, _mm_cmplt_ps( _mm_add_ps( distance, reach ), zero ) );
+		}
+
+		TUInt32 iOutside = _mm_movemask_ps( outside );
+		for (TUInt32 i = 0; i < 4; ++i)
+		{
+			TUInt8 visible = ((iOutside >> i) & 1) ? 0 : 1;
+			pVisible[iBounds + i] = visible;
+			iNumVisible += visible;
+		}
+	}
+
+	// Remaining bounds one at a time
+	for (; iBounds < iNumBounds; ++iBounds)
+	{
+		pVisible[iBounds] = IsVisible( frustum, pBounds[iBounds] ) ? 1 : 0;
+		iNumVisible += pVisible[iBounds];
+	}
+	return iNumVisible;
+#else
+	return BatchCullBoundsScalar( frustum, pBounds, pVisible, iNumBounds );
+#endif
+
+	GEN_ENDGUARD;
+}
+
+// Portable version of BatchCullBounds, tests one bounds at a time
+TUInt32 BatchCullBoundsScalar
+(
+	const SFrustum& frustum,
+	const SBounds*  pBounds,
+	TUInt8*         pVisible,
+	const TUInt32   iNumBounds
+)
+{
+	GEN_GUARD;
+
+	TUInt32 iNumVisible = 0;
+	for (TUInt32 iBounds = 0; iBounds < iNumBounds; ++iBounds)
+	{
+		pVisible[iBounds] = IsVisible( frustum, pBounds[iBounds] ) ? 1 : 0;
+		iNumVisible += pVisible[iBounds];
+	}
+	return iNumVisible;
+
+	GEN_ENDGUARD;
+}
+
+
+} // namespace gen
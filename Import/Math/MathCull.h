@@ -0,0 +1,128 @@
+/**************************************************************************************************
+	Module:       MathCull.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Bounding volumes and view frustum culling - bounds for meshes and their instances, and a
+	batch test of whole arrays of bounds against a camera's view frustum
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#ifndef GEN_MATH_CULL_H_INCLUDED
+#define GEN_MATH_CULL_H_INCLUDED
+
+#include "GenDefines.h"
+#include "CVector3.h"
+#include "CVector4.h"
+#include "CMatrix4x4.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Bounding Volumes
+-----------------------------------------------------------------------------------------*/
+
+// Bounds of a set of points: an axis-aligned bounding box given as centre and half-size, and a
+// bounding sphere about the same centre. The sphere is not the smallest possible, but has the
+// smallest radius for that centre and shares it with the box so a single distance serves both
+// tests in the culling below. Empty bounds (no points) have a negative radius
+struct SBounds
+{
+	CVector3 centre;
+	CVector3 extents; // Half the size of the box in each axis
+	TFloat32 radius;
+};
+
+// Calculate the bounds of a strided stream of points, given as a pointer to the first CVector3
+// and the number of bytes from one to the next (see BatchTransform in MathBatch.h)
+void CalculateBounds
+(
+	const TUInt8*  pPoints,
+	const TUInt32  iStride,
+	const TUInt32  iNumPoints,
+	SBounds*       pBounds
+);
+
+// Return the bounds of the given bounds after transformation by an affine matrix. The box is the
+// box enclosing the transformed box, the sphere radius is scaled by the largest matrix scaling
+SBounds TransformBounds
+(
+	const SBounds&    bounds,
+	const CMatrix4x4& m
+);
+
+// Return bounds enclosing both of the given bounds. Either may be empty
+SBounds MergeBounds
+(
+	const SBounds& bounds0,
+	const SBounds& bounds1
+);
+
+// Return the given bounds enlarged by a distance in all directions, e.g. to allow for the error
+// in quantised vertex positions
+SBounds ExpandBounds
+(
+	const SBounds& bounds,
+	const TFloat32 fDistance
+);
+
+
+/*-----------------------------------------------------------------------------------------
+	View Frustum
+-----------------------------------------------------------------------------------------*/
+
+// The six planes enclosing the volume a camera can see. Each plane is (a, b, c, d) with unit
+// normal (a, b, c) pointing into the frustum: points p inside have a*p.x + b*p.y + c*p.z + d >= 0
+struct SFrustum
+{
+	CVector4 planes[6]; // Left, right, bottom, top, near, far
+};
+
+// Extract the frustum planes from a view-projection matrix (or a world-view-projection matrix to
+// get the frustum in that model's space). Assumes DirectX conventions: row vectors and clip space
+// depth from 0 to 1
+void ExtractFrustum
+(
+	const CMatrix4x4& viewProj,
+	SFrustum*         pFrustum
+);
+
+
+/*-----------------------------------------------------------------------------------------
+	Batch Frustum Culling
+-----------------------------------------------------------------------------------------*/
+// Bounds are tested four at a time in structure-of-arrays form. Bounds are outside the frustum
+// if they are entirely outside any one plane, using the sphere or the box, whichever reaches
+// less far towards the plane. This is conservative: bounds near a corner of the frustum may be
+// reported visible when they are not, but visible bounds are never culled. Empty bounds are
+// always culled
+
+// Test an array of bounds against a frustum. The result for each is written to the given array
+// of flags: 1 if visible, 0 if culled. Returns the number visible
+TUInt32 BatchCullBounds
+(
+	const SFrustum& frustum,
+	const SBounds*  pBounds,
+	TUInt8*         pVisible,
+	const TUInt32   iNumBounds
+);
+
+// Portable version of BatchCullBounds, tests one bounds at a time. Available to test and
+// benchmark the SIMD version, results are identical
+TUInt32 BatchCullBoundsScalar
+(
+	const SFrustum& frustum,
+	const SBounds*  pBounds,
+	TUInt8*         pVisible,
+	const TUInt32   iNumBounds
+);
+
+
+} // namespace gen
+
+#endif // GEN_MATH_CULL_H_INCLUDED
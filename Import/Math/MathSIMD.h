@@ -0,0 +1,103 @@
+/**************************************************************************************************
+	Module:       MathSIMD.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Selection of the SIMD instruction set used by the maths classes, and helper functions for
+	their SIMD implementations. Only needed by maths .cpp files, not by users of the classes
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+// The SIMD implementations are selected at compile time from the instruction sets the compiler
+// targets: SSE2 is used on all x64 builds and on x86 builds with /arch:SSE2 (MSVC) or -msse2
+// (GCC), AVX is additionally used with /arch:AVX or -mavx. Define GEN_NO_SIMD in the project
+// settings to use the portable scalar code everywhere
+//
+// Where possible the SIMD versions give the same results as the scalar ones: the same operations
+// are performed in the same order, only several elements at once. Exceptions are noted with the
+// function (e.g. the general matrix inverse)
+
+#ifndef GEN_MATH_SIMD_H_INCLUDED
+#define GEN_MATH_SIMD_H_INCLUDED
+
+#include "GenDefines.h"
+
+#if !defined(GEN_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define GEN_SIMD_SSE
+	#include <emmintrin.h>
+	#if defined(__AVX__)
+		#define GEN_SIMD_AVX
+		#include <immintrin.h>
+	#endif
+#endif
+
+namespace gen
+{
+
+/*------------------------------------------------------------------------------------------------
+	Constants
+ ------------------------------------------------------------------------------------------------*/
+
+// Name of the SIMD instruction set used by the maths classes
+#if defined(GEN_SIMD_AVX)
+	const char* const ksMathSIMD = "AVX";
+#elif defined(GEN_SIMD_SSE)
+	const char* const ksMathSIMD = "SSE2";
+#else
+	const char* const ksMathSIMD = "None (scalar)";
+#endif
+
+
+#if defined(GEN_SIMD_SSE)
+
+/*------------------------------------------------------------------------------------------------
+	SSE helpers
+ ------------------------------------------------------------------------------------------------*/
+// Loads and stores are unaligned: maths classes are declared 16-byte aligned, but may be stored
+// in containers or mapped files that only guarantee 4-byte alignment. On current processors an
+// unaligned load of aligned data costs the same as an aligned load
+
+// Load / store four floats
+inline __m128 SIMDLoad( const TFloat32* pf )
+{
+	return _mm_loadu_ps( pf );
+}
+inline void SIMDStore
+(
+	TFloat32*    pf,
+	const __m128 v
+)
+{
+	_mm_storeu_ps( pf, v );
+}
+
+// Return a vector with all four elements set to the given element of a vector
+template <int i> inline __m128 SIMDSplat( const __m128 v )
+{
+	return _mm_shuffle_ps( v, v, _MM_SHUFFLE(i, i, i, i) );
+}
+
+// Return the horizontal sum of the four elements of a vector in all elements
+inline __m128 SIMDSum( const __m128 v )
+{
+	__m128 vSum = _mm_add_ps( v, _mm_shuffle_ps( v, v, _MM_SHUFFLE(2, 3, 0, 1) ) );
+	return _mm_add_ps( vSum, _mm_shuffle_ps( vSum, vSum, _MM_SHUFFLE(1, 0, 3, 2) ) );
+}
+
+// Return a mask selecting the x, y and z elements of a vector (use with _mm_and_ps)
+inline __m128 SIMDMaskXYZ()
+{
+	return _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+}
+
+#endif // GEN_SIMD_SSE
+
+
+} // namespace gen
+
+#endif // GEN_MATH_SIMD_H_INCLUDED
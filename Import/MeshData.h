@@ -15,6 +15,7 @@ using namespace std;
 #include "GenDefines.h"
 #include "Colour.h"
 #include "CMatrix4x4.h"
+#include "MathCull.h"
 
 namespace gen
 {
@@ -53,16 +54,27 @@ struct SMeshNode
 };
 
 
-// A single face in a mesh - all faces are triangles
+// A single face in a mesh - all faces are triangles. Faces use 16-bit vertex indices where
+// possible, 32-bit indices are only used by sub-meshes with too many vertices for 16 bits
 struct SMeshFace
 {
 	TUInt16 aiVertex[3];
 };
 typedef vector<SMeshFace> TMeshFaces;
 
+struct SMeshFace32
+{
+	TUInt32 aiVertex[3];
+};
+typedef vector<SMeshFace32> TMeshFaces32;
+
+// Maximum number of vertices in a sub-mesh using 16-bit indices
+const TUInt32 kiMaxVertices16 = 0x10000;
+
 // A sub-mesh is a single block of geometry that uses the same material. It contains a set of faces
 // and vertices and is controlled by a single node. The vertices are pointed to as raw bytes,
-// because of the flexibility of vertex data
+// because of the flexibility of vertex data. The faces are also raw bytes, an array of SMeshFace
+// if the index size is 2 or of SMeshFace32 if it is 4
 struct SSubMesh
 {
 	TUInt32    node;        // Node in heirarchy controlling this submesh
@@ -73,7 +85,9 @@ struct SSubMesh
 	bool       hasSkinningData, hasNormals, hasTangents, // Components of each vertex
 	           hasTextureCoords, hasVertexColours;       // (Vertex coordinate assumed)
 	TUInt32    numFaces;
-	SMeshFace* faces;
+	TUInt8*    faces;       // Pointer to raw face data, three indices per face
+	TUInt32    indexSize;   // Size in bytes of a single vertex index (2 or 4)
+	SBounds    bounds;      // Bounds of the vertex positions, in the space of the node
 };
 
 
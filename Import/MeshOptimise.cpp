@@ -0,0 +1,343 @@
+/**************************************************************************************************
+	Module:       MeshOptimise.cpp
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Mesh optimisation - reordering of faces and vertices for the GPU vertex caches, and CPU-side
+	measurement of vertex cache efficiency
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#include <math.h>
+#include <vector>
+using namespace std;
+
+#include "MeshOptimise.h"
+#include "Error.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Local helpers
+-----------------------------------------------------------------------------------------*/
+
+namespace
+{
+	// Scoring constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	const TFloat32 kfCacheDecayPower = 1.5f;
+	const TFloat32 kfLastFaceScore = 0.75f;
+	const TFloat32 kfValenceBoostScale = 2.0f;
+	const TFloat32 kfValenceBoostPower = 0.5f;
+
+	// Marks no face chosen or vertex not yet remapped
+	const TUInt32 kiNone = 0xffffffff;
+
+	// Score of a vertex from its position in the modelled cache (-1 if not in the cache) and the
+	// number of faces still to be added that use it. Higher scores are better
+	TFloat32 VertexScore
+	(
+		const TInt32  iCachePosition,
+		const TUInt32 iNumRemainingFaces
+	)
+	{
+		if (iNumRemainingFaces == 0)
+		{
+			return -1.0f;
+		}
+
+		TFloat32 fScore = 0.0f;
+		if (iCachePosition >= 0)
+		{
+			// Vertices of the last face added score the same, so the direction the mesh is
+			// walked doesn't matter. Otherwise the score drops off with position in the cache
+			if (iCachePosition < 3)
+			{
+				fScore = kfLastFaceScore;
+			}
+			else
+			{
+				const TFloat32 fScaler = 1.0f / (kiOptimiseCacheSize - 3);
+				fScore = powf( 1.0f - (iCachePosition - 3) * fScaler, kfCacheDecayPower );
+			}
+		}
+
+		// Boost vertices with few faces remaining, so lone faces are not left behind
+		fScore += kfValenceBoostScale *
+		          powf( static_cast<TFloat32>(iNumRemainingFaces), -kfValenceBoostPower );
+		return fScore;
+	}
+
+	// Read an index from a list of faces with the given index size
+	inline TUInt32 GetIndex
+	(
+		const TUInt8* pFaces,
+		const TUInt32 iIndexSize,
+		const TUInt32 iIndex
+	)
+	{
+		return (iIndexSize == sizeof(TUInt16)) ? reinterpret_cast<const TUInt16*>(pFaces)[iIndex] :
+		                                         reinterpret_cast<const TUInt32*>(pFaces)[iIndex];
+	}
+}
+
+
+/*------------------------------------------------------------------------------------------------
+	Face and vertex reordering
+ ------------------------------------------------------------------------------------------------*/
+
+// Reorder the faces of an indexed triangle list to make good use of the post-transform vertex
+// cache. Uses Tom Forsyth's linear-speed vertex cache optimisation: triangles are added one at a
+// time, picking the one whose vertices are most recently used and have fewest faces remaining.
+// Indices are given as three per face, and must be less than the given number of vertices. The
+// faces are left unchanged if the original order is already as good
+void OptimiseFaceOrder
+(
+	TUInt32*      pIndices,
+	const TUInt32 iNumFaces,
+	const TUInt32 iNumVertices
+)
+{
+	GEN_GUARD;
+
+	if (iNumFaces == 0)
+	{
+		return;
+	}
+	const TUInt32 iNumIndices = iNumFaces * 3;
+
+	// List the faces using each vertex - the faces for a vertex are found at vertexFaceStarts[v]
+	// to vertexFaceStarts[v + 1] in the vertexFaces list
+	vector<TUInt32> vertexFaceStarts( iNumVertices + 1, 0 );
+	for (TUInt32 iIndex = 0; iIndex < iNumIndices; ++iIndex)
+	{
+		++vertexFaceStarts[pIndices[iIndex] + 1];
+	}
+	for (TUInt32 iVertex = 0; iVertex < iNumVertices; ++iVertex)
+	{
+		vertexFaceStarts[iVertex + 1] += vertexFaceStarts[iVertex];
+	}
+	vector<TUInt32> vertexFaces( iNumIndices );
+	vector<TUInt32> numRemainingFaces( iNumVertices, 0 );
+	for (TUInt32 iIndex = 0; iIndex < iNumIndices; ++iIndex)
+	{
+		TUInt32 iVertex = pIndices[iIndex];
+		vertexFaces[vertexFaceStarts[iVertex] + numRemainingFaces[iVertex]++] = iIndex / 3;
+	}
+
+	// Initial vertex and face scores
+	vector<TInt32> cachePositions( iNumVertices, -1 );
+	vector<TFloat32> vertexScores( iNumVertices );
+	for (TUInt32 iVertex = 0; iVertex < iNumVertices; ++iVertex)
+	{
+		vertexScores[iVertex] = VertexScore( -1, numRemainingFaces[iVertex] );
+	}
+	vector<TFloat32> faceScores( iNumFaces );
+	vector<bool> facesAdded( iNumFaces, false );
+	TUInt32 iBestFace = 0;
+	for (TUInt32 iFace = 0; iFace < iNumFaces; ++iFace)
+	{
+		faceScores[iFace] = vertexScores[pIndices[iFace * 3]] + vertexScores[pIndices[iFace * 3 + 1]] +
+		                    vertexScores[pIndices[iFace * 3 + 2]];
+		if (faceScores[iFace] > faceScores[iBestFace])
+		{
+			iBestFace = iFace;
+		}
+	}
+
+	// Modelled LRU cache, with room for the vertices pushed out by a new face
+	TUInt32 aiCache[kiOptimiseCacheSize + 3];
+	TUInt32 iCacheSize = 0;
+
+	vector<TUInt32> newIndices( iNumIndices );
+	TUInt32 iNextUnaddedFace = 0;
+	for (TUInt32 iNewFace = 0; iNewFace < iNumFaces; ++iNewFace)
+	{
+		// If no face is touching the cache, continue from the next face not yet added
+		if (iBestFace == kiNone)
+		{
+			while (facesAdded[iNextUnaddedFace])
+			{
+				++iNextUnaddedFace;
+			}
+			iBestFace = iNextUnaddedFace;
+		}
+
+		// Add the best face, removing it from the remaining faces of its vertices
+		const TUInt32* pFace = &pIndices[iBestFace * 3];
+		newIndices[iNewFace * 3]     = pFace[0];
+		newIndices[iNewFace * 3 + 1] = pFace[1];
+		newIndices[iNewFace * 3 + 2] = pFace[2];
+		facesAdded[iBestFace] = true;
+		for (TUInt32 i = 0; i < 3; ++i)
+		{
+			--numRemainingFaces[pFace[i]];
+		}
+
+		// Move the face's vertices to the front of the cache, others move back to make room
+		TUInt32 aiNewCache[kiOptimiseCacheSize + 3];
+		aiNewCache[0] = pFace[0];
+		aiNewCache[1] = pFace[1];
+		aiNewCache[2] = pFace[2];
+		TUInt32 iNewCacheSize = 3;
+		for (TUInt32 iEntry = 0; iEntry < iCacheSize; ++iEntry)
+		{
+			TUInt32 iVertex = aiCache[iEntry];
+			if (iVertex != pFace[0] && iVertex != pFace[1] && iVertex != pFace[2])
+			{
+				aiNewCache[iNewCacheSize++] = iVertex;
+			}
+		}
+
+		// Update scores of every vertex that was or is in the cache, and of their faces. Vertices
+		// pushed out of the cache are rescored but the next face is chosen from those in the cache
+		iBestFace = kiNone;
+		TFloat32 fBestScore = -1.0f;
+		for (TUInt32 iEntry = 0; iEntry < iNewCacheSize; ++iEntry)
+		{
+			TUInt32 iVertex = aiNewCache[iEntry];
+			cachePositions[iVertex] = (iEntry < kiOptimiseCacheSize) ? static_cast<TInt32>(iEntry) : -1;
+			vertexScores[iVertex] = VertexScore( cachePositions[iVertex], numRemainingFaces[iVertex] );
+		}
+		for (TUInt32 iEntry = 0; iEntry < iNewCacheSize; ++iEntry)
+		{
+			TUInt32 iVertex = aiNewCache[iEntry];
+			for (TUInt32 iVertexFace = vertexFaceStarts[iVertex];
+			     iVertexFace < vertexFaceStarts[iVertex + 1]; ++iVertexFace)
+			{
+				TUInt32 iFace = vertexFaces[iVertexFace];
+				if (!facesAdded[iFace])
+				{
+					faceScores[iFace] = vertexScores[pIndices[iFace * 3]] +
+					                    vertexScores[pIndices[iFace * 3 + 1]] +
+					                    vertexScores[pIndices[iFace * 3 + 2]];
+					if (iEntry < kiOptimiseCacheSize && faceScores[iFace] > fBestScore)
+					{
+						fBestScore = faceScores[iFace];
+						iBestFace = iFace;
+					}
+				}
+			}
+		}
+
+		// Keep the cache to its modelled size
+		iCacheSize = (iNewCacheSize < kiOptimiseCacheSize) ? iNewCacheSize : kiOptimiseCacheSize;
+		for (TUInt32 iEntry = 0; iEntry < iCacheSize; ++iEntry)
+		{
+			aiCache[iEntry] = aiNewCache[iEntry];
+		}
+	}
+
+	// Some meshes are already well ordered (e.g. exported from a stripifier), only use the new order
+	// if it is better for a FIFO cache of the modelled size
+	SVertexCacheStats oldStats, newStats;
+	MeasureVertexCache( reinterpret_cast<const TUInt8*>(pIndices), sizeof(TUInt32), iNumFaces,
+	                    iNumVertices, kiOptimiseCacheSize, &oldStats );
+	MeasureVertexCache( reinterpret_cast<const TUInt8*>(&newIndices[0]), sizeof(TUInt32), iNumFaces,
+	                    iNumVertices, kiOptimiseCacheSize, &newStats );
+	if (newStats.numTransforms < oldStats.numTransforms)
+	{
+		for (TUInt32 iIndex = 0; iIndex < iNumIndices; ++iIndex)
+		{
+			pIndices[iIndex] = newIndices[iIndex];
+		}
+	}
+
+	GEN_ENDGUARD;
+}
+
+
+// Reorder vertices into the order they are first used by the given faces, improving locality of
+// vertex fetches (best done after OptimiseFaceOrder). The faces are updated to use the new vertex
+// order. The new position of each original vertex is returned in the given array, which must
+// have space for the number of vertices. Unused vertices are moved to the end. Returns the
+// number of vertices used by the faces
+TUInt32 OptimiseVertexOrder
+(
+	TUInt32*      pIndices,
+	const TUInt32 iNumFaces,
+	const TUInt32 iNumVertices,
+	TUInt32*      pVertexRemap
+)
+{
+	GEN_GUARD;
+
+	for (TUInt32 iVertex = 0; iVertex < iNumVertices; ++iVertex)
+	{
+		pVertexRemap[iVertex] = kiNone;
+	}
+
+	TUInt32 iNumUsedVertices = 0;
+	for (TUInt32 iIndex = 0; iIndex < iNumFaces * 3; ++iIndex)
+	{
+		TUInt32& iVertex = pIndices[iIndex];
+		if (pVertexRemap[iVertex] == kiNone)
+		{
+			pVertexRemap[iVertex] = iNumUsedVertices++;
+		}
+		iVertex = pVertexRemap[iVertex];
+	}
+
+	TUInt32 iNextVertex = iNumUsedVertices;
+	for (TUInt32 iVertex = 0; iVertex < iNumVertices; ++iVertex)
+	{
+		if (pVertexRemap[iVertex] == kiNone)
+		{
+			pVertexRemap[iVertex] = iNextVertex++;
+		}
+	}
+
+	return iNumUsedVertices;
+
+	GEN_ENDGUARD;
+}
+
+
+/*------------------------------------------------------------------------------------------------
+	Vertex cache measurement
+ ------------------------------------------------------------------------------------------------*/
+
+// Measure the vertex cache efficiency of a list of faces with the given index size (2 or 4
+// bytes), simulating a FIFO cache of the given size. Typical hardware caches are 16 to 32
+// entries. Allows face ordering to be assessed without a GPU
+void MeasureVertexCache
+(
+	const TUInt8*      pFaces,
+	const TUInt32      iIndexSize,
+	const TUInt32      iNumFaces,
+	const TUInt32      iNumVertices,
+	const TUInt32      iCacheSize,
+	SVertexCacheStats* pStats
+)
+{
+	GEN_GUARD;
+
+	// A vertex is in the FIFO cache if it was transformed within the last iCacheSize transforms.
+	// Store the transform count when each vertex was last transformed
+	vector<TUInt32> transformTimes( iNumVertices, 0 );
+	TUInt32 iNumTransforms = 0;
+	for (TUInt32 iIndex = 0; iIndex < iNumFaces * 3; ++iIndex)
+	{
+		TUInt32 iVertex = GetIndex( pFaces, iIndexSize, iIndex );
+		if (transformTimes[iVertex] == 0 || iNumTransforms - transformTimes[iVertex] >= iCacheSize)
+		{
+			++iNumTransforms;
+			transformTimes[iVertex] = iNumTransforms;
+		}
+	}
+
+	pStats->numFaces = iNumFaces;
+	pStats->numVertices = iNumVertices;
+	pStats->numTransforms = iNumTransforms;
+	pStats->acmr = iNumFaces ? static_cast<TFloat32>(iNumTransforms) / iNumFaces : 0.0f;
+	pStats->atvr = iNumVertices ? static_cast<TFloat32>(iNumTransforms) / iNumVertices : 0.0f;
+
+	GEN_ENDGUARD;
+}
+
+
+} // namespace gen
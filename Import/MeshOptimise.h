@@ -0,0 +1,101 @@
+/**************************************************************************************************
+	Module:       MeshOptimise.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Mesh optimisation - reordering of faces and vertices for the GPU vertex caches, and CPU-side
+	measurement of vertex cache efficiency
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#ifndef GEN_MESH_OPTIMISE_H_INCLUDED
+#define GEN_MESH_OPTIMISE_H_INCLUDED
+
+#include "GenDefines.h"
+#include "MeshData.h"
+
+namespace gen
+{
+
+/*------------------------------------------------------------------------------------------------
+	Face and vertex reordering
+ ------------------------------------------------------------------------------------------------*/
+
+// Size of the post-transform vertex cache modelled when reordering faces. The ordering is not very
+// sensitive to the exact size, 32 is a good fit for most GPUs
+const TUInt32 kiOptimiseCacheSize = 32;
+
+// Reorder the faces of an indexed triangle list to make good use of the post-transform vertex
+// cache. Uses Tom Forsyth's linear-speed vertex cache optimisation: triangles are added one at a
+// time, picking the one whose vertices are most recently used and have fewest faces remaining.
+// Indices are given as three per face, and must be less than the given number of vertices. The
+// faces are left unchanged if the original order is already as good
+void OptimiseFaceOrder
+(
+	TUInt32*      pIndices,
+	const TUInt32 iNumFaces,
+	const TUInt32 iNumVertices
+);
+
+// Reorder vertices into the order they are first used by the given faces, improving locality of
+// vertex fetches (best done after OptimiseFaceOrder). The faces are updated to use the new vertex
+// order. The new position of each original vertex is returned in the given array, which must
+// have space for the number of vertices. Unused vertices are moved to the end. Returns the
+// number of vertices used by the faces
+TUInt32 OptimiseVertexOrder
+(
+	TUInt32*      pIndices,
+	const TUInt32 iNumFaces,
+	const TUInt32 iNumVertices,
+	TUInt32*      pVertexRemap
+);
+
+
+/*------------------------------------------------------------------------------------------------
+	Vertex cache measurement
+ ------------------------------------------------------------------------------------------------*/
+
+// Vertex cache statistics for a mesh, from a simulation of a FIFO post-transform cache
+struct SVertexCacheStats
+{
+	TUInt32  numFaces;
+	TUInt32  numVertices;
+	TUInt32  numTransforms; // Vertex shader runs (cache misses)
+	TFloat32 acmr;          // Average cache miss ratio - transforms per face, 0.5 is ideal for a
+	                        // large regular mesh, 3 is the worst case
+	TFloat32 atvr;          // Average transform to vertex ratio - 1 is ideal
+};
+
+// Measure the vertex cache efficiency of a list of faces with the given index size (2 or 4
+// bytes), simulating a FIFO cache of the given size. Typical hardware caches are 16 to 32
+// entries. Allows face ordering to be assessed without a GPU
+void MeasureVertexCache
+(
+	const TUInt8*      pFaces,
+	const TUInt32      iIndexSize,
+	const TUInt32      iNumFaces,
+	const TUInt32      iNumVertices,
+	const TUInt32      iCacheSize,
+	SVertexCacheStats* pStats
+);
+
+// Measure the vertex cache efficiency of a sub-mesh, simulating a FIFO cache of the given size
+inline void MeasureVertexCache
+(
+	const SSubMesh&    subMesh,
+	const TUInt32      iCacheSize,
+	SVertexCacheStats* pStats
+)
+{
+	MeasureVertexCache( subMesh.faces, subMesh.indexSize, subMesh.numFaces, subMesh.numVertices,
+	                    iCacheSize, pStats );
+}
+
+
+} // namespace gen
+
+#endif // GEN_MESH_OPTIMISE_H_INCLUDED
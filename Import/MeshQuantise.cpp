@@ -0,0 +1,313 @@
+/**************************************************************************************************
+	Module:       MeshQuantise.cpp
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Vertex quantisation - conversion of mesh vertex data to a compact layout with reduced
+	precision elements, and measurement of the error introduced
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include "MeshQuantise.h"
+#include "BaseMath.h"
+#include "CVector3.h"
+#include "Error.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	Local helpers
+-----------------------------------------------------------------------------------------*/
+
+namespace
+{
+	// Byte offsets of the elements of a vertex in the full (float) layout
+	struct SFullVertexOffsets
+	{
+		TUInt32 normal;
+		TUInt32 tangent;
+		TUInt32 textureCoord;
+		TUInt32 vertexColour;
+	};
+
+	// Get element offsets for the full vertex layout of a sub-mesh: position, skinning data
+	// (weights and bone indices), normal, tangent, texture coordinate, vertex colour
+	void GetFullVertexOffsets
+	(
+		const SSubMesh&     subMesh,
+		SFullVertexOffsets* pOffsets
+	)
+	{
+		pOffsets->normal = 12 + (subMesh.hasSkinningData ? 20 : 0);
+		pOffsets->tangent = pOffsets->normal + (subMesh.hasNormals ? 12 : 0);
+		pOffsets->textureCoord = pOffsets->tangent + (subMesh.hasTangents ? 12 : 0);
+		pOffsets->vertexColour = pOffsets->textureCoord + (subMesh.hasTextureCoords ? 8 : 0);
+	}
+
+	// Round a vector to half float precision
+	CVector3 RoundToHalf( const CVector3& v )
+	{
+		return CVector3( HalfToFloat( FloatToHalf( v.x ) ), HalfToFloat( FloatToHalf( v.y ) ),
+		                 HalfToFloat( FloatToHalf( v.z ) ) );
+	}
+
+	// Write a unit direction as four signed normalised bytes and return the angle in degrees
+	// between the original and quantised directions
+	TFloat32 QuantiseDirection
+	(
+		const CVector3& v,
+		TInt8*          pOut
+	)
+	{
+		pOut[0] = FloatToSNorm8( v.x );
+		pOut[1] = FloatToSNorm8( v.y );
+		pOut[2] = FloatToSNorm8( v.z );
+		pOut[3] = 0;
+
+		CVector3 quantised( SNorm8ToFloat( pOut[0] ), SNorm8ToFloat( pOut[1] ),
+		                    SNorm8ToFloat( pOut[2] ) );
+		TFloat32 fLengths = v.Length() * quantised.Length();
+		if (IsZero( fLengths ))
+		{
+			return 0.0f;
+		}
+		TFloat32 fCos = Dot( v, quantised ) / fLengths;
+		return ToDegrees( ACos( Min( 1.0f, Max( -1.0f, fCos ) ) ) );
+	}
+
+} // anonymous namespace
+
+
+/*-----------------------------------------------------------------------------------------
+	Quantisation
+-----------------------------------------------------------------------------------------*/
+
+// Get the compact vertex layout for a mesh. Positions use half floats if no position would move
+// by more than the given tolerance (as a fraction of the size of the mesh bounding box). Returns
+// false if the mesh has no compact layout (i.e. it has skinning data)
+bool GetCompactVertexFormat
+(
+	const SSubMesh&       subMesh,
+	const TFloat32        fPositionTolerance,
+	SCompactVertexFormat* pFormat
+)
+{
+	GEN_GUARD;
+
+	if (subMesh.hasSkinningData)
+	{
+		return false;
+	}
+
+	// Find the mesh bounding box and the largest position error from using half floats
+	TFloat32 fMaxError = 0.0f;
+	CVector3 minBounds, maxBounds;
+	for (TUInt32 iVertex = 0; iVertex < subMesh.numVertices; ++iVertex)
+	{
+		const CVector3& position =
+			*reinterpret_cast<const CVector3*>(subMesh.vertices + iVertex * subMesh.vertexSize);
+		if (iVertex == 0)
+		{
+			minBounds = maxBounds = position;
+		}
+		else
+		{
+			minBounds.x = Min( minBounds.x, position.x );
+			minBounds.y = Min( minBounds.y, position.y );
+			minBounds.z = Min( minBounds.z, position.z );
+			maxBounds.x = Max( maxBounds.x, position.x );
+			maxBounds.y = Max( maxBounds.y, position.y );
+			maxBounds.z = Max( maxBounds.z, position.z );
+		}
+		fMaxError = Max( fMaxError, Distance( position, RoundToHalf( position ) ) );
+	}
+	pFormat->halfPositions = (fMaxError <= fPositionTolerance * Distance( minBounds, maxBounds ));
+
+	pFormat->hasNormals = subMesh.hasNormals;
+	pFormat->hasTangents = subMesh.hasTangents;
+	pFormat->hasTextureCoords = subMesh.hasTextureCoords;
+	pFormat->hasVertexColours = subMesh.hasVertexColours;
+	pFormat->normalOffset = pFormat->halfPositions ? 8 : 12;
+	pFormat->tangentOffset = pFormat->normalOffset + (subMesh.hasNormals ? 4 : 0);
+	pFormat->textureCoordOffset = pFormat->tangentOffset + (subMesh.hasTangents ? 4 : 0);
+	pFormat->vertexColourOffset = pFormat->textureCoordOffset + (subMesh.hasTextureCoords ? 4 : 0);
+	pFormat->vertexSize = pFormat->vertexColourOffset + (subMesh.hasVertexColours ? 4 : 0);
+	return true;
+
+	GEN_ENDGUARD;
+}
+
+
+// Convert the vertices of a mesh to the given compact layout (from GetCompactVertexFormat). The
+// output must have space for the number of vertices times the compact vertex size. The errors
+// introduced are combined with those already in the given error structure, so several meshes may
+// be measured together (zero the structure before the first call)
+void QuantiseVertices
+(
+	const SSubMesh&             subMesh,
+	const SCompactVertexFormat& format,
+	TUInt8*                     pVertices,
+	SQuantiseError*             pError
+)
+{
+	GEN_GUARD;
+
+	SFullVertexOffsets offsets;
+	GetFullVertexOffsets( subMesh, &offsets );
+
+	for (TUInt32 iVertex = 0; iVertex < subMesh.numVertices; ++iVertex)
+	{
+		const TUInt8* pIn = subMesh.vertices + iVertex * subMesh.vertexSize;
+		TUInt8* pOut = pVertices + iVertex * format.vertexSize;
+
+		const CVector3& position = *reinterpret_cast<const CVector3*>(pIn);
+		if (format.halfPositions)
+		{
+			TUInt16* pHalf = reinterpret_cast<TUInt16*>(pOut);
+			pHalf[0] = FloatToHalf( position.x );
+			pHalf[1] = FloatToHalf( position.y );
+			pHalf[2] = FloatToHalf( position.z );
+			pHalf[3] = FloatToHalf( 1.0f );
+			pError->position = Max( pError->position, Distance( position, RoundToHalf( position ) ) );
+		}
+		else
+		{
+			memcpy( pOut, &position, sizeof(CVector3) );
+		}
+
+		if (format.hasNormals)
+		{
+			const CVector3& normal = *reinterpret_cast<const CVector3*>(pIn + offsets.normal);
+			TInt8* pNormal = reinterpret_cast<TInt8*>(pOut + format.normalOffset);
+			pError->normal = Max( pError->normal, QuantiseDirection( normal, pNormal ) );
+		}
+		if (format.hasTangents)
+		{
+			const CVector3& tangent = *reinterpret_cast<const CVector3*>(pIn + offsets.tangent);
+			TInt8* pTangent = reinterpret_cast<TInt8*>(pOut + format.tangentOffset);
+			pError->tangent = Max( pError->tangent, QuantiseDirection( tangent, pTangent ) );
+		}
+		if (format.hasTextureCoords)
+		{
+			const TFloat32* pUV = reinterpret_cast<const TFloat32*>(pIn + offsets.textureCoord);
+			TUInt16* pHalf = reinterpret_cast<TUInt16*>(pOut + format.textureCoordOffset);
+			for (TUInt32 i = 0; i < 2; ++i)
+			{
+				pHalf[i] = FloatToHalf( pUV[i] );
+				pError->textureCoord = Max( pError->textureCoord, Abs( pUV[i] - HalfToFloat( pHalf[i] ) ) );
+			}
+		}
+		if (format.hasVertexColours)
+		{
+			memcpy( pOut + format.vertexColourOffset, pIn + offsets.vertexColour, 4 );
+		}
+	}
+
+	GEN_ENDGUARD;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Element conversion
+-----------------------------------------------------------------------------------------*/
+
+// Convert a 32-bit float to a 16-bit half float (rounded to nearest, out of range values become
+// infinity)
+TUInt16 FloatToHalf( const TFloat32 f )
+{
+	TUInt32 iBits;
+	memcpy( &iBits, &f, sizeof(iBits) );
+	TUInt32 iSign = (iBits >> 16) & 0x8000;
+	TInt32  iExponent = static_cast<TInt32>((iBits >> 23) & 0xff) - 127 + 15;
+	TUInt32 iMantissa = iBits & 0x7fffff;
+
+	// Infinity and NaN (keep NaNs as NaNs), then values too large for a half
+	if (((iBits >> 23) & 0xff) == 0xff)
+	{
+		return static_cast<TUInt16>(iSign | 0x7c00 | (iMantissa ? 0x200 : 0));
+	}
+	if (iExponent >= 31)
+	{
+		return static_cast<TUInt16>(iSign | 0x7c00);
+	}
+
+	// Values too small for a normal half become denormals or zero
+	TUInt32 iShift = 13;
+	TUInt32 iHalf;
+	if (iExponent <= 0)
+	{
+		if (iExponent < -10)
+		{
+			return static_cast<TUInt16>(iSign);
+		}
+		iMantissa |= 0x800000;
+		iShift = 14 - iExponent;
+		iHalf = iMantissa >> iShift;
+	}
+	else
+	{
+		iHalf = (iExponent << 10) | (iMantissa >> iShift);
+	}
+
+	// Round to nearest even - a carry out of the mantissa correctly increments the exponent
+	TUInt32 iRemainder = iMantissa & ((1u << iShift) - 1);
+	TUInt32 iHalfway = 1u << (iShift - 1);
+	if (iRemainder > iHalfway || (iRemainder == iHalfway && (iHalf & 1)))
+	{
+		++iHalf;
+	}
+	return static_cast<TUInt16>(iSign | iHalf);
+}
+
+// Convert a 16-bit half float to a 32-bit float
+TFloat32 HalfToFloat( const TUInt16 h )
+{
+	TUInt32 iSign = static_cast<TUInt32>(h & 0x8000) << 16;
+	TUInt32 iExponent = (h >> 10) & 0x1f;
+	TUInt32 iMantissa = h & 0x3ff;
+
+	if (iExponent == 0)
+	{
+		// Zero or denormal
+		TFloat32 f = ldexpf( static_cast<TFloat32>(iMantissa), -24 );
+		return iSign ? -f : f;
+	}
+
+	TUInt32 iBits;
+	if (iExponent == 31)
+	{
+		iBits = iSign | 0x7f800000 | (iMantissa << 13); // Infinity or NaN
+	}
+	else
+	{
+		iBits = iSign | ((iExponent - 15 + 127) << 23) | (iMantissa << 13);
+	}
+	TFloat32 f;
+	memcpy( &f, &iBits, sizeof(f) );
+	return f;
+}
+
+
+// Convert a float in the range -1 to 1 to a signed normalised byte (clamped)
+TInt8 FloatToSNorm8( const TFloat32 f )
+{
+	TFloat32 fClamped = Min( 1.0f, Max( -1.0f, f ) );
+	return static_cast<TInt8>(floorf( fClamped * 127.0f + 0.5f ));
+}
+
+// Convert a signed normalised byte to a float in the range -1 to 1. Both -128 and -127 are -1
+TFloat32 SNorm8ToFloat( const TInt8 i )
+{
+	return Max( -1.0f, static_cast<TFloat32>(i) / 127.0f );
+}
+
+
+} // namespace gen
@@ -0,0 +1,106 @@
+/**************************************************************************************************
+	Module:       MeshQuantise.h
+	Author:       DirectX_Experiments contributors
+	Date created: 17/10/26
+
+	Vertex quantisation - conversion of mesh vertex data to a compact layout with reduced
+	precision elements, and measurement of the error introduced
+
+	Copyright 2026, DirectX_Experiments contributors
+
+	Change history:
+		V1.0    Created 17/10/26
+**************************************************************************************************/
+
+#ifndef GEN_MESH_QUANTISE_H_INCLUDED
+#define GEN_MESH_QUANTISE_H_INCLUDED
+
+#include "GenDefines.h"
+#include "MeshData.h"
+
+namespace gen
+{
+
+/*------------------------------------------------------------------------------------------------
+	Compact vertex layout
+ ------------------------------------------------------------------------------------------------*/
+
+// The compact layout uses only element formats that the GPU input assembler decodes itself, so
+// shaders read the same float values as for the full layout:
+//   Position       - four half floats (w = 1), or three floats if half precision is too coarse
+//   Normal/tangent - four signed normalised bytes (w = 0)
+//   Texture coord  - two half floats
+//   Vertex colour  - four unsigned normalised bytes (unchanged)
+// Elements are in the same order as the full layout. Skinning data is not supported
+
+// Default position tolerance for the compact layout, as a fraction of the size of the mesh
+// bounding box. Half floats are accurate to about 1/2048 of the coordinate size, so meshes
+// centred near the origin will pass, meshes far from their origin may not
+const TFloat32 kfCompactPositionTolerance = 1.0f / 2048.0f;
+
+// Description of a compact vertex layout for a mesh
+struct SCompactVertexFormat
+{
+	bool    halfPositions;     // Positions stored as half floats, otherwise as floats
+	bool    hasNormals, hasTangents, hasTextureCoords, hasVertexColours;
+	TUInt32 normalOffset;      // Byte offsets of each element (position is always at 0)
+	TUInt32 tangentOffset;
+	TUInt32 textureCoordOffset;
+	TUInt32 vertexColourOffset;
+	TUInt32 vertexSize;        // Total size in bytes of a single vertex
+};
+
+// Maximum error introduced by quantisation. Errors are measured against the original float data
+struct SQuantiseError
+{
+	TFloat32 position;     // Largest distance a position moved (model units)
+	TFloat32 normal;       // Largest angle between original and quantised normal (degrees)
+	TFloat32 tangent;      // Largest angle between original and quantised tangent (degrees)
+	TFloat32 textureCoord; // Largest change in a texture coordinate component
+};
+
+
+/*------------------------------------------------------------------------------------------------
+	Quantisation
+ ------------------------------------------------------------------------------------------------*/
+
+// Get the compact vertex layout for a mesh. Positions use half floats if no position would move
+// by more than the given tolerance (as a fraction of the size of the mesh bounding box). Returns
+// false if the mesh has no compact layout (i.e. it has skinning data)
+bool GetCompactVertexFormat
+(
+	const SSubMesh&       subMesh,
+	const TFloat32        fPositionTolerance,
+	SCompactVertexFormat* pFormat
+);
+
+// Convert the vertices of a mesh to the given compact layout (from GetCompactVertexFormat). The
+// output must have space for the number of vertices times the compact vertex size. The errors
+// introduced are combined with those already in the given error structure, so several meshes may
+// be measured together (zero the structure before the first call)
+void QuantiseVertices
+(
+	const SSubMesh&             subMesh,
+	const SCompactVertexFormat& format,
+	TUInt8*                     pVertices,
+	SQuantiseError*             pError
+);
+
+
+/*------------------------------------------------------------------------------------------------
+	Element conversion
+ ------------------------------------------------------------------------------------------------*/
+
+// Convert a 32-bit float to a 16-bit half float (rounded to nearest, out of range values become
+// infinity) and back
+TUInt16 FloatToHalf( const TFloat32 f );
+TFloat32 HalfToFloat( const TUInt16 h );
+
+// Convert a float in the range -1 to 1 to a signed normalised byte (clamped) and back
+TInt8 FloatToSNorm8( const TFloat32 f );
+TFloat32 SNorm8ToFloat( const TInt8 i );
+
+
+} // namespace gen
+
+#endif // GEN_MESH_QUANTISE_H_INCLUDED
@@ -0,0 +1,93 @@
+//--------------------------------------------------------------------------------------
+//	InstanceBuilder.cpp
+//
+//	The instance builder collects the world matrix and colour of each copy of an instanced
+//	model into the data read by the vertex shader. It only works on the CPU, the data is
+//	copied to the instance buffer by the instanced model (see InstancedModel.h)
+//--------------------------------------------------------------------------------------
+
+#include <cstddef>
+#include "InstanceBuilder.h" // Declaration of this class
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - creates a builder with no instances
+CInstanceBuilder::CInstanceBuilder()
+{
+	m_Changed = true; // No data has been used yet
+}
+
+
+/////////////////////////////
+// Instances
+
+// Remove all instances
+void CInstanceBuilder::Clear()
+{
+	m_Instances.clear();
+	m_Changed = true;
+}
+
+// Add an instance with the given world matrix and colour. Returns the index of the new instance
+unsigned int CInstanceBuilder::Add( const gen::CMatrix4x4& worldMatrix, const gen::CVector3& colour )
+{
+	SInstance instance = { worldMatrix, colour };
+	m_Instances.push_back( instance );
+	m_Changed = true;
+	return static_cast<unsigned int>(m_Instances.size() - 1);
+}
+
+// Add an instance with the given position, rotation and scale, the world matrix is built in the same way as a model's (see CModel).
+// Returns the index of the new instance
+unsigned int CInstanceBuilder::Add( const gen::CVector3& position, const gen::CVector3& rotation, float scale, const gen::CVector3& colour )
+{
+	gen::CMatrix4x4 worldMatrix;
+	worldMatrix.MakeAffineEuler( position, rotation, gen::kZXY, gen::CVector3( scale, scale, scale ) );
+	return Add( worldMatrix, colour );
+}
+
+
+// Change the world matrix or colour of an existing instance
+void CInstanceBuilder::SetWorldMatrix( unsigned int instance, const gen::CMatrix4x4& worldMatrix )
+{
+	m_Instances[instance].worldMatrix = worldMatrix;
+	m_Changed = true;
+}
+
+void CInstanceBuilder::SetColour( unsigned int instance, const gen::CVector3& colour )
+{
+	m_Instances[instance].colour = colour;
+	m_Changed = true;
+}
+
+
+/////////////////////////////
+// Instance data
+
+// Get the vertex elements describing the instance data, read from the given vertex buffer slot once per instance. The elements follow
+// the layout of SInstance. Returns the number of elements
+unsigned int CInstanceBuilder::GetElements( unsigned int slot, SVertexElement* elements )
+{
+	// The four rows of the world matrix
+	for (unsigned int row = 0; row < 4; ++row)
+	{
+		elements[row].semantic = "INSTANCEWORLD";
+		elements[row].semanticIndex = row;
+		elements[row].format = kFormatFloat4;
+		elements[row].offset = static_cast<unsigned int>(offsetof(SInstance, worldMatrix)) + row * 4 * sizeof(float);
+		elements[row].slot = slot;
+		elements[row].perInstance = true;
+	}
+
+	// Colour
+	elements[4].semantic = "INSTANCECOLOUR";
+	elements[4].semanticIndex = 0;
+	elements[4].format = kFormatFloat3;
+	elements[4].offset = static_cast<unsigned int>(offsetof(SInstance, colour));
+	elements[4].slot = slot;
+	elements[4].perInstance = true;
+
+	return NUM_INSTANCE_ELTS;
+}
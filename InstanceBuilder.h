@@ -0,0 +1,115 @@
+//--------------------------------------------------------------------------------------
+//	InstanceBuilder.h
+//
+//	The instance builder collects the world matrix and colour of each copy of an instanced
+//	model into the data read by the vertex shader. It only works on the CPU, the data is
+//	copied to the instance buffer by the instanced model (see InstancedModel.h)
+//--------------------------------------------------------------------------------------
+
+#ifndef INSTANCE_BUILDER_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define INSTANCE_BUILDER_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "RenderDevice.h" // Vertex elements
+#include "CVector3.h"     // Maths classes from the import library
+#include "CMatrix4x4.h"
+
+
+// Data for one instance, as read by the vertex shader from the instance buffer. The world matrix is read as four float4 rows
+// (INSTANCEWORLD0-3) and the colour as a float3 (INSTANCECOLOUR). Matrices are 16-byte aligned, so there is padding after the colour,
+// the instance buffer uses the same size including the padding
+struct SInstance
+{
+	gen::CMatrix4x4 worldMatrix;
+	gen::CVector3   colour;
+};
+
+
+// The instances are kept in one array in the same layout as the instance buffer, so the whole array is copied to the GPU in one go.
+// Any change marks the data as changed, the instanced model only copies the data to the GPU when it has changed
+class CInstanceBuilder
+{
+/////////////////////////////
+// Private member variables
+private:
+
+	vector<SInstance> m_Instances;
+	bool              m_Changed; // Instances have changed since the data was last used (see ClearChanged)
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - creates a builder with no instances
+	CInstanceBuilder();
+
+
+	/////////////////////////////
+	// Instances
+
+	// Remove all instances
+	void Clear();
+
+	// Add an instance with the given world matrix or position, rotation (Euler angles, same order as models) and scale, and colour.
+	// Returns the index of the new instance
+	unsigned int Add( const gen::CMatrix4x4& worldMatrix, const gen::CVector3& colour );
+	unsigned int Add( const gen::CVector3& position, const gen::CVector3& rotation, float scale, const gen::CVector3& colour );
+
+	// Change the world matrix or colour of an existing instance
+	void SetWorldMatrix( unsigned int instance, const gen::CMatrix4x4& worldMatrix );
+	void SetColour( unsigned int instance, const gen::CVector3& colour );
+
+	// Get the number of instances and an existing instance
+	unsigned int GetNumInstances()
+	{
+		return static_cast<unsigned int>(m_Instances.size());
+	}
+	const SInstance& GetInstance( unsigned int instance )
+	{
+		return m_Instances[instance];
+	}
+
+
+	/////////////////////////////
+	// Instance data
+
+	// Get the instance data to copy to the instance buffer and its size in bytes. No data if there are no instances
+	const void* GetData()
+	{
+		return m_Instances.empty() ? NULL : &m_Instances[0];
+	}
+	unsigned int GetDataSize()
+	{
+		return static_cast<unsigned int>(m_Instances.size() * sizeof(SInstance));
+	}
+
+	// Have the instances changed since ClearChanged was last called (or since the builder was created). SetChanged marks them as
+	// changed without changing them, e.g. when the data must be copied to a new buffer
+	bool HasChanged()
+	{
+		return m_Changed;
+	}
+	void ClearChanged()
+	{
+		m_Changed = false;
+	}
+	void SetChanged()
+	{
+		m_Changed = true;
+	}
+
+	// Get the vertex elements describing the instance data, read from the given vertex buffer slot once per instance. Add these to a
+	// model's own vertex elements to make the layout of an instanced model. The array must hold NUM_INSTANCE_ELTS elements, returns
+	// the number of elements
+	static const unsigned int NUM_INSTANCE_ELTS = 5;
+	static unsigned int GetElements( unsigned int slot, SVertexElement* elements );
+};
+
+
+#endif // End of header guard - see top of file
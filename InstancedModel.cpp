@@ -0,0 +1,126 @@
+//--------------------------------------------------------------------------------------
+//	InstancedModel.cpp
+//
+//	An instanced model draws many copies of the same geometry, each with its own world
+//	matrix and colour, using a single draw call for each part of the geometry
+//--------------------------------------------------------------------------------------
+
+#include "InstancedModel.h" // Declaration of this class
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - creates a model with no geometry or instances
+CInstancedModel::CInstancedModel()
+{
+	m_Layout = 0;
+	m_InstanceBuffer = 0;
+	m_InstanceBufferSize = 0;
+}
+
+// Destructor
+CInstancedModel::~CInstancedModel()
+{
+	ReleaseResources();
+}
+
+// Release resources used by model, the instances are kept
+void CInstancedModel::ReleaseResources()
+{
+	// Handles of 0 are ignored
+	if (g_pRenderDevice)
+	{
+		g_pRenderDevice->ReleaseBuffer( m_InstanceBuffer );
+		g_pRenderDevice->ReleaseLayout( m_Layout );
+	}
+	m_InstanceBuffer = 0;
+	m_InstanceBufferSize = 0;
+	m_Layout = 0;
+	m_Model.ReleaseResources();
+}
+
+
+/////////////////////////////
+// Model Loading
+
+// Load the geometry from a file. The model's own layout isn't needed (it has no instance data), only the layout combining the model's
+// vertices with the instance data is created. Returns true if the load was successful
+bool CInstancedModel::Load( const string& fileName, TRenderTechnique exampleTechnique, bool tangents /*= false*/, bool compact /*= false*/ )
+{
+	ReleaseResources();
+	if (!m_Model.Load( fileName, 0, tangents, compact ))
+	{
+		return false;
+	}
+
+	SVertexElement instanceElts[CInstanceBuilder::NUM_INSTANCE_ELTS];
+	unsigned int numInstanceElts = CInstanceBuilder::GetElements( 1, instanceElts );
+	m_Layout = m_Model.CreateLayout( instanceElts, numInstanceElts, exampleTechnique );
+	if (!m_Layout)
+	{
+		ReleaseResources();
+		return false;
+	}
+
+	// The instances may have been sent to a previous buffer, make sure they are sent to the new one
+	m_Instances.SetChanged();
+	return true;
+}
+
+
+/////////////////////////////
+// Model Usage
+
+// Render every instance with the given technique. Each part of the model is drawn once for all the instances
+void CInstancedModel::Render( TRenderTechnique technique, CConstantBuffer* objectConstants )
+{
+	if (!m_Model.HasGeometry() || m_Instances.GetNumInstances() == 0 || !UpdateInstanceBuffer())
+	{
+		return;
+	}
+
+	// Select the shared geometry, the combined layout and the instance data in slot 1, then draw each pass of the technique
+	m_Model.SelectGeometry( m_Layout );
+	g_pRenderDevice->SetVertexBuffer( 1, m_InstanceBuffer, sizeof(SInstance) );
+	unsigned int numPasses = g_pRenderDevice->GetNumPasses( technique );
+	for (unsigned int p = 0; p < numPasses; ++p)
+	{
+		g_pRenderDevice->ApplyPass( technique, p );
+		m_Model.Draw( objectConstants, m_Instances.GetNumInstances() );
+	}
+}
+
+
+/////////////////////////////
+// Private member functions
+
+// Copy the instances to the instance buffer if they have changed, creating a larger buffer if needed. The buffer at least doubles in
+// size when it grows, so adding instances one at a time doesn't create a new buffer every time. Returns false on failure
+bool CInstancedModel::UpdateInstanceBuffer()
+{
+	if (!m_Instances.HasChanged())
+	{
+		return true;
+	}
+
+	unsigned int numInstances = m_Instances.GetNumInstances();
+	if (numInstances > m_InstanceBufferSize)
+	{
+		g_pRenderDevice->ReleaseBuffer( m_InstanceBuffer );
+		m_InstanceBufferSize = numInstances > m_InstanceBufferSize * 2 ? numInstances : m_InstanceBufferSize * 2;
+		m_InstanceBuffer = g_pRenderDevice->CreateDynamicVertexBuffer( m_InstanceBufferSize * sizeof(SInstance) );
+		if (!m_InstanceBuffer)
+		{
+			m_InstanceBufferSize = 0;
+			return false;
+		}
+	}
+
+	if (!g_pRenderDevice->UpdateBuffer( m_InstanceBuffer, m_Instances.GetData(), m_Instances.GetDataSize() ))
+	{
+		return false;
+	}
+	m_Instances.ClearChanged();
+	return true;
+}
@@ -0,0 +1,94 @@
+//--------------------------------------------------------------------------------------
+//	InstancedModel.h
+//
+//	An instanced model draws many copies of the same geometry, each with its own world
+//	matrix and colour, using a single draw call for each part of the geometry
+//--------------------------------------------------------------------------------------
+
+#ifndef INSTANCED_MODEL_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define INSTANCED_MODEL_H_INCLUDED
+
+#include <string>
+using namespace std;
+
+#include "RenderDevice.h"    // Buffers, layouts and drawing, independent of the graphics API
+#include "Model.h"           // Geometry shared by all the instances
+#include "InstanceBuilder.h" // World matrices and colours of the instances
+
+
+// The geometry is loaded once into a model kept at the origin. The instance data is held in a second vertex buffer, read once per
+// instance rather than once per vertex (slot 1 of the layout). The vertex shader places each vertex with the matrix of its part of the
+// model then with the instance's world matrix, so models with moving parts can be instanced too - all instances share the same pose.
+// The instance buffer is only updated when the instances have changed, so static props cost nothing on the CPU after the first frame
+class CInstancedModel
+{
+/////////////////////////////
+// Private member variables
+private:
+
+	CModel           m_Model;     // Geometry, never moved
+	CInstanceBuilder m_Instances;
+
+	// Layout of the model's vertices plus the instance data, and the buffer holding the instance data with its size in instances. The
+	// buffer grows as needed, it is never made smaller
+	TRenderLayout    m_Layout;
+	TRenderBuffer    m_InstanceBuffer;
+	unsigned int     m_InstanceBufferSize;
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - creates a model with no geometry or instances
+	CInstancedModel();
+
+	// Destructor
+	~CInstancedModel();
+
+	// Release resources used by model, the instances are kept
+	void ReleaseResources();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CInstancedModel( const CInstancedModel& );
+	CInstancedModel& operator=( const CInstancedModel& );
+
+public:
+
+	/////////////////////////////
+	// Model Loading
+
+	// Load the geometry from a file, in the same way as CModel::Load. The example technique must be an instanced technique, one whose
+	// vertex shader reads the instance data as well as the vertices (see CInstanceBuilder). Returns true if the load was successful
+	bool Load( const string& fileName, TRenderTechnique exampleTechnique, bool tangents = false, bool compact = false );
+
+
+	/////////////////////////////
+	// Model Usage
+
+	// Get the instances to add, change or remove them. Changes are sent to the GPU the next time the model is rendered
+	CInstanceBuilder& GetInstances()
+	{
+		return m_Instances;
+	}
+
+	// Render every instance with the given technique, which must read the instance data. The matrix of each part of the model (relative
+	// to the instance) is sent to the given per-object constant buffer. Assumes any other shader constants and variables for the
+	// technique have already been set up. Drawn with the global render device
+	void Render( TRenderTechnique technique, CConstantBuffer* objectConstants );
+
+
+/////////////////////////////
+// Private member functions
+private:
+
+	// Copy the instances to the instance buffer if they have changed, creating a larger buffer if needed. Returns false on failure
+	bool UpdateInstanceBuffer();
+};
+
+
+#endif // End of header guard - see top of file
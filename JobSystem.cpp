@@ -0,0 +1,230 @@
+//--------------------------------------------------------------------------------------
+//	JobSystem.cpp
+//
+//	The job system runs small pieces of work (jobs) on a pool of worker threads, used to
+//	spread the work of each frame across the processor cores
+//--------------------------------------------------------------------------------------
+
+#include "JobSystem.h" // Declaration of this class
+
+// The job system and queue of the calling thread, set for worker threads only
+static thread_local CJobSystem*  ThreadJobSystem = NULL;
+static thread_local unsigned int ThreadQueue = 0;
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - may specify the number of threads including the calling thread, by default uses one thread per processor core
+CJobSystem::CJobSystem( unsigned int numThreads /*= 0*/ )
+{
+	if (numThreads == 0)
+	{
+		numThreads = thread::hardware_concurrency();
+		if (numThreads == 0)
+		{
+			numThreads = 1;
+		}
+	}
+
+	m_NumQueued = 0;
+	m_Quit = false;
+	for (unsigned int queue = 0; queue < numThreads; ++queue)
+	{
+		m_Queues.push_back( new SQueue );
+	}
+	for (unsigned int queue = 1; queue < numThreads; ++queue)
+	{
+		m_Workers.push_back( thread( &CJobSystem::WorkerLoop, this, queue ) );
+	}
+}
+
+// Destructor - stops the worker threads
+CJobSystem::~CJobSystem()
+{
+	{
+		lock_guard<mutex> sleepLock( m_SleepLock );
+		m_Quit = true;
+	}
+	m_Wake.notify_all();
+	for (unsigned int worker = 0; worker < m_Workers.size(); ++worker)
+	{
+		m_Workers[worker].join();
+	}
+	for (unsigned int queue = 0; queue < m_Queues.size(); ++queue)
+	{
+		delete m_Queues[queue];
+	}
+}
+
+
+/////////////////////////////
+// Jobs
+
+// Run a job as part of the given group
+void CJobSystem::Run( const function<void()>& work, CJobGroup* group )
+{
+	// Count the job before it is queued, so neither the group nor the queues can be seen as finished / empty before the job is taken
+	++group->m_NumJobs;
+	++m_NumQueued;
+	SQueue* queue = m_Queues[GetThreadQueue()];
+	{
+		lock_guard<mutex> queueLock( queue->lock );
+		SJob job = { work, group };
+		queue->jobs.push_back( job );
+	}
+
+	// Wake a sleeping worker. Taking the sleep lock first means a worker can't be between checking for jobs and going to sleep, which
+	// would miss the wake-up
+	{
+		lock_guard<mutex> sleepLock( m_SleepLock );
+	}
+	m_Wake.notify_one();
+}
+
+// Wait for all the jobs in a group to finish, working on jobs (from any group) in the meantime
+void CJobSystem::Wait( CJobGroup* group )
+{
+	unsigned int queue = GetThreadQueue();
+	while (!group->IsFinished())
+	{
+		// If there are no jobs left to take, the last jobs of the group are running on other threads
+		if (!RunOneJob( queue ))
+		{
+			this_thread::yield();
+		}
+	}
+
+	// All the group's jobs have finished so no other thread can set the exception now. Clear it so the group can be used again
+	if (group->m_Exception)
+	{
+		exception_ptr jobException = group->m_Exception;
+		group->m_Exception = NULL;
+		rethrow_exception( jobException );
+	}
+}
+
+// Split the range 0 to count-1 into chunks of the given size and run the given function on each chunk in parallel, returning when
+// all are finished
+void CJobSystem::ParallelFor( unsigned int count, unsigned int chunkSize,
+                              const function<void( unsigned int chunk, unsigned int first, unsigned int end )>& work )
+{
+	// Queue all chunks but the first, which the calling thread starts on straight away. A range with a single chunk doesn't use the
+	// queues at all
+	CJobGroup group;
+	unsigned int numChunks = GetNumChunks( count, chunkSize );
+	for (unsigned int chunk = 1; chunk < numChunks; ++chunk)
+	{
+		unsigned int first = chunk * chunkSize;
+		unsigned int end = (count - first > chunkSize) ? first + chunkSize : count;
+		Run( [&work, chunk, first, end]() { work( chunk, first, end ); }, &group );
+	}
+
+	// The queued chunks refer to the group and the work function, so they must finish before returning even if this chunk throws
+	if (numChunks > 0)
+	{
+		try
+		{
+			work( 0, 0, (count > chunkSize) ? chunkSize : count );
+		}
+		catch (...)
+		{
+			StoreException( &group );
+		}
+	}
+	Wait( &group );
+}
+
+
+/////////////////////////////
+// Private member functions
+
+// Index of the queue of the calling thread - 0 for any thread that isn't a worker of this job system
+unsigned int CJobSystem::GetThreadQueue()
+{
+	return (ThreadJobSystem == this) ? ThreadQueue : 0;
+}
+
+// Take a job from the given thread's queue, or steal one from another thread, and run it. Returns false if there were no jobs
+bool CJobSystem::RunOneJob( unsigned int queue )
+{
+	if (m_NumQueued == 0)
+	{
+		return false;
+	}
+
+	// Take the newest job from this thread's queue, or the oldest from another thread's queue, trying the queues in turn from the one
+	// after this thread's so the threads don't all steal from the same place
+	SJob job;
+	bool found = false;
+	unsigned int numQueues = GetNumThreads();
+	for (unsigned int i = 0; i < numQueues && !found; ++i)
+	{
+		SQueue* victim = m_Queues[(queue + i) % numQueues];
+		lock_guard<mutex> queueLock( victim->lock );
+		if (!victim->jobs.empty())
+		{
+			if (i == 0)
+			{
+				job = move( victim->jobs.back() );
+				victim->jobs.pop_back();
+			}
+			else
+			{
+				job = move( victim->jobs.front() );
+				victim->jobs.pop_front();
+			}
+			found = true;
+		}
+	}
+	if (!found)
+	{
+		return false;
+	}
+	--m_NumQueued;
+
+	// An exception must not escape a worker thread (which would terminate the program) and the group must always be finished, so keep
+	// the first exception for the thread waiting on the group
+	try
+	{
+		job.work();
+	}
+	catch (...)
+	{
+		StoreException( job.group );
+	}
+	--job.group->m_NumJobs;
+	return true;
+}
+
+// Keep the exception being handled in the given group if it is the group's first, called from a catch block
+void CJobSystem::StoreException( CJobGroup* group )
+{
+	lock_guard<mutex> exceptionLock( group->m_ExceptionLock );
+	if (!group->m_Exception)
+	{
+		group->m_Exception = current_exception();
+	}
+}
+
+// Worker thread function - runs jobs until the job system is destroyed
+void CJobSystem::WorkerLoop( unsigned int queue )
+{
+	ThreadJobSystem = this;
+	ThreadQueue = queue;
+	while (true)
+	{
+		if (!RunOneJob( queue ))
+		{
+			unique_lock<mutex> sleepLock( m_SleepLock );
+			while (!m_Quit && m_NumQueued == 0)
+			{
+				m_Wake.wait( sleepLock );
+			}
+			if (m_Quit)
+			{
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,153 @@
+//--------------------------------------------------------------------------------------
+//	JobSystem.h
+//
+//	The job system runs small pieces of work (jobs) on a pool of worker threads, used to
+//	spread the work of each frame across the processor cores
+//--------------------------------------------------------------------------------------
+
+#ifndef JOB_SYSTEM_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define JOB_SYSTEM_H_INCLUDED
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+using namespace std;
+
+
+// A group of jobs that can be waited for. Each job is added to a group when it is run, the group is finished when all of its jobs
+// are. A job that depends on others is simply run after waiting for their group, so the order of the stages of work is explicit in
+// the code that runs them
+class CJobGroup
+{
+	friend class CJobSystem;
+
+private:
+	atomic<unsigned int> m_NumJobs; // Jobs in the group not yet finished
+
+	// The first exception thrown by a job in the group, rethrown when the group is waited for
+	mutex         m_ExceptionLock;
+	exception_ptr m_Exception;
+
+public:
+	CJobGroup() : m_NumJobs( 0 ) {}
+
+	bool IsFinished()
+	{
+		return m_NumJobs == 0;
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CJobGroup( const CJobGroup& );
+	CJobGroup& operator=( const CJobGroup& );
+};
+
+
+// Each thread has its own queue of jobs. A thread adds jobs to the back of its own queue and takes jobs from the back too, so it works
+// on the most recent (still in cache) work first. When its queue is empty it steals from the front of the other threads' queues, so
+// work spreads across threads without a single shared queue that all threads contend for. The thread that created the job system
+// is thread 0 and works on jobs while it waits for a group. Worker threads sleep when there are no jobs at all
+class CJobSystem
+{
+/////////////////////////////
+// Private types and member variables
+private:
+
+	struct SJob
+	{
+		function<void()> work;
+		CJobGroup*       group;
+	};
+
+	// A thread's job queue, the lock is needed as other threads steal from it
+	struct SQueue
+	{
+		mutex        lock;
+		deque<SJob>  jobs;
+	};
+	vector<SQueue*>  m_Queues;  // One per thread, owned by the job system
+	vector<thread>   m_Workers; // Threads 1 and up, thread 0 is the thread that created the job system
+
+	// Worker threads wait on the condition variable while there are no jobs queued (and the job system is not being destroyed)
+	atomic<unsigned int> m_NumQueued;
+	bool                 m_Quit; // Protected by the sleep lock
+	mutex                m_SleepLock;
+	condition_variable   m_Wake;
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - may specify the number of threads including the calling thread, by default uses one thread per processor core.
+	// With a single thread every job runs on the calling thread while it waits
+	CJobSystem( unsigned int numThreads = 0 );
+
+	// Destructor - stops the worker threads. Wait for any jobs run before destroying the job system
+	~CJobSystem();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CJobSystem( const CJobSystem& );
+	CJobSystem& operator=( const CJobSystem& );
+
+public:
+
+	/////////////////////////////
+	// Jobs
+
+	// Number of threads working on jobs, including the thread that created the job system
+	unsigned int GetNumThreads()
+	{
+		return static_cast<unsigned int>(m_Queues.size());
+	}
+
+	// Run a job as part of the given group. The job may start straight away on another thread, or later on this thread when waiting.
+	// Jobs may run further jobs
+	void Run( const function<void()>& work, CJobGroup* group );
+
+	// Wait for all the jobs in a group to finish, working on jobs (from any group) in the meantime. If any job in the group threw an
+	// exception, the first one is rethrown here once all the jobs have finished
+	void Wait( CJobGroup* group );
+
+	// Split the range 0 to count-1 into chunks of the given size and run the given function on each chunk in parallel, returning
+	// when all are finished and rethrowing the first exception thrown by a chunk, as Wait. The function is passed the chunk number
+	// and the range first to end-1. Chunks depend only on count and chunk size, not on the number of threads, so results kept per
+	// chunk and combined in chunk order are the same on any machine
+	void ParallelFor( unsigned int count, unsigned int chunkSize,
+	                  const function<void( unsigned int chunk, unsigned int first, unsigned int end )>& work );
+
+	// Number of chunks used by ParallelFor for the given count and chunk size
+	static unsigned int GetNumChunks( unsigned int count, unsigned int chunkSize )
+	{
+		return (count + chunkSize - 1) / chunkSize;
+	}
+
+
+/////////////////////////////
+// Private member functions
+private:
+
+	// Index of the queue of the calling thread - 0 for any thread that isn't a worker of this job system
+	unsigned int GetThreadQueue();
+
+	// Take a job from the given thread's queue, or steal one from another thread, and run it. Returns false if there were no jobs
+	bool RunOneJob( unsigned int queue );
+
+	// Keep the exception being handled in the given group if it is the group's first, called from a catch block
+	static void StoreException( CJobGroup* group );
+
+	// Worker thread function - runs jobs until the job system is destroyed
+	void WorkerLoop( unsigned int queue );
+};
+
+
+#endif // End of header guard - see top of file
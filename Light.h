@@ -3,26 +3,26 @@
 class Light : public CModel
 {
 private:
-	D3DXVECTOR3 InitColour; // initial colour
-	D3DXVECTOR3 CurrentColour; // current colour
+	gen::CVector3 InitColour; // initial colour
+	gen::CVector3 CurrentColour; // current colour
 public:
 	Light();
 	~Light();
-	D3DXVECTOR3 GetColour()
+	const gen::CVector3& GetColour()
 	{
 		return CurrentColour;
 	}
-	D3DXVECTOR3 GetInitColour()
+	const gen::CVector3& GetInitColour()
 	{
 		return InitColour;
 	}
 
 
-	void SetColour(D3DXVECTOR3 colour)
+	void SetColour(const gen::CVector3& colour)
 	{
 		CurrentColour = colour;
 	}
-	void SetInitColour(D3DXVECTOR3 colour)
+	void SetInitColour(const gen::CVector3& colour)
 	{
 		InitColour = colour;
 	}
@@ -95,6 +95,8 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLi
 
 	// Release all the DirectX resources before leaving
 	ReleaseResources();
+	ReleaseShaders();
+	ReleaseDevice();
 
 	return (int)msg.wParam;
 }
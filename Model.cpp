@@ -5,32 +5,24 @@
 //	also manages it's positioning with a world matrix
 //--------------------------------------------------------------------------------------
 
-#include "Defines.h" // General definitions shared by all source files
-#include "Model.h"   // Declaration of this class
+#include "Defines.h"       // General definitions shared by all source files
+#include "Model.h"         // Declaration of this class
+#include "GeometryCache.h" // Geometry shared by models loaded from the same file
 
-#include "CImportXFile.h"    // Class to load meshes (taken from a full graphics engine)
 
 ///////////////////////////////
 // Constructors / Destructors
 
 // Constructor - initialise all camera settings - look at the constructor declaration in the header file to see that there are defaults provided for everything
-CModel::CModel( D3DXVECTOR3 position, D3DXVECTOR3 rotation, float scale )
+CModel::CModel( const gen::CVector3& position, const gen::CVector3& rotation, float scale )
 {
 	m_Position = position;
 	m_Rotation = rotation;
-	SetScale( scale );
-	UpdateMatrix();
+	SetScale( scale ); // Also marks world matrix to be built when first used
 
 	// Good practice to ensure all private data is sensibly initialised
-	m_VertexBuffer = NULL;
-	m_NumVertices = 0;
-	m_VertexSize = 0;
-	m_VertexLayout = NULL;
-
-	m_IndexBuffer = NULL;
-	m_NumIndices = 0;
-
-	m_HasGeometry = false;
+	m_Geometry = NULL;
+	CalculateWorldBounds();
 }
 
 // Model destructor
@@ -39,14 +31,18 @@ CModel::~CModel()
 	ReleaseResources();
 }
 
-// Release resources used by model
+// Release resources used by model - the model's reference to its geometry. The geometry's buffers are released along with the last
+// reference to it
 void CModel::ReleaseResources()
 {
-	// Release resources
-	SAFE_RELEASE( m_IndexBuffer );  // Using a DirectX helper macro to simplify code here - look it up in Defines.h
-	SAFE_RELEASE( m_VertexBuffer );
-	SAFE_RELEASE( m_VertexLayout );
-	m_HasGeometry = false;
+	if (m_Geometry)
+	{
+		m_Geometry->Release();
+		m_Geometry = NULL;
+	}
+	m_Nodes.Clear();
+	m_MatrixDirty = true; // New root node needs the world matrix
+	CalculateWorldBounds(); // Empty bounds
 }
 
 
@@ -56,155 +52,121 @@ void CModel::ReleaseResources()
 // The loading and parsing of ".X" files is supported using a class taken from another application. We will not look at the process (more to do with parsing than graphics). Ultimately
 // we end up with arrays of data exactly as we have previously manually typed in
 
-// Load the model geometry from a file. This function only reads the geometry using the first material in the file, so multi-material
-// models will load but will have parts missing. May optionally request for tangents to be created for the model (for normal or parallax mapping)
-// We need to pass an example technique that the model will use to help DirectX understand how to connect this data with the vertex shaders
+// Load the model geometry from a file. Every sub-mesh in the file is loaded into a single vertex and index buffer and rendered as
+// a list of subsets. May optionally request for tangents to be created for the model (for normal or parallax mapping), and for
+// a compact vertex layout with reduced precision (about half the memory, see gen::QuantiseVertices)
+// We need to pass an example technique that the model will use to help the render device understand how to connect this data with the
+// vertex shaders
 // Returns true if the load was successful
-bool CModel::Load( const string& fileName, ID3D10EffectTechnique* exampleTechnique, bool tangents /*= false*/ ) // The commented out bit is the default parameter (can't write it here, only in the declaration)
+bool CModel::Load( const string& fileName, TRenderTechnique exampleTechnique, bool tangents /*= false*/, bool compact /*= false*/ ) // The commented out bit is the default parameter (can't write it here, only in the declaration)
 {
 	// Release any existing geometry in this object
 	ReleaseResources();
 
-	// Use CImportXFile class (from another application) to load the given file. The import code is wrapped in the namespace 'gen'
-	gen::CImportXFile mesh;
-	if (mesh.ImportFile( fileName.c_str() ) != gen::kSuccess)
+	// The geometry cache only loads the file and creates buffers the first time this file and these options are used, later models
+	// share the same geometry
+	CModelGeometry* geometry = g_GeometryCache.Load( fileName, tangents, compact, exampleTechnique );
+	if (!geometry)
 	{
 		return false;
 	}
+	SetGeometry( geometry );
+	geometry->Release(); // The model holds its own reference
+	return true;
+}
 
-	// Get first sub-mesh from loaded file
-	gen::SSubMesh subMesh;
-	if (mesh.GetSubMesh( 0, &subMesh, tangents ) != gen::kSuccess)
-	{
-		return false;
-	}
 
+// Create the model geometry from mesh data that has already been loaded. Only this final step of creating the render device buffers
+// needs to happen on the render thread. If a compact vertex layout is requested, the errors introduced are combined into the given
+// structure if one is provided. The geometry is not cached, it belongs to this model alone. Returns true if successful
+bool CModel::Load( const gen::CMeshCache& mesh, TRenderTechnique exampleTechnique, bool compact /*= false*/,
+                   gen::SQuantiseError* quantiseError /*= NULL*/ )
+{
+	// Release any existing geometry in this object
+	ReleaseResources();
 
-	// Create vertex element list & layout. We need a vertex layout to say what data we have per vertex in this model (e.g. position, normal, uv, etc.)
-	// In previous projects the element list was a manually typed in array as we knew what data we would provide. However, as we can load models with
-	// different vertex data this time we need flexible code. The array is built up one element at a time: ask the import class if it loaded normals, 
-	// if so then add a normal line to the array, then ask if it loaded UVS...etc
-	unsigned int numElts = 0;
-	unsigned int offset = 0;
-	// Position is always required
-	m_VertexElts[numElts].SemanticName = "POSITION";   // Semantic in HLSL (what is this data for)
-	m_VertexElts[numElts].SemanticIndex = 0;           // Index to add to semantic (a count for this kind of data, when using multiple of the same type, e.g. TEXCOORD0, TEXCOORD1)
-	m_VertexElts[numElts].Format = DXGI_FORMAT_R32G32B32_FLOAT; // Type of data - this one will be a float3 in the shader. Most data communicated as though it were colours
-	m_VertexElts[numElts].AlignedByteOffset = offset;  // Offset of element from start of vertex data (e.g. if we have position (float3), uv (float2) then normal, the normal's offset is 5 floats = 5*4 = 20)
-	m_VertexElts[numElts].InputSlot = 0;               // For when using multiple vertex buffers (e.g. instancing - an advanced topic)
-	m_VertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA; // Use this value for most cases (only changed for instancing)
-	m_VertexElts[numElts].InstanceDataStepRate = 0;                     // --"--
-	offset += 12;
-	++numElts;
-	// Repeat for each kind of vertex data
-	if (subMesh.hasNormals)
+	CModelGeometry* geometry = new CModelGeometry;
+	bool success = geometry->Create( mesh, exampleTechnique, compact, quantiseError );
+	if (success)
 	{
-		m_VertexElts[numElts].SemanticName = "NORMAL";
-		m_VertexElts[numElts].SemanticIndex = 0;
-		m_VertexElts[numElts].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		m_VertexElts[numElts].AlignedByteOffset = offset;
-		m_VertexElts[numElts].InputSlot = 0;
-		m_VertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
-		m_VertexElts[numElts].InstanceDataStepRate = 0;
-		offset += 12;
-		++numElts;
+		SetGeometry( geometry );
 	}
-	if (subMesh.hasTangents)
-	{
-		m_VertexElts[numElts].SemanticName = "TANGENT";
-		m_VertexElts[numElts].SemanticIndex = 0;
-		m_VertexElts[numElts].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		m_VertexElts[numElts].AlignedByteOffset = offset;
-		m_VertexElts[numElts].InputSlot = 0;
-		m_VertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
-		m_VertexElts[numElts].InstanceDataStepRate = 0;
-		offset += 12;
-		++numElts;
-	}
-	if (subMesh.hasTextureCoords)
-	{
-		m_VertexElts[numElts].SemanticName = "TEXCOORD";
-		m_VertexElts[numElts].SemanticIndex = 0;
-		m_VertexElts[numElts].Format = DXGI_FORMAT_R32G32_FLOAT;
-		m_VertexElts[numElts].AlignedByteOffset = offset;
-		m_VertexElts[numElts].InputSlot = 0;
-		m_VertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
-		m_VertexElts[numElts].InstanceDataStepRate = 0;
-		offset += 8;
-		++numElts;
-	}
-	if (subMesh.hasVertexColours)
+	geometry->Release(); // Destroys the geometry if not used
+	return success;
+}
+
+
+// Use existing geometry, e.g. from the geometry cache. Adds a reference to the geometry and releases the model's previous geometry. The
+// model's nodes are reset to the geometry's default pose - a copy of the geometry's hierarchy, sharing its node data
+void CModel::SetGeometry( CModelGeometry* geometry )
+{
+	if (geometry)
 	{
-		m_VertexElts[numElts].SemanticName = "COLOR";
-		m_VertexElts[numElts].SemanticIndex = 0;
-		m_VertexElts[numElts].Format = DXGI_FORMAT_R8G8B8A8_UNORM; // A RGBA colour with 1 byte (0-255) per component
-		m_VertexElts[numElts].AlignedByteOffset = offset;
-		m_VertexElts[numElts].InputSlot = 0;
-		m_VertexElts[numElts].InputSlotClass = D3D10_INPUT_PER_VERTEX_DATA;
-		m_VertexElts[numElts].InstanceDataStepRate = 0;
-		offset += 4;
-		++numElts;
+		geometry->AddRef(); // Before releasing, the new and old geometry may be the same
 	}
-	m_VertexSize = offset;
-
-	// Given the vertex element list, pass it to DirectX to create a vertex layout. We also need to pass an example of a technique that will
-	// render this model. We will only be able to render this model with techniques that have the same vertex input as the example we use here
-	D3D10_PASS_DESC PassDesc;
-	exampleTechnique->GetPassByIndex( 0 )->GetDesc( &PassDesc );
-	g_pd3dDevice->CreateInputLayout( m_VertexElts, numElts, PassDesc.pIAInputSignature, PassDesc.IAInputSignatureSize, &m_VertexLayout );
-
-
-	// Create the vertex buffer and fill it with the loaded vertex data
-	m_NumVertices = subMesh.numVertices;
-	D3D10_BUFFER_DESC bufferDesc;
-	bufferDesc.BindFlags = D3D10_BIND_VERTEX_BUFFER;
-	bufferDesc.Usage = D3D10_USAGE_DEFAULT; // Not a dynamic buffer
-	bufferDesc.ByteWidth = m_NumVertices * m_VertexSize; // Buffer size
-	bufferDesc.CPUAccessFlags = 0;   // Indicates that CPU won't access this buffer at all after creation
-	bufferDesc.MiscFlags = 0;
-	D3D10_SUBRESOURCE_DATA initData; // Initial data
-	initData.pSysMem = subMesh.vertices;   
-	if (FAILED( g_pd3dDevice->CreateBuffer( &bufferDesc, &initData, &m_VertexBuffer )))
+	ReleaseResources();
+	m_Geometry = geometry;
+	if (m_Geometry)
 	{
-		return false;
+		m_Nodes = m_Geometry->GetNodes();
 	}
+	m_MatrixDirty = true;
+}
 
 
-	// Create the index buffer - assuming 2-byte (WORD) index data
-	m_NumIndices = static_cast<unsigned int>(subMesh.numFaces) * 3;
-	bufferDesc.BindFlags = D3D10_BIND_INDEX_BUFFER;
-	bufferDesc.Usage = D3D10_USAGE_DEFAULT;
-	bufferDesc.ByteWidth = m_NumIndices * sizeof(WORD);
-	bufferDesc.CPUAccessFlags = 0;
-	bufferDesc.MiscFlags = 0;
-	initData.pSysMem = subMesh.faces;   
-	if (FAILED( g_pd3dDevice->CreateBuffer( &bufferDesc, &initData, &m_IndexBuffer )))
+// Create a vertex layout for this model's geometry with extra elements read from other vertex buffers, e.g. instance data in slot 1.
+// The layout belongs to the caller. Returns 0 on failure or if the model has no geometry
+TRenderLayout CModel::CreateLayout( const SVertexElement* extraElements, unsigned int numExtraElements, TRenderTechnique exampleTechnique )
+{
+	if (!HasGeometry())
 	{
-		return false;
+		return 0;
 	}
-
-	m_HasGeometry = true;
-	return true;
+	return m_Geometry->CreateLayout( extraElements, numExtraElements, exampleTechnique );
 }
 
 
 /////////////////////////////
 // Model Usage
 
-// Update the world matrix of the model from its position, rotation and scaling
-void CModel::UpdateMatrix()
+// Update the world matrix of the model from its position, rotation and scaling, then the matrices of any nodes that have moved. Does
+// nothing if nothing has changed since the last update. Returns true if the world matrix or any node matrices were rebuilt
+bool CModel::UpdateMatrix()
 {
-	// Make a matrix for position and scaling, and one each for X, Y & Z rotations
-	D3DXMATRIX matrixXRot, matrixYRot, matrixZRot, matrixTranslation, matrixScaling;
-	D3DXMatrixRotationX( &matrixXRot, m_Rotation.x );
-	D3DXMatrixRotationY( &matrixYRot, m_Rotation.y );
-	D3DXMatrixRotationZ( &matrixZRot, m_Rotation.z );
-	D3DXMatrixTranslation( &matrixTranslation, m_Position.x, m_Position.y, m_Position.z );
-	D3DXMatrixScaling( &matrixScaling, m_Scale.x, m_Scale.y, m_Scale.z );
-
-	// Multiply above matrices together to get the effect of them all combined - this makes the world matrix for the rendering pipeline
-	// Order of multiplication is important, get slightly different control mechanism depending on order
-	m_WorldMatrix = matrixScaling * matrixZRot * matrixXRot * matrixYRot * matrixTranslation;
+	if (!m_MatrixDirty)
+	{
+		// Only does any work if a node has been moved
+		if (m_Nodes.UpdateMatrices() == 0)
+		{
+			return false;
+		}
+		CalculateWorldBounds();
+		return true;
+	}
+
+	// The world matrix is scaling * Z rotation * X rotation * Y rotation * translation. Order of multiplication is important, get slightly
+	// different control mechanism depending on order. Rather than building five matrices and multiplying them together, the combined
+	// matrix is written directly from the sines and cosines of the angles (rotation order kZXY = Z then X then Y)
+	m_WorldMatrix.MakeAffineEuler( m_Position, m_Rotation, gen::kZXY, m_Scale );
+	m_MatrixDirty = false;
+
+	// The root node of the hierarchy is attached to the world matrix, so all the nodes are updated
+	m_Nodes.SetModelMatrix( m_WorldMatrix );
+	m_Nodes.UpdateMatrices();
+	CalculateWorldBounds();
+	return true;
+}
+
+// Combine the bounds of each subset, placed by the render matrix of its node, into the world bounds of the model
+void CModel::CalculateWorldBounds()
+{
+	m_WorldBounds.centre = m_Position;
+	m_WorldBounds.extents = gen::CVector3::kZero;
+	m_WorldBounds.radius = -1.0f; // Empty
+	if (m_Geometry)
+	{
+		m_Geometry->CalculateWorldBounds( m_Nodes, &m_WorldBounds );
+	}
 }
 
 
@@ -215,68 +177,97 @@ void CModel::Control( float frameTime, EKeyCode turnUp, EKeyCode turnDown, EKeyC
 	if (KeyHeld( turnDown ))
 	{
 		m_Rotation.x += RotSpeed * frameTime;
+		m_MatrixDirty = true;
 	}
 	if (KeyHeld( turnUp ))
 	{
 		m_Rotation.x -= RotSpeed * frameTime;
+		m_MatrixDirty = true;
 	}
 	if (KeyHeld( turnRight ))
 	{
 		m_Rotation.y += RotSpeed * frameTime;
+		m_MatrixDirty = true;
 	}
 	if (KeyHeld( turnLeft ))
 	{
 		m_Rotation.y -= RotSpeed * frameTime;
+		m_MatrixDirty = true;
 	}
 	if (KeyHeld( turnCW ))
 	{
 		m_Rotation.z += RotSpeed * frameTime;
+		m_MatrixDirty = true;
 	}
 	if (KeyHeld( turnCCW ))
 	{
 		m_Rotation.z -= RotSpeed * frameTime;
+		m_MatrixDirty = true;
 	}
 
-	// Local Z movement - move in the direction of the Z axis, get axis from world matrix
+	// Local Z movement - move in the direction of the Z axis, get axis from world matrix (rebuilt first if rotated above)
 	if (KeyHeld( moveForward ))
 	{
-		m_Position.x += m_WorldMatrix._31 * MoveSpeed * frameTime;
-		m_Position.y += m_WorldMatrix._32 * MoveSpeed * frameTime;
-		m_Position.z += m_WorldMatrix._33 * MoveSpeed * frameTime;
+		const gen::CMatrix4x4& worldMatrix = GetWorldMatrix();
+		m_Position.x += worldMatrix.e20 * MoveSpeed * frameTime;
+		m_Position.y += worldMatrix.e21 * MoveSpeed * frameTime;
+		m_Position.z += worldMatrix.e22 * MoveSpeed * frameTime;
+		m_MatrixDirty = true;
 	}
 	if (KeyHeld( moveBackward ))
 	{
-		m_Position.x -= m_WorldMatrix._31 * MoveSpeed * frameTime;
-		m_Position.y -= m_WorldMatrix._32 * MoveSpeed * frameTime;
-		m_Position.z -= m_WorldMatrix._33 * MoveSpeed * frameTime;
+		const gen::CMatrix4x4& worldMatrix = GetWorldMatrix();
+		m_Position.x -= worldMatrix.e20 * MoveSpeed * frameTime;
+		m_Position.y -= worldMatrix.e21 * MoveSpeed * frameTime;
+		m_Position.z -= worldMatrix.e22 * MoveSpeed * frameTime;
+		m_MatrixDirty = true;
 	}
 }
 
 
-// Render the model with the given technique. Assumes any shader variables for the technique have already been set up (e.g. matrices and textures)
-void CModel::Render( ID3D10EffectTechnique* technique )
+// Render the model with the given technique. The world matrix of each part of the model is sent to the given per-object constant buffer.
+// Assumes any other shader constants and variables for the technique have already been set up (e.g. view/projection matrices and textures)
+void CModel::Render( TRenderTechnique technique, CConstantBuffer* objectConstants )
 {
 	// Don't render if no geometry
-	if (!m_HasGeometry)
+	if (!HasGeometry())
 	{
 		return;
 	}
 
-	// Select vertex and index buffer - assuming all data will be as triangle lists
-	UINT offset = 0;
-	g_pd3dDevice->IASetVertexBuffers( 0, 1, &m_VertexBuffer, &m_VertexSize, &offset );
-	g_pd3dDevice->IASetInputLayout( m_VertexLayout );
-	g_pd3dDevice->IASetIndexBuffer( m_IndexBuffer, DXGI_FORMAT_R16_UINT, 0 );
-	g_pd3dDevice->IASetPrimitiveTopology( D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
-
-	// Render the model. All the data and shader variables are prepared, now select the technique to use and draw.
-	// The loop is for advanced techniques that need multiple passes - we will only use techniques with one pass
-	D3D10_TECHNIQUE_DESC techDesc;
-	technique->GetDesc( &techDesc );
-	for( UINT p = 0; p < techDesc.Passes; ++p )
+	// Render the model. Select the geometry and the technique to use, then draw each subset. The loop is for advanced techniques that
+	// need multiple passes - we will only use techniques with one pass
+	SelectGeometry();
+	unsigned int numPasses = g_pRenderDevice->GetNumPasses( technique );
+	for (unsigned int p = 0; p < numPasses; ++p)
+	{
+		g_pRenderDevice->ApplyPass( technique, p );
+		Draw( objectConstants );
+	}
+}
+
+
+// Select the model's vertex and index buffers and vertex layout (or the given layout), ready to draw the model with Draw
+void CModel::SelectGeometry( TRenderLayout layout /*= 0*/ )
+{
+	if (HasGeometry())
 	{
-		technique->GetPassByIndex( p )->Apply( 0 );
-		g_pd3dDevice->DrawIndexed( m_NumIndices, 0, 0 );
+		m_Geometry->Select( layout );
 	}
-	g_pd3dDevice->DrawIndexed( m_NumIndices, 0, 0 );
+}
+
+
+// Draw every part of the model with the current technique pass, sending the world matrix of each part to the given constant buffer. The
+// model's geometry must be selected (see SelectGeometry) and a technique pass applied. If a number of instances is given each part is
+// drawn that many times, the instance data must also be selected
+void CModel::Draw( CConstantBuffer* objectConstants, unsigned int numInstances /*= 0*/ )
+{
+	if (!HasGeometry())
+	{
+		return;
+	}
+
+	// Make sure the world matrix and node matrices are up to date, then draw the shared geometry posed by this model's nodes
+	UpdateMatrix();
+	m_Geometry->Draw( m_Nodes, objectConstants, numInstances );
 }
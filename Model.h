@@ -9,11 +9,19 @@
 #define MODEL_H_INCLUDED
 
 #include <string>
+#include <vector>
 using namespace std;
 
-#include <d3d10.h>
-#include <d3dx10.h>
 #include "Input.h"
+#include "RenderDevice.h" // Buffers, layouts and drawing, independent of the graphics API
+#include "CVector3.h"   // Maths classes from the import library, portable unlike the D3DX types
+#include "CMatrix4x4.h"
+#include "MathCull.h"     // Bounding volumes
+#include "NodeHierarchy.h" // Parts of the model that can move relative to each other
+#include "ModelGeometry.h" // Vertex and index data, shared between models
+
+// Forward declaration of mesh data class used for loading, avoids including the import library here
+namespace gen { class CMeshCache; struct SQuantiseError; }
 
 
 class CModel
@@ -25,33 +33,30 @@ private:
 	// Postioning
 
 	// Positions, rotations and scaling for the model
-	D3DXVECTOR3   m_Position;
-	D3DXVECTOR3   m_Rotation;
-	D3DXVECTOR3   m_Scale;
+	gen::CVector3   m_Position;
+	gen::CVector3   m_Rotation;
+	gen::CVector3   m_Scale;
+
+	// World matrix for the model - built from the above. Same memory layout as a D3DXMATRIX so it can be sent straight to shaders
+	// The matrix is only rebuilt when it is next used after the position, rotation or scaling change (flagged as "dirty")
+	gen::CMatrix4x4 m_WorldMatrix;
+	bool            m_MatrixDirty;
+
+	// Hierarchy of nodes from the model file, each part of the model's geometry is attached to a node. Most models have a single node,
+	// models with several (e.g. vehicles) can move their parts by changing the node matrices. The root node is attached to the world
+	// matrix above
+	CNodeHierarchy  m_Nodes;
 
-	// World matrix for the model - built from the above
-	D3DXMATRIX m_WorldMatrix;
+	// Bounds of the whole model in world space, updated with the world matrix and nodes. Used to cull models outside the view
+	gen::SBounds    m_WorldBounds;
 
 	
 	//-----------------
 	// Geometry data
 
-	// Does this model have any geometry to render
-	bool                     m_HasGeometry;
-
-	// Vertex data for the model stored in a vertex buffer and the number of the vertices in the buffer
-	ID3D10Buffer*            m_VertexBuffer;
-	unsigned int             m_NumVertices;
-
-	// Description of the elements in a single vertex (position, normal, UVs etc.)
-	static const int         MAX_VERTEX_ELTS = 64;
-	D3D10_INPUT_ELEMENT_DESC m_VertexElts[MAX_VERTEX_ELTS];
-	ID3D10InputLayout*       m_VertexLayout; // Layout of a vertex (derived from above)
-	unsigned int             m_VertexSize;   // Size of vertex calculated from contained elements
-
-	// Index data for the model stored in a index buffer and the number of indices in the buffer
-	ID3D10Buffer*            m_IndexBuffer;
-	unsigned int             m_NumIndices;
+	// Vertex and index buffers and the parts of the model, shared with other models loaded from the same file (see CModelGeometry).
+	// NULL if the model has no geometry
+	CModelGeometry* m_Geometry;
 
 
 /////////////////////////////
@@ -62,79 +67,188 @@ public:
 	// Constructors / Destructors
 
 	// Constructor - initialise all settings, sensible defaults provided for everything.
-	CModel( D3DXVECTOR3 position = D3DXVECTOR3(0,0,0), D3DXVECTOR3 rotation = D3DXVECTOR3(0,0,0), float scale = 1.0f );
+	CModel( const gen::CVector3& position = gen::CVector3::kOrigin, const gen::CVector3& rotation = gen::CVector3::kZero, float scale = 1.0f );
 
 	// Destructor
 	~CModel();
 
-	// Release resources used by model
+	// Release resources used by model - the model's reference to its geometry
 	void ReleaseResources();
 
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CModel( const CModel& );
+	CModel& operator=( const CModel& );
+
+public:
 
 	/////////////////////////////
 	// Data access
 
 	// Getters
-	D3DXVECTOR3 GetPosition()
+	const gen::CVector3& GetPosition()
 	{
 		return m_Position;
 	}
-	D3DXVECTOR3 GetRotation()
+	const gen::CVector3& GetRotation()
 	{
 		return m_Rotation;
 	}
-	D3DXVECTOR3 GetScale()
+	const gen::CVector3& GetScale()
 	{
 		return m_Scale;
 	}
 
-	D3DXMATRIX GetWorldMatrix()
+	// Rebuilds the world matrix (and those of the nodes) first if the position, rotation or scaling has changed since it was last built
+	const gen::CMatrix4x4& GetWorldMatrix()
 	{
+		UpdateMatrix();
 		return m_WorldMatrix;
 	}
 
+	// Get the bounds of the model's geometry in world space, updated along with the world matrix. The bounds of each part are taken
+	// from the model file, where they are calculated when the file is imported. Models with no geometry have empty bounds
+	const gen::SBounds& GetWorldBounds()
+	{
+		UpdateMatrix();
+		return m_WorldBounds;
+	}
 
-	// Setters
-	void SetPosition( D3DXVECTOR3 position )
+
+	// Setters - each marks the world matrix as needing a rebuild
+	void SetPosition( const gen::CVector3& position )
 	{
 		m_Position = position;
+		m_MatrixDirty = true;
 	}
-	void SetRotation( D3DXVECTOR3 rotation )
+	void SetRotation( const gen::CVector3& rotation )
 	{
 		m_Rotation = rotation;
+		m_MatrixDirty = true;
 	}
-	void SetScale( D3DXVECTOR3 scale ) // Overloaded setter, two versions: this one sets x,y,z scale separately, the next sets all to the same value
+	void SetScale( const gen::CVector3& scale ) // Overloaded setter, two versions: this one sets x,y,z scale separately, the next sets all to the same value
 	{
 		m_Scale = scale;
+		m_MatrixDirty = true;
 	}
 	void SetScale( float scale )
 	{
-		m_Scale = D3DXVECTOR3( scale, scale, scale );
+		m_Scale = gen::CVector3( scale, scale, scale );
+		m_MatrixDirty = true;
+	}
+
+
+	// Get the number of nodes in the model's hierarchy and the index of the node with the given name (GetNumNodes() if not found).
+	// Node names are the frame names in the model file
+	unsigned int GetNumNodes()
+	{
+		return m_Nodes.GetNumNodes();
+	}
+	unsigned int FindNode( const string& name )
+	{
+		return m_Nodes.FindNode( name );
+	}
+
+	// Get or set the matrix of a node relative to its parent node, e.g. to turn a wheel or turret. Setting a node moves all the nodes
+	// attached to it, their matrices are updated at the same time as the world matrix
+	const gen::CMatrix4x4& GetNodeMatrix( unsigned int node )
+	{
+		return m_Nodes.GetNodeMatrix( node );
+	}
+	void SetNodeMatrix( unsigned int node, const gen::CMatrix4x4& matrix )
+	{
+		m_Nodes.SetNodeMatrix( node, matrix );
 	}
 
 
 	/////////////////////////////
 	// Model Loading
 
-	// Load the model geometry from a file. This function only reads the geometry using the first material in the file, so multi-material
-	// models will load but will have parts missing. May optionally request for tangents to be created for the model (for normal or parallax mapping)
-	// We need to pass an example technique that the model will use to help DirectX understand how to connect this data with the vertex shaders
-	// Returns true if the load was successful
-	bool Load( const string& fileName, ID3D10EffectTechnique* shaderCode, bool tangents = false );
+	// Load the model geometry from a file. Every sub-mesh in the file is loaded into a single vertex and index buffer and rendered as
+	// a list of subsets. May optionally request for tangents to be created for the model (for normal or parallax mapping), and for
+	// a compact vertex layout with reduced precision (about half the memory, see gen::QuantiseVertices)
+	// We need to pass an example technique that the model will use to help the render device understand how to connect this data with the
+	// vertex shaders, or 0 if the model is only drawn with layouts made by CreateLayout (e.g. instanced). Returns true if the load was
+	// successful. The geometry comes from the global geometry cache, models loaded from the same file with the same options share it
+	bool Load( const string& fileName, TRenderTechnique shaderCode, bool tangents = false, bool compact = false );
+
+	// Create the model geometry from mesh data that has already been loaded. Only this final step of creating the render device buffers
+	// needs to happen on the render thread. If a compact vertex layout is requested, the errors introduced are combined into the given
+	// structure if one is provided. The geometry is not cached, it belongs to this model alone. Returns true if successful
+	bool Load( const gen::CMeshCache& mesh, TRenderTechnique shaderCode, bool compact = false,
+	           gen::SQuantiseError* quantiseError = NULL );
+
+	// Get the model's geometry (NULL if none), or use existing geometry, e.g. from the geometry cache. Setting adds a reference to the
+	// geometry and releases the model's previous geometry. The model's nodes are reset to the geometry's default pose
+	CModelGeometry* GetGeometry()
+	{
+		return m_Geometry;
+	}
+	void SetGeometry( CModelGeometry* geometry );
+
+	// Does this model have any geometry to render, and the vertex buffer holding it. Models sharing a vertex buffer have the same
+	// geometry, so can be drawn one after another without selecting it again (see SelectGeometry)
+	bool HasGeometry()
+	{
+		return m_Geometry != NULL && m_Geometry->HasGeometry();
+	}
+	TRenderBuffer GetVertexBuffer()
+	{
+		return m_Geometry ? m_Geometry->GetVertexBuffer() : 0;
+	}
+
+	// Create a vertex layout for this model's geometry with extra elements read from other vertex buffers, e.g. instance data in slot 1.
+	// The layout is for techniques with the same vertex input as the example technique given, and belongs to the caller. Returns 0 on
+	// failure or if the model has no geometry
+	TRenderLayout CreateLayout( const SVertexElement* extraElements, unsigned int numExtraElements, TRenderTechnique exampleTechnique );
+
+	// Get the number of subsets (parts with a single material) in the model and the material used by a given subset
+	unsigned int GetNumSubsets()
+	{
+		return m_Geometry ? m_Geometry->GetNumSubsets() : 0;
+	}
+	unsigned int GetSubsetMaterial( unsigned int subset )
+	{
+		return m_Geometry->GetSubsetMaterial( subset );
+	}
 
 
 	/////////////////////////////
 	// Model Usage
 
-	// Update the world matrix of the model from its position, rotation and scaling
-	void UpdateMatrix();
+	// Update the world matrix of the model from its position, rotation and scaling, then the matrices of any nodes that have moved,
+	// and the world bounds. Does nothing if nothing has changed since the last update. Not usually needed as GetWorldMatrix and Render do this, but can be
+	// used to choose when the work is done. Returns true if any matrix was rebuilt - the world matrix or those of any nodes that moved
+	// on their own. Only changes this model, so different models
+	// can be updated on different threads at the same time
+	bool UpdateMatrix();
 	
 	// Control the model's position and rotation using keys provided. Amount of motion performed depends on frame time
 	void Control( float frameTime, EKeyCode turnUp, EKeyCode turnDown, EKeyCode turnLeft, EKeyCode turnRight,  
 				  EKeyCode turnCW, EKeyCode turnCCW, EKeyCode moveForward, EKeyCode moveBackward );
 
-	// Render the model with the given technique. Assumes any shader variables for the technique have already been set up (e.g. matrices and textures)
-	void Render( ID3D10EffectTechnique* technique );
+	// Render the model with the given technique. The world matrix of each part of the model is sent to the given per-object constant
+	// buffer (see SPerObjectConstants). Assumes any other shader constants and variables for the technique have already been set up (e.g.
+	// view/projection matrices and textures). Drawn with the global render device
+	void Render( TRenderTechnique technique, CConstantBuffer* objectConstants );
+
+	// The two steps of Render, for code that renders many models and avoids selecting the same technique or geometry again for each
+	// one (e.g. the render queue). SelectGeometry selects the model's vertex and index buffers and vertex layout. Draw draws every part
+	// of the model, sending the world matrix of each part to the given constant buffer - the model's geometry (or identical geometry
+	// from another model sharing the same buffers) must be selected and a technique pass applied. Both do nothing if no geometry
+	// A layout can be given to SelectGeometry to use instead of the model's own, e.g. one from CreateLayout. If a number of instances
+	// is given to Draw, each part is drawn that many times in a single draw call, with the instance data from other vertex buffers
+	// selected by the caller (see CInstancedModel)
+	void SelectGeometry( TRenderLayout layout = 0 );
+	void Draw( CConstantBuffer* objectConstants, unsigned int numInstances = 0 );
+
+
+/////////////////////////////
+// Private member functions
+private:
+
+	// Combine the bounds of each subset, placed by the render matrix of its node, into the world bounds of the model
+	void CalculateWorldBounds();
 };
 
 
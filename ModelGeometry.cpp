@@ -0,0 +1,475 @@
+//--------------------------------------------------------------------------------------
+//	ModelGeometry.cpp
+//
+//	The model geometry class holds the vertex and index buffers of a loaded model file and
+//	the parts (subsets) they are drawn as. Geometry is shared by every model using the same
+//	file and options (see GeometryCache.h)
+//--------------------------------------------------------------------------------------
+
+#include <cstring>
+#include <algorithm>
+#include "Defines.h"       // General definitions shared by all source files
+#include "ModelGeometry.h" // Declaration of this class
+#include "GeometryCache.h" // Cache to remove the geometry from when released
+
+#include "CMeshCache.h"      // Class to load meshes via a binary cache (taken from a full graphics engine)
+#include "MeshQuantise.h"    // Conversion of vertices to a compact layout
+#include "MathBatch.h"       // Transformation of whole arrays of vectors
+
+// Copy the vertices of a sub-mesh into the full vertex layout of the given sub-mesh, which has at least the same components. Components
+// missing from the sub-mesh are padded: no bone influences other than its own node, zero normals, tangents and UVs, white colours. The
+// full layout is the one written by the import library, including float colours
+static void CopyVertices( const gen::SSubMesh& part, const gen::SSubMesh& layout, unsigned char* vertices )
+{
+	if (part.vertexSize == layout.vertexSize)
+	{
+		memcpy( vertices, part.vertices, part.numVertices * part.vertexSize );
+		return;
+	}
+
+	// Each component in the import library's vertex order: position, skinning data (4 weights & 4 byte bone indices), normal, tangent,
+	// UV then colour (4 floats)
+	const bool partHas[5] = { part.hasSkinningData, part.hasNormals, part.hasTangents, part.hasTextureCoords, part.hasVertexColours };
+	const bool layoutHas[5] = { layout.hasSkinningData, layout.hasNormals, layout.hasTangents, layout.hasTextureCoords,
+	                            layout.hasVertexColours };
+	const unsigned int componentSize[5] = { 20, 12, 12, 8, 16 };
+	for (unsigned int vertex = 0; vertex < part.numVertices; ++vertex)
+	{
+		const unsigned char* in = part.vertices + vertex * part.vertexSize;
+		unsigned char* out = vertices + vertex * layout.vertexSize;
+		memcpy( out, in, 12 );
+		in += 12;
+		out += 12;
+		for (unsigned int component = 0; component < 5; ++component)
+		{
+			if (partHas[component])
+			{
+				memcpy( out, in, componentSize[component] );
+				in += componentSize[component];
+			}
+			else if (layoutHas[component])
+			{
+				const float one = 1.0f;
+				memset( out, 0, componentSize[component] );
+				if (component == 0)
+				{
+					memcpy( out, &one, sizeof(float) );
+					out[16] = static_cast<unsigned char>(part.node);
+				}
+				else if (component == 4)
+				{
+					for (unsigned int channel = 0; channel < 4; ++channel)
+					{
+						memcpy( out + channel * sizeof(float), &one, sizeof(float) );
+					}
+				}
+			}
+			out += layoutHas[component] ? componentSize[component] : 0;
+		}
+	}
+}
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - creates empty geometry with one reference, held by the caller
+CModelGeometry::CModelGeometry()
+{
+	m_RefCount = 1;
+	m_Cache = NULL;
+
+	m_VertexBuffer = 0;
+	m_NumVertices = 0;
+	m_VertexSize = 0;
+	m_VertexLayout = 0;
+	m_NumVertexElts = 0;
+
+	m_IndexBuffer = 0;
+	m_NumIndices = 0;
+	m_LargeIndexOffset = 0;
+	m_IndexBufferSize = 0;
+}
+
+// Destructor - only called by Release
+CModelGeometry::~CModelGeometry()
+{
+	ReleaseBuffers();
+}
+
+// Release a reference to the geometry. Releasing the last reference removes the geometry from its cache and destroys it
+void CModelGeometry::Release()
+{
+	if (--m_RefCount > 0)
+	{
+		return;
+	}
+	if (m_Cache)
+	{
+		m_Cache->Remove( this );
+	}
+	delete this;
+}
+
+
+/////////////////////////////
+// Creation
+
+// Create the geometry from a loaded mesh. Every sub-mesh is combined into a single vertex and index buffer and drawn as a list of
+// subsets. May optionally request a compact vertex layout with reduced precision (about half the memory, see gen::QuantiseVertices),
+// the errors introduced are combined into the given structure if one is provided. A vertex layout is created if an example technique
+// is given. Returns true if successful
+bool CModelGeometry::Create( const gen::CMeshCache& mesh, TRenderTechnique exampleTechnique, bool compact /*= false*/,
+                             gen::SQuantiseError* quantiseError /*= NULL*/ )
+{
+	// Release any existing geometry in this object
+	ReleaseBuffers();
+	if (mesh.GetNumSubMeshes() == 0)
+	{
+		return false;
+	}
+
+	// Get first sub-mesh from loaded file. The data belongs to the mesh object, it is only valid while that object is loaded. All the
+	// sub-meshes share one vertex format, which has every component found in any of them - the vertices of a sub-mesh without some
+	// component are padded when copied. The format is kept in this sub-mesh (its vertex size and component flags)
+	gen::SSubMesh subMesh;
+	mesh.GetSubMesh( 0, &subMesh );
+	for (unsigned int subMeshNum = 1; subMeshNum < mesh.GetNumSubMeshes(); ++subMeshNum)
+	{
+		gen::SSubMesh part;
+		mesh.GetSubMesh( subMeshNum, &part );
+		subMesh.hasSkinningData = subMesh.hasSkinningData || part.hasSkinningData;
+		subMesh.hasNormals = subMesh.hasNormals || part.hasNormals;
+		subMesh.hasTangents = subMesh.hasTangents || part.hasTangents;
+		subMesh.hasTextureCoords = subMesh.hasTextureCoords || part.hasTextureCoords;
+		subMesh.hasVertexColours = subMesh.hasVertexColours || part.hasVertexColours;
+	}
+	subMesh.vertexSize = 12 + (subMesh.hasSkinningData ? 20 : 0) + (subMesh.hasNormals ? 12 : 0) + (subMesh.hasTangents ? 12 : 0) +
+	                     (subMesh.hasTextureCoords ? 8 : 0) + (subMesh.hasVertexColours ? 16 : 0);
+
+
+	// Create the node hierarchy in its default pose. The world matrix of each node is its default matrix relative to the root, used
+	// below to put the parts of the model attached to different nodes into place
+	m_Nodes.Create( mesh );
+
+	// Make a subset for each sub-mesh. Total up the vertices and indices so the combined data can be created in one go. Sub-meshes
+	// use 16-bit indices unless they have too many vertices, so the subsets with 16-bit indices are listed first then any with 32-bit
+	// indices. Each kind is stored in its own section of the index buffer and the start index of a subset is within its section
+	m_NumVertices = 0;
+	unsigned int numIndices[2] = { 0, 0 }; // Indices in the 16-bit and 32-bit sections
+	vector<unsigned int> subsetSubMeshes;
+	for (int largeIndices = 0; largeIndices < 2; ++largeIndices)
+	{
+		for (unsigned int subMeshNum = 0; subMeshNum < mesh.GetNumSubMeshes(); ++subMeshNum)
+		{
+			gen::SSubMesh part;
+			mesh.GetSubMesh( subMeshNum, &part );
+			if ((part.indexSize == sizeof(unsigned int)) != (largeIndices != 0))
+			{
+				continue;
+			}
+
+			SSubset subset = {};
+			subset.startIndex = numIndices[largeIndices];
+			subset.numIndices = part.numFaces * 3;
+			subset.baseVertex = m_NumVertices;
+			subset.largeIndices = (largeIndices != 0);
+			subset.material = part.material;
+			subset.node = part.node;
+			m_Subsets.push_back( subset );
+			subsetSubMeshes.push_back( subMeshNum );
+
+			m_NumVertices += part.numVertices;
+			numIndices[largeIndices] += subset.numIndices;
+		}
+	}
+	m_NumIndices = numIndices[0] + numIndices[1];
+	m_LargeIndexOffset = (numIndices[0] * 2 + 3) & ~3u; // 32-bit indices must be 4-byte aligned
+
+	// Copy the vertices and indices of every subset into combined lists. The indices of each subset stay relative to its own first
+	// vertex (the base vertex is added when drawing), so most models still fit in 16-bit indices. Parts attached to a node other than
+	// the root are transformed into the root's space, the node hierarchy's render matrices allow for this when the nodes move
+	unsigned int fullVertexSize = subMesh.vertexSize;
+	vector<unsigned char> vertices( m_NumVertices * fullVertexSize );
+	vector<unsigned char> indices( m_LargeIndexOffset + numIndices[1] * sizeof(unsigned int) );
+	unsigned int normalOffset = 12 + (subMesh.hasSkinningData ? 20 : 0); // Skinning data (weights & bone indices) follows position
+	unsigned int tangentOffset = normalOffset + (subMesh.hasNormals ? 12 : 0);
+	for (unsigned int subset = 0; subset < m_Subsets.size(); ++subset)
+	{
+		gen::SSubMesh part;
+		mesh.GetSubMesh( subsetSubMeshes[subset], &part );
+		unsigned char* partVertices = &vertices[m_Subsets[subset].baseVertex * fullVertexSize];
+		CopyVertices( part, subMesh, partVertices );
+		unsigned int indexStart = m_Subsets[subset].largeIndices ? m_LargeIndexOffset : 0;
+		indexStart += m_Subsets[subset].startIndex * part.indexSize;
+		memcpy( &indices[indexStart], part.faces, m_Subsets[subset].numIndices * part.indexSize );
+
+		const gen::CMatrix4x4& nodeMatrix = m_Nodes.GetWorldMatrix( part.node );
+		m_Subsets[subset].bounds = gen::TransformBounds( part.bounds, nodeMatrix );
+		if (!nodeMatrix.IsIdentity())
+		{
+			// Transform each vertex stream in place with the import library's batch functions, which process several vertices at once
+			gen::BatchTransform( nodeMatrix, gen::kBatchPoints, partVertices, fullVertexSize, partVertices, fullVertexSize, part.numVertices );
+			if (subMesh.hasNormals)
+			{
+				unsigned char* normals = partVertices + normalOffset;
+				gen::BatchTransform( nodeMatrix, gen::kBatchNormals, normals, fullVertexSize, normals, fullVertexSize, part.numVertices );
+			}
+			if (subMesh.hasTangents)
+			{
+				unsigned char* tangents = partVertices + tangentOffset;
+				gen::BatchTransform( nodeMatrix, gen::kBatchNormals, tangents, fullVertexSize, tangents, fullVertexSize, part.numVertices );
+			}
+		}
+	}
+
+
+	// If requested, convert the combined vertices to a compact layout: half float positions and UVs, byte normals and tangents. The
+	// import library does the conversion and measures the error introduced. All the new formats are converted back to floats by the
+	// GPU as the vertices are read, so the same shaders are used. Positions stay as floats if half precision is too coarse for the
+	// model, and models with skinning data always use the full layout
+	gen::SCompactVertexFormat compactFormat;
+	gen::SSubMesh combined = subMesh;
+	combined.vertices = &vertices[0];
+	combined.numVertices = m_NumVertices;
+	compact = compact && gen::GetCompactVertexFormat( combined, gen::kfCompactPositionTolerance, &compactFormat );
+	if (compact)
+	{
+		gen::SQuantiseError error = { 0.0f, 0.0f, 0.0f, 0.0f };
+		vector<unsigned char> compactVertices( m_NumVertices * compactFormat.vertexSize );
+		gen::QuantiseVertices( combined, compactFormat, &compactVertices[0], &error );
+		vertices.swap( compactVertices );
+
+		// Quantised positions may have moved outside the bounds calculated from the original positions
+		for (unsigned int subset = 0; subset < m_Subsets.size(); ++subset)
+		{
+			m_Subsets[subset].bounds = gen::ExpandBounds( m_Subsets[subset].bounds, error.position );
+		}
+
+		if (quantiseError)
+		{
+			quantiseError->position = gen::Max( quantiseError->position, error.position );
+			quantiseError->normal = gen::Max( quantiseError->normal, error.normal );
+			quantiseError->tangent = gen::Max( quantiseError->tangent, error.tangent );
+			quantiseError->textureCoord = gen::Max( quantiseError->textureCoord, error.textureCoord );
+		}
+	}
+
+
+	// Create vertex element list. We need a vertex layout to say what data we have per vertex in this model (e.g. position, normal, uv, etc.)
+	// In previous projects the element list was a manually typed in array as we knew what data we would provide. However, as we can load models with
+	// different vertex data this time we need flexible code. The array is built up one element at a time: ask the import class if it loaded normals, 
+	// if so then add a normal line to the array, then ask if it loaded UVS...etc
+	// The format and size of each element depends on whether the compact layout is used
+	unsigned int numElts = 0;
+	unsigned int offset = 0;
+	// Position is always required
+	m_VertexElts[numElts].semantic = "POSITION";   // Semantic in HLSL (what is this data for)
+	m_VertexElts[numElts].semanticIndex = 0;       // Index to add to semantic (a count for this kind of data, when using multiple of the same type, e.g. TEXCOORD0, TEXCOORD1)
+	m_VertexElts[numElts].format = (compact && compactFormat.halfPositions) ? kFormatHalf4 : kFormatFloat3; // Type of data - this one will be a float3 in the shader
+	m_VertexElts[numElts].offset = offset;         // Offset of element from start of vertex data (e.g. if we have position (float3), uv (float2) then normal, the normal's offset is 5 floats = 5*4 = 20)
+	m_VertexElts[numElts].slot = 0;                // For when using multiple vertex buffers (e.g. instancing - an advanced topic)
+	m_VertexElts[numElts].perInstance = false;     // --"--
+	offset += GetVertexFormatSize( m_VertexElts[numElts].format );
+	offset += subMesh.hasSkinningData ? 20 : 0; // Skinning data follows position in the full layout, it is not used by the shaders here
+	++numElts;
+	// Repeat for each kind of vertex data
+	if (subMesh.hasNormals)
+	{
+		m_VertexElts[numElts].semantic = "NORMAL";
+		m_VertexElts[numElts].semanticIndex = 0;
+		m_VertexElts[numElts].format = compact ? kFormatByte4SNorm : kFormatFloat3;
+		m_VertexElts[numElts].offset = offset;
+		m_VertexElts[numElts].slot = 0;
+		m_VertexElts[numElts].perInstance = false;
+		offset += GetVertexFormatSize( m_VertexElts[numElts].format );
+		++numElts;
+	}
+	if (subMesh.hasTangents)
+	{
+		m_VertexElts[numElts].semantic = "TANGENT";
+		m_VertexElts[numElts].semanticIndex = 0;
+		m_VertexElts[numElts].format = compact ? kFormatByte4SNorm : kFormatFloat3;
+		m_VertexElts[numElts].offset = offset;
+		m_VertexElts[numElts].slot = 0;
+		m_VertexElts[numElts].perInstance = false;
+		offset += GetVertexFormatSize( m_VertexElts[numElts].format );
+		++numElts;
+	}
+	if (subMesh.hasTextureCoords)
+	{
+		m_VertexElts[numElts].semantic = "TEXCOORD";
+		m_VertexElts[numElts].semanticIndex = 0;
+		m_VertexElts[numElts].format = compact ? kFormatHalf2 : kFormatFloat2;
+		m_VertexElts[numElts].offset = offset;
+		m_VertexElts[numElts].slot = 0;
+		m_VertexElts[numElts].perInstance = false;
+		offset += GetVertexFormatSize( m_VertexElts[numElts].format );
+		++numElts;
+	}
+	if (subMesh.hasVertexColours)
+	{
+		m_VertexElts[numElts].semantic = "COLOR";
+		m_VertexElts[numElts].semanticIndex = 0;
+		m_VertexElts[numElts].format = kFormatByte4UNorm; // A RGBA colour with 1 byte (0-255) per component
+		m_VertexElts[numElts].offset = offset;
+		m_VertexElts[numElts].slot = 0;
+		m_VertexElts[numElts].perInstance = false;
+		offset += GetVertexFormatSize( m_VertexElts[numElts].format );
+		++numElts;
+	}
+	m_VertexSize = offset;
+	m_NumVertexElts = numElts;
+
+
+	// Create the vertex buffer and fill it with the combined vertex data
+	m_VertexBuffer = g_pRenderDevice->CreateVertexBuffer( &vertices[0], m_NumVertices * m_VertexSize );
+	if (!m_VertexBuffer)
+	{
+		ReleaseBuffers();
+		return false;
+	}
+
+
+	// Create the index buffer - holding the 2-byte index data followed by any 4-byte index data
+	m_IndexBufferSize = static_cast<unsigned int>(indices.size());
+	m_IndexBuffer = g_pRenderDevice->CreateIndexBuffer( &indices[0], m_IndexBufferSize );
+	if (!m_IndexBuffer)
+	{
+		ReleaseBuffers();
+		return false;
+	}
+
+	// Given the vertex element list, the render device can create a vertex layout for the example technique. Without an example there is
+	// no layout until one is created by CreateDefaultLayout, or the geometry is only drawn with layouts from CreateLayout
+	if (exampleTechnique && !CreateDefaultLayout( exampleTechnique ))
+	{
+		ReleaseBuffers();
+		return false;
+	}
+
+	return true;
+}
+
+
+// Create the vertex layout of the geometry if it doesn't have one yet. Models sharing the geometry may be rendered with different
+// techniques, the layout is made for the first one given and serves all techniques with the same vertex input. Returns true if the
+// geometry has a layout
+bool CModelGeometry::CreateDefaultLayout( TRenderTechnique exampleTechnique )
+{
+	if (!m_VertexLayout && HasGeometry() && exampleTechnique)
+	{
+		m_VertexLayout = g_pRenderDevice->CreateLayout( m_VertexElts, m_NumVertexElts, exampleTechnique );
+	}
+	return m_VertexLayout != 0;
+}
+
+
+// Create a vertex layout for the geometry with extra elements read from other vertex buffers, e.g. instance data in slot 1. The
+// layout belongs to the caller. Returns 0 on failure
+TRenderLayout CModelGeometry::CreateLayout( const SVertexElement* extraElements, unsigned int numExtraElements,
+                                            TRenderTechnique exampleTechnique )
+{
+	if (!HasGeometry() || m_NumVertexElts + numExtraElements > MAX_VERTEX_ELTS)
+	{
+		return 0;
+	}
+	SVertexElement elements[MAX_VERTEX_ELTS];
+	copy( m_VertexElts, m_VertexElts + m_NumVertexElts, elements );
+	copy( extraElements, extraElements + numExtraElements, elements + m_NumVertexElts );
+	return g_pRenderDevice->CreateLayout( elements, m_NumVertexElts + numExtraElements, exampleTechnique );
+}
+
+
+/////////////////////////////
+// Data access
+
+// Calculate the bounds of the geometry in world space when posed with the given nodes - each subset's bounds placed by the render matrix
+// of its node. The bounds are merged into those passed in
+void CModelGeometry::CalculateWorldBounds( CNodeHierarchy& nodes, gen::SBounds* bounds )
+{
+	for (unsigned int subset = 0; subset < m_Subsets.size(); ++subset)
+	{
+		const gen::CMatrix4x4& renderMatrix = nodes.GetRenderMatrix( m_Subsets[subset].node );
+		*bounds = gen::MergeBounds( *bounds, gen::TransformBounds( m_Subsets[subset].bounds, renderMatrix ) );
+	}
+}
+
+
+/////////////////////////////
+// Usage
+
+// Select the vertex and index buffers and vertex layout (or the given layout), ready to draw with Draw
+void CModelGeometry::Select( TRenderLayout layout /*= 0*/ )
+{
+	// The render device draws all data as triangle lists. Draw always leaves the 16-bit section of the index buffer selected
+	g_pRenderDevice->SetVertexBuffer( 0, m_VertexBuffer, m_VertexSize );
+	g_pRenderDevice->SetLayout( layout ? layout : m_VertexLayout );
+	g_pRenderDevice->SetIndexBuffer( m_IndexBuffer, false, 0 );
+}
+
+
+// Draw every subset with the current technique pass, sending the render matrix of each subset's node from the given nodes to the given
+// per-object constant buffer. The geometry must be selected and a technique pass applied. If a number of instances is given each subset
+// is drawn that many times, the instance data must also be selected
+void CModelGeometry::Draw( CNodeHierarchy& nodes, CConstantBuffer* objectConstants, unsigned int numInstances /*= 0*/ )
+{
+	// Draw each subset as a range of the index buffer, with the matrix of its node. The constants are only sent when the matrix differs
+	// from the last one sent, e.g. not for a model that is drawn again in a later pass
+	SPerObjectConstants object;
+	bool largeIndices = false;
+	unsigned int currentNode = nodes.GetNumNodes(); // No node
+	for (unsigned int subset = 0; subset < m_Subsets.size(); ++subset)
+	{
+		if (m_Subsets[subset].node != currentNode)
+		{
+			currentNode = m_Subsets[subset].node;
+			object.worldMatrix = nodes.GetRenderMatrix( currentNode );
+			objectConstants->SetAndUpload( &object );
+		}
+
+		// Subsets with 32-bit indices come last, select that section of the index buffer when reaching them
+		if (m_Subsets[subset].largeIndices != largeIndices)
+		{
+			largeIndices = m_Subsets[subset].largeIndices;
+			g_pRenderDevice->SetIndexBuffer( m_IndexBuffer, largeIndices, largeIndices ? m_LargeIndexOffset : 0 );
+		}
+		if (numInstances > 0)
+		{
+			g_pRenderDevice->DrawIndexedInstanced( m_Subsets[subset].numIndices, numInstances, m_Subsets[subset].startIndex,
+			                                       m_Subsets[subset].baseVertex, 0 );
+		}
+		else
+		{
+			g_pRenderDevice->DrawIndexed( m_Subsets[subset].numIndices, m_Subsets[subset].startIndex, m_Subsets[subset].baseVertex );
+		}
+	}
+	if (largeIndices)
+	{
+		g_pRenderDevice->SetIndexBuffer( m_IndexBuffer, false, 0 );
+	}
+}
+
+
+/////////////////////////////
+// Private member functions
+
+// Release the buffers and layout and remove all subsets, leaving no geometry
+void CModelGeometry::ReleaseBuffers()
+{
+	// Handles of 0 are ignored
+	if (g_pRenderDevice)
+	{
+		g_pRenderDevice->ReleaseBuffer( m_IndexBuffer );
+		g_pRenderDevice->ReleaseBuffer( m_VertexBuffer );
+		g_pRenderDevice->ReleaseLayout( m_VertexLayout );
+	}
+	m_IndexBuffer = 0;
+	m_VertexBuffer = 0;
+	m_VertexLayout = 0;
+	m_IndexBufferSize = 0;
+	m_NumVertices = 0;
+	m_NumIndices = 0;
+	m_Subsets.clear();
+	m_Nodes.Clear();
+}
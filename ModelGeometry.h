@@ -0,0 +1,190 @@
+//--------------------------------------------------------------------------------------
+//	ModelGeometry.h
+//
+//	The model geometry class holds the vertex and index buffers of a loaded model file and
+//	the parts (subsets) they are drawn as. Geometry is shared by every model using the same
+//	file and options (see GeometryCache.h)
+//--------------------------------------------------------------------------------------
+
+#ifndef MODEL_GEOMETRY_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define MODEL_GEOMETRY_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "RenderDevice.h"    // Buffers, layouts and drawing, independent of the graphics API
+#include "ShaderConstants.h" // World matrices sent to the shaders
+#include "MathCull.h"        // Bounding volumes
+#include "NodeHierarchy.h"   // Parts of the model that can move relative to each other
+
+// Forward declaration of mesh data class used for loading, avoids including the import library here
+namespace gen { class CMeshCache; struct SQuantiseError; }
+class CGeometryCache;
+
+
+// Geometry never changes once created, everything that differs between models using it (position, node matrices) is kept by each model.
+// Geometry is reference counted: it is created with one reference, each model using it adds another, and it is destroyed, releasing its
+// buffers, when the last reference is released. Geometry from the geometry cache is removed from the cache at the same time
+class CModelGeometry
+{
+/////////////////////////////
+// Private types and member variables
+private:
+
+	// Number of users of this geometry, and the cache holding it (NULL if not cached). The cache sets itself when it adds the geometry
+	friend class CGeometryCache;
+	unsigned int    m_RefCount;
+	CGeometryCache* m_Cache;
+
+	// Vertex data stored in a vertex buffer and the number of the vertices in the buffer
+	TRenderBuffer            m_VertexBuffer;
+	unsigned int             m_NumVertices;
+
+	// Description of the elements in a single vertex (position, normal, UVs etc.)
+	static const int         MAX_VERTEX_ELTS = 64;
+	SVertexElement           m_VertexElts[MAX_VERTEX_ELTS];
+	unsigned int             m_NumVertexElts;
+	TRenderLayout            m_VertexLayout; // Layout of a vertex (derived from above), 0 until created for an example technique
+	unsigned int             m_VertexSize;   // Size of vertex calculated from contained elements
+
+	// Index data stored in a index buffer and the number of indices in the buffer. Indices are 16-bit where possible, any 32-bit
+	// indices are stored after them starting at the given byte offset
+	TRenderBuffer            m_IndexBuffer;
+	unsigned int             m_NumIndices;
+	unsigned int             m_LargeIndexOffset;
+	unsigned int             m_IndexBufferSize;  // In bytes
+
+	// A subset is the geometry from one sub-mesh in the file (one part of the model with a single material). All subsets share the
+	// vertex and index buffers above, each is drawn as a range of the index buffer. Indices are relative to the subset's first vertex
+	struct SSubset
+	{
+		unsigned int startIndex;   // First index of this subset in its section of the index buffer (see below)
+		unsigned int numIndices;
+		int          baseVertex;   // Position in the vertex buffer of this subset's vertex 0
+		bool         largeIndices; // Subset uses 32-bit indices, which start at m_LargeIndexOffset in the index buffer
+		unsigned int material;     // Index of the material in the file used by this subset
+		unsigned int node;         // Node in the hierarchy this subset is attached to
+		gen::SBounds bounds;       // Bounds of this subset's vertices as stored (relative to the root in the default pose)
+	};
+	vector<SSubset>          m_Subsets;
+
+	// Hierarchy of nodes from the file in its default pose, each model using the geometry starts with a copy (which shares the node
+	// data, see CNodeHierarchy)
+	CNodeHierarchy           m_Nodes;
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - creates empty geometry with one reference, held by the caller
+	CModelGeometry();
+
+private:
+	// Destroyed only by releasing the last reference
+	~CModelGeometry();
+
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CModelGeometry( const CModelGeometry& );
+	CModelGeometry& operator=( const CModelGeometry& );
+
+public:
+
+	// Add a reference to the geometry, or release one. Releasing the last reference destroys the geometry
+	void AddRef()
+	{
+		++m_RefCount;
+	}
+	void Release();
+
+	// Number of references to the geometry, e.g. the number of models sharing it
+	unsigned int GetRefCount()
+	{
+		return m_RefCount;
+	}
+
+
+	/////////////////////////////
+	// Creation
+
+	// Create the geometry from a loaded mesh. Every sub-mesh is combined into a single vertex and index buffer and drawn as a list of
+	// subsets. May optionally request a compact vertex layout with reduced precision (about half the memory, see gen::QuantiseVertices),
+	// the errors introduced are combined into the given structure if one is provided. A vertex layout is created if an example technique
+	// is given (see CreateDefaultLayout). Returns true if successful
+	bool Create( const gen::CMeshCache& mesh, TRenderTechnique exampleTechnique, bool compact = false,
+	             gen::SQuantiseError* quantiseError = NULL );
+
+	// Create the vertex layout of the geometry if it doesn't have one yet. We need to pass an example technique that will render this
+	// geometry to help the render device understand how to connect this data with the vertex shaders - the geometry can only be rendered
+	// with techniques that have the same vertex input as the example. Returns true if the geometry has a layout
+	bool CreateDefaultLayout( TRenderTechnique exampleTechnique );
+
+	// Create a vertex layout for the geometry with extra elements read from other vertex buffers, e.g. instance data in slot 1. The
+	// layout belongs to the caller. Returns 0 on failure
+	TRenderLayout CreateLayout( const SVertexElement* extraElements, unsigned int numExtraElements, TRenderTechnique exampleTechnique );
+
+
+	/////////////////////////////
+	// Data access
+
+	// Does the geometry have anything to render, and the vertex buffer holding it. Models sharing a vertex buffer share the geometry
+	bool HasGeometry()
+	{
+		return !m_Subsets.empty();
+	}
+	TRenderBuffer GetVertexBuffer()
+	{
+		return m_VertexBuffer;
+	}
+
+	// Total size of the vertex and index buffers in bytes, the GPU memory used by the geometry
+	unsigned int GetMemorySize()
+	{
+		return m_NumVertices * m_VertexSize + m_IndexBufferSize;
+	}
+
+	// Get the hierarchy of nodes in its default pose
+	const CNodeHierarchy& GetNodes()
+	{
+		return m_Nodes;
+	}
+
+	// Get the number of subsets (parts with a single material) and the material used by a given subset
+	unsigned int GetNumSubsets()
+	{
+		return static_cast<unsigned int>(m_Subsets.size());
+	}
+	unsigned int GetSubsetMaterial( unsigned int subset )
+	{
+		return m_Subsets[subset].material;
+	}
+
+	// Calculate the bounds of the geometry in world space when posed with the given nodes (the render matrices of a model's nodes)
+	void CalculateWorldBounds( CNodeHierarchy& nodes, gen::SBounds* bounds );
+
+
+	/////////////////////////////
+	// Usage
+
+	// Select the vertex and index buffers and vertex layout (or the given layout), ready to draw with Draw
+	void Select( TRenderLayout layout = 0 );
+
+	// Draw every subset with the current technique pass, sending the render matrix of each subset's node from the given nodes to the given
+	// per-object constant buffer (see SPerObjectConstants). The geometry must be selected and a technique pass applied. If a number of
+	// instances is given each subset is drawn that many times, the instance data must also be selected
+	void Draw( CNodeHierarchy& nodes, CConstantBuffer* objectConstants, unsigned int numInstances = 0 );
+
+
+/////////////////////////////
+// Private member functions
+private:
+
+	// Release the buffers and layout and remove all subsets, leaving no geometry
+	void ReleaseBuffers();
+};
+
+
+#endif // End of header guard - see top of file
@@ -0,0 +1,137 @@
+//--------------------------------------------------------------------------------------
+//	NodeHierarchy.cpp
+//
+//	The node hierarchy class holds the parts (nodes) of a model that can move relative to
+//	each other, e.g. the wheels or turret of a vehicle, and calculates their matrices
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "NodeHierarchy.h" // Declaration of this class
+
+#include "CMeshCache.h" // Class to load meshes via a binary cache (taken from a full graphics engine)
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - creates a hierarchy with a single root node at the model's origin
+CNodeHierarchy::CNodeHierarchy()
+{
+	Clear();
+}
+
+
+///////////////////////////////
+// Creation
+
+// Create the hierarchy from the nodes of a loaded mesh, all nodes start in their default position
+void CNodeHierarchy::Create( const gen::CMeshCache& mesh )
+{
+	unsigned int numNodes = mesh.GetNumNodes();
+	if (numNodes == 0)
+	{
+		Clear();
+		return;
+	}
+
+	// Build new node data, any hierarchies sharing the old data keep it
+	shared_ptr<SNodeData> data = make_shared<SNodeData>();
+	data->names.resize( numNodes );
+	data->parents.resize( numNodes );
+	data->defaultMatrices.resize( numNodes );
+	for (unsigned int node = 0; node < numNodes; ++node)
+	{
+		gen::SMeshNode meshNode;
+		mesh.GetNode( node, &meshNode );
+		data->names[node] = meshNode.name;
+		data->parents[node] = (node > 0) ? meshNode.parent : 0;
+		data->defaultMatrices[node] = meshNode.positionMatrix;
+	}
+	data->offsetMatrices.assign( numNodes, gen::CMatrix4x4::kIdentity );
+	m_Data = data;
+	m_LocalMatrices.clear();
+	m_WorldMatrices.resize( numNodes );
+	m_RenderMatrices.resize( numNodes );
+	m_Dirty.assign( numNodes, true );
+
+	// Update with the model at the origin to get the default matrix of each node relative to the root, and invert them to get the
+	// offset matrices. Until the model matrix is set the world matrices are these default matrices, which are used to put the model's
+	// vertices into place as it is loaded
+	m_ModelMatrix = gen::CMatrix4x4::kIdentity;
+	m_AnyDirty = true;
+	UpdateMatrices();
+	for (unsigned int node = 0; node < numNodes; ++node)
+	{
+		data->offsetMatrices[node] = gen::InverseAffine( m_WorldMatrices[node] );
+		m_RenderMatrices[node] = gen::CMatrix4x4::kIdentity;
+	}
+}
+
+// Reset to a single root node at the model's origin. Every cleared hierarchy shares the same node data
+void CNodeHierarchy::Clear()
+{
+	static const shared_ptr<const SNodeData> RootOnly = []()
+	{
+		shared_ptr<SNodeData> data = make_shared<SNodeData>();
+		data->names.assign( 1, "" );
+		data->parents.assign( 1, 0 );
+		data->defaultMatrices.assign( 1, gen::CMatrix4x4::kIdentity );
+		data->offsetMatrices.assign( 1, gen::CMatrix4x4::kIdentity );
+		return shared_ptr<const SNodeData>( data );
+	}();
+	m_Data = RootOnly;
+	m_LocalMatrices.clear();
+	m_WorldMatrices.assign( 1, gen::CMatrix4x4::kIdentity );
+	m_RenderMatrices.assign( 1, gen::CMatrix4x4::kIdentity );
+	m_Dirty.assign( 1, false );
+	m_ModelMatrix = gen::CMatrix4x4::kIdentity;
+	m_AnyDirty = false;
+}
+
+
+/////////////////////////////
+// Data access
+
+// Return the index of the node with the given name, or GetNumNodes() if not found
+unsigned int CNodeHierarchy::FindNode( const string& name )
+{
+	return static_cast<unsigned int>(find( m_Data->names.begin(), m_Data->names.end(), name ) - m_Data->names.begin());
+}
+
+
+/////////////////////////////
+// Update
+
+// Recalculate the world and render matrices of every node that has changed, or has an ancestor that has changed, since the last
+// update. Returns the number of nodes updated
+unsigned int CNodeHierarchy::UpdateMatrices()
+{
+	if (!m_AnyDirty)
+	{
+		return 0;
+	}
+
+	// A single sweep through the nodes. Parents come before their children, so a parent's flag and world matrix are already up to date
+	// when its children are reached. A changed node passes its flag on to its children, and so to the whole subtree below it
+	unsigned int numUpdated = 0;
+	unsigned int numNodes = GetNumNodes();
+	const vector<gen::CMatrix4x4>& localMatrices = m_LocalMatrices.empty() ? m_Data->defaultMatrices : m_LocalMatrices;
+	for (unsigned int node = 0; node < numNodes; ++node)
+	{
+		unsigned int parent = m_Data->parents[node];
+		if (m_Dirty[parent])
+		{
+			m_Dirty[node] = true;
+		}
+		if (m_Dirty[node])
+		{
+			m_WorldMatrices[node] = localMatrices[node] * (node == 0 ? m_ModelMatrix : m_WorldMatrices[parent]);
+			m_RenderMatrices[node] = m_Data->offsetMatrices[node] * m_WorldMatrices[node];
+			++numUpdated;
+		}
+	}
+
+	fill( m_Dirty.begin(), m_Dirty.end(), false );
+	m_AnyDirty = false;
+	return numUpdated;
+}
@@ -0,0 +1,140 @@
+//--------------------------------------------------------------------------------------
+//	NodeHierarchy.h
+//
+//	The node hierarchy class holds the parts (nodes) of a model that can move relative to
+//	each other, e.g. the wheels or turret of a vehicle, and calculates their matrices
+//--------------------------------------------------------------------------------------
+
+#ifndef NODE_HIERARCHY_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define NODE_HIERARCHY_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <memory>
+using namespace std;
+
+#include "CMatrix4x4.h" // Maths classes from the import library
+
+// Forward declaration of mesh data class used to create the hierarchy, avoids including the import library here
+namespace gen { class CMeshCache; }
+
+
+// The nodes are stored in the same order as the mesh file lists them (gen::SMeshNode): depth-first, so every parent comes before its
+// children. Each kind of node data is kept in its own array (structure of arrays) rather than as a list of node objects, so the update
+// reads and writes memory in one linear sweep. Node 0 is the root, which is attached to the world matrix of the model that owns the
+// hierarchy
+//
+// A model's vertices are stored already transformed by the default (as loaded) matrix of their node relative to the root. So the
+// matrix used to render a node's geometry is the inverse of that default matrix (the "offset" matrix) combined with the node's
+// current world matrix. When no node has moved from its default position, every render matrix is the model's world matrix
+//
+// The data from the mesh file never changes, so copies of a hierarchy share it (e.g. every model using the same geometry). The local
+// matrices are also shared until a node is moved, only then does a hierarchy get its own copy (copy-on-write). Only the world and
+// render matrices, which depend on the model's world matrix, belong to each hierarchy from the start
+class CNodeHierarchy
+{
+/////////////////////////////
+// Private types and member variables
+private:
+
+	// Node data from the mesh file, one entry per node in each array
+	struct SNodeData
+	{
+		vector<string>          names;           // Name from the mesh file, only used to find nodes
+		vector<unsigned int>    parents;         // Index of parent node, the root is its own parent
+		vector<gen::CMatrix4x4> defaultMatrices; // Matrix of node relative to its parent as loaded (root: relative to the model)
+		vector<gen::CMatrix4x4> offsetMatrices;  // Inverse of the default matrix of node relative to the root
+	};
+	shared_ptr<const SNodeData> m_Data;
+
+	// Current state of each node, one entry per node in each array
+	vector<gen::CMatrix4x4> m_LocalMatrices;  // Current matrix of node relative to its parent, empty until any node is moved (the
+	                                          // default matrices are used until then)
+	vector<gen::CMatrix4x4> m_WorldMatrices;  // Current matrix of node in world space
+	vector<gen::CMatrix4x4> m_RenderMatrices; // Offset matrix * world matrix, see above
+	vector<char>            m_Dirty;          // Local matrix of node has changed since last update
+
+	// World matrix of the model that owns the hierarchy, the parent of the root node
+	gen::CMatrix4x4 m_ModelMatrix;
+
+	// Any node has changed since last update - the update does nothing if not
+	bool m_AnyDirty;
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - creates a hierarchy with a single root node at the model's origin
+	CNodeHierarchy();
+
+
+	///////////////////////////////
+	// Creation
+
+	// Create the hierarchy from the nodes of a loaded mesh, all nodes start in their default position
+	void Create( const gen::CMeshCache& mesh );
+
+	// Reset to a single root node at the model's origin
+	void Clear();
+
+
+	/////////////////////////////
+	// Data access
+
+	// Number of nodes, and index of the node with the given name (returns GetNumNodes() if not found)
+	unsigned int GetNumNodes()
+	{
+		return static_cast<unsigned int>(m_Data->parents.size());
+	}
+	unsigned int FindNode( const string& name );
+
+	// Get or set the matrix of a node relative to its parent. Setting marks the node, and so all nodes below it, for update. The first
+	// node set in a hierarchy copies the default matrices of all the nodes
+	const gen::CMatrix4x4& GetNodeMatrix( unsigned int node )
+	{
+		return m_LocalMatrices.empty() ? m_Data->defaultMatrices[node] : m_LocalMatrices[node];
+	}
+	void SetNodeMatrix( unsigned int node, const gen::CMatrix4x4& matrix )
+	{
+		if (m_LocalMatrices.empty())
+		{
+			m_LocalMatrices = m_Data->defaultMatrices;
+		}
+		m_LocalMatrices[node] = matrix;
+		m_Dirty[node] = true;
+		m_AnyDirty = true;
+	}
+
+	// Set the world matrix of the model that owns the hierarchy, this marks every node for update
+	void SetModelMatrix( const gen::CMatrix4x4& matrix )
+	{
+		m_ModelMatrix = matrix;
+		m_Dirty[0] = true;
+		m_AnyDirty = true;
+	}
+
+	// Get the world / render matrix of a node as of the last update
+	const gen::CMatrix4x4& GetWorldMatrix( unsigned int node )
+	{
+		return m_WorldMatrices[node];
+	}
+	const gen::CMatrix4x4& GetRenderMatrix( unsigned int node )
+	{
+		return m_RenderMatrices[node];
+	}
+
+
+	/////////////////////////////
+	// Update
+
+	// Recalculate the world and render matrices of every node that has changed, or has an ancestor that has changed, since the
+	// last update. Returns the number of nodes updated
+	unsigned int UpdateMatrices();
+};
+
+
+#endif // End of header guard - see top of file
@@ -0,0 +1,436 @@
+//--------------------------------------------------------------------------------------
+//	RecordingRenderDevice.cpp
+//
+//	Render device that draws nothing, instead recording every resource creation, state
+//	change and draw into a command trace. Needs no GPU, so rendering code can be run,
+//	timed and checked anywhere
+//--------------------------------------------------------------------------------------
+
+#include "RecordingRenderDevice.h" // Declaration of this class
+
+// Names of each vertex format as used in the trace
+const char* VertexFormatNames[kNumVertexFormats] =
+{
+	"float2", "float3", "float4", "half2", "half4", "byte4snorm", "byte4unorm"
+};
+
+// Hash of a block of data (FNV-1a), recorded when buffers are created so changes to their contents show up in the trace
+unsigned int HashData( const void* data, unsigned int size )
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	unsigned int hash = 2166136261u;
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - creates a device with no commands recorded
+CRecordingRenderDevice::CRecordingRenderDevice()
+{
+	m_NumBuffers = 0;
+	m_NumLayouts = 0;
+	ClearCommands();
+}
+
+
+/////////////////////////////
+// Recorded commands
+
+// Forget the commands recorded so far, e.g. to record each frame separately. Handles and names are kept
+void CRecordingRenderDevice::ClearCommands()
+{
+	m_Commands.clear();
+	m_Values.clear();
+	m_Strings.clear();
+	for (unsigned int type = 0; type < kNumRenderCommands; ++type)
+	{
+		m_CommandCounts[type] = 0;
+	}
+}
+
+// Number of draws recorded that follow a shader variable write with no pass applied in between, worked out from the commands in the
+// same way as the DirectX device decides to apply the pass again (only once a pass has been applied)
+unsigned int CRecordingRenderDevice::GetNumReapplies()
+{
+	unsigned int numReapplies = 0;
+	bool passApplied = false;
+	bool variablesChanged = false;
+	for (unsigned int command = 0; command < m_Commands.size(); ++command)
+	{
+		switch (m_Commands[command].type)
+		{
+		case kCommandSetMatrix:
+		case kCommandSetFloats:
+		case kCommandSetFloat:
+		case kCommandSetTexture:
+			variablesChanged = true;
+			break;
+		case kCommandApplyPass:
+			passApplied = true;
+			variablesChanged = false;
+			break;
+		case kCommandDrawIndexed:
+		case kCommandDrawIndexedInstanced:
+			numReapplies += (passApplied && variablesChanged) ? 1 : 0;
+			variablesChanged = false;
+			break;
+		default:
+			break;
+		}
+	}
+	return numReapplies;
+}
+
+// Write the recorded commands as text, one per line. Techniques, variables and textures are written by name, other objects by handle
+void CRecordingRenderDevice::WriteTrace( ostream& out )
+{
+	for (unsigned int command = 0; command < m_Commands.size(); ++command)
+	{
+		const SRenderCommand& c = m_Commands[command];
+		out << GetCommandName( c.type );
+		switch (c.type)
+		{
+		case kCommandCreateVertexBuffer:
+		case kCommandCreateIndexBuffer:
+			out << " buffer=" << c.args[0] << " size=" << c.args[1] << " hash=" << hex << c.args[2] << dec;
+			break;
+		case kCommandCreateDynamicVertexBuffer:
+			out << " buffer=" << c.args[0] << " size=" << c.args[1];
+			break;
+		case kCommandReleaseBuffer:
+			out << " buffer=" << c.args[0];
+			break;
+		case kCommandUpdateBuffer:
+			out << " buffer=" << c.args[0] << " size=" << c.args[1] << " hash=" << hex << c.args[2] << dec;
+			break;
+		case kCommandCreateConstantBuffer:
+			out << " buffer=" << c.args[0] << " name=" << m_Strings[c.args[1]] << " size=" << c.args[2];
+			break;
+		case kCommandCreateLayout:
+			out << " layout=" << c.args[0] << " technique=" << GetName( m_TechniqueNames, c.args[1] ) << " elements=" << m_Strings[c.args[2]];
+			break;
+		case kCommandReleaseLayout:
+		case kCommandSetLayout:
+			out << " layout=" << c.args[0];
+			break;
+		case kCommandLoadEffect:
+			out << " file=" << m_Strings[c.args[0]];
+			break;
+		case kCommandLoadTexture:
+		case kCommandReleaseTexture:
+			out << " texture=" << GetName( m_TextureNames, c.args[0] );
+			break;
+		case kCommandSetMatrix:
+		case kCommandSetFloats:
+		case kCommandSetFloat:
+			out << " " << GetName( m_VariableNames, c.args[0] );
+			break;
+		case kCommandSetTexture:
+			out << " " << GetName( m_VariableNames, c.args[0] ) << " texture=" << (c.args[1] ? GetName( m_TextureNames, c.args[1] ) : "none");
+			break;
+		case kCommandSetVertexBuffer:
+			out << " slot=" << c.args[0] << " buffer=" << c.args[1] << " vertexSize=" << c.args[2];
+			break;
+		case kCommandSetIndexBuffer:
+			out << " buffer=" << c.args[0] << " bits=" << (c.args[1] ? 32 : 16) << " offset=" << c.args[2];
+			break;
+		case kCommandApplyPass:
+			out << " technique=" << GetName( m_TechniqueNames, c.args[0] ) << " pass=" << c.args[1];
+			break;
+		case kCommandDrawIndexed:
+			out << " indices=" << c.args[0] << " start=" << c.args[1] << " baseVertex=" << static_cast<int>(c.args[2]);
+			break;
+		case kCommandDrawIndexedInstanced:
+			out << " indices=" << c.args[0] << " instances=" << c.args[1] << " start=" << c.args[2]
+			    << " baseVertex=" << static_cast<int>(c.args[3]) << " startInstance=" << c.args[4];
+			break;
+		default:
+			break;
+		}
+		for (unsigned int value = 0; value < c.numValues; ++value)
+		{
+			out << " " << m_Values[c.firstValue + value];
+		}
+		out << "\n";
+	}
+}
+
+// Name of the given kind of command as used in the trace
+const char* CRecordingRenderDevice::GetCommandName( ERenderCommand type )
+{
+	static const char* CommandNames[kNumRenderCommands] =
+	{
+		"CreateVertexBuffer",
+		"CreateIndexBuffer",
+		"CreateDynamicVertexBuffer",
+		"ReleaseBuffer",
+		"UpdateBuffer",
+		"CreateConstantBuffer",
+		"CreateLayout",
+		"ReleaseLayout",
+		"LoadEffect",
+		"LoadTexture",
+		"ReleaseTexture",
+		"SetMatrix",
+		"SetFloats",
+		"SetFloat",
+		"SetTexture",
+		"SetVertexBuffer",
+		"SetLayout",
+		"SetIndexBuffer",
+		"ApplyPass",
+		"DrawIndexed",
+		"DrawIndexedInstanced",
+		"Clear",
+		"Present",
+	};
+	return CommandNames[type];
+}
+
+
+/////////////////////////////
+// Buffers and layouts
+
+TRenderBuffer CRecordingRenderDevice::CreateVertexBuffer( const void* data, unsigned int size )
+{
+	Record( kCommandCreateVertexBuffer, ++m_NumBuffers, size, HashData( data, size ) );
+	return m_NumBuffers;
+}
+
+TRenderBuffer CRecordingRenderDevice::CreateIndexBuffer( const void* data, unsigned int size )
+{
+	Record( kCommandCreateIndexBuffer, ++m_NumBuffers, size, HashData( data, size ) );
+	return m_NumBuffers;
+}
+
+void CRecordingRenderDevice::ReleaseBuffer( TRenderBuffer buffer )
+{
+	if (buffer)
+	{
+		Record( kCommandReleaseBuffer, buffer );
+	}
+}
+
+
+// Dynamic buffers are recorded with their size only, each update with the size and hash of its data
+TRenderBuffer CRecordingRenderDevice::CreateDynamicVertexBuffer( unsigned int size )
+{
+	Record( kCommandCreateDynamicVertexBuffer, ++m_NumBuffers, size );
+	return m_NumBuffers;
+}
+
+bool CRecordingRenderDevice::UpdateBuffer( TRenderBuffer buffer, const void* data, unsigned int size )
+{
+	Record( kCommandUpdateBuffer, buffer, size, HashData( data, size ) );
+	return true;
+}
+
+// Constant buffers are recorded with the cbuffer name, as the effect file is not read any name succeeds
+TRenderBuffer CRecordingRenderDevice::CreateConstantBuffer( const string& name, unsigned int size )
+{
+	if (size % 16 != 0)
+	{
+		return 0;
+	}
+	Record( kCommandCreateConstantBuffer, ++m_NumBuffers, AddString( name ), size );
+	return m_NumBuffers;
+}
+
+
+// The elements are recorded as a description like "POSITION0:float3@0,NORMAL0:float3@12", elements in other vertex buffers than slot 0
+// have their slot added, e.g. "/slot1", and instance data is marked with a *
+TRenderLayout CRecordingRenderDevice::CreateLayout( const SVertexElement* elements, unsigned int numElements, TRenderTechnique exampleTechnique )
+{
+	string description;
+	for (unsigned int elt = 0; elt < numElements; ++elt)
+	{
+		if (elt > 0)
+		{
+			description += ",";
+		}
+		description += elements[elt].semantic + to_string( elements[elt].semanticIndex ) + ":" + VertexFormatNames[elements[elt].format] +
+		               "@" + to_string( elements[elt].offset );
+		if (elements[elt].slot > 0)
+		{
+			description += "/slot" + to_string( elements[elt].slot );
+		}
+		if (elements[elt].perInstance)
+		{
+			description += "*";
+		}
+	}
+	Record( kCommandCreateLayout, ++m_NumLayouts, exampleTechnique, AddString( description ) );
+	return m_NumLayouts;
+}
+
+void CRecordingRenderDevice::ReleaseLayout( TRenderLayout layout )
+{
+	if (layout)
+	{
+		Record( kCommandReleaseLayout, layout );
+	}
+}
+
+
+/////////////////////////////
+// Effects and textures
+
+// The effect file is not read, any file name succeeds
+bool CRecordingRenderDevice::LoadEffect( const string& fileName )
+{
+	Record( kCommandLoadEffect, AddString( fileName ) );
+	return true;
+}
+
+
+// Get a technique or variable from the effect file by name, the same name always gives the same handle
+TRenderTechnique CRecordingRenderDevice::GetTechnique( const string& name )
+{
+	unsigned int& technique = m_Techniques[name];
+	if (technique == 0)
+	{
+		m_TechniqueNames.push_back( name );
+		technique = static_cast<unsigned int>(m_TechniqueNames.size());
+	}
+	return technique;
+}
+
+TRenderVariable CRecordingRenderDevice::GetVariable( const string& name )
+{
+	unsigned int& variable = m_Variables[name];
+	if (variable == 0)
+	{
+		m_VariableNames.push_back( name );
+		variable = static_cast<unsigned int>(m_VariableNames.size());
+	}
+	return variable;
+}
+
+unsigned int CRecordingRenderDevice::GetNumPasses( TRenderTechnique /*technique*/ )
+{
+	return 1;
+}
+
+
+// The texture file is not read, any file name succeeds. Textures are named by file in the trace, so each load gets a new handle
+TRenderTexture CRecordingRenderDevice::LoadTexture( const string& fileName )
+{
+	m_TextureNames.push_back( fileName );
+	TRenderTexture texture = static_cast<TRenderTexture>(m_TextureNames.size());
+	Record( kCommandLoadTexture, texture );
+	return texture;
+}
+
+void CRecordingRenderDevice::ReleaseTexture( TRenderTexture texture )
+{
+	if (texture)
+	{
+		Record( kCommandReleaseTexture, texture );
+	}
+}
+
+
+/////////////////////////////
+// Shader variables
+
+void CRecordingRenderDevice::SetMatrix( TRenderVariable variable, const gen::CMatrix4x4& matrix )
+{
+	Record( kCommandSetMatrix, variable, 0, 0, &matrix.e00, 16 );
+}
+
+void CRecordingRenderDevice::SetFloats( TRenderVariable variable, const float* values, unsigned int numValues )
+{
+	Record( kCommandSetFloats, variable, 0, 0, values, numValues );
+}
+
+void CRecordingRenderDevice::SetFloat( TRenderVariable variable, float value )
+{
+	Record( kCommandSetFloat, variable, 0, 0, &value, 1 );
+}
+
+void CRecordingRenderDevice::SetTexture( TRenderVariable variable, TRenderTexture texture )
+{
+	Record( kCommandSetTexture, variable, texture );
+}
+
+
+/////////////////////////////
+// Drawing
+
+void CRecordingRenderDevice::SetVertexBuffer( unsigned int slot, TRenderBuffer buffer, unsigned int vertexSize )
+{
+	Record( kCommandSetVertexBuffer, slot, buffer, vertexSize );
+}
+
+void CRecordingRenderDevice::SetLayout( TRenderLayout layout )
+{
+	Record( kCommandSetLayout, layout );
+}
+
+void CRecordingRenderDevice::SetIndexBuffer( TRenderBuffer buffer, bool largeIndices, unsigned int offset )
+{
+	Record( kCommandSetIndexBuffer, buffer, largeIndices ? 1 : 0, offset );
+}
+
+void CRecordingRenderDevice::ApplyPass( TRenderTechnique technique, unsigned int pass )
+{
+	Record( kCommandApplyPass, technique, pass );
+}
+
+void CRecordingRenderDevice::DrawIndexed( unsigned int numIndices, unsigned int startIndex, int baseVertex )
+{
+	Record( kCommandDrawIndexed, numIndices, startIndex, static_cast<unsigned int>(baseVertex) );
+}
+
+void CRecordingRenderDevice::DrawIndexedInstanced( unsigned int numIndices, unsigned int numInstances, unsigned int startIndex, int baseVertex,
+                                                   unsigned int startInstance )
+{
+	// The only command with more than three arguments, the last two are added to the recorded command
+	Record( kCommandDrawIndexedInstanced, numIndices, numInstances, startIndex );
+	m_Commands.back().args[3] = static_cast<unsigned int>(baseVertex);
+	m_Commands.back().args[4] = startInstance;
+}
+
+void CRecordingRenderDevice::Clear( const float colour[4] )
+{
+	Record( kCommandClear, 0, 0, 0, colour, 4 );
+}
+
+void CRecordingRenderDevice::Present()
+{
+	Record( kCommandPresent );
+}
+
+
+/////////////////////////////
+// Private member functions
+
+// Record a command with the given arguments and floats
+void CRecordingRenderDevice::Record( ERenderCommand type, unsigned int arg0 /*= 0*/, unsigned int arg1 /*= 0*/, unsigned int arg2 /*= 0*/,
+                                     const float* values /*= NULL*/, unsigned int numValues /*= 0*/ )
+{
+	SRenderCommand command = { type, { arg0, arg1, arg2, 0, 0 }, static_cast<unsigned int>(m_Values.size()), numValues };
+	m_Commands.push_back( command );
+	m_Values.insert( m_Values.end(), values, values + numValues );
+	++m_CommandCounts[type];
+}
+
+// Get the name of a technique, variable or texture by handle from the given list. Handle 0 (what the DirectX device returns for an
+// unknown name) or an unknown handle gives "invalid"
+const char* CRecordingRenderDevice::GetName( const vector<string>& names, unsigned int handle )
+{
+	return (handle > 0 && handle <= names.size()) ? names[handle - 1].c_str() : "invalid";
+}
+
+// Add a string used by a command, returns its index to store in the command
+unsigned int CRecordingRenderDevice::AddString( const string& s )
+{
+	m_Strings.push_back( s );
+	return static_cast<unsigned int>(m_Strings.size() - 1);
+}
@@ -0,0 +1,214 @@
+//--------------------------------------------------------------------------------------
+//	RecordingRenderDevice.h
+//
+//	Render device that draws nothing, instead recording every resource creation, state
+//	change and draw into a command trace. Needs no GPU, so rendering code can be run,
+//	timed and checked anywhere
+//--------------------------------------------------------------------------------------
+
+#ifndef RECORDING_RENDER_DEVICE_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define RECORDING_RENDER_DEVICE_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+using namespace std;
+
+#include "RenderDevice.h" // Interface implemented by this class
+
+
+// Kinds of command recorded, one for each device function that creates or releases something or changes the state of the device
+enum ERenderCommand
+{
+	kCommandCreateVertexBuffer,
+	kCommandCreateIndexBuffer,
+	kCommandCreateDynamicVertexBuffer,
+	kCommandReleaseBuffer,
+	kCommandUpdateBuffer,
+	kCommandCreateConstantBuffer,
+	kCommandCreateLayout,
+	kCommandReleaseLayout,
+	kCommandLoadEffect,
+	kCommandLoadTexture,
+	kCommandReleaseTexture,
+	kCommandSetMatrix,
+	kCommandSetFloats,
+	kCommandSetFloat,
+	kCommandSetTexture,
+	kCommandSetVertexBuffer,
+	kCommandSetLayout,
+	kCommandSetIndexBuffer,
+	kCommandApplyPass,
+	kCommandDrawIndexed,
+	kCommandDrawIndexedInstanced,
+	kCommandClear,
+	kCommandPresent,
+	kNumRenderCommands
+};
+
+// A recorded command. The meaning of the arguments depends on the kind of command, they are the parameters of the device function
+// in the same order, with handles in place of data and names (see WriteTrace). Floats passed with the command (matrices, vectors,
+// colours) are kept in a separate list
+struct SRenderCommand
+{
+	ERenderCommand type;
+	unsigned int   args[5];
+	unsigned int   firstValue; // Position of the command's floats in the value list
+	unsigned int   numValues;
+};
+
+
+// Recording a command is little more than adding it to a list, so timing rendering code with this device measures the CPU cost of
+// working out what to submit, without the graphics driver. The trace written from the commands is plain text with one command per
+// line and no pointers or timings, so traces of the same frame are identical from run to run and two traces can be compared with
+// any diff tool. Techniques and variables are given handles by name without an effect file, every technique has a single pass
+class CRecordingRenderDevice : public IRenderDevice
+{
+/////////////////////////////
+// Private member variables
+private:
+
+	// Commands recorded since the last call to ClearCommands, their floats and the number of each kind
+	vector<SRenderCommand> m_Commands;
+	vector<float>          m_Values;
+	unsigned int           m_CommandCounts[kNumRenderCommands];
+
+	// Names used in the trace: file names and layout descriptions (by index from commands), techniques, variables and textures (by
+	// handle - 1)
+	vector<string>            m_Strings;
+	vector<string>            m_TechniqueNames;
+	vector<string>            m_VariableNames;
+	vector<string>            m_TextureNames;
+	map<string, unsigned int> m_Techniques; // Handle for each name
+	map<string, unsigned int> m_Variables;
+
+	// Handles given out so far
+	unsigned int m_NumBuffers;
+	unsigned int m_NumLayouts;
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - creates a device with no commands recorded
+	CRecordingRenderDevice();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CRecordingRenderDevice( const CRecordingRenderDevice& );
+	CRecordingRenderDevice& operator=( const CRecordingRenderDevice& );
+
+public:
+
+	/////////////////////////////
+	// Recorded commands
+
+	// Get the commands recorded since the last call to ClearCommands, and the floats passed with them
+	unsigned int GetNumCommands()
+	{
+		return static_cast<unsigned int>(m_Commands.size());
+	}
+	const SRenderCommand& GetCommand( unsigned int command )
+	{
+		return m_Commands[command];
+	}
+	const float* GetCommandValues( unsigned int command )
+	{
+		return m_Commands[command].numValues ? &m_Values[m_Commands[command].firstValue] : NULL;
+	}
+
+	// Number of commands of the given kind recorded since the last call to ClearCommands, e.g. the number of draw calls in a frame
+	unsigned int GetCommandCount( ERenderCommand type )
+	{
+		return m_CommandCounts[type];
+	}
+
+	// Number of draws recorded since the last call to ClearCommands that follow a shader variable write with no pass applied in between.
+	// The DirectX device applies the current pass again before each of these draws to send the changed variables, this device doesn't
+	unsigned int GetNumReapplies();
+
+	// Forget the commands recorded so far, e.g. to record each frame separately. Handles and names are kept
+	void ClearCommands();
+
+	// Write the recorded commands as text, one per line
+	void WriteTrace( ostream& out );
+
+	// Name of the given kind of command as used in the trace
+	static const char* GetCommandName( ERenderCommand type );
+
+
+	/////////////////////////////
+	// Buffers and layouts
+
+	TRenderBuffer CreateVertexBuffer( const void* data, unsigned int size );
+	TRenderBuffer CreateIndexBuffer( const void* data, unsigned int size );
+	void ReleaseBuffer( TRenderBuffer buffer );
+	TRenderBuffer CreateDynamicVertexBuffer( unsigned int size );
+	bool UpdateBuffer( TRenderBuffer buffer, const void* data, unsigned int size );
+	TRenderBuffer CreateConstantBuffer( const string& name, unsigned int size );
+
+	TRenderLayout CreateLayout( const SVertexElement* elements, unsigned int numElements, TRenderTechnique exampleTechnique );
+	void ReleaseLayout( TRenderLayout layout );
+
+
+	/////////////////////////////
+	// Effects and textures
+
+	// The effect file is not read, any file name succeeds
+	bool LoadEffect( const string& fileName );
+
+	// The same name always gives the same handle
+	TRenderTechnique GetTechnique( const string& name );
+	TRenderVariable GetVariable( const string& name );
+	unsigned int GetNumPasses( TRenderTechnique technique );
+
+	// The texture file is not read, any file name succeeds
+	TRenderTexture LoadTexture( const string& fileName );
+	void ReleaseTexture( TRenderTexture texture );
+
+
+	/////////////////////////////
+	// Shader variables
+
+	void SetMatrix( TRenderVariable variable, const gen::CMatrix4x4& matrix );
+	void SetFloats( TRenderVariable variable, const float* values, unsigned int numValues );
+	void SetFloat( TRenderVariable variable, float value );
+	void SetTexture( TRenderVariable variable, TRenderTexture texture );
+
+
+	/////////////////////////////
+	// Drawing
+
+	void SetVertexBuffer( unsigned int slot, TRenderBuffer buffer, unsigned int vertexSize );
+	void SetLayout( TRenderLayout layout );
+	void SetIndexBuffer( TRenderBuffer buffer, bool largeIndices, unsigned int offset );
+	void ApplyPass( TRenderTechnique technique, unsigned int pass );
+	void DrawIndexed( unsigned int numIndices, unsigned int startIndex, int baseVertex );
+	void DrawIndexedInstanced( unsigned int numIndices, unsigned int numInstances, unsigned int startIndex, int baseVertex,
+	                           unsigned int startInstance );
+	void Clear( const float colour[4] );
+	void Present();
+
+
+/////////////////////////////
+// Private member functions
+private:
+
+	// Record a command with the given arguments and floats
+	void Record( ERenderCommand type, unsigned int arg0 = 0, unsigned int arg1 = 0, unsigned int arg2 = 0,
+	             const float* values = NULL, unsigned int numValues = 0 );
+
+	// Add a string used by a command, returns its index to store in the command
+	unsigned int AddString( const string& s );
+
+	// Get the name of a technique, variable or texture by handle from the given list, "invalid" for handle 0 or an unknown handle
+	static const char* GetName( const vector<string>& names, unsigned int handle );
+};
+
+
+#endif // End of header guard - see top of file
@@ -0,0 +1,30 @@
+//--------------------------------------------------------------------------------------
+//	RenderDevice.cpp
+//
+//	The render device interface is everything the rendering code needs from a graphics
+//	API: buffers, vertex layouts, shader techniques and variables, textures and drawing.
+//	The DirectX 10 device is one implementation, the recording device is another that
+//	needs no GPU at all
+//--------------------------------------------------------------------------------------
+
+#include "RenderDevice.h" // Declaration of the interface
+
+// The render device used by all rendering code
+IRenderDevice* g_pRenderDevice = NULL;
+
+
+// Size in bytes of one element of the given format
+unsigned int GetVertexFormatSize( EVertexFormat format )
+{
+	static const unsigned int FormatSizes[kNumVertexFormats] =
+	{
+		8,  // kFormatFloat2
+		12, // kFormatFloat3
+		16, // kFormatFloat4
+		4,  // kFormatHalf2
+		8,  // kFormatHalf4
+		4,  // kFormatByte4SNorm
+		4,  // kFormatByte4UNorm
+	};
+	return FormatSizes[format];
+}
@@ -0,0 +1,167 @@
+//--------------------------------------------------------------------------------------
+//	RenderDevice.h
+//
+//	The render device interface is everything the rendering code needs from a graphics
+//	API: buffers, vertex layouts, shader techniques and variables, textures and drawing.
+//	The DirectX 10 device is one implementation, the recording device is another that
+//	needs no GPU at all
+//--------------------------------------------------------------------------------------
+
+#ifndef RENDER_DEVICE_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define RENDER_DEVICE_H_INCLUDED
+
+#include <string>
+using namespace std;
+
+#include "CMatrix4x4.h" // Maths classes from the import library
+
+
+//-----------------------------------------------------------------------------
+// Handles
+//-----------------------------------------------------------------------------
+
+// Objects created by a render device are referred to by handles, numbers chosen by the device. 0 is never a valid handle, so it is
+// used for "none" (e.g. a material with no normal map). Code using the device never sees the graphics API's own types
+typedef unsigned int TRenderBuffer;    // Vertex or index buffer
+typedef unsigned int TRenderLayout;    // Description of the vertex data read by a technique's vertex shader
+typedef unsigned int TRenderTechnique; // Technique from the effect file, a set of shaders and states used to render
+typedef unsigned int TRenderVariable;  // Global variable in the effect file, e.g. a matrix or texture used by the shaders
+typedef unsigned int TRenderTexture;   // Texture loaded from a file
+
+
+//-----------------------------------------------------------------------------
+// Vertex layouts
+//-----------------------------------------------------------------------------
+
+// Formats of the data in a vertex element. The GPU converts them all to floats as the vertices are read
+enum EVertexFormat
+{
+	kFormatFloat2,
+	kFormatFloat3,
+	kFormatFloat4,
+	kFormatHalf2,      // 16-bit floats
+	kFormatHalf4,
+	kFormatByte4SNorm, // Signed bytes, -127 to 127 read as -1 to 1 (e.g. normals)
+	kFormatByte4UNorm, // Unsigned bytes, 0 to 255 read as 0 to 1 (e.g. colours)
+	kNumVertexFormats
+};
+
+// Size in bytes of one element of the given format
+unsigned int GetVertexFormatSize( EVertexFormat format );
+
+// Description of a single element of a vertex (position, normal, UVs etc.)
+struct SVertexElement
+{
+	const char*   semantic;      // Semantic in HLSL (what is this data for)
+	unsigned int  semanticIndex; // Index to add to semantic, when using multiple of the same type, e.g. TEXCOORD0, TEXCOORD1
+	EVertexFormat format;
+	unsigned int  offset;        // Offset of element from start of vertex data in bytes
+	unsigned int  slot;          // Vertex buffer the element is read from, when using several at once (e.g. instancing)
+	bool          perInstance;   // Element is read once per instance rather than once per vertex (only used for instancing)
+};
+
+
+//-----------------------------------------------------------------------------
+// Render device interface
+//-----------------------------------------------------------------------------
+
+// The device only draws indexed triangle lists, the only kind of geometry used here. Buffers, layouts and textures belong to the
+// device and should be released through it when no longer needed, any still held are released when the device is destroyed
+class IRenderDevice
+{
+public:
+	virtual ~IRenderDevice() {}
+
+	/////////////////////////////
+	// Buffers and layouts
+
+	// Create a vertex or index buffer holding a copy of the given data. Returns 0 on failure
+	virtual TRenderBuffer CreateVertexBuffer( const void* data, unsigned int size ) = 0;
+	virtual TRenderBuffer CreateIndexBuffer( const void* data, unsigned int size ) = 0;
+	virtual void ReleaseBuffer( TRenderBuffer buffer ) = 0;
+
+	// Create a vertex buffer of the given size whose contents are replaced often (e.g. instance data), initially undefined. Returns 0 on
+	// failure. Replace the contents with UpdateBuffer, the size must be no more than the buffer was created with. The old contents are
+	// lost even if the new data is smaller. Returns false on failure
+	virtual TRenderBuffer CreateDynamicVertexBuffer( unsigned int size ) = 0;
+	virtual bool UpdateBuffer( TRenderBuffer buffer, const void* data, unsigned int size ) = 0;
+
+	// Create a buffer holding the values of a constant buffer (cbuffer) in the effect file, the shader variables declared inside it, and
+	// use it for that cbuffer in every technique. The variables can then only be changed together by replacing the buffer's contents with
+	// UpdateBuffer - the data must match the cbuffer's layout in HLSL (variables packed in 16-byte registers, see ShaderConstants.h).
+	// The effect must be loaded first and the size must be a multiple of 16 bytes. Returns 0 on failure
+	virtual TRenderBuffer CreateConstantBuffer( const string& name, unsigned int size ) = 0;
+
+	// Create a vertex layout from a list of elements. The layout can be used with any technique with the same vertex shader input as
+	// the example technique given. Returns 0 on failure
+	virtual TRenderLayout CreateLayout( const SVertexElement* elements, unsigned int numElements, TRenderTechnique exampleTechnique ) = 0;
+	virtual void ReleaseLayout( TRenderLayout layout ) = 0;
+
+
+	/////////////////////////////
+	// Effects and textures
+
+	// Load and compile an effect file (.fx file containing shaders). Returns false on failure
+	virtual bool LoadEffect( const string& fileName ) = 0;
+
+	// Get a technique or variable from the effect file by name
+	virtual TRenderTechnique GetTechnique( const string& name ) = 0;
+	virtual TRenderVariable GetVariable( const string& name ) = 0;
+
+	// Number of passes in a technique, each pass draws the geometry again
+	virtual unsigned int GetNumPasses( TRenderTechnique technique ) = 0;
+
+	// Load a texture from a file. Returns 0 on failure
+	virtual TRenderTexture LoadTexture( const string& fileName ) = 0;
+	virtual void ReleaseTexture( TRenderTexture texture ) = 0;
+
+
+	/////////////////////////////
+	// Shader variables
+
+	// Set the value of an effect variable. Values are used by the next draw
+	virtual void SetMatrix( TRenderVariable variable, const gen::CMatrix4x4& matrix ) = 0;
+	virtual void SetFloats( TRenderVariable variable, const float* values, unsigned int numValues ) = 0; // Vectors and colours
+	virtual void SetFloat( TRenderVariable variable, float value ) = 0;
+	virtual void SetTexture( TRenderVariable variable, TRenderTexture texture ) = 0;
+
+
+	/////////////////////////////
+	// Drawing
+
+	// Select the geometry to draw: a vertex buffer for the given slot, the layout of its vertices, and an index buffer. Indices are
+	// 16-bit, or 32-bit if largeIndices is true, starting at the given byte offset in the index buffer
+	virtual void SetVertexBuffer( unsigned int slot, TRenderBuffer buffer, unsigned int vertexSize ) = 0;
+	virtual void SetLayout( TRenderLayout layout ) = 0;
+	virtual void SetIndexBuffer( TRenderBuffer buffer, bool largeIndices, unsigned int offset ) = 0;
+
+	// Select the shaders and states of a pass of a technique. The pass stays selected for any number of draws, changing shader variables
+	// in between does not need the pass to be applied again
+	virtual void ApplyPass( TRenderTechnique technique, unsigned int pass ) = 0;
+
+	// Draw triangles from a range of the selected index buffer. The base vertex is added to each index
+	virtual void DrawIndexed( unsigned int numIndices, unsigned int startIndex, int baseVertex ) = 0;
+
+	// Draw the same range of triangles several times in one call. Per-instance vertex elements (see SVertexElement) are read once for each
+	// instance drawn, starting from the given instance in their vertex buffer
+	virtual void DrawIndexedInstanced( unsigned int numIndices, unsigned int numInstances, unsigned int startIndex, int baseVertex,
+	                                   unsigned int startInstance ) = 0;
+
+	// Clear the back buffer to a colour (RGBA) and the depth buffer to the far distance
+	virtual void Clear( const float colour[4] ) = 0;
+
+	// Display the back buffer at the end of the frame
+	virtual void Present() = 0;
+};
+
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// The render device used by all rendering code, created along with the DirectX device (see Device.cpp), or a recording device where
+// there is no GPU
+extern IRenderDevice* g_pRenderDevice;
+
+
+#endif // End of header guard - see top of file
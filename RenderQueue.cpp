@@ -0,0 +1,179 @@
+//--------------------------------------------------------------------------------------
+//	RenderQueue.cpp
+//
+//	The render queue collects everything to be drawn in a frame, then sorts it so that
+//	models sharing a technique, textures or geometry are drawn together and each state
+//	is only selected once
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+using namespace std;
+
+#include "RenderQueue.h" // Declaration of this class
+
+// Number of bits of each state in the sort key
+const unsigned int LayerBits     = 4;
+const unsigned int TechniqueBits = 12;
+const unsigned int TextureBits   = 16;
+const unsigned int GeometryBits  = 16;
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - items are rendered by sending their world matrices and colours to the given constant buffers and their textures to the
+// given shader variables
+CRenderQueue::CRenderQueue( CConstantBuffer* objectConstants, CConstantBuffer* materialConstants, TRenderVariable diffuseMapVar,
+                            TRenderVariable normalMapVar )
+{
+	m_ObjectConstants = objectConstants;
+	m_MaterialConstants = materialConstants;
+	m_DiffuseMapVar = diffuseMapVar;
+	m_NormalMapVar = normalMapVar;
+
+	SRenderQueueStats noStats = {};
+	m_Stats = noStats;
+}
+
+
+/////////////////////////////
+// Queue usage
+
+// Set the layer of a technique (0-15), all items with that technique are drawn after items in lower layers
+void CRenderQueue::SetLayer( TRenderTechnique technique, unsigned int layer )
+{
+	if (technique >= m_TechniqueLayers.size())
+	{
+		m_TechniqueLayers.resize( technique + 1, 0 );
+	}
+	m_TechniqueLayers[technique] = min( layer, (1u << LayerBits) - 1 );
+}
+
+// Remove all items, e.g. at the start of a frame. The lists keep their memory, so filling the queue each frame doesn't allocate
+void CRenderQueue::Clear()
+{
+	m_Items.clear();
+	m_Order.clear();
+}
+
+// Add a model to draw with the given technique, textures (0 for none) and colour. Models with no geometry are ignored
+void CRenderQueue::Add( CModel* model, TRenderTechnique technique, TRenderTexture diffuseMap, TRenderTexture normalMap,
+                        const gen::CVector3& colour )
+{
+	if (!model->HasGeometry())
+	{
+		return;
+	}
+	SItem item = { model, technique, diffuseMap, normalMap, colour };
+	SSortEntry entry = { GetSortKey( item ), static_cast<unsigned int>(m_Items.size()) };
+	m_Items.push_back( item );
+	m_Order.push_back( entry );
+}
+
+
+// Sort the items and render them with the global render device. Each technique group applies its passes once, and the models in the
+// group are drawn in each pass. Textures and geometry are device state that lasts between draws, so they are only set when different
+// from the last item drawn, even across technique groups. As with rendering models separately, a texture of 0 leaves the previous
+// texture set - the technique doesn't use it
+void CRenderQueue::Render()
+{
+	sort( m_Order.begin(), m_Order.end() );
+
+	SRenderQueueStats stats = {};
+	stats.items = static_cast<unsigned int>(m_Order.size());
+
+	TRenderTexture currentDiffuseMap = 0;
+	TRenderTexture currentNormalMap = 0;
+	CModel*        currentGeometry = NULL; // Model whose geometry is selected
+
+	unsigned int groupStart = 0;
+	while (groupStart < m_Order.size())
+	{
+		// Find the items using the same technique as the first in this group, they are next to each other after sorting
+		TRenderTechnique technique = m_Items[m_Order[groupStart].item].technique;
+		unsigned int groupEnd = groupStart + 1;
+		while (groupEnd < m_Order.size() && m_Items[m_Order[groupEnd].item].technique == technique)
+		{
+			++groupEnd;
+		}
+
+		// Draw the group once for each pass of the technique (only one for the techniques used here)
+		unsigned int numPasses = g_pRenderDevice->GetNumPasses( technique );
+		for (unsigned int p = 0; p < numPasses; ++p)
+		{
+			g_pRenderDevice->ApplyPass( technique, p );
+			++stats.passesApplied;
+
+			for (unsigned int entry = groupStart; entry < groupEnd; ++entry)
+			{
+				const SItem& item = m_Items[m_Order[entry].item];
+				stats.passesAvoided += (entry > groupStart) ? 1 : 0;
+
+				if (item.diffuseMap)
+				{
+					if (item.diffuseMap != currentDiffuseMap)
+					{
+						g_pRenderDevice->SetTexture( m_DiffuseMapVar, item.diffuseMap );
+						currentDiffuseMap = item.diffuseMap;
+						++stats.texturesSet;
+					}
+					else
+					{
+						++stats.texturesAvoided;
+					}
+				}
+				if (item.normalMap)
+				{
+					if (item.normalMap != currentNormalMap)
+					{
+						g_pRenderDevice->SetTexture( m_NormalMapVar, item.normalMap );
+						currentNormalMap = item.normalMap;
+						++stats.texturesSet;
+					}
+					else
+					{
+						++stats.texturesAvoided;
+					}
+				}
+
+				// Models sharing a vertex buffer share all their geometry
+				if (currentGeometry == NULL || item.model->GetVertexBuffer() != currentGeometry->GetVertexBuffer())
+				{
+					item.model->SelectGeometry();
+					currentGeometry = item.model;
+					++stats.geometrySelected;
+				}
+				else
+				{
+					++stats.geometryAvoided;
+				}
+
+				// Items are sorted by material, so the colour is often the same as the previous item's and the constants aren't sent again
+				SPerMaterialConstants material;
+				material.modelColour = item.colour;
+				m_MaterialConstants->SetAndUpload( &material );
+				item.model->Draw( m_ObjectConstants );
+			}
+		}
+
+		groupStart = groupEnd;
+	}
+
+	m_Stats = stats;
+}
+
+
+/////////////////////////////
+// Private member functions
+
+// Calculate the sort key of an item. Each state is masked to its bits, see the class comment
+unsigned long long CRenderQueue::GetSortKey( const SItem& item )
+{
+	unsigned long long layer = item.technique < m_TechniqueLayers.size() ? m_TechniqueLayers[item.technique] : 0;
+	unsigned long long key = layer;
+	key = (key << TechniqueBits) | (item.technique & ((1u << TechniqueBits) - 1));
+	key = (key << TextureBits)   | (item.diffuseMap & ((1u << TextureBits) - 1));
+	key = (key << TextureBits)   | (item.normalMap & ((1u << TextureBits) - 1));
+	key = (key << GeometryBits)  | (item.model->GetVertexBuffer() & ((1u << GeometryBits) - 1));
+	return key;
+}
@@ -0,0 +1,141 @@
+//--------------------------------------------------------------------------------------
+//	RenderQueue.h
+//
+//	The render queue collects everything to be drawn in a frame, then sorts it so that
+//	models sharing a technique, textures or geometry are drawn together and each state
+//	is only selected once
+//--------------------------------------------------------------------------------------
+
+#ifndef RENDER_QUEUE_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define RENDER_QUEUE_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "RenderDevice.h"    // Handles of techniques, textures and variables
+#include "ShaderConstants.h" // Material and object constants set for each item
+#include "Model.h"
+
+
+// Count of state changes made while rendering the queue, and the number avoided compared to rendering each item separately (as
+// CModel::Render does), which selects its technique, textures and geometry every time
+struct SRenderQueueStats
+{
+	unsigned int items;
+	unsigned int passesApplied;
+	unsigned int passesAvoided;
+	unsigned int texturesSet;
+	unsigned int texturesAvoided;
+	unsigned int geometrySelected;
+	unsigned int geometryAvoided;
+};
+
+
+// Each item added to the queue is given a 64-bit sort key made from its states, most significant first: layer (4 bits), technique
+// (12 bits), diffuse map (16 bits), normal map (16 bits) and geometry (16 bits, the model's vertex buffer). Sorting by key puts items
+// with the same technique together, within that those with the same textures, then the same geometry. Handles too large for their
+// bits only make the sort less effective, states are always compared in full when rendering. Layers are drawn in order, e.g. to draw
+// blended techniques after all the opaque ones
+class CRenderQueue
+{
+/////////////////////////////
+// Private types and member variables
+private:
+
+	// A model to draw and how to draw it
+	struct SItem
+	{
+		CModel*          model;
+		TRenderTechnique technique;
+		TRenderTexture   diffuseMap; // 0 if not used by the technique
+		TRenderTexture   normalMap;  // --"--
+		gen::CVector3    colour;
+	};
+	vector<SItem> m_Items; // In the order added
+
+	// Items are sorted indirectly - only the key and the item's position are moved. Equal keys keep the order the items were added
+	struct SSortEntry
+	{
+		unsigned long long key;
+		unsigned int       item;
+
+		bool operator<( const SSortEntry& other ) const
+		{
+			return key < other.key || (key == other.key && item < other.item);
+		}
+	};
+	vector<SSortEntry> m_Order;
+
+	// Layer of each technique (by handle), techniques not given a layer are in layer 0
+	vector<unsigned int> m_TechniqueLayers;
+
+	// Constant buffers and shader variables set for each item
+	CConstantBuffer* m_ObjectConstants;
+	CConstantBuffer* m_MaterialConstants;
+	TRenderVariable  m_DiffuseMapVar;
+	TRenderVariable  m_NormalMapVar;
+
+	SRenderQueueStats m_Stats; // From the last call to Render
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - items are rendered by sending their world matrices and colours to the given constant buffers (see SPerObjectConstants
+	// and SPerMaterialConstants) and their textures to the given shader variables
+	CRenderQueue( CConstantBuffer* objectConstants, CConstantBuffer* materialConstants, TRenderVariable diffuseMapVar,
+	              TRenderVariable normalMapVar );
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CRenderQueue( const CRenderQueue& );
+	CRenderQueue& operator=( const CRenderQueue& );
+
+public:
+
+	/////////////////////////////
+	// Queue usage
+
+	// Set the layer of a technique (0-15), all items with that technique are drawn after items in lower layers
+	void SetLayer( TRenderTechnique technique, unsigned int layer );
+
+	// Remove all items, e.g. at the start of a frame
+	void Clear();
+
+	// Add a model to draw with the given technique, textures (0 for none) and colour. Models with no geometry are ignored. The model
+	// must not be destroyed before the queue is rendered
+	void Add( CModel* model, TRenderTechnique technique, TRenderTexture diffuseMap, TRenderTexture normalMap, const gen::CVector3& colour );
+
+	// Sort the items and render them with the global render device. Each technique pass is applied once for all the items using it,
+	// each texture is set only when it differs from the previous item's and geometry is only selected when it changes. The material
+	// constants are only sent when the colour changes. Assumes any other shader constants (e.g. view/projection matrices) have already
+	// been set up
+	void Render();
+
+	// Number of items in the queue
+	unsigned int GetNumItems()
+	{
+		return static_cast<unsigned int>(m_Items.size());
+	}
+
+	// Get the state changes made and avoided by the last call to Render
+	const SRenderQueueStats& GetStats()
+	{
+		return m_Stats;
+	}
+
+
+/////////////////////////////
+// Private member functions
+private:
+
+	// Calculate the sort key of an item
+	unsigned long long GetSortKey( const SItem& item );
+};
+
+
+#endif // End of header guard - see top of file
@@ -1,54 +1,36 @@
 #include "Shader.h"
-#include "Device.h"
-#include <d3dx10.h>
-#include <atlbase.h>
 
 // Effects / techniques
-ID3D10Effect*          Effect = NULL;
-ID3D10EffectTechnique* PlainColourTechnique = NULL;
-ID3D10EffectTechnique* VertexTexTechnique = NULL;
-ID3D10EffectTechnique* VertexChangingTexTechnique = NULL;
-ID3D10EffectTechnique* VertexLitTexTechnique = NULL;
-ID3D10EffectTechnique* NormalMappingTechnique = NULL;
-ID3D10EffectTechnique* NormalMappingParaTechnique = NULL;
-ID3D10EffectTechnique* AdditiveBlendingTechnique = NULL;
-
-// Light Effect variables
-ID3D10EffectVectorVariable* g_pCameraPosVar = NULL;
-ID3D10EffectVectorVariable* g_pLightPosVar = NULL;
-ID3D10EffectVectorVariable* g_pLightColourVar = NULL;
-ID3D10EffectVectorVariable* g_pLight2PosVar = NULL;
-ID3D10EffectVectorVariable* g_pLight2ColourVar = NULL;
-ID3D10EffectVectorVariable* g_pAmbientColourVar = NULL;
-ID3D10EffectScalarVariable* g_pSpecularPowerVar = NULL;
-
-// Matrices
-ID3D10EffectMatrixVariable* WorldMatrixVar = NULL;
-ID3D10EffectMatrixVariable* ViewMatrixVar = NULL;
-ID3D10EffectMatrixVariable* ProjMatrixVar = NULL;
-ID3D10EffectMatrixVariable* ViewProjMatrixVar = NULL;
-
-// Variables
-ID3D10EffectScalarVariable* colourMultiVar = NULL;
-ID3D10EffectScalarVariable* ParallaxDepthVar = NULL; // To set the depth of the parallax mapping effect
-
-// Textures - no texture class yet so using DirectX variables
-ID3D10ShaderResourceView* CubeDiffuseMap = NULL;
-ID3D10ShaderResourceView* FloorDiffuseMap = NULL;
-ID3D10ShaderResourceView* SphereDiffuseMap = NULL;
-ID3D10ShaderResourceView* TeapotDiffuseMap = NULL;
-ID3D10ShaderResourceView* TrollDiffuseMap = NULL;
-ID3D10ShaderResourceView* Cube2DiffuseMap = NULL;
-ID3D10ShaderResourceView* Cube2NormalMap = NULL;
-ID3D10ShaderResourceView* Teapot2DiffuseMap = NULL;
-ID3D10ShaderResourceView* Teapot2NormalMap = NULL;
-ID3D10ShaderResourceView* CarDiffuseMap = NULL;
-
-// Miscellaneous
-ID3D10EffectVectorVariable* ModelColourVar = NULL;
-
-ID3D10EffectShaderResourceVariable* DiffuseMapVar = NULL;
-ID3D10EffectShaderResourceVariable* NormalMapVar = NULL;
+TRenderTechnique PlainColourTechnique = 0;
+TRenderTechnique VertexTexTechnique = 0;
+TRenderTechnique VertexChangingTexTechnique = 0;
+TRenderTechnique VertexLitTexTechnique = 0;
+TRenderTechnique NormalMappingTechnique = 0;
+TRenderTechnique NormalMappingParaTechnique = 0;
+TRenderTechnique AdditiveBlendingTechnique = 0;
+TRenderTechnique InstancedLitColourTechnique = 0;
+
+// Constant buffers
+CConstantBuffer PerFrameConstants;
+CConstantBuffer PerMaterialConstants;
+CConstantBuffer PerObjectConstants;
+
+// Textures - no texture class yet so using render device handles
+TRenderTexture CubeDiffuseMap = 0;
+TRenderTexture FloorDiffuseMap = 0;
+TRenderTexture SphereDiffuseMap = 0;
+TRenderTexture TeapotDiffuseMap = 0;
+TRenderTexture TrollDiffuseMap = 0;
+TRenderTexture Cube2DiffuseMap = 0;
+TRenderTexture Cube2NormalMap = 0;
+TRenderTexture Teapot2DiffuseMap = 0;
+TRenderTexture Teapot2NormalMap = 0;
+TRenderTexture CarDiffuseMap = 0;
+TRenderTexture InsurgentDiffuseMap = 0;
+
+// Texture variables
+TRenderVariable DiffuseMapVar = 0;
+TRenderVariable NormalMapVar = 0;
 
 //--------------------------------------------------------------------------------------
 // Load and compile Effect file (.fx file containing shaders)
@@ -59,74 +41,57 @@ ID3D10EffectShaderResourceVariable* NormalMapVar = NULL;
 //
 bool LoadEffectFile()
 {
-	ID3D10Blob* pErrors; // This strangely typed variable collects any errors when compiling the effect file
-	DWORD dwShaderFlags = D3D10_SHADER_ENABLE_STRICTNESS; // These "flags" are used to set the compiler options
-
-														  // Load and compile the effect file
-	HRESULT hr = D3DX10CreateEffectFromFile(L"GraphicsAssign1.fx", NULL, NULL, "fx_4_0", dwShaderFlags, 0, g_pd3dDevice, NULL, NULL, &Effect, &pErrors, NULL);
-	if (FAILED(hr))
+	// Load and compile the effect file, the render device reports any errors
+	if (!g_pRenderDevice->LoadEffect("GraphicsAssign1.fx"))
 	{
-		if (pErrors != 0)  MessageBox(NULL, CA2CT(reinterpret_cast<char*>(pErrors->GetBufferPointer())), L"Error", MB_OK); // Compiler error: display error message
-		else               MessageBox(NULL, L"Error loading FX file. Ensure your FX file is in the same folder as this executable.", L"Error", MB_OK);  // No error message - probably file not found
 		return false;
 	}
 
 	// Now we can select techniques from the compiled effect file
-	PlainColourTechnique = Effect->GetTechniqueByName("PlainColour");
-	VertexTexTechnique = Effect->GetTechniqueByName("VertexTex");
-	VertexChangingTexTechnique = Effect->GetTechniqueByName("VertexChangingTex");
-	VertexLitTexTechnique = Effect->GetTechniqueByName("VertexLitTex");
-	NormalMappingTechnique = Effect->GetTechniqueByName("NormalMapping");
-	NormalMappingParaTechnique = Effect->GetTechniqueByName("NormalMappingPara");
-	AdditiveBlendingTechnique = Effect->GetTechniqueByName("AdditiveBlendingTech");
-
-	// Create special variables to allow us to access global variables in the shaders from C++
-	WorldMatrixVar = Effect->GetVariableByName("WorldMatrix")->AsMatrix();
-	ViewMatrixVar = Effect->GetVariableByName("ViewMatrix")->AsMatrix();
-	ProjMatrixVar = Effect->GetVariableByName("ProjMatrix")->AsMatrix();
-
-	// We access the texture variable in the shader in the same way as we have before for matrices, light data etc.
-	// Only difference is that this variable is a "Shader Resource"
-	DiffuseMapVar = Effect->GetVariableByName("DiffuseMap")->AsShaderResource();
-
-	// Other shader variables
-	ModelColourVar = Effect->GetVariableByName("ModelColour")->AsVector();
-
-	// Other variables
-	colourMultiVar = Effect->GetVariableByName("colourMulti")->AsScalar();
+	PlainColourTechnique = g_pRenderDevice->GetTechnique("PlainColour");
+	VertexTexTechnique = g_pRenderDevice->GetTechnique("VertexTex");
+	VertexChangingTexTechnique = g_pRenderDevice->GetTechnique("VertexChangingTex");
+	VertexLitTexTechnique = g_pRenderDevice->GetTechnique("VertexLitTex");
+	NormalMappingTechnique = g_pRenderDevice->GetTechnique("NormalMapping");
+	NormalMappingParaTechnique = g_pRenderDevice->GetTechnique("NormalMappingPara");
+	AdditiveBlendingTechnique = g_pRenderDevice->GetTechnique("AdditiveBlendingTech");
+	InstancedLitColourTechnique = g_pRenderDevice->GetTechnique("InstancedLitColourTech");
+
+	// The matrices, lights and other values used by the shaders are grouped into constant buffers by how often they change. We create a
+	// buffer for each and fill a C++ structure with the same layout (see ShaderConstants.h), rather than setting each variable separately
+	if (!PerFrameConstants.Create( "PerFrame", sizeof(SPerFrameConstants) ) ||
+	    !PerMaterialConstants.Create( "PerMaterial", sizeof(SPerMaterialConstants) ) ||
+	    !PerObjectConstants.Create( "PerObject", sizeof(SPerObjectConstants) ))
+	{
+		return false;
+	}
 
-	// Light variables
-	g_pCameraPosVar = Effect->GetVariableByName("CameraPos")->AsVector();
-	g_pLightPosVar = Effect->GetVariableByName("Light1Pos")->AsVector();
-	g_pLightColourVar = Effect->GetVariableByName("Light1Colour")->AsVector();
-	g_pLight2PosVar = Effect->GetVariableByName("Light2Pos")->AsVector();
-	g_pLight2ColourVar = Effect->GetVariableByName("Light2Colour")->AsVector();
-	g_pAmbientColourVar = Effect->GetVariableByName("AmbientColour")->AsVector();
-	g_pSpecularPowerVar = Effect->GetVariableByName("SpecularPower")->AsScalar();
-	NormalMapVar = Effect->GetVariableByName("NormalMap")->AsShaderResource();
-	ParallaxDepthVar = Effect->GetVariableByName("ParallaxDepth")->AsScalar();
+	// Textures are not constants, get handles to the texture variables in the shaders so we can set them from C++
+	DiffuseMapVar = g_pRenderDevice->GetVariable("DiffuseMap");
+	NormalMapVar = g_pRenderDevice->GetVariable("NormalMap");
 
 	return true;
 }
 
-// Release the memory held by all objects created
+// Release the textures and constant buffers for the scene, the effect is released along with the render device
 void ReleaseShaders()
 {
-
-	if (FloorDiffuseMap)  FloorDiffuseMap->Release();
-	if (CubeDiffuseMap)   CubeDiffuseMap->Release();
-	if (Cube2DiffuseMap)   Cube2DiffuseMap->Release();
-	if (Cube2NormalMap)   Cube2NormalMap->Release();
-	if (Teapot2DiffuseMap)   Teapot2DiffuseMap->Release();
-	if (Teapot2NormalMap)   Teapot2NormalMap->Release();
-	if (CarDiffuseMap)   CarDiffuseMap->Release();
-	if (SphereDiffuseMap)  SphereDiffuseMap->Release();
-	if (TeapotDiffuseMap)  TeapotDiffuseMap->Release();
-	if (TrollDiffuseMap)  TrollDiffuseMap->Release();
-	if (Effect)           Effect->Release();
-	if (DepthStencilView) DepthStencilView->Release();
-	if (RenderTargetView) RenderTargetView->Release();
-	if (DepthStencil)     DepthStencil->Release();
-	if (SwapChain)        SwapChain->Release();
-
+	if (!g_pRenderDevice)
+	{
+		return;
+	}
+	PerFrameConstants.ReleaseResources();
+	PerMaterialConstants.ReleaseResources();
+	PerObjectConstants.ReleaseResources();
+	g_pRenderDevice->ReleaseTexture(FloorDiffuseMap);
+	g_pRenderDevice->ReleaseTexture(CubeDiffuseMap);
+	g_pRenderDevice->ReleaseTexture(Cube2DiffuseMap);
+	g_pRenderDevice->ReleaseTexture(Cube2NormalMap);
+	g_pRenderDevice->ReleaseTexture(Teapot2DiffuseMap);
+	g_pRenderDevice->ReleaseTexture(Teapot2NormalMap);
+	g_pRenderDevice->ReleaseTexture(CarDiffuseMap);
+	g_pRenderDevice->ReleaseTexture(InsurgentDiffuseMap);
+	g_pRenderDevice->ReleaseTexture(SphereDiffuseMap);
+	g_pRenderDevice->ReleaseTexture(TeapotDiffuseMap);
+	g_pRenderDevice->ReleaseTexture(TrollDiffuseMap);
 }
\ No newline at end of file
@@ -1,58 +1,45 @@
-#include <d3d10.h>
+#include "RenderDevice.h"
+#include "ShaderConstants.h"
 
 // Header guard - prevents this file being included more than once
 #pragma once
 
-// Effects / techniques
-extern ID3D10Effect*          Effect;
-extern ID3D10EffectTechnique* PlainColourTechnique;
-extern ID3D10EffectTechnique* VertexTexTechnique;
-extern ID3D10EffectTechnique* VertexChangingTexTechnique;
-extern ID3D10EffectTechnique* VertexLitTexTechnique;
-extern ID3D10EffectTechnique* NormalMappingTechnique;
-extern ID3D10EffectTechnique* NormalMappingParaTechnique;
-extern ID3D10EffectTechnique* AdditiveBlendingTechnique;
-// Light Effect variables
-extern ID3D10EffectVectorVariable* g_pCameraPosVar;
-extern ID3D10EffectVectorVariable* g_pLightPosVar;
-extern ID3D10EffectVectorVariable* g_pLightColourVar;
-extern ID3D10EffectVectorVariable* g_pLight2PosVar;
-extern ID3D10EffectVectorVariable* g_pLight2ColourVar;
-extern ID3D10EffectVectorVariable* g_pAmbientColourVar;
-extern ID3D10EffectScalarVariable* g_pSpecularPowerVar;
-
-// Matrices
-extern ID3D10EffectMatrixVariable* WorldMatrixVar;
-extern ID3D10EffectMatrixVariable* ViewMatrixVar;
-extern ID3D10EffectMatrixVariable* ProjMatrixVar;
-extern ID3D10EffectMatrixVariable* ViewProjMatrixVar;
-
-// Variables
-extern ID3D10EffectScalarVariable* colourMultiVar;
-extern ID3D10EffectScalarVariable* ParallaxDepthVar;
-
-// Textures - no texture class yet so using DirectX variables
-extern ID3D10ShaderResourceView* CubeDiffuseMap;
-extern ID3D10ShaderResourceView* FloorDiffuseMap;
-extern ID3D10ShaderResourceView* SphereDiffuseMap;
-extern ID3D10ShaderResourceView* TeapotDiffuseMap;
-extern ID3D10ShaderResourceView* TrollDiffuseMap;
-extern ID3D10ShaderResourceView* Cube2DiffuseMap;
-extern ID3D10ShaderResourceView* Cube2NormalMap;
-extern ID3D10ShaderResourceView* Teapot2DiffuseMap;
-extern ID3D10ShaderResourceView* Teapot2NormalMap;
-extern ID3D10ShaderResourceView* CarDiffuseMap;
-
-// Miscellaneous
-extern ID3D10EffectVectorVariable* ModelColourVar;
-
-extern ID3D10EffectShaderResourceVariable* DiffuseMapVar;
-extern ID3D10EffectShaderResourceVariable* NormalMapVar;
+// Effects / techniques - handles from the render device, which holds the effect
+extern TRenderTechnique PlainColourTechnique;
+extern TRenderTechnique VertexTexTechnique;
+extern TRenderTechnique VertexChangingTexTechnique;
+extern TRenderTechnique VertexLitTexTechnique;
+extern TRenderTechnique NormalMappingTechnique;
+extern TRenderTechnique NormalMappingParaTechnique;
+extern TRenderTechnique AdditiveBlendingTechnique;
+extern TRenderTechnique InstancedLitColourTechnique; // Only for instanced models
+
+// Constant buffers - camera, lights and other values set once a frame, material colour and world matrices (see ShaderConstants.h)
+extern CConstantBuffer PerFrameConstants;
+extern CConstantBuffer PerMaterialConstants;
+extern CConstantBuffer PerObjectConstants;
+
+// Textures - no texture class yet so using render device handles
+extern TRenderTexture CubeDiffuseMap;
+extern TRenderTexture FloorDiffuseMap;
+extern TRenderTexture SphereDiffuseMap;
+extern TRenderTexture TeapotDiffuseMap;
+extern TRenderTexture TrollDiffuseMap;
+extern TRenderTexture Cube2DiffuseMap;
+extern TRenderTexture Cube2NormalMap;
+extern TRenderTexture Teapot2DiffuseMap;
+extern TRenderTexture Teapot2NormalMap;
+extern TRenderTexture CarDiffuseMap;
+extern TRenderTexture InsurgentDiffuseMap;
+
+// Texture variables
+extern TRenderVariable DiffuseMapVar;
+extern TRenderVariable NormalMapVar;
 
 // Initialise shaders - load an effect file (.fx file containing shaders)
 bool LoadEffectFile();
 
-// Release shader objects to free memory when quitting
+// Release shader objects (textures and constant buffers) to free memory when quitting
 void ReleaseShaders();
 
 
@@ -0,0 +1,96 @@
+//--------------------------------------------------------------------------------------
+//	ShaderConstants.cpp
+//
+//	The shader constants are the values sent to the shaders grouped by how often they
+//	change - every frame, for each material or for each object - matching the constant
+//	buffers (cbuffers) in the effect file
+//--------------------------------------------------------------------------------------
+
+#include <cstring>
+#include "ShaderConstants.h" // Declaration of this class
+
+
+///////////////////////////////
+// Constructors / Destructors
+
+// Constructor - creates an object with no buffer
+CConstantBuffer::CConstantBuffer()
+{
+	m_Buffer = 0;
+	m_Dirty = false;
+	ResetStats();
+}
+
+// Destructor
+CConstantBuffer::~CConstantBuffer()
+{
+	ReleaseResources();
+}
+
+// Release the buffer on the render device
+void CConstantBuffer::ReleaseResources()
+{
+	// Handles of 0 are ignored
+	if (g_pRenderDevice)
+	{
+		g_pRenderDevice->ReleaseBuffer( m_Buffer );
+	}
+	m_Buffer = 0;
+	m_Data.clear();
+	m_Dirty = false;
+}
+
+
+/////////////////////////////
+// Creation
+
+// Create a buffer for the effect's cbuffer with the given name. The contents are zero until first set, the first upload sends them
+// whether set or not as the new buffer's contents are undefined. Returns true if successful
+bool CConstantBuffer::Create( const string& name, unsigned int size )
+{
+	ReleaseResources();
+	m_Buffer = g_pRenderDevice->CreateConstantBuffer( name, size );
+	if (!m_Buffer)
+	{
+		return false;
+	}
+	m_Data.assign( size, 0 );
+	m_Dirty = true;
+	return true;
+}
+
+
+/////////////////////////////
+// Usage
+
+// Replace the contents with the given data. Comparing first costs little more than the copy, and saves an upload when nothing changed
+void CConstantBuffer::Set( const void* data )
+{
+	if (m_Data.empty() || (!m_Dirty && memcmp( &m_Data[0], data, m_Data.size() ) == 0))
+	{
+		return;
+	}
+	memcpy( &m_Data[0], data, m_Data.size() );
+	m_Dirty = true;
+}
+
+// Send the contents to the GPU if they have changed since last sent. Returns false on failure or if there is no buffer
+bool CConstantBuffer::Upload()
+{
+	if (!m_Buffer)
+	{
+		return false;
+	}
+	if (!m_Dirty)
+	{
+		++m_NumSkipped;
+		return true;
+	}
+	if (!g_pRenderDevice->UpdateBuffer( m_Buffer, &m_Data[0], static_cast<unsigned int>(m_Data.size()) ))
+	{
+		return false;
+	}
+	m_Dirty = false;
+	++m_NumUploads;
+	return true;
+}
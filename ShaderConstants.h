@@ -0,0 +1,159 @@
+//--------------------------------------------------------------------------------------
+//	ShaderConstants.h
+//
+//	The shader constants are the values sent to the shaders grouped by how often they
+//	change - every frame, for each material or for each object - matching the constant
+//	buffers (cbuffers) in the effect file
+//--------------------------------------------------------------------------------------
+
+#ifndef SHADER_CONSTANTS_H_INCLUDED // Header guard - prevents file being included more than once (would cause errors)
+#define SHADER_CONSTANTS_H_INCLUDED
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "RenderDevice.h" // Constant buffers, independent of the graphics API
+#include "CVector3.h"     // Maths classes from the import library
+#include "CMatrix4x4.h"
+
+
+//-----------------------------------------------------------------------------
+// Constant buffer layouts
+//-----------------------------------------------------------------------------
+
+// Each structure has the same memory layout as its cbuffer in GraphicsAssign1.fx, so it is sent to the GPU as it is. HLSL packs cbuffer
+// variables into 16-byte registers and never splits a variable across two, so each float3 is followed by a float (or padding) to fill
+// its register. Matrices are declared row_major in HLSL to match gen::CMatrix4x4. Padding is zeroed by the constructors so identical
+// values always compare equal (see CConstantBuffer::Set)
+
+// Constants that change once a frame: camera and lights (cbuffer PerFrame)
+struct SPerFrameConstants
+{
+	gen::CMatrix4x4 viewMatrix;
+	gen::CMatrix4x4 projMatrix;
+	gen::CVector3   cameraPos;
+	float           specularPower;
+	gen::CVector3   light1Pos;
+	float           parallaxDepth;
+	gen::CVector3   light1Colour;
+	float           colourMulti;   // Multiplier for changing texture colour, changes over time
+	gen::CVector3   light2Pos;
+	float           padding0;
+	gen::CVector3   light2Colour;
+	float           padding1;
+	gen::CVector3   ambientColour;
+	float           padding2;
+
+	SPerFrameConstants() : padding0( 0.0f ), padding1( 0.0f ), padding2( 0.0f ) {}
+};
+
+// Constants that change with the material: a single colour for an entire model, used for light models (cbuffer PerMaterial). Textures
+// are not constants, they are still set as shader variables
+struct SPerMaterialConstants
+{
+	gen::CVector3 modelColour;
+	float         padding0;
+
+	SPerMaterialConstants() : padding0( 0.0f ) {}
+};
+
+// Constants that change for each object drawn: the world matrix of the model, or of a part of a model (cbuffer PerObject)
+struct SPerObjectConstants
+{
+	gen::CMatrix4x4 worldMatrix;
+};
+
+
+//-----------------------------------------------------------------------------
+// Constant buffer class
+//-----------------------------------------------------------------------------
+
+// Holds a CPU copy of a constant buffer's contents alongside the buffer on the render device. The contents are replaced with a whole
+// structure in one go, and only sent to the GPU when they differ from what was sent last. So a value set every frame or for every
+// object costs a single comparison when it hasn't changed (e.g. objects sharing a material, a static camera), and one buffer update
+// when it has - rather than a shader variable write for each value
+class CConstantBuffer
+{
+/////////////////////////////
+// Private member variables
+private:
+
+	TRenderBuffer         m_Buffer;
+	vector<unsigned char> m_Data;  // Contents as last set
+	bool                  m_Dirty; // Contents have changed since last sent to the GPU
+
+	// Number of uploads made and skipped as the contents were unchanged, since the last call to ResetStats
+	unsigned int m_NumUploads;
+	unsigned int m_NumSkipped;
+
+
+/////////////////////////////
+// Public member functions
+public:
+
+	///////////////////////////////
+	// Constructors / Destructors
+
+	// Constructor - creates an object with no buffer
+	CConstantBuffer();
+
+	// Destructor
+	~CConstantBuffer();
+
+	// Release the buffer on the render device
+	void ReleaseResources();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CConstantBuffer( const CConstantBuffer& );
+	CConstantBuffer& operator=( const CConstantBuffer& );
+
+public:
+
+	/////////////////////////////
+	// Creation
+
+	// Create a buffer for the effect's cbuffer with the given name, using the global render device. The size is that of the structure that
+	// will be set, e.g. sizeof(SPerFrameConstants). The contents are zero until first set. Returns true if successful
+	bool Create( const string& name, unsigned int size );
+
+
+	/////////////////////////////
+	// Usage
+
+	// Replace the contents with the given data, the size given to Create. Only marks the buffer for upload if the data has changed
+	void Set( const void* data );
+
+	// Send the contents to the GPU if they have changed since last sent, to be used by the next draw. Returns false on failure
+	bool Upload();
+
+	// Set then upload, for contents that change just before a draw
+	bool SetAndUpload( const void* data )
+	{
+		Set( data );
+		return Upload();
+	}
+
+
+	/////////////////////////////
+	// Statistics
+
+	// Number of uploads made, and skipped as the contents were unchanged, since the last call to ResetStats
+	unsigned int GetNumUploads()
+	{
+		return m_NumUploads;
+	}
+	unsigned int GetNumSkipped()
+	{
+		return m_NumSkipped;
+	}
+	void ResetStats()
+	{
+		m_NumUploads = 0;
+		m_NumSkipped = 0;
+	}
+};
+
+
+#endif // End of header guard - see top of file
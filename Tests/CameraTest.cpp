@@ -0,0 +1,245 @@
+//--------------------------------------------------------------------------------------
+//	CameraTest.cpp
+//
+//	Checks the camera and model matrices built with the gen maths classes against reference
+//	matrices made the way D3DX made them: separate rotation, scaling and translation matrices
+//	multiplied together, a general inverse and D3DXMatrixPerspectiveFovLH. The references
+//	are calculated in double precision. Returns non-zero if any check fails
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+using namespace std;
+
+#include "Defines.h"
+#include "Camera.h"
+using namespace gen;
+
+// Viewport dimensions, used by the camera (defined by the window setup code in the application)
+int g_ViewportWidth = 1280, g_ViewportHeight = 960;
+
+// Number of random transforms checked
+const unsigned int NumTests = 10000;
+
+// Largest difference allowed between any element of a matrix and its reference (see MaxDifference).
+// Float rounding of the closed-form matrices gives about 2.4e-7 (3.9e-7 for the view-projection).
+// Fast low precision maths approximates the sines and cosines of the rotations, giving up to about
+// 7.5e-5 (1.1e-4 for the view-projection) - see BaseMath.h
+#if defined(GEN_FAST_MATH_LOW)
+const double Tolerance = 2.5e-4;
+#else
+const double Tolerance = 1.0e-6;
+#endif
+
+
+// A double precision matrix for the references, rows and columns as for CMatrix4x4
+struct SRefMatrix
+{
+	double e[4][4];
+};
+
+static SRefMatrix RefIdentity()
+{
+	SRefMatrix m = {};
+	for (int i = 0; i < 4; ++i)
+	{
+		m.e[i][i] = 1.0;
+	}
+	return m;
+}
+
+static SRefMatrix RefMultiply( const SRefMatrix& a, const SRefMatrix& b )
+{
+	SRefMatrix m = {};
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int col = 0; col < 4; ++col)
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				m.e[row][col] += a.e[row][i] * b.e[i][col];
+			}
+		}
+	}
+	return m;
+}
+
+// Same matrices as D3DXMatrixRotationX/Y/Z, D3DXMatrixScaling and D3DXMatrixTranslation
+static SRefMatrix RefRotationX( double angle )
+{
+	SRefMatrix m = RefIdentity();
+	m.e[1][1] = cos( angle );  m.e[1][2] = sin( angle );
+	m.e[2][1] = -sin( angle ); m.e[2][2] = cos( angle );
+	return m;
+}
+static SRefMatrix RefRotationY( double angle )
+{
+	SRefMatrix m = RefIdentity();
+	m.e[0][0] = cos( angle ); m.e[0][2] = -sin( angle );
+	m.e[2][0] = sin( angle ); m.e[2][2] = cos( angle );
+	return m;
+}
+static SRefMatrix RefRotationZ( double angle )
+{
+	SRefMatrix m = RefIdentity();
+	m.e[0][0] = cos( angle );  m.e[0][1] = sin( angle );
+	m.e[1][0] = -sin( angle ); m.e[1][1] = cos( angle );
+	return m;
+}
+static SRefMatrix RefScaling( const CVector3& scale )
+{
+	SRefMatrix m = RefIdentity();
+	m.e[0][0] = scale.x; m.e[1][1] = scale.y; m.e[2][2] = scale.z;
+	return m;
+}
+static SRefMatrix RefTranslation( const CVector3& position )
+{
+	SRefMatrix m = RefIdentity();
+	m.e[3][0] = position.x; m.e[3][1] = position.y; m.e[3][2] = position.z;
+	return m;
+}
+
+// World matrix as the model and camera classes used to make it: scale * Z * X * Y * translation
+static SRefMatrix RefWorld( const CVector3& position, const CVector3& rotation, const CVector3& scale )
+{
+	SRefMatrix m = RefMultiply( RefScaling( scale ), RefRotationZ( rotation.z ) );
+	m = RefMultiply( m, RefRotationX( rotation.x ) );
+	m = RefMultiply( m, RefRotationY( rotation.y ) );
+	return RefMultiply( m, RefTranslation( position ) );
+}
+
+// General inverse by Gauss-Jordan elimination with partial pivoting, as D3DXMatrixInverse works
+// for any matrix
+static SRefMatrix RefInverse( const SRefMatrix& matrix )
+{
+	SRefMatrix m = matrix;
+	SRefMatrix inverse = RefIdentity();
+	for (int col = 0; col < 4; ++col)
+	{
+		int pivot = col;
+		for (int row = col + 1; row < 4; ++row)
+		{
+			if (fabs( m.e[row][col] ) > fabs( m.e[pivot][col] ))
+			{
+				pivot = row;
+			}
+		}
+		for (int i = 0; i < 4; ++i)
+		{
+			swap( m.e[col][i], m.e[pivot][i] );
+			swap( inverse.e[col][i], inverse.e[pivot][i] );
+		}
+		double scale = 1.0 / m.e[col][col];
+		for (int i = 0; i < 4; ++i)
+		{
+			m.e[col][i] *= scale;
+			inverse.e[col][i] *= scale;
+		}
+		for (int row = 0; row < 4; ++row)
+		{
+			if (row != col)
+			{
+				double factor = m.e[row][col];
+				for (int i = 0; i < 4; ++i)
+				{
+					m.e[row][i] -= factor * m.e[col][i];
+					inverse.e[row][i] -= factor * inverse.e[col][i];
+				}
+			}
+		}
+	}
+	return inverse;
+}
+
+// Same matrix as D3DXMatrixPerspectiveFovLH
+static SRefMatrix RefPerspectiveFovLH( double fov, double aspect, double nearClip, double farClip )
+{
+	SRefMatrix m = {};
+	double yScale = 1.0 / tan( fov * 0.5 );
+	m.e[0][0] = yScale / aspect;
+	m.e[1][1] = yScale;
+	m.e[2][2] = farClip / (farClip - nearClip);
+	m.e[2][3] = 1.0;
+	m.e[3][2] = -nearClip * farClip / (farClip - nearClip);
+	return m;
+}
+
+
+// Return the largest difference between the elements of a matrix and its reference, relative to
+// the largest element in the same row of the reference where that is larger than 1. Translations
+// are sums of products of the position, so their rounding errors scale with the whole row
+static double MaxDifference( const CMatrix4x4& m, const SRefMatrix& reference )
+{
+	const float* elements = &m.e00;
+	double maxDifference = 0.0;
+	for (int row = 0; row < 4; ++row)
+	{
+		double rowSize = 1.0;
+		for (int col = 0; col < 4; ++col)
+		{
+			rowSize = max( rowSize, fabs( reference.e[row][col] ) );
+		}
+		for (int col = 0; col < 4; ++col)
+		{
+			maxDifference = max( maxDifference, fabs( elements[row * 4 + col] - reference.e[row][col] ) / rowSize );
+		}
+	}
+	return maxDifference;
+}
+
+
+// Simple repeatable random number generator, returns values from -1 to 1
+static float Random()
+{
+	static unsigned int state = 12345;
+	state = state * 1664525u + 1013904223u;
+	return static_cast<float>(state >> 8) / static_cast<float>(1 << 23) - 1.0f;
+}
+
+
+int main()
+{
+	// Largest difference of each matrix over all the tests
+	double worldDifference = 0.0, viewDifference = 0.0, projDifference = 0.0, viewProjDifference = 0.0;
+	for (unsigned int test = 0; test < NumTests; ++test)
+	{
+		CVector3 position( Random() * 100.0f, Random() * 100.0f, Random() * 100.0f );
+		CVector3 rotation( Random() * 2.0f * kfPi, Random() * 2.0f * kfPi, Random() * 2.0f * kfPi );
+		CVector3 scale( 1.25f + Random() * 0.75f, 1.25f + Random() * 0.75f, 1.25f + Random() * 0.75f );
+
+		// Model world matrix (CModel::UpdateMatrix)
+		CMatrix4x4 world;
+		world.MakeAffineEuler( position, rotation, kZXY, scale );
+		worldDifference = max( worldDifference, MaxDifference( world, RefWorld( position, rotation, scale ) ) );
+
+		// Camera matrices, the camera's world matrix is unscaled
+		float fov = ::ToRadians( 30.0f + (Random() + 1.0f) * 30.0f );
+		float nearClip = 0.1f + (Random() + 1.0f);
+		float farClip = 1000.0f + (Random() + 1.0f) * 5000.0f;
+		CCamera camera( position, rotation, fov, nearClip, farClip );
+		SRefMatrix refView = RefInverse( RefWorld( position, rotation, CVector3::kOne ) );
+		SRefMatrix refProj = RefPerspectiveFovLH( fov, 1.33, nearClip, farClip );
+		viewDifference = max( viewDifference, MaxDifference( camera.GetViewMatrix(), refView ) );
+		projDifference = max( projDifference, MaxDifference( camera.GetProjectionMatrix(), refProj ) );
+		viewProjDifference = max( viewProjDifference, MaxDifference( camera.GetViewProjectionMatrix(), RefMultiply( refView, refProj ) ) );
+	}
+
+	const char* names[4] = { "Model world", "View", "Projection", "View-projection" };
+	double differences[4] = { worldDifference, viewDifference, projDifference, viewProjDifference };
+	unsigned int failures = 0;
+	for (unsigned int matrix = 0; matrix < 4; ++matrix)
+	{
+		bool passed = (differences[matrix] <= Tolerance);
+		printf( "%-16s max difference %.1e%s\n", names[matrix], differences[matrix], passed ? "" : " - FAILED" );
+		failures += passed ? 0 : 1;
+	}
+
+	if (failures > 0)
+	{
+		printf( "%u checks failed\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}
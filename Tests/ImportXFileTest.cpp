@@ -0,0 +1,72 @@
+//--------------------------------------------------------------------------------------
+//	ImportXFileTest.cpp
+//
+//	Checks the X-file importer rejects files with invalid skinning data rather than
+//	reading or writing outside its vertex data. Returns non-zero if any check fails
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <string>
+using namespace std;
+
+#include "CImportXFile.h"
+using namespace gen;
+
+// A triangle in a frame, skinned to that frame. The vertex indices and number of skinning weights are inserted
+const char* SkinnedFileStart =
+	"xof 0303txt 0032\n"
+	"Frame Bone {\n"
+	"  FrameTransformMatrix { 1.0,0.0,0.0,0.0,0.0,1.0,0.0,0.0,0.0,0.0,1.0,0.0,0.0,0.0,0.0,1.0;; }\n"
+	"  Mesh {\n"
+	"    3;\n    0.0;0.0;0.0;,\n    1.0;0.0;0.0;,\n    0.0;1.0;0.0;;\n"
+	"    1;\n    3;0;1;2;;\n"
+	"    MeshMaterialList {\n      1;\n      1;\n      0;\n"
+	"      Material {\n        1.0;1.0;1.0;1.0;;\n        0.0;\n        0.0;0.0;0.0;;\n        0.0;0.0;0.0;;\n      }\n    }\n"
+	"    XSkinMeshHeader { 1; 1; 1; }\n"
+	"    SkinWeights {\n      \"Bone\";\n";
+const char* SkinnedFileEnd =
+	"      1.0,0.0,0.0,0.0,0.0,1.0,0.0,0.0,0.0,0.0,1.0,0.0,0.0,0.0,0.0,1.0;;\n"
+	"    }\n"
+	"  }\n"
+	"}\n";
+
+
+// Print the result of a check, returns 1 if it failed
+static unsigned int Check( const char* name, bool passed )
+{
+	printf( "%-52s %s\n", name, passed ? "passed" : "FAILED" );
+	return passed ? 0 : 1;
+}
+
+// Import the skinned triangle with the given skinning weights text (count, vertex indices and weights)
+static EImportError ImportSkinned( CImportXFile* importer, const string& weights )
+{
+	string file = string( SkinnedFileStart ) + weights + SkinnedFileEnd;
+	return importer->ImportFile( reinterpret_cast<const TUInt8*>(file.data()), static_cast<TUInt32>(file.size()) );
+}
+
+
+int main()
+{
+	unsigned int failures = 0;
+
+	CImportXFile valid;
+	failures += Check( "Valid skinning weights imported",
+	                   ImportSkinned( &valid, "      3;\n      0,1,2;\n      0.5,0.5,0.5;\n" ) == kSuccess );
+
+	CImportXFile badIndex;
+	failures += Check( "Skinning weight of a missing vertex rejected",
+	                   ImportSkinned( &badIndex, "      1;\n      3;\n      1.0;\n" ) == kInvalidData );
+
+	CImportXFile badCount;
+	failures += Check( "More skinning weights than the file holds rejected",
+	                   ImportSkinned( &badCount, "      4000000000;\n      0;\n      1.0;\n" ) == kInvalidData );
+
+	if (failures > 0)
+	{
+		printf( "%u checks failed\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}
@@ -0,0 +1,262 @@
+//--------------------------------------------------------------------------------------
+//	InstanceBuilderTest.cpp
+//
+//	Checks the instance data made by the instance builder matches the vertex elements
+//	describing it, and that an instanced model draws all its instances in one call per
+//	part and only updates or grows its instance buffer when needed, using the recording
+//	render device. Run from the repository root so the model is found. Returns non-zero
+//	if any check fails
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+using namespace std;
+
+#include "Defines.h"
+#include "RecordingRenderDevice.h"
+#include "InstancedModel.h"
+#include "ShaderConstants.h"
+
+// Viewport dimensions (defined by the window setup code in the application)
+int g_ViewportWidth = 1280, g_ViewportHeight = 960;
+
+// Instances added for the instance data checks
+const unsigned int NumInstances = 100;
+
+
+// Print the result of a check, returns 1 if it failed
+static unsigned int Check( const char* name, bool passed )
+{
+	printf( "%-52s %s\n", name, passed ? "passed" : "FAILED" );
+	return passed ? 0 : 1;
+}
+
+// Return the last command of the given kind recorded by the device, or NULL if there are none
+static const SRenderCommand* FindLastCommand( CRecordingRenderDevice& device, ERenderCommand type )
+{
+	for (unsigned int command = device.GetNumCommands(); command > 0; --command)
+	{
+		if (device.GetCommand( command - 1 ).type == type)
+		{
+			return &device.GetCommand( command - 1 );
+		}
+	}
+	return NULL;
+}
+
+// Return the last update of the given buffer recorded by the device, or NULL if there are none
+static const SRenderCommand* FindLastUpdate( CRecordingRenderDevice& device, unsigned int buffer )
+{
+	for (unsigned int command = device.GetNumCommands(); command > 0; --command)
+	{
+		const SRenderCommand& update = device.GetCommand( command - 1 );
+		if (update.type == kCommandUpdateBuffer && update.args[0] == buffer)
+		{
+			return &update;
+		}
+	}
+	return NULL;
+}
+
+
+// Check the instance data read through the vertex elements gives back the matrix and colour of each instance, as the vertex shader
+// would read it. Returns the number of failures
+static unsigned int CheckInstanceData()
+{
+	unsigned int failures = 0;
+
+	CInstanceBuilder builder;
+	failures += Check( "Empty builder has no data", builder.GetData() == NULL && builder.GetDataSize() == 0 );
+
+	for (unsigned int instance = 0; instance < NumInstances; ++instance)
+	{
+		gen::CVector3 position( instance * 3.0f, 1.0f, -static_cast<float>(instance) );
+		gen::CVector3 colour( instance / 100.0f, 0.5f, 1.0f - instance / 100.0f );
+		if (instance % 2 == 0)
+		{
+			builder.Add( position, gen::CVector3( 0.1f * instance, 0.2f, 0.3f ), 1.0f + instance * 0.01f, colour );
+		}
+		else
+		{
+			gen::CMatrix4x4 worldMatrix;
+			worldMatrix.MakeAffineEuler( position, gen::CVector3( 0.0f, 0.05f * instance, 0.0f ), gen::kZXY, gen::CVector3::kOne );
+			builder.Add( worldMatrix, colour );
+		}
+	}
+	builder.SetColour( NumInstances / 2, gen::CVector3( 1.0f, 0.0f, 0.0f ) );
+
+	// Each instance follows the last with no gaps, as the instance buffer stride is the size of SInstance
+	SVertexElement elements[CInstanceBuilder::NUM_INSTANCE_ELTS];
+	unsigned int numElements = CInstanceBuilder::GetElements( 1, elements );
+	const unsigned char* data = static_cast<const unsigned char*>(builder.GetData());
+	bool elementsCorrect = (numElements == CInstanceBuilder::NUM_INSTANCE_ELTS);
+	for (unsigned int elt = 0; elt < numElements; ++elt)
+	{
+		elementsCorrect = elementsCorrect && elements[elt].slot == 1 && elements[elt].perInstance &&
+		                  elements[elt].format == (elt < 4 ? kFormatFloat4 : kFormatFloat3);
+	}
+	bool dataCorrect = (builder.GetDataSize() == NumInstances * sizeof(SInstance));
+	for (unsigned int instance = 0; instance < NumInstances && dataCorrect; ++instance)
+	{
+		const SInstance& expected = builder.GetInstance( instance );
+		const unsigned char* instanceData = data + instance * sizeof(SInstance);
+		for (unsigned int row = 0; row < 4; ++row)
+		{
+			dataCorrect = dataCorrect &&
+			              memcmp( instanceData + elements[row].offset, &expected.worldMatrix.e00 + row * 4, 4 * sizeof(float) ) == 0;
+		}
+		dataCorrect = dataCorrect && memcmp( instanceData + elements[4].offset, &expected.colour.x, 3 * sizeof(float) ) == 0;
+	}
+	bool colourSet = (builder.GetInstance( NumInstances / 2 ).colour == gen::CVector3( 1.0f, 0.0f, 0.0f ));
+	failures += Check( "Instance elements are per-instance in the given slot", elementsCorrect );
+	failures += Check( "Instance data read by the elements matches instances", dataCorrect && colourSet );
+
+	// Instances read as float4s must start on a 16-byte boundary in the buffer
+	failures += Check( "Instance size is a multiple of 16 bytes", sizeof(SInstance) % 16 == 0 );
+
+	builder.ClearChanged();
+	builder.SetWorldMatrix( 0, gen::CMatrix4x4::kIdentity );
+	bool changedBySet = builder.HasChanged();
+	builder.ClearChanged();
+	builder.Clear();
+	failures += Check( "Changes and clearing mark the data as changed",
+	                   changedBySet && builder.HasChanged() && builder.GetNumInstances() == 0 );
+	return failures;
+}
+
+
+// Render an instanced cube with the recording device and check the draws made and the instance buffer updates as instances are added
+// and changed. Returns the number of failures, or 1 if the model fails to load
+static unsigned int CheckInstancedDraws()
+{
+	unsigned int failures = 0;
+
+	CRecordingRenderDevice device;
+	g_pRenderDevice = &device;
+	TRenderTechnique technique = device.GetTechnique( "InstancedLitColour" );
+	CConstantBuffer objectConstants;
+	objectConstants.Create( "PerObject", sizeof(SPerObjectConstants) );
+
+	{
+		CInstancedModel model;
+		if (!model.Load( "Cube.x", technique ))
+		{
+			printf( "Failed to load Cube.x - run from the repository root\n" );
+			objectConstants.ReleaseResources();
+			g_pRenderDevice = NULL;
+			return 1;
+		}
+
+		// The layout has the model's vertex elements followed by the instance elements
+		stringstream trace;
+		device.WriteTrace( trace );
+		failures += Check( "Layout includes the instance elements",
+		                   device.GetCommandCount( kCommandCreateLayout ) == 1 &&
+		                   trace.str().find( "INSTANCEWORLD0:float4@0/slot1*" ) != string::npos &&
+		                   trace.str().find( "INSTANCECOLOUR0:float3@64/slot1*" ) != string::npos );
+
+		// Number of parts (subsets) in the model, each is drawn separately
+		CModel cube;
+		cube.Load( "Cube.x", 0 );
+		unsigned int numParts = cube.GetNumSubsets();
+
+		// Nothing is drawn without instances
+		CInstanceBuilder& instances = model.GetInstances();
+		device.ClearCommands();
+		model.Render( technique, &objectConstants );
+		failures += Check( "No instances draws nothing", device.GetNumCommands() == 0 );
+
+		// All the instances are drawn with one draw call for each part of the model, after the instance buffer is created to fit them
+		// and filled
+		for (unsigned int instance = 0; instance < NumInstances; ++instance)
+		{
+			instances.Add( gen::CVector3( instance * 3.0f, 0.0f, 0.0f ), gen::CVector3::kZero, 1.0f, gen::CVector3::kOne );
+		}
+		device.ClearCommands();
+		model.Render( technique, &objectConstants );
+		const SRenderCommand* create = FindLastCommand( device, kCommandCreateDynamicVertexBuffer );
+		const SRenderCommand* setInstances = FindLastCommand( device, kCommandSetVertexBuffer );
+		unsigned int instanceBuffer = create ? create->args[0] : 0;
+		const SRenderCommand* update = FindLastUpdate( device, instanceBuffer );
+		failures += Check( "Instance buffer created to fit all instances",
+		                   create && create->args[1] == NumInstances * sizeof(SInstance) );
+		failures += Check( "Instance buffer filled with all instances",
+		                   update && update->args[1] == instances.GetDataSize() && !instances.HasChanged() );
+		failures += Check( "Instance buffer selected in slot 1 with instance stride", setInstances && setInstances->args[0] == 1 &&
+		                   setInstances->args[1] == instanceBuffer && setInstances->args[2] == sizeof(SInstance) );
+
+		unsigned int numPasses = device.GetCommandCount( kCommandApplyPass );
+		bool drawsCorrect = (device.GetCommandCount( kCommandDrawIndexedInstanced ) == numParts * numPasses &&
+		                     device.GetCommandCount( kCommandDrawIndexed ) == 0);
+		for (unsigned int command = 0; command < device.GetNumCommands(); ++command)
+		{
+			const SRenderCommand& draw = device.GetCommand( command );
+			if (draw.type == kCommandDrawIndexedInstanced)
+			{
+				drawsCorrect = drawsCorrect && draw.args[1] == NumInstances && draw.args[4] == 0;
+			}
+		}
+		failures += Check( "One instanced draw of all instances per part", drawsCorrect );
+
+		// Unchanged instances aren't sent again
+		device.ClearCommands();
+		model.Render( technique, &objectConstants );
+		failures += Check( "Unchanged instances are not uploaded again", FindLastUpdate( device, instanceBuffer ) == NULL &&
+		                   device.GetCommandCount( kCommandDrawIndexedInstanced ) > 0 );
+
+		// Changing an instance updates the existing buffer
+		instances.SetColour( 0, gen::CVector3( 1.0f, 0.0f, 0.0f ) );
+		device.ClearCommands();
+		model.Render( technique, &objectConstants );
+		failures += Check( "Changed instance updates the buffer without a new one", FindLastUpdate( device, instanceBuffer ) != NULL &&
+		                   device.GetCommandCount( kCommandCreateDynamicVertexBuffer ) == 0 );
+
+		// One more instance than fits doubles the buffer, releasing the old one. Up to that size no new buffer is needed, nor when
+		// there are fewer instances again
+		instances.Add( gen::CMatrix4x4::kIdentity, gen::CVector3::kOne );
+		device.ClearCommands();
+		model.Render( technique, &objectConstants );
+		create = FindLastCommand( device, kCommandCreateDynamicVertexBuffer );
+		const SRenderCommand* release = FindLastCommand( device, kCommandReleaseBuffer );
+		failures += Check( "Buffer doubles when instances no longer fit", create && release &&
+		                   create->args[1] == 2 * NumInstances * sizeof(SInstance) && release->args[0] == instanceBuffer );
+
+		while (instances.GetNumInstances() < 2 * NumInstances)
+		{
+			instances.Add( gen::CMatrix4x4::kIdentity, gen::CVector3::kOne );
+		}
+		device.ClearCommands();
+		model.Render( technique, &objectConstants );
+		bool fullFits = (device.GetCommandCount( kCommandCreateDynamicVertexBuffer ) == 0);
+		instances.Clear();
+		instances.Add( gen::CMatrix4x4::kIdentity, gen::CVector3::kOne );
+		device.ClearCommands();
+		model.Render( technique, &objectConstants );
+		const SRenderCommand* draw = FindLastCommand( device, kCommandDrawIndexedInstanced );
+		failures += Check( "Buffer reused for as many or fewer instances", fullFits &&
+		                   device.GetCommandCount( kCommandCreateDynamicVertexBuffer ) == 0 && draw && draw->args[1] == 1 );
+	}
+
+	// Resources must be released while the device exists
+	objectConstants.ReleaseResources();
+	g_pRenderDevice = NULL;
+	return failures;
+}
+
+
+int main()
+{
+	unsigned int failures = 0;
+	failures += CheckInstanceData();
+	failures += CheckInstancedDraws();
+
+	if (failures > 0)
+	{
+		printf( "%u checks failed\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}
@@ -0,0 +1,115 @@
+//--------------------------------------------------------------------------------------
+//	JobSystemTest.cpp
+//
+//	Checks the job system runs every job and chunk exactly once, and that an exception
+//	thrown by a job is rethrown to the thread waiting for its group after all the other
+//	jobs have finished. Returns non-zero if any check fails
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <stdexcept>
+using namespace std;
+
+#include "JobSystem.h"
+
+// Threads used by the job system, more than one so jobs run on the worker threads too
+const unsigned int NumThreads = 4;
+
+// Size of the ranges run in parallel, and chunk size used
+const unsigned int NumItems = 10000;
+const unsigned int ChunkSize = 100;
+
+
+// Print the result of a check, returns 1 if it failed
+static unsigned int Check( const char* name, bool passed )
+{
+	printf( "%-40s %s\n", name, passed ? "passed" : "FAILED" );
+	return passed ? 0 : 1;
+}
+
+
+int main()
+{
+	unsigned int failures = 0;
+	CJobSystem jobs( NumThreads );
+
+	// Every item of a parallel range is visited once
+	vector<atomic<unsigned int>> visits( NumItems );
+	for (unsigned int item = 0; item < NumItems; ++item)
+	{
+		visits[item] = 0;
+	}
+	jobs.ParallelFor( NumItems, ChunkSize, [&visits]( unsigned int, unsigned int first, unsigned int end )
+	{
+		for (unsigned int item = first; item < end; ++item)
+		{
+			++visits[item];
+		}
+	} );
+	bool allOnce = true;
+	for (unsigned int item = 0; item < NumItems; ++item)
+	{
+		allOnce = allOnce && (visits[item] == 1);
+	}
+	failures += Check( "ParallelFor visits each item once", allOnce );
+
+	// An exception in one chunk (a queued one and the calling thread's first one) reaches the caller, after all the other chunks
+	// have finished
+	for (unsigned int throwChunk = 0; throwChunk < 2; ++throwChunk)
+	{
+		atomic<unsigned int> numFinished( 0 );
+		bool caught = false;
+		try
+		{
+			jobs.ParallelFor( NumItems, ChunkSize, [&numFinished, throwChunk]( unsigned int chunk, unsigned int, unsigned int )
+			{
+				if (chunk == throwChunk * 50)
+				{
+					throw runtime_error( "chunk failed" );
+				}
+				++numFinished;
+			} );
+		}
+		catch (const runtime_error&)
+		{
+			caught = true;
+		}
+		failures += Check( throwChunk == 0 ? "ParallelFor rethrows from first chunk" : "ParallelFor rethrows from queued chunk",
+		                   caught && numFinished == CJobSystem::GetNumChunks( NumItems, ChunkSize ) - 1 );
+	}
+
+	// Only the first exception of a group is rethrown, and the group can be used again afterwards
+	CJobGroup group;
+	atomic<unsigned int> numRun( 0 );
+	for (unsigned int job = 0; job < 100; ++job)
+	{
+		jobs.Run( [&numRun]() { ++numRun; throw runtime_error( "job failed" ); }, &group );
+	}
+	unsigned int numCaught = 0;
+	try
+	{
+		jobs.Wait( &group );
+	}
+	catch (const runtime_error&)
+	{
+		++numCaught;
+	}
+	jobs.Run( [&numRun]() { ++numRun; }, &group );
+	try
+	{
+		jobs.Wait( &group );
+	}
+	catch (...)
+	{
+		++numCaught;
+	}
+	failures += Check( "Wait rethrows the first exception once", numCaught == 1 && numRun == 101 && group.IsFinished() );
+
+	if (failures > 0)
+	{
+		printf( "%u checks failed\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}
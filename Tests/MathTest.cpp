@@ -0,0 +1,182 @@
+//--------------------------------------------------------------------------------------
+//	MathTest.cpp
+//
+//	Runs the maths benchmarks (MathBenchmark.h) with a few iterations and checks that the
+//	SIMD versions of each function match the scalar versions, and that the fast maths
+//	functions are as accurate as each precision claims, within the documented tolerances.
+//	Prints the benchmark reports and returns non-zero if any check fails
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "MathBenchmark.h"
+using namespace gen;
+
+// Iterations of each benchmark - enough to fill the inputs of each function, the times are not
+// checked
+const TUInt32 TestIterations = 100;
+
+// Each culling iteration tests all 100,000 bounds, so one is enough
+const TUInt32 CullIterations = 1;
+
+
+// Largest difference allowed between the SIMD and scalar results of a benchmarked function (see
+// SMathBenchmark::maxDifference). Functions not listed must give identical results, as stated in
+// MathSIMD.h
+struct STolerance
+{
+	const char* function;
+	TFloat32    maxDifference;
+};
+
+// Batch slerps use polynomial approximations, differing by less than 1e-6 (about 5e-5 with fast
+// low precision maths) - see MathBatch.h
+#if defined(GEN_FAST_MATH_LOW)
+const TFloat32 SlerpTolerance = 5.0e-5f;
+#else
+const TFloat32 SlerpTolerance = 1.0e-6f;
+#endif
+
+const STolerance Tolerances[] =
+{
+	{ "Inverse", 1.0e-4f }, // Different method to the scalar version, about 1e-5 (CMatrix4x4.h)
+	{ "BatchSlerp (quaternions)", SlerpTolerance },
+	{ "BatchSlerp (transforms)",  SlerpTolerance },
+};
+
+// Return the tolerance for the given benchmarked function
+static TFloat32 GetTolerance( const string& function )
+{
+	for (unsigned int tolerance = 0; tolerance < sizeof(Tolerances) / sizeof(Tolerances[0]); ++tolerance)
+	{
+		if (function == Tolerances[tolerance].function)
+		{
+			return Tolerances[tolerance].maxDifference;
+		}
+	}
+	return 0.0f;
+}
+
+
+// Largest errors allowed for each function at each precision (see SMathPrecision), from the
+// descriptions of the precisions in BaseMath.h. A zero tolerance is not checked
+struct SPrecisionTolerance
+{
+	const char* function;
+	TFloat64    maxULPError;
+	TFloat64    maxError;
+};
+
+const SPrecisionTolerance PrecisionTolerances[] =
+{
+	// Standard library, square root is exact and 1 / square root rounds twice
+	{ "Sqrt (exact)",    1.0, 0.0 },
+	{ "InvSqrt (exact)", 2.0, 0.0 },
+	{ "Sin (exact)",     1.0, 0.0 },
+	{ "Cos (exact)",     1.0, 0.0 },
+	{ "SinCos (exact)",  1.0, 0.0 },
+
+	// A few ulps
+	{ "Sqrt (high)",     4.0, 0.0 },
+	{ "InvSqrt (high)",  4.0, 0.0 },
+	{ "Sin (high)",      4.0, 0.0 },
+	{ "Cos (high)",      4.0, 0.0 },
+	{ "SinCos (high)",   4.0, 0.0 },
+
+	// Relative errors of about 5e-6 for the square roots (100 ulps is at most 1.2e-5) and absolute
+	// errors of about 4e-5 for the trigonometry
+	{ "Sqrt (low)",    100.0, 0.0 },
+	{ "InvSqrt (low)", 100.0, 0.0 },
+	{ "Sin (low)",       0.0, 5.0e-5 },
+	{ "Cos (low)",       0.0, 5.0e-5 },
+	{ "SinCos (low)",    0.0, 5.0e-5 },
+};
+
+
+// Check each benchmark result is within the tolerance for its function and has no mismatched
+// yes/no results (culling gives identical results, MathCull.h), print any that aren't. Returns the
+// number of failures
+static unsigned int CheckBenchmarks( const vector<SMathBenchmark>& results )
+{
+	unsigned int failures = 0;
+	for (unsigned int result = 0; result < results.size(); ++result)
+	{
+		TFloat32 tolerance = GetTolerance( results[result].function );
+		if (!(results[result].maxDifference <= tolerance))
+		{
+			printf( "FAILED: %s - SIMD and scalar differ by %g, tolerance %g\n", results[result].function.c_str(),
+			        results[result].maxDifference, tolerance );
+			++failures;
+		}
+		if (results[result].mismatches > 0)
+		{
+			printf( "FAILED: %s - SIMD and scalar differ in %u results\n", results[result].function.c_str(),
+			        results[result].mismatches );
+			++failures;
+		}
+	}
+	return failures;
+}
+
+// Check the errors of each function at each precision are within its tolerances, print any that
+// aren't or have no tolerance. Returns the number of failures
+static unsigned int CheckPrecision( const vector<SMathPrecision>& results )
+{
+	const unsigned int numTolerances = sizeof(PrecisionTolerances) / sizeof(PrecisionTolerances[0]);
+	unsigned int failures = 0;
+	for (unsigned int result = 0; result < results.size(); ++result)
+	{
+		unsigned int tolerance = 0;
+		while (tolerance < numTolerances && results[result].function != PrecisionTolerances[tolerance].function)
+		{
+			++tolerance;
+		}
+		if (tolerance == numTolerances)
+		{
+			printf( "FAILED: %s - no tolerance\n", results[result].function.c_str() );
+			++failures;
+		}
+		else if ((PrecisionTolerances[tolerance].maxULPError > 0.0 &&
+		          !(results[result].maxULPError <= PrecisionTolerances[tolerance].maxULPError)) ||
+		         (PrecisionTolerances[tolerance].maxError > 0.0 &&
+		          !(results[result].maxError <= PrecisionTolerances[tolerance].maxError)))
+		{
+			printf( "FAILED: %s - error %g ulps (%g), tolerance %g ulps (%g)\n", results[result].function.c_str(),
+			        results[result].maxULPError, results[result].maxError, PrecisionTolerances[tolerance].maxULPError,
+			        PrecisionTolerances[tolerance].maxError );
+			++failures;
+		}
+	}
+	return failures;
+}
+
+
+int main()
+{
+	unsigned int failures = 0;
+
+	vector<SMathBenchmark> results;
+	BenchmarkMatrix4x4( TestIterations, &results );
+	BenchmarkBatchTransform( TestIterations, &results );
+	BenchmarkPoseBlend( TestIterations, &results );
+	BenchmarkFrustumCull( CullIterations, &results );
+	printf( "%s", MathBenchmarkReport( results ).c_str() );
+	failures += CheckBenchmarks( results );
+
+	vector<SMathPrecision> precision;
+	MeasureMathPrecision( TestIterations, &precision );
+	printf( "%s", MathPrecisionReport( precision ).c_str() );
+	failures += CheckPrecision( precision );
+
+	if (failures > 0)
+	{
+		printf( "%u checks failed\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}
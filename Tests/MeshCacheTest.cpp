@@ -0,0 +1,104 @@
+//--------------------------------------------------------------------------------------
+//	MeshCacheTest.cpp
+//
+//	Checks that a mesh cache file with a face index outside its sub-mesh's vertices is
+//	treated as invalid and rebuilt from the X-file, rather than used. The X-file and its
+//	cache are written to the current directory. Returns non-zero if any check fails
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "CMeshCache.h"
+using namespace gen;
+
+// A single triangle, its faces are cached as the 16-bit indices 0, 1, 2
+const char* TriangleFileName = "MeshCacheTest.x";
+const char* TriangleCacheName = "MeshCacheTest.xbin";
+const char* TriangleFile =
+	"xof 0303txt 0032\n"
+	"Mesh {\n"
+	"  3;\n  0.0;0.0;0.0;,\n  1.0;0.0;0.0;,\n  0.0;1.0;0.0;;\n"
+	"  1;\n  3;0;1;2;;\n"
+	"  MeshMaterialList {\n    1;\n    1;\n    0;\n"
+	"    Material {\n      1.0;1.0;1.0;1.0;;\n      0.0;\n      0.0;0.0;0.0;;\n      0.0;0.0;0.0;;\n    }\n  }\n"
+	"}\n";
+
+
+// Print the result of a check, returns 1 if it failed
+static unsigned int Check( const char* name, bool passed )
+{
+	printf( "%-48s %s\n", name, passed ? "passed" : "FAILED" );
+	return passed ? 0 : 1;
+}
+
+// Read a whole file
+static vector<char> ReadFile( const char* fileName )
+{
+	ifstream file( fileName, ios::binary );
+	return vector<char>( istreambuf_iterator<char>( file ), istreambuf_iterator<char>() );
+}
+
+// Returns true if the loaded mesh is the triangle with valid faces
+static bool IsTriangle( const CMeshCache& mesh )
+{
+	if (!mesh.IsLoaded() || mesh.GetNumSubMeshes() != 1)
+	{
+		return false;
+	}
+	SSubMesh subMesh;
+	mesh.GetSubMesh( 0, &subMesh );
+	const TUInt16* indices = reinterpret_cast<const TUInt16*>(subMesh.faces);
+	return subMesh.numVertices == 3 && subMesh.numFaces == 1 && subMesh.indexSize == sizeof(TUInt16) &&
+	       indices[0] < 3 && indices[1] < 3 && indices[2] < 3;
+}
+
+
+int main()
+{
+	unsigned int failures = 0;
+
+	ofstream file( TriangleFileName );
+	file << TriangleFile;
+	file.close();
+	remove( TriangleCacheName );
+
+	CMeshCache mesh;
+	bool built = (mesh.Load( TriangleFileName ) == kSuccess && IsTriangle( mesh ));
+	mesh.Close();
+	failures += Check( "Cache built from the X-file", built );
+
+	// Point the last face index at a missing vertex - the face data is at the end of the cache
+	vector<char> cache = ReadFile( TriangleCacheName );
+	const char faces[6] = { 0, 0, 1, 0, 2, 0 };
+	vector<char>::iterator found = find_end( cache.begin(), cache.end(), faces, faces + 6 );
+	bool corrupted = (found != cache.end());
+	if (corrupted)
+	{
+		*(found + 4) = 3;
+		ofstream corruptFile( TriangleCacheName, ios::binary );
+		corruptFile.write( &cache[0], cache.size() );
+	}
+	failures += Check( "Cache face data found", corrupted );
+
+	bool rebuilt = (mesh.Load( TriangleFileName ) == kSuccess && IsTriangle( mesh ));
+	mesh.Close();
+	vector<char> rebuiltCache = ReadFile( TriangleCacheName );
+	failures += Check( "Cache with an invalid face index rebuilt", rebuilt && corrupted &&
+	                   rebuiltCache.size() == cache.size() &&
+	                   memcmp( &rebuiltCache[found - cache.begin()], faces, 6 ) == 0 );
+
+	if (failures > 0)
+	{
+		printf( "%u checks failed\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}
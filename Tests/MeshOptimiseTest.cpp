@@ -0,0 +1,129 @@
+//--------------------------------------------------------------------------------------
+//	MeshOptimiseTest.cpp
+//
+//	Imports models with and without the vertex cache optimisation stage and checks that
+//	each sub-mesh keeps exactly the same triangles (compared by vertex data, as vertices
+//	are renumbered) and that the ACMR for 16 and 32 entry FIFO caches is never worse.
+//	Run from the repository root so the models are found. Returns non-zero if any check
+//	fails
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "CImportXFile.h"
+#include "MeshOptimise.h"
+using namespace gen;
+
+// Models checked
+const char* FileNames[] = { "Teapot.x", "Troll.x", "Sphere.x", "Hills.x" };
+
+// FIFO cache sizes checked
+const TUInt32 CacheSizes[2] = { 16, 32 };
+
+
+// Return the index of a vertex of a face in a sub-mesh
+static TUInt32 GetIndex( const SSubMesh& subMesh, TUInt32 face, TUInt32 corner )
+{
+	const TUInt8* index = subMesh.faces + (face * 3 + corner) * subMesh.indexSize;
+	return subMesh.indexSize == 2 ? *reinterpret_cast<const TUInt16*>(index) : *reinterpret_cast<const TUInt32*>(index);
+}
+
+// Return the triangles of a sub-mesh as the data of their three vertices, sorted. Each triangle
+// is rotated to start with its smallest vertex, which keeps the winding
+static vector<string> GetTriangles( const SSubMesh& subMesh )
+{
+	vector<string> triangles( subMesh.numFaces );
+	for (TUInt32 face = 0; face < subMesh.numFaces; ++face)
+	{
+		string corners[3];
+		for (TUInt32 corner = 0; corner < 3; ++corner)
+		{
+			const TUInt8* vertex = subMesh.vertices + GetIndex( subMesh, face, corner ) * subMesh.vertexSize;
+			corners[corner].assign( reinterpret_cast<const char*>(vertex), subMesh.vertexSize );
+		}
+		TUInt32 first = (corners[1] < corners[0]) ? 1 : 0;
+		first = (corners[2] < corners[first]) ? 2 : first;
+		triangles[face] = corners[first] + corners[(first + 1) % 3] + corners[(first + 2) % 3];
+	}
+	sort( triangles.begin(), triangles.end() );
+	return triangles;
+}
+
+
+// Check one model, print any failures. Returns the number of failures
+static unsigned int CheckFile( const string& fileName )
+{
+	CImportXFile original, optimised;
+	if (original.ImportFile( fileName ) != kSuccess || optimised.ImportFile( fileName ) != kSuccess)
+	{
+		printf( "FAILED: %s - import failed, run from the repository root\n", fileName.c_str() );
+		return 1;
+	}
+	optimised.OptimiseMeshes();
+	if (!optimised.IsOptimised() || optimised.GetNumSubMeshes() != original.GetNumSubMeshes())
+	{
+		printf( "FAILED: %s - optimisation not applied\n", fileName.c_str() );
+		return 1;
+	}
+
+	unsigned int failures = 0;
+	TUInt32 numFaces = 0;
+	for (TUInt32 subMesh = 0; subMesh < original.GetNumSubMeshes(); ++subMesh)
+	{
+		SSubMesh before, after;
+		if (original.GetSubMesh( subMesh, &before ) != kSuccess || optimised.GetSubMesh( subMesh, &after ) != kSuccess)
+		{
+			printf( "FAILED: %s - sub-mesh %u not available\n", fileName.c_str(), subMesh );
+			return failures + 1;
+		}
+		numFaces += before.numFaces;
+
+		if (before.numFaces != after.numFaces || before.vertexSize != after.vertexSize ||
+		    GetTriangles( before ) != GetTriangles( after ))
+		{
+			printf( "FAILED: %s sub-mesh %u - triangles differ after optimisation\n", fileName.c_str(), subMesh );
+			++failures;
+		}
+		for (TUInt32 cache = 0; cache < 2; ++cache)
+		{
+			SVertexCacheStats beforeStats, afterStats;
+			MeasureVertexCache( before, CacheSizes[cache], &beforeStats );
+			MeasureVertexCache( after, CacheSizes[cache], &afterStats );
+			if (afterStats.numTransforms > beforeStats.numTransforms)
+			{
+				printf( "FAILED: %s sub-mesh %u - FIFO %u ACMR worse, %.3f to %.3f\n", fileName.c_str(), subMesh,
+				        CacheSizes[cache], beforeStats.acmr, afterStats.acmr );
+				++failures;
+			}
+		}
+
+		delete[] before.vertices;
+		delete[] before.faces;
+		delete[] after.vertices;
+		delete[] after.faces;
+	}
+	printf( "%-10s %u sub-meshes, %u faces checked\n", fileName.c_str(), original.GetNumSubMeshes(), numFaces );
+	return failures;
+}
+
+
+int main()
+{
+	unsigned int failures = 0;
+	for (unsigned int file = 0; file < sizeof(FileNames) / sizeof(FileNames[0]); ++file)
+	{
+		failures += CheckFile( FileNames[file] );
+	}
+
+	if (failures > 0)
+	{
+		printf( "%u checks failed\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}
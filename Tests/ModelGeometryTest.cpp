@@ -0,0 +1,95 @@
+//--------------------------------------------------------------------------------------
+//	ModelGeometryTest.cpp
+//
+//	Checks that geometry made from a model whose parts have different vertex formats
+//	keeps every part, with all the vertices in one layout holding every component. The
+//	model is written to the current directory. Returns non-zero if any check fails
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+using namespace std;
+
+#include "Defines.h"
+#include "RecordingRenderDevice.h"
+#include "ModelGeometry.h"
+#include "CMeshCache.h"
+
+// Viewport dimensions (defined by the window setup code in the application)
+int g_ViewportWidth = 1280, g_ViewportHeight = 960;
+
+// A model of two triangles with different materials, the first has normals and UVs, the second only positions
+const char* MixedFileName = "ModelGeometryTest.x";
+const char* MixedFile =
+	"xof 0303txt 0032\n"
+	"Mesh {\n"
+	"  3;\n  0.0;0.0;0.0;,\n  1.0;0.0;0.0;,\n  0.0;1.0;0.0;;\n"
+	"  1;\n  3;0;1;2;;\n"
+	"  MeshNormals {\n    3;\n    0.0;0.0;-1.0;,\n    0.0;0.0;-1.0;,\n    0.0;0.0;-1.0;;\n    1;\n    3;0;1;2;;\n  }\n"
+	"  MeshTextureCoords {\n    3;\n    0.0;0.0;,\n    1.0;0.0;,\n    0.0;1.0;;\n  }\n"
+	"  MeshMaterialList {\n    1;\n    1;\n    0;\n"
+	"    Material {\n      1.0;1.0;1.0;1.0;;\n      0.0;\n      0.0;0.0;0.0;;\n      0.0;0.0;0.0;;\n    }\n  }\n"
+	"}\n"
+	"Mesh {\n"
+	"  3;\n  2.0;0.0;0.0;,\n  3.0;0.0;0.0;,\n  2.0;1.0;0.0;;\n"
+	"  1;\n  3;0;1;2;;\n"
+	"  MeshMaterialList {\n    1;\n    1;\n    0;\n"
+	"    Material {\n      1.0;0.0;0.0;1.0;;\n      0.0;\n      0.0;0.0;0.0;;\n      0.0;0.0;0.0;;\n    }\n  }\n"
+	"}\n";
+
+
+// Print the result of a check, returns 1 if it failed
+static unsigned int Check( const char* name, bool passed )
+{
+	printf( "%-48s %s\n", name, passed ? "passed" : "FAILED" );
+	return passed ? 0 : 1;
+}
+
+
+int main()
+{
+	unsigned int failures = 0;
+
+	ofstream file( MixedFileName );
+	file << MixedFile;
+	file.close();
+	gen::CMeshCache mesh;
+	if (mesh.Load( MixedFileName ) != gen::kSuccess)
+	{
+		printf( "Failed to load %s - the current directory must be writable\n", MixedFileName );
+		return 1;
+	}
+	gen::SSubMesh parts[2];
+	bool formatsDiffer = (mesh.GetNumSubMeshes() == 2);
+	if (formatsDiffer)
+	{
+		mesh.GetSubMesh( 0, &parts[0] );
+		mesh.GetSubMesh( 1, &parts[1] );
+		formatsDiffer = parts[0].vertexSize != parts[1].vertexSize;
+	}
+	failures += Check( "Model parts have different vertex formats", formatsDiffer );
+
+	CRecordingRenderDevice device;
+	g_pRenderDevice = &device;
+	{
+		// Positions, normals and UVs - 32 bytes a vertex
+		CModelGeometry* geometry = new CModelGeometry;
+		bool created = geometry->Create( mesh, device.GetTechnique( "VertexLitTex" ) );
+		failures += Check( "Geometry created", created );
+		failures += Check( "Every part kept", created && geometry->GetNumSubsets() == 2 );
+		failures += Check( "Vertex buffer holds all vertices in one layout",
+		                   created && device.GetCommandCount( kCommandCreateVertexBuffer ) == 1 &&
+		                   device.GetCommand( 0 ).type == kCommandCreateVertexBuffer && device.GetCommand( 0 ).args[1] == 6 * 32 );
+		geometry->Release();
+	}
+	g_pRenderDevice = NULL;
+
+	if (failures > 0)
+	{
+		printf( "%u checks failed\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}
@@ -0,0 +1,181 @@
+//--------------------------------------------------------------------------------------
+//	RenderTraceTest.cpp
+//
+//	Records a frame of models drawn through the render queue with the recording render
+//	device, and checks the command trace: the commands made, that the trace is the same
+//	each time the frame is recorded, how invalid handles are written and the pass
+//	re-applies counted from a trace. Run from the repository root so the models are
+//	found. Returns non-zero if any check fails
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+using namespace std;
+
+#include "Defines.h"
+#include "RecordingRenderDevice.h"
+#include "RenderQueue.h"
+#include "ShaderConstants.h"
+#include "Model.h"
+
+// Viewport dimensions (defined by the window setup code in the application)
+int g_ViewportWidth = 1280, g_ViewportHeight = 960;
+
+// Models drawn in the frame, the cubes share geometry
+const unsigned int NumCubes = 3;
+
+
+// Counts taken from a recorded frame
+struct SFrameCounts
+{
+	unsigned int numDraws;        // Draw calls expected - one per subset of each model
+	unsigned int passesApplied;   // As counted by the render queue
+	unsigned int numApplyPass;    // ApplyPass commands in the trace
+	unsigned int numDrawIndexed;  // DrawIndexed commands in the trace
+	bool         clearFirst;      // Frame starts with Clear and ends with Present
+	bool         presentLast;
+};
+
+// Record a frame of the cubes and the floor, drawn with two techniques through the render queue, using a new recording device each
+// time. Returns the trace of the frame, or an empty string if the models fail to load
+static string RecordFrame( SFrameCounts* counts )
+{
+	CRecordingRenderDevice device;
+	g_pRenderDevice = &device;
+
+	TRenderTechnique litTechnique = device.GetTechnique( "VertexLitTex" );
+	TRenderTechnique plainTechnique = device.GetTechnique( "PlainColour" );
+	TRenderVariable diffuseMapVar = device.GetVariable( "DiffuseMap" );
+	TRenderVariable normalMapVar = device.GetVariable( "NormalMap" );
+	TRenderTexture cubeTexture = device.LoadTexture( "StoneDiffuseSpecular.dds" );
+
+	CConstantBuffer perFrameConstants, perMaterialConstants, perObjectConstants;
+	perFrameConstants.Create( "PerFrame", sizeof(SPerFrameConstants) );
+	perMaterialConstants.Create( "PerMaterial", sizeof(SPerMaterialConstants) );
+	perObjectConstants.Create( "PerObject", sizeof(SPerObjectConstants) );
+
+	string trace;
+	{
+		CModel cubes[NumCubes];
+		CModel floor;
+		bool loaded = floor.Load( "Floor.x", plainTechnique );
+		for (unsigned int cube = 0; cube < NumCubes; ++cube)
+		{
+			loaded = cubes[cube].Load( "Cube.x", litTechnique ) && loaded;
+			cubes[cube].SetPosition( gen::CVector3( cube * 20.0f, 10.0f, 0.0f ) );
+		}
+
+		if (loaded)
+		{
+			// Only the frame itself is checked, not the loading
+			device.ClearCommands();
+
+			float clearColour[4] = { 0.2f, 0.2f, 0.3f, 1.0f };
+			device.Clear( clearColour );
+			SPerFrameConstants frameConstants;
+			frameConstants.viewMatrix.MakeAffineEuler( gen::CVector3( 0.0f, 20.0f, -50.0f ), gen::CVector3( 0.3f, 0.0f, 0.0f ),
+			                                           gen::kZXY, gen::CVector3::kOne );
+			frameConstants.projMatrix = gen::CMatrix4x4::kIdentity;
+			frameConstants.cameraPos = gen::CVector3( 0.0f, 20.0f, -50.0f );
+			frameConstants.specularPower = 256.0f;
+			frameConstants.light1Pos = gen::CVector3( 30.0f, 10.0f, 0.0f );
+			frameConstants.parallaxDepth = 0.08f;
+			frameConstants.light1Colour = gen::CVector3( 10.0f, 0.0f, 7.0f );
+			frameConstants.colourMulti = 0.0f;
+			frameConstants.light2Pos = gen::CVector3( -20.0f, 30.0f, 50.0f );
+			frameConstants.light2Colour = gen::CVector3( 40.0f, 32.0f, 8.0f );
+			frameConstants.ambientColour = gen::CVector3( 0.2f, 0.2f, 0.2f );
+			perFrameConstants.SetAndUpload( &frameConstants );
+
+			// Add the models in an order that needs sorting - the queue should group the cubes by technique
+			CRenderQueue queue( &perObjectConstants, &perMaterialConstants, diffuseMapVar, normalMapVar );
+			queue.Add( &cubes[0], litTechnique, cubeTexture, 0, gen::CVector3::kOne );
+			queue.Add( &floor, plainTechnique, 0, 0, gen::CVector3( 0.5f, 0.5f, 0.5f ) );
+			for (unsigned int cube = 1; cube < NumCubes; ++cube)
+			{
+				queue.Add( &cubes[cube], litTechnique, cubeTexture, 0, gen::CVector3::kOne );
+			}
+			queue.Render();
+			device.Present();
+
+			counts->numDraws = floor.GetNumSubsets() + NumCubes * cubes[0].GetNumSubsets();
+			counts->passesApplied = queue.GetStats().passesApplied;
+			counts->numApplyPass = device.GetCommandCount( kCommandApplyPass );
+			counts->numDrawIndexed = device.GetCommandCount( kCommandDrawIndexed );
+			counts->clearFirst = device.GetNumCommands() > 0 && device.GetCommand( 0 ).type == kCommandClear;
+			counts->presentLast = device.GetNumCommands() > 0 &&
+			                      device.GetCommand( device.GetNumCommands() - 1 ).type == kCommandPresent;
+
+			stringstream traceText;
+			device.WriteTrace( traceText );
+			trace = traceText.str();
+		}
+	}
+
+	// Resources must be released while the device exists
+	perFrameConstants.ReleaseResources();
+	perMaterialConstants.ReleaseResources();
+	perObjectConstants.ReleaseResources();
+	device.ReleaseTexture( cubeTexture );
+	g_pRenderDevice = NULL;
+	return trace;
+}
+
+
+// Print the result of a check, returns 1 if it failed
+static unsigned int Check( const char* name, bool passed )
+{
+	printf( "%-44s %s\n", name, passed ? "passed" : "FAILED" );
+	return passed ? 0 : 1;
+}
+
+
+int main()
+{
+	unsigned int failures = 0;
+
+	SFrameCounts counts, repeatCounts;
+	string trace = RecordFrame( &counts );
+	if (trace.empty())
+	{
+		printf( "Failed to load the models - run from the repository root\n" );
+		return 1;
+	}
+	printf( "%s", trace.c_str() );
+	string repeatTrace = RecordFrame( &repeatCounts );
+
+	failures += Check( "Frame starts with Clear and ends with Present", counts.clearFirst && counts.presentLast );
+	failures += Check( "One pass applied per technique", counts.numApplyPass == 2 && counts.passesApplied == counts.numApplyPass );
+	failures += Check( "One draw per model subset", counts.numDrawIndexed == counts.numDraws );
+	failures += Check( "All handles in the trace are valid", trace.find( "invalid" ) == string::npos );
+	failures += Check( "Trace is the same when recorded again", trace == repeatTrace );
+
+	// Handle 0 is what a device returns for an unknown name, it must be written rather than looked up
+	CRecordingRenderDevice device;
+	device.ApplyPass( 0, 0 );
+	device.SetMatrix( 0, gen::CMatrix4x4::kIdentity );
+	stringstream invalidTrace;
+	device.WriteTrace( invalidTrace );
+	failures += Check( "Handle 0 is written as invalid",
+	                   invalidTrace.str().find( "ApplyPass technique=invalid pass=0\nSetMatrix invalid " ) == 0 );
+
+	// The DirectX device applies the pass again before a draw only if variables were written since the pass was applied
+	device.ClearCommands();
+	device.SetMatrix( 1, gen::CMatrix4x4::kIdentity ); // No pass applied yet
+	device.DrawIndexed( 36, 0, 0 );
+	device.ApplyPass( 1, 0 );
+	device.DrawIndexed( 36, 0, 0 );
+	device.SetFloat( 1, 1.0f );
+	device.DrawIndexed( 36, 0, 0 );
+	device.DrawIndexed( 36, 0, 0 );
+	failures += Check( "Pass re-applies counted after variable writes", device.GetNumReapplies() == 1 );
+
+	if (failures > 0)
+	{
+		printf( "%u checks failed\n", failures );
+		return 1;
+	}
+	printf( "All checks passed\n" );
+	return 0;
+}